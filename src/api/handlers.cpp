@@ -3,15 +3,27 @@
 #include <WiFi.h>
 #include <Preferences.h>
 #include "../types.h"
+#include "../signalk/data_store.h"
+#include "../signalk/vessel_model.h"
+#include "../signalk/delta_writer.h"
+#include "../utils/time_utils.h"
 #include "../services/storage.h"
 #include "../services/dyndns.h"
+#include "../services/websocket.h"
+#include "../services/ingest.h"
+#include "../services/expo_push.h"
+#include "../services/nmea0183_tcp.h"
+#include "../services/input_recorder.h"
+#include "../services/input_replay.h"
+#include "../services/metrics.h"
 #include "security.h"
+#include "web_auth.h"
+#include "json_response.h"
 
 // ====== FORWARD DECLARATIONS FOR GLOBALS ======
 extern AsyncWebServer server;
 extern String vesselUUID;
 extern String serverName;
-extern std::map<String, PathValue> dataStore;
 extern std::map<String, AccessRequestData> accessRequests;
 extern std::map<String, ApprovedToken> approvedTokens;
 extern std::vector<String> expoTokens;
@@ -20,8 +32,6 @@ extern int tcpServerPort;
 extern bool tcpEnabled;
 extern DynDnsConfig dynDnsConfig;
 extern WiFiClient tcpClient;
-extern std::map<String, PathValue> lastSentValues;
-extern std::set<String> notifications;
 extern struct GeofenceConfig geofence;
 extern struct DepthAlarmConfig depthAlarm;
 extern struct WindAlarmConfig windAlarm;
@@ -31,9 +41,6 @@ extern APConfig apConfig;
 
 // Forward declarations for utility functions
 extern String generateUUID();
-extern void setPathValue(const String& path, double value, const String& source, const String& units, const String& description);
-extern void setPathValue(const String& path, const String& value, const String& source, const String& units, const String& description);
-extern void setPathValueJson(const String& path, const String& jsonStr, const String& source, const String& units, const String& description);
 extern void saveApprovedTokens();
 extern bool addExpoToken(const String& token);
 extern void requestDynDnsUpdate();
@@ -912,14 +919,12 @@ void handleSignalKRoot(AsyncWebServerRequest* req) {
   server["id"] = serverName;
   server["version"] = "1.0.0";
 
-  String output;
-  serializeJson(doc, output);
-
   Serial.println("Response:");
-  Serial.println(output);
+  serializeJson(doc, Serial);
+  Serial.println();
   Serial.println("==================================\n");
 
-  req->send(200, "application/json", output);
+  sendJson(req, doc);
 }
 
 void handleAPIRoot(AsyncWebServerRequest* req) {
@@ -928,9 +933,7 @@ void handleAPIRoot(AsyncWebServerRequest* req) {
   doc["version"] = "1.7.0";
   doc["self"] = "vessels." + vesselUUID;
 
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  sendJson(req, doc);
 }
 
 void handleAccessRequest(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
@@ -967,9 +970,7 @@ void handleAccessRequest(AsyncWebServerRequest* req, uint8_t* data, size_t len,
       accessRequest["permission"] = "APPROVED";
       accessRequest["token"] = pair.second.token;
 
-      String output;
-      serializeJson(response, output);
-      req->send(202, "application/json", output);
+      sendJson(req, response, 202);
       Serial.println("=================================\n");
       return;
     }
@@ -991,14 +992,13 @@ void handleAccessRequest(AsyncWebServerRequest* req, uint8_t* data, size_t len,
   response["requestId"] = requestId;
   response["href"] = "/signalk/v1/access/requests/" + requestId;
 
-  String output;
-  serializeJson(response, output);
-
-  Serial.printf("Response (202 PENDING): %s\n", output.c_str());
+  Serial.print("Response (202 PENDING): ");
+  serializeJson(response, Serial);
+  Serial.println();
   Serial.printf("RequestId: %s - Awaiting manual approval\n", requestId.c_str());
   Serial.println("=================================\n");
 
-  req->send(202, "application/json", output);
+  sendJson(req, response, 202);
 }
 
 void handleGetAccessRequestById(AsyncWebServerRequest* req) {
@@ -1022,10 +1022,7 @@ void handleGetAccessRequestById(AsyncWebServerRequest* req) {
       accessRequest["permission"] = "APPROVED";
       accessRequest["token"] = pair.second.token;
 
-      String output;
-      serializeJson(response, output);
-
-      req->send(200, "application/json", output);
+      sendJson(req, response);
       return;
     }
   }
@@ -1052,10 +1049,7 @@ void handleGetAccessRequestById(AsyncWebServerRequest* req) {
     accessRequest["permission"] = "APPROVED";
     accessRequest["token"] = newToken;
 
-    String output;
-    serializeJson(response, output);
-
-    req->send(200, "application/json", output);
+    sendJson(req, response);
     return;
   }
 
@@ -1080,13 +1074,12 @@ void handleGetAccessRequestById(AsyncWebServerRequest* req) {
     Serial.println("Response: Still PENDING");
   }
 
-  String output;
-  serializeJson(response, output);
-
-  Serial.printf("Response JSON: %s\n", output.c_str());
+  Serial.print("Response JSON: ");
+  serializeJson(response, Serial);
+  Serial.println();
   Serial.println("==============================\n");
 
-  req->send(200, "application/json", output);
+  sendJson(req, response);
 }
 
 void handleGetAccessRequests(AsyncWebServerRequest* req) {
@@ -1119,190 +1112,59 @@ void handleAuthValidate(AsyncWebServerRequest* req) {
   doc["state"] = "COMPLETED";
   doc["statusCode"] = 200;
 
-  String output;
-  serializeJson(doc, output);
-  Serial.printf("Response: %s\n", output.c_str());
+  Serial.print("Response: ");
+  serializeJson(doc, Serial);
+  Serial.println();
   Serial.println("===============================\n");
 
-  req->send(200, "application/json", output);
+  sendJson(req, doc);
 }
 
 void handleVesselsSelf(AsyncWebServerRequest* req) {
-  Serial.println("\n=== GET /signalk/v1/api/vessels/self ===");
-  Serial.printf("dataStore has %d items\n", dataStore.size());
-
-  DynamicJsonDocument doc(4096);
-
-  doc["uuid"] = vesselUUID;
-  doc["name"] = serverName;
-
-  if (dataStore.size() > 0) {
-    JsonObject nav = doc.createNestedObject("navigation");
-
-    for (auto& kv : dataStore) {
-      String path = kv.first;
-      if (!path.startsWith("navigation.")) continue;
-      Serial.printf("Processing navigation path: %s\n", path.c_str());
-
-      String subPath = path.substring(11);
-
-      JsonObject current = nav;
-
-      int dotIndex = 0;
-      int prevDotIndex = 0;
-      while ((dotIndex = subPath.indexOf('.', prevDotIndex)) >= 0) {
-        String part = subPath.substring(prevDotIndex, dotIndex);
-        if (!current.containsKey(part)) {
-          current = current.createNestedObject(part);
-        } else {
-          JsonVariant v = current[part];
-          if (v.is<JsonObject>()) {
-            current = v.as<JsonObject>();
-          } else {
-            current = current.createNestedObject(part);
-          }
-        }
-        prevDotIndex = dotIndex + 1;
-      }
-
-      String finalKey = subPath.substring(prevDotIndex);
-      subPath = finalKey;
-
-      JsonObject value = current.createNestedObject(subPath);
-      value["timestamp"] = kv.second.timestamp;
-
-      if (kv.second.isJson) {
-        DynamicJsonDocument valueDoc(512);
-        DeserializationError err = deserializeJson(valueDoc, kv.second.jsonValue);
-        if (!err) {
-          value["value"] = valueDoc.as<JsonVariant>();
-        } else {
-          value["value"] = kv.second.jsonValue;
-        }
-      } else if (kv.second.isNumeric) {
-        value["value"] = kv.second.numValue;
-      } else {
-        value["value"] = kv.second.strValue;
-      }
-
-      JsonObject meta = value.createNestedObject("meta");
-      if (kv.second.units.length() > 0) meta["units"] = kv.second.units;
-      if (kv.second.description.length() > 0) meta["description"] = kv.second.description;
-
-      JsonObject src = value.createNestedObject("$source");
-      src["label"] = kv.second.source;
-    }
-  }
-
-  JsonObject env = doc.createNestedObject("environment");
-  for (auto& kv : dataStore) {
-    String path = kv.first;
-    if (!path.startsWith("environment.")) continue;
-
-    String subPath = path.substring(12);
-
-    JsonObject current = env;
-
-    int dotIndex = 0;
-    int prevDotIndex = 0;
-    while ((dotIndex = subPath.indexOf('.', prevDotIndex)) >= 0) {
-      String part = subPath.substring(prevDotIndex, dotIndex);
-      if (!current.containsKey(part)) {
-        current = current.createNestedObject(part);
-      } else {
-        JsonVariant v = current[part];
-        if (v.is<JsonObject>()) {
-          current = v.as<JsonObject>();
-        } else {
-          current = current.createNestedObject(part);
-        }
-      }
-      prevDotIndex = dotIndex + 1;
-    }
-
-    String finalKey = subPath.substring(prevDotIndex);
-    subPath = finalKey;
-
-    JsonObject value = current.createNestedObject(subPath);
-    value["timestamp"] = kv.second.timestamp;
-
-    if (kv.second.isJson) {
-      DynamicJsonDocument valueDoc(512);
-      DeserializationError err = deserializeJson(valueDoc, kv.second.jsonValue);
-      if (!err) {
-        value["value"] = valueDoc.as<JsonVariant>();
-      } else {
-        value["value"] = kv.second.jsonValue;
-      }
-    } else if (kv.second.isNumeric) {
-      value["value"] = kv.second.numValue;
-    } else {
-      value["value"] = kv.second.strValue;
-    }
-
-    JsonObject meta = value.createNestedObject("meta");
-    if (kv.second.units.length() > 0) meta["units"] = kv.second.units;
-    if (kv.second.description.length() > 0) meta["description"] = kv.second.description;
-
-    JsonObject src = value.createNestedObject("$source");
-    src["label"] = kv.second.source;
-  }
-
-  if (!notifications.empty()) {
-    JsonObject notifs = doc.createNestedObject("notifications");
-    for (auto& kv : dataStore) {
-      String path = kv.first;
-      if (!path.startsWith("notifications.")) continue;
-
-      String subPath = path.substring(14);
-
-      if (kv.second.isJson) {
-        DynamicJsonDocument valueDoc(512);
-        DeserializationError err = deserializeJson(valueDoc, kv.second.jsonValue);
-        if (!err) {
-          notifs[subPath] = valueDoc.as<JsonVariant>();
-        }
-      }
-    }
-  }
-
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  // Unchanged groups come from the cache; the snapshot keeps its fragments
+  // alive until the last chunk has been sent
+  std::shared_ptr<VesselModelSnapshot> model =
+    std::make_shared<VesselModelSnapshot>(getVesselModelSnapshot(vesselUUID, serverName));
+
+  AsyncWebServerResponse* response = req->beginChunkedResponse(
+    "application/json",
+    [model](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+      return model->read(index, buffer, maxLen);
+    });
+  req->send(response);
 }
 
 void handleGetPath(AsyncWebServerRequest* req) {
   String path = req->url().substring(String("/signalk/v1/api/vessels/self/").length());
   path.replace("/", ".");
 
-  if (dataStore.count(path) == 0) {
+  // A snapshot taken now; the loop task may update the path meanwhile
+  PathValue pv;
+  PathId id = findPath(path);
+  if (id == INVALID_PATH_ID || !readPathValue(id, pv)) {
     req->send(404, "application/json", "{\"error\":\"Path not found\"}");
     return;
   }
 
-  PathValue& pv = dataStore[path];
-  DynamicJsonDocument doc(512);
-
-  if (pv.isJson) {
-    DynamicJsonDocument valueDoc(256);
-    DeserializationError err = deserializeJson(valueDoc, pv.jsonValue);
-    if (!err) {
-      doc["value"] = valueDoc.as<JsonVariant>();
-    } else {
-      doc["value"] = pv.jsonValue;
-    }
-  } else if (pv.isNumeric) {
-    doc["value"] = pv.numValue;
-  } else {
-    doc["value"] = pv.strValue;
-  }
-
-  doc["timestamp"] = pv.timestamp;
-  doc["$source"] = pv.source;
-
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  bool written = false;
+  sendJsonStream(req, [pv, written](JsonWriter& w) mutable -> bool {
+    if (written) return false;
+    char ts[ISO8601_BUF_LEN];
+    size_t tsLen = formatIso8601(pv.timestamp, ts, sizeof(ts));
+
+    w.raw('{');
+    w.key("value");
+    writePathValue(w, pv);
+    w.raw(',');
+    w.key("timestamp");
+    w.string(ts, tsLen);
+    w.raw(',');
+    w.key("$source");
+    w.string(getSourceName(pv.source));
+    w.raw('}');
+    written = !w.overflowed();
+    return true;
+  });
 }
 
 void handlePutPath(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
@@ -1387,9 +1249,7 @@ void handlePutPath(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t
   response["state"] = "COMPLETED";
   response["statusCode"] = 200;
 
-  String output;
-  serializeJson(response, output);
-  req->send(200, "application/json", output);
+  sendJson(req, response);
 }
 
 // ====== WEB UI HANDLERS ======
@@ -1412,32 +1272,90 @@ void handleAdmin(AsyncWebServerRequest* req) {
 
 // ====== ADMIN API HANDLERS ======
 
-void handleGetAdminTokens(AsyncWebServerRequest* req) {
-  DynamicJsonDocument doc(2048);
+// Position in the admin token listing. Entries are resumed by key rather
+// than by iterator, so approvals or revocations between chunks are safe.
+struct AdminTokenCursor {
+  enum Stage { OPEN, PENDING, APPROVED, CLOSE, DONE };
+  Stage stage = OPEN;
+  String lastKey;
+  bool first = true;  // No entry written yet in the current list
+};
+
+static void writeTokenEntry(JsonWriter& w, const char* idKey, const String& id, const String& clientId,
+                            const String& description, const String& permissions) {
+  w.raw('{');
+  w.key(idKey);
+  w.string(id);
+  w.raw(',');
+  w.key("clientId");
+  w.string(clientId);
+  w.raw(',');
+  w.key("description");
+  w.string(description);
+  w.raw(',');
+  w.key("permissions");
+  w.string(permissions);
+  w.raw('}');
+}
 
-  JsonArray pending = doc.createNestedArray("pending");
-  for (auto& pair : accessRequests) {
-    if (pair.second.state == "PENDING") {
-      JsonObject obj = pending.createNestedObject();
-      obj["requestId"] = pair.second.requestId;
-      obj["clientId"] = pair.second.clientId;
-      obj["description"] = pair.second.description;
-      obj["permissions"] = pair.second.permissions;
+static bool writeAdminTokensPiece(AdminTokenCursor& c, JsonWriter& w) {
+  AdminTokenCursor next = c;
+
+  switch (c.stage) {
+    case AdminTokenCursor::OPEN:
+      w.raw("{\"pending\":[");
+      next.stage = AdminTokenCursor::PENDING;
+      break;
+
+    case AdminTokenCursor::PENDING: {
+      auto it = c.first ? accessRequests.begin() : accessRequests.upper_bound(c.lastKey);
+      while (it != accessRequests.end() && it->second.state != "PENDING") ++it;
+      if (it == accessRequests.end()) {
+        w.raw("],\"approved\":[");
+        next.stage = AdminTokenCursor::APPROVED;
+        next.first = true;
+        break;
+      }
+      const AccessRequestData& r = it->second;
+      if (!c.first) w.raw(',');
+      writeTokenEntry(w, "requestId", r.requestId, r.clientId, r.description, r.permissions);
+      next.lastKey = it->first;
+      next.first = false;
+      break;
     }
-  }
 
-  JsonArray approved = doc.createNestedArray("approved");
-  for (auto& pair : approvedTokens) {
-    JsonObject obj = approved.createNestedObject();
-    obj["token"] = pair.second.token;
-    obj["clientId"] = pair.second.clientId;
-    obj["description"] = pair.second.description;
-    obj["permissions"] = pair.second.permissions;
+    case AdminTokenCursor::APPROVED: {
+      auto it = c.first ? approvedTokens.begin() : approvedTokens.upper_bound(c.lastKey);
+      if (it == approvedTokens.end()) {
+        next.stage = AdminTokenCursor::CLOSE;
+        break;
+      }
+      const ApprovedToken& t = it->second;
+      if (!c.first) w.raw(',');
+      writeTokenEntry(w, "token", t.token, t.clientId, t.description, t.permissions);
+      next.lastKey = it->first;
+      next.first = false;
+      break;
+    }
+
+    case AdminTokenCursor::CLOSE:
+      w.raw("]}");
+      next.stage = AdminTokenCursor::DONE;
+      break;
+
+    case AdminTokenCursor::DONE:
+      return false;
   }
 
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  if (!w.overflowed()) c = next;
+  return true;
+}
+
+void handleGetAdminTokens(AsyncWebServerRequest* req) {
+  AdminTokenCursor cursor;
+  sendJsonStream(req, [cursor](JsonWriter& w) mutable -> bool {
+    return writeAdminTokensPiece(cursor, w);
+  });
 }
 
 void handleAdminApiPost(AsyncWebServerRequest* req) {
@@ -1479,9 +1397,7 @@ void handleAdminApiPost(AsyncWebServerRequest* req) {
     response["success"] = true;
     response["token"] = token;
 
-    String output;
-    serializeJson(response, output);
-    req->send(200, "application/json", output);
+    sendJson(req, response);
     return;
   }
 
@@ -1567,9 +1483,7 @@ void handleApproveToken(AsyncWebServerRequest* req) {
   response["success"] = true;
   response["token"] = token;
 
-  String output;
-  serializeJson(response, output);
-  req->send(200, "application/json", output);
+  sendJson(req, response);
 }
 
 void handleDenyToken(AsyncWebServerRequest* req) {
@@ -1658,9 +1572,7 @@ void handleRegisterExpoToken(AsyncWebServerRequest* req, uint8_t* data, size_t l
   response["added"] = added;
   response["totalTokens"] = expoTokens.size();
 
-  String output;
-  serializeJson(response, output);
-  req->send(200, "application/json", output);
+  sendJson(req, response);
 }
 
 // ====== TCP CONFIGURATION HANDLERS ======
@@ -1671,9 +1583,7 @@ void handleGetTcpConfig(AsyncWebServerRequest* req) {
   doc["port"] = tcpServerPort;
   doc["enabled"] = tcpEnabled;
 
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  sendJson(req, doc);
 }
 
 void handleSetTcpConfig(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total) {
@@ -1719,7 +1629,7 @@ void handleSetTcpConfig(AsyncWebServerRequest* req, uint8_t *data, size_t len, s
 // ====== DYNDNS CONFIGURATION HANDLERS ======
 
 void handleGetDynDnsConfig(AsyncWebServerRequest* req) {
-  DynamicJsonDocument doc(512);
+  DynamicJsonDocument doc(768);
   doc["provider"] = dynDnsConfig.provider;
   doc["hostname"] = dynDnsConfig.hostname;
   doc["username"] = dynDnsConfig.username;
@@ -1729,10 +1639,16 @@ void handleGetDynDnsConfig(AsyncWebServerRequest* req) {
   doc["lastResult"] = dynDnsConfig.lastResult;
   doc["lastUpdated"] = dynDnsConfig.lastUpdated;
   doc["lastSuccess"] = dynDnsConfig.lastSuccess;
+  doc["publicIp"] = dynDnsConfig.publicIp;
+  doc["lastSkipped"] = dynDnsConfig.lastSkipped;
 
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  JsonObject timing = doc.createNestedObject("timing");
+  timing["lookupMs"] = dynDnsConfig.lookupMs;
+  timing["connectMs"] = dynDnsConfig.connectMs;
+  timing["requestMs"] = dynDnsConfig.requestMs;
+  timing["totalMs"] = dynDnsConfig.totalMs;
+
+  sendJson(req, doc);
 }
 
 void handleSetDynDnsConfig(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total) {
@@ -1771,9 +1687,155 @@ void handleTriggerDynDnsUpdate(AsyncWebServerRequest* req) {
   doc["success"] = true;
   doc["message"] = "DynDNS update scheduled";
 
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  sendJson(req, doc);
+}
+
+// ====== WEBSOCKET STATUS HANDLERS ======
+
+void handleGetWebSocketClients(AsyncWebServerRequest* req) {
+  DynamicJsonDocument doc(256 + WS_MAX_SUBSCRIBERS * 256);
+  doc["queueLimit"] = WS_CLIENT_QUEUE_LIMIT;
+  doc["saturatedTimeoutMs"] = WS_SATURATED_TIMEOUT_MS;
+  writeWebSocketClientStats(doc.createNestedArray("clients"));
+
+  sendJson(req, doc);
+}
+
+void handleGetNMEA0183Clients(AsyncWebServerRequest* req) {
+  DynamicJsonDocument doc(256 + MAX_NMEA_CLIENTS * 384);
+  doc["port"] = NMEA_TCP_PORT;
+  doc["maxClients"] = MAX_NMEA_CLIENTS;
+  doc["ringSize"] = NMEA_TX_RING_SIZE;
+  JsonArray clients = doc.createNestedArray("clients");
+  for (const NMEA0183ClientStats& c : getNMEA0183ClientStats()) {
+    JsonObject obj = clients.createNestedObject();
+    obj["slot"] = c.slot;
+    obj["remoteIp"] = c.remoteIp;
+    obj["connectedMs"] = c.connectedMs;
+    obj["receiving"] = c.receiving;
+    obj["bytesSent"] = c.bytesSent;
+    obj["bytesPerSecond"] = c.bytesPerSecond;
+    obj["sentencesSent"] = c.sentencesSent;
+    obj["sentencesDropped"] = c.sentencesDropped;
+    obj["backlogBytes"] = c.backlogBytes;
+    obj["latencyAvgUs"] = c.latencyAvgUs;
+    obj["latencyMaxUs"] = c.latencyMaxUs;
+  }
+
+  sendJson(req, doc);
+}
+
+// ====== TASK STATUS HANDLERS ======
+
+void handleGetTaskStats(AsyncWebServerRequest* req) {
+  DynamicJsonDocument doc(1024);
+  writeIngestStats(doc.to<JsonObject>());
+
+  ExpoPushStats push = getExpoPushStats();
+  JsonObject pushObj = doc.createNestedObject("push");
+  pushObj["queued"] = push.queued;
+  pushObj["pending"] = push.pending;
+  pushObj["dropped"] = push.dropped;
+  pushObj["sent"] = push.sent;
+  pushObj["failed"] = push.failed;
+  pushObj["retries"] = push.retries;
+  pushObj["connects"] = push.connects;
+
+  VesselModelStats model = getVesselModelStats();
+  JsonObject modelObj = doc.createNestedObject("vesselModel");
+  modelObj["requests"] = model.requests;
+  modelObj["groupsRebuilt"] = model.groupsRebuilt;
+  modelObj["groupsReused"] = model.groupsReused;
+  modelObj["lastLength"] = model.lastLength;
+
+  JsonObject storeObj = doc.createNestedObject("dataStore");
+  storeObj["paths"] = getPathCount();
+  storeObj["deferredWrites"] = getDeferredStoreWrites();
+  storeObj["droppedWrites"] = getDroppedStoreWrites();
+
+  sendJson(req, doc);
+}
+
+void handleGetMetrics(AsyncWebServerRequest* req) {
+  AsyncResponseStream* response = req->beginResponseStream(METRICS_CONTENT_TYPE);
+  writeMetrics(*response);
+  req->send(response);
+}
+
+// ====== INPUT RECORDER / REPLAY HANDLERS ======
+
+void handleGetRecorderStatus(AsyncWebServerRequest* req) {
+  DynamicJsonDocument doc(2048);
+  writeInputRecorderStatus(doc.to<JsonObject>());
+  sendJson(req, doc);
+}
+
+void handleStartRecorder(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total) {
+  // The body arrives before the route's auth check; answered there
+  if (index + len != total || !validateWebSession(extractSessionCookie(req))) {
+    return;
+  }
+
+  DynamicJsonDocument doc(512);
+  DeserializationError error = deserializeJson(doc, data, len);
+
+  if (error) {
+    req->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    return;
+  }
+
+  // {"sink":"spiffs","file":"/capture.bin"} or {"sink":"tcp","host":"192.168.4.2","port":9000}
+  String sink = doc["sink"] | "spiffs";
+  bool started;
+  if (sink == "tcp") {
+    started = startInputRecorder(RECORDER_SINK_TCP, doc["host"] | "", doc["port"] | 0);
+  } else {
+    started = startInputRecorder(RECORDER_SINK_SPIFFS, doc["file"] | "/capture.bin");
+  }
+
+  if (!started) {
+    req->send(409, "application/json", "{\"error\":\"Recording already in progress or invalid sink\"}");
+    return;
+  }
+  req->send(202, "application/json", "{\"success\":true}");
+}
+
+void handleStopRecorder(AsyncWebServerRequest* req) {
+  stopInputRecorder();
+  req->send(200, "application/json", "{\"success\":true}");
+}
+
+void handleGetReplayStatus(AsyncWebServerRequest* req) {
+  DynamicJsonDocument doc(1024);
+  writeInputReplayStatus(doc.to<JsonObject>());
+  sendJson(req, doc);
+}
+
+void handleStartReplay(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total) {
+  // The body arrives before the route's auth check; answered there
+  if (index + len != total || !validateWebSession(extractSessionCookie(req))) {
+    return;
+  }
+
+  DynamicJsonDocument doc(256);
+  DeserializationError error = deserializeJson(doc, data, len);
+
+  if (error) {
+    req->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    return;
+  }
+
+  // {"file":"/capture.bin","speed":1}; speed 0 replays as fast as possible
+  if (!startInputReplay(doc["file"] | "/capture.bin", doc["speed"] | 1.0f)) {
+    req->send(409, "application/json", "{\"error\":\"Replay already running, file being recorded or invalid request\"}");
+    return;
+  }
+  req->send(202, "application/json", "{\"success\":true}");
+}
+
+void handleStopReplay(AsyncWebServerRequest* req) {
+  stopInputReplay();
+  req->send(200, "application/json", "{\"success\":true}");
 }
 
 // ====== HARDWARE SETTINGS HANDLERS ======
@@ -1810,9 +1872,7 @@ void handleGetHardwareSettings(AsyncWebServerRequest* req) {
   can["rx"] = hardwareConfig.can_rx;
   can["tx"] = hardwareConfig.can_tx;
 
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  sendJson(req, doc);
 }
 
 void handleSetHardwareSettings(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total) {
@@ -1879,9 +1939,7 @@ void handleGetAPSettings(AsyncWebServerRequest* req) {
   doc["ssid"] = apConfig.ssid;
   doc["password"] = apConfig.password;
 
-  String output;
-  serializeJson(doc, output);
-  req->send(200, "application/json", output);
+  sendJson(req, doc);
 }
 
 void handleSetAPSettings(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total) {
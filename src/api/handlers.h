@@ -24,7 +24,7 @@ void handleAccessRequest(AsyncWebServerRequest* req, uint8_t* data, size_t len,
 // GET /signalk/v1/auth/validate - Validate authentication token
 void handleAuthValidate(AsyncWebServerRequest* req);
 
-// GET /signalk/v1/api/vessels/self - Get vessel data
+// GET /signalk/v1/api/vessels/self - Full vessel model, streamed from the per-group cache
 void handleVesselsSelf(AsyncWebServerRequest* req);
 
 // GET /signalk/v1/api/vessels/self/* - Get specific path
@@ -78,6 +78,42 @@ void handleSetDynDnsConfig(AsyncWebServerRequest* req, uint8_t *data, size_t len
 // POST /api/dyndns/update - Trigger immediate update
 void handleTriggerDynDnsUpdate(AsyncWebServerRequest* req);
 
+// ====== WEBSOCKET STATUS HANDLERS ======
+
+// GET /api/websocket/clients - Per-client queue depth and drop counters
+void handleGetWebSocketClients(AsyncWebServerRequest* req);
+
+// GET /api/nmea0183/clients - Per-client throughput, drop and latency counters
+void handleGetNMEA0183Clients(AsyncWebServerRequest* req);
+
+// ====== TASK STATUS HANDLERS ======
+
+// GET /api/system/tasks - Task load, ingest queue high-water marks, push delivery and model cache counters
+void handleGetTaskStats(AsyncWebServerRequest* req);
+
+// GET /metrics - Ingest, output and heap counters in Prometheus text format
+void handleGetMetrics(AsyncWebServerRequest* req);
+
+// ====== INPUT RECORDER / REPLAY HANDLERS ======
+
+// GET /api/recorder - Recorder state, per-port counters and recordings on SPIFFS
+void handleGetRecorderStatus(AsyncWebServerRequest* req);
+
+// POST /api/recorder/start - Record all inputs to a SPIFFS file or a TCP sink
+void handleStartRecorder(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total);
+
+// POST /api/recorder/stop - Stop recording
+void handleStopRecorder(AsyncWebServerRequest* req);
+
+// GET /api/replay - Replay state, throughput and latency
+void handleGetReplayStatus(AsyncWebServerRequest* req);
+
+// POST /api/replay/start - Replay a recording at 1x, Nx or full speed
+void handleStartReplay(AsyncWebServerRequest* req, uint8_t *data, size_t len, size_t index, size_t total);
+
+// POST /api/replay/stop - Stop the running replay
+void handleStopReplay(AsyncWebServerRequest* req);
+
 // ====== PUSH NOTIFICATION HANDLERS ======
 
 // POST /plugins/signalk-node-red/redApi/register-expo-token - Register Expo push token
@@ -0,0 +1,87 @@
+#include "json_response.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// Per-response state, shared with the chunk callback until the response is freed
+struct JsonStreamState {
+  JsonStreamStep step;
+  std::vector<char> staged;  // A piece larger than the chunk it was due in
+  size_t stagedSent = 0;
+  bool done = false;
+};
+
+void sendJson(AsyncWebServerRequest* req, const JsonDocument& doc, int code) {
+  AsyncResponseStream* response = req->beginResponseStream("application/json");
+  response->setCode(code);
+  serializeJson(doc, *response);
+  req->send(response);
+}
+
+// Render the next piece into state.staged, growing it until the piece fits
+static void stagePiece(JsonStreamState& state, size_t minCapacity) {
+  for (size_t capacity = minCapacity; capacity <= JSON_STREAM_MAX_PIECE; capacity *= 2) {
+    state.staged.resize(capacity);
+    JsonWriter w(state.staged.data(), capacity);
+    if (!state.step(w)) {
+      state.done = true;
+      break;
+    }
+    if (!w.overflowed()) {
+      state.staged.resize(w.length());
+      state.stagedSent = 0;
+      return;
+    }
+  }
+  if (!state.done) {
+    Serial.printf("ERROR: JSON stream piece exceeds %u bytes, response truncated\n",
+                  (unsigned)JSON_STREAM_MAX_PIECE);
+    state.done = true;
+  }
+  state.staged.clear();
+  state.stagedSent = 0;
+}
+
+// Fill one chunk: finish a staged piece, then write pieces straight into the
+// chunk until the next one does not fit. Returns 0 only at the end.
+static size_t fillChunk(JsonStreamState& state, uint8_t* buffer, size_t maxLen) {
+  size_t filled = 0;
+  for (;;) {
+    if (state.stagedSent < state.staged.size()) {
+      size_t n = std::min(state.staged.size() - state.stagedSent, maxLen - filled);
+      memcpy(buffer + filled, state.staged.data() + state.stagedSent, n);
+      state.stagedSent += n;
+      filled += n;
+      if (state.stagedSent < state.staged.size()) return filled;
+      state.staged.clear();
+      state.stagedSent = 0;
+    }
+    if (state.done || filled == maxLen) return filled;
+
+    JsonWriter w((char*)buffer + filled, maxLen - filled);
+    if (!state.step(w)) {
+      state.done = true;
+      return filled;
+    }
+    if (!w.overflowed()) {
+      filled += w.length();
+      continue;
+    }
+    // Retry in the next chunk unless this one would otherwise go out empty
+    if (filled > 0) return filled;
+    stagePiece(state, std::max(maxLen * 2, (size_t)256));
+  }
+}
+
+void sendJsonStream(AsyncWebServerRequest* req, JsonStreamStep step, int code) {
+  std::shared_ptr<JsonStreamState> state = std::make_shared<JsonStreamState>();
+  state->step = step;
+
+  AsyncWebServerResponse* response = req->beginChunkedResponse(
+    "application/json",
+    [state](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+      return fillChunk(*state, buffer, maxLen);
+    });
+  response->setCode(code);
+  req->send(response);
+}
@@ -0,0 +1,42 @@
+#ifndef API_JSON_RESPONSE_H
+#define API_JSON_RESPONSE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <functional>
+#include "../config.h"
+#include "../utils/json_writer.h"
+
+/**
+ * JSON responses without an intermediate String
+ *
+ * sendJson() serializes a small, fixed-capacity document straight into the
+ * response buffer. sendJsonStream() is for responses whose size depends on
+ * the data (token lists, data store values): the body is produced piece by
+ * piece while the connection drains, so peak heap per request is one TCP
+ * chunk plus the largest single piece, independent of the total size.
+ */
+
+/**
+ * Send doc as the response body
+ * @param code HTTP status code
+ */
+void sendJson(AsyncWebServerRequest* req, const JsonDocument& doc, int code = 200);
+
+/**
+ * Writes the next piece of a streamed body (an opening brace, one array
+ * element, ...) and returns true, or returns false without writing once the
+ * document is complete. A piece that does not fit is retried with a fresh
+ * writer, so the cursor must only advance when !w.overflowed().
+ */
+typedef std::function<bool(JsonWriter& w)> JsonStreamStep;
+
+/**
+ * Send a chunked response produced by step; pieces larger than one TCP
+ * chunk (up to JSON_STREAM_MAX_PIECE bytes) are staged on the heap
+ * @param code HTTP status code
+ */
+void sendJsonStream(AsyncWebServerRequest* req, JsonStreamStep step, int code = 200);
+
+#endif // API_JSON_RESPONSE_H
@@ -1,6 +1,7 @@
 #include "routes.h"
 #include "handlers.h"
 #include "web_auth.h"
+#include "security.h"
 #include "settings_html.h"
 #include <ArduinoJson.h>
 
@@ -366,6 +367,57 @@ void setupRoutes(AsyncWebServer& server) {
     handleTriggerDynDnsUpdate(req);
   });
 
+  // WebSocket client status API
+  server.on("/api/websocket/clients", HTTP_GET, [](AsyncWebServerRequest* req) {
+    if (!requireWebAuth(req)) return;
+    handleGetWebSocketClients(req);
+  });
+
+  // NMEA 0183 TCP client status API
+  server.on("/api/nmea0183/clients", HTTP_GET, [](AsyncWebServerRequest* req) {
+    if (!requireWebAuth(req)) return;
+    handleGetNMEA0183Clients(req);
+  });
+
+  // Task load and ingest queue status API
+  server.on("/api/system/tasks", HTTP_GET, [](AsyncWebServerRequest* req) {
+    if (!requireWebAuth(req)) return;
+    handleGetTaskStats(req);
+  });
+
+  // Prometheus metrics - scrapers can't log in, so an approved SignalK
+  // token (Authorization: Bearer) is accepted as well as a web session
+  server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest* req) {
+    if (!isTokenValid(extractBearerToken(req)) && !requireWebAuth(req)) return;
+    handleGetMetrics(req);
+  });
+
+  // Raw input recorder and replay API
+  server.on("/api/recorder", HTTP_GET, [](AsyncWebServerRequest* req) {
+    if (!requireWebAuth(req)) return;
+    handleGetRecorderStatus(req);
+  });
+  server.on("/api/recorder/start", HTTP_POST,
+    [](AsyncWebServerRequest* req) {
+      if (!requireWebAuth(req)) return;
+    }, NULL, handleStartRecorder);
+  server.on("/api/recorder/stop", HTTP_POST, [](AsyncWebServerRequest* req) {
+    if (!requireWebAuth(req)) return;
+    handleStopRecorder(req);
+  });
+  server.on("/api/replay", HTTP_GET, [](AsyncWebServerRequest* req) {
+    if (!requireWebAuth(req)) return;
+    handleGetReplayStatus(req);
+  });
+  server.on("/api/replay/start", HTTP_POST,
+    [](AsyncWebServerRequest* req) {
+      if (!requireWebAuth(req)) return;
+    }, NULL, handleStartReplay);
+  server.on("/api/replay/stop", HTTP_POST, [](AsyncWebServerRequest* req) {
+    if (!requireWebAuth(req)) return;
+    handleStopReplay(req);
+  });
+
   // Hardware Settings API
   server.on("/api/settings/hardware", HTTP_GET, [](AsyncWebServerRequest* req) {
     if (!requireWebAuth(req)) return;
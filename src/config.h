@@ -43,23 +43,69 @@
 #define LED_PIN 4              // WS2812 RGB LED pin
 #define LED_COUNT 1            // Single RGB LED on board
 
+// SignalK Data Store Configuration
+#define MAX_SIGNALK_PATHS 256      // Capacity of the interned path table
+#define MAX_SIGNALK_SOURCES 32     // Capacity of the interned source label table
+#define MAX_SIGNALK_GROUPS 16      // Top-level path groups (navigation, environment, ...)
+#define VESSEL_MODEL_MIN_REBUILD_MS 500 // A cached model subtree is reused for at least this long
+#define DATA_STORE_WRITE_QUEUE_SIZE 32 // Name-based updates from other tasks waiting for loop()
+#define JSON_STREAM_MAX_PIECE 8192 // Largest single piece of a streamed JSON response (bytes)
+
 // WebSocket Configuration
 #define WS_DELTA_MIN_MS 100        // Minimum delta broadcast interval
 #define WS_CLEANUP_MS 5000         // WebSocket cleanup interval
+#define WS_MAX_SUBSCRIBERS 32      // Width of the per-path subscriber bitmask
+#define WS_CLIENT_QUEUE_LIMIT 8    // Queued messages before a client is treated as busy
+#define WS_SATURATED_TIMEOUT_MS 15000 // Disconnect clients busy for this long
+#define WS_REQUEST_QUEUE_SIZE 16   // Subscribe/unsubscribe/broadcast requests waiting for loop()
 #define AUTH_TOKEN_LENGTH 32       // Token length
 
+// Ingest task (serial, CAN and Seatalk parsing)
+#define INGEST_TASK_CORE 0             // loop() and its network output stay on core 1
+#define INGEST_TASK_PRIORITY 5         // Above loop() (1), below WiFi/lwIP
+#define INGEST_TASK_STACK 6144         // Bytes
+#define INGEST_UPDATE_QUEUE_SIZE 256   // Parsed updates in flight to loop() (power of two)
+#define INGEST_SENTENCE_QUEUE_SIZE 32  // NMEA sentences in flight each way (power of two)
+#define INGEST_STATS_LOG_MS 60000      // Task/queue statistics log interval
+
+// Raw input recorder and replay (services/input_recorder.h, input_replay.h)
+#define INPUT_RECORDER_BUFFER_SIZE 8192  // RAM between the inputs and the sink (bytes)
+#define INPUT_RECORDER_FLUSH_MS 500      // Buffered records are written out at least this often
+#define INPUT_RECORDER_MAX_FILE 524288   // A SPIFFS recording stops at this size (bytes)
+#define INPUT_RECORDER_CONNECT_MS 3000   // TCP sink connect timeout
+#define INPUT_RECORDER_TASK_CORE 1       // Short-lived task that connects the TCP sink
+#define INPUT_RECORDER_TASK_PRIORITY 1   // Same as loop()
+#define INPUT_RECORDER_TASK_STACK 4096   // Bytes
+#define INPUT_REPLAY_RECORDS_PER_POLL 32 // Most records injected per ingest task pass
+
+// Expo push delivery task (endpoint: see services/expo_push_client.h)
+#define EXPO_PUSH_TASK_CORE 1          // Network output stays on core 1
+#define EXPO_PUSH_TASK_PRIORITY 1      // Same as loop()
+#define EXPO_PUSH_TASK_STACK 8192      // Bytes; the TLS handshake needs most of it
+#define EXPO_PUSH_QUEUE_DEPTH 8        // Notifications waiting for delivery
+#define EXPO_PUSH_MAX_ATTEMPTS 4       // Per batch, with exponential backoff
+#define EXPO_PUSH_IDLE_CLOSE_MS 60000  // Close the kept-alive connection after this long idle
+
+// DynDNS worker task
+#define DYNDNS_TASK_CORE 1
+#define DYNDNS_TASK_PRIORITY 1
+#define DYNDNS_TASK_STACK 8192
+#define DYNDNS_IP_CHECK_HOST "api.ipify.org"  // Plain-text public IP over HTTP
+
 // TCP Configuration
 #define TCP_RECONNECT_DELAY 5000   // TCP reconnect delay in milliseconds
 
 // NMEA 0183 TCP Server Configuration
 #define NMEA_TCP_PORT 10110        // Standard NMEA 0183 TCP port
-#define MAX_NMEA_CLIENTS 8         // Maximum simultaneous TCP clients
+#define MAX_NMEA_CLIENTS 32        // Pooled connection slots (lwIP CONFIG_LWIP_MAX_ACTIVE_TCP also applies)
 #define CLIENT_TIMEOUT_MS 30000    // TCP client timeout (30 seconds)
-#define CLIENT_BUFFER_SIZE 512     // Buffer size per client
+#define NMEA_TCP_INPUT_QUEUE_SIZE 16 // Received sentences waiting for loop() (power of two)
 
 // NMEA Rate Limiting
 #define NMEA_CLIENT_TIMEOUT 10000  // Client timeout in milliseconds
 #define MAX_SENTENCES_PER_SECOND 100 // Maximum NMEA sentences per second
+#define NMEA_TX_RING_SIZE 4096     // Shared outbound ring; a client further behind drops old sentences
+#define NMEA_TX_RING_SENTENCES 128 // Sentences tracked in the ring (power of two)
 
 // Access Point Configuration
 #define AP_SSID "ESP32-SignalK"
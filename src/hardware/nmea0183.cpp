@@ -1,60 +1,135 @@
 #include "nmea0183.h"
+#include "../types.h"
+#include "../signalk/data_store.h"
+#include "../utils/conversions.h"
+#include "../utils/time_utils.h"
+#include "../utils/nmea_tokenizer.h"
+#include <atomic>
 #include <cmath>
+#include <string.h>
 
 // External declarations for global variables and functions
-extern struct GPSData {
-  double lat;
-  double lon;
-  double sog;
-  double cog;
-  double heading;
-  double altitude;
-  int satellites;
-  String fixQuality;
-  String timestamp;
-} gpsData;
-
-// Helper functions (declared in main)
-extern String iso8601Now();
-extern double knotsToMS(double knots);
-extern double degToRad(double deg);
-extern void setPathValue(const String& path, double value, const String& source,
-                        const String& unit, const String& description);
-extern void setPathValue(const String& path, const String& value, const String& source,
-                        const String& unit, const String& description);
+extern GPSData gpsData;
+
 extern void updateWindAlarm(double windSpeedMS);
 extern void updateDepthAlarm(double depth);
-extern void updateNavigationPosition(double lat, double lon, const String& source);
 
-// ====== NMEA PARSING ======
+// Source ID for all NMEA 0183 inputs
+static SourceId sourceId = INVALID_SOURCE_ID;
+
+// SignalK path IDs, resolved once by initNMEA0183Paths()
+static PathId idCrossTrackError = INVALID_PATH_ID;
+static PathId idNextPointVelocityMadeGood = INVALID_PATH_ID;
+static PathId idCourseOverGroundTrue = INVALID_PATH_ID;
+static PathId idCurrentDrift = INVALID_PATH_ID;
+static PathId idCurrentSetTrue = INVALID_PATH_ID;
+static PathId idGnssAltitude = INVALID_PATH_ID;
+static PathId idGnssSatellitesInView = INVALID_PATH_ID;
+static PathId idHeadingMagnetic = INVALID_PATH_ID;
+static PathId idHeadingTrue = INVALID_PATH_ID;
+static PathId idSpeedOverGround = INVALID_PATH_ID;
+static PathId idSpeedThroughWater = INVALID_PATH_ID;
+static PathId idDepthBelowTransducer = INVALID_PATH_ID;
+static PathId idWindAngleApparent = INVALID_PATH_ID;
+static PathId idWindAngleTrueWater = INVALID_PATH_ID;
+static PathId idWindDirectionMagnetic = INVALID_PATH_ID;
+static PathId idWindDirectionTrue = INVALID_PATH_ID;
+static PathId idWindSpeedApparent = INVALID_PATH_ID;
+static PathId idWindSpeedTrue = INVALID_PATH_ID;
+static PathId idMagneticVariation = INVALID_PATH_ID;
+static PathId idDepthBelowSurface = INVALID_PATH_ID;
+static PathId idDepthBelowKeel = INVALID_PATH_ID;
+static PathId idDepthSurfaceToTransducer = INVALID_PATH_ID;
+static PathId idDepthTransducerToKeel = INVALID_PATH_ID;
+static PathId idWaterTemperature = INVALID_PATH_ID;
+static PathId idRudderAngle = INVALID_PATH_ID;
+static PathId idRateOfTurn = INVALID_PATH_ID;
+static PathId idOutsideTemperature = INVALID_PATH_ID;
+static PathId idOutsidePressure = INVALID_PATH_ID;
+static PathId idOutsideHumidity = INVALID_PATH_ID;
+static PathId idNextPointPosition = INVALID_PATH_ID;
+static PathId idNextPointDistance = INVALID_PATH_ID;
+static PathId idNextPointBearingTrue = INVALID_PATH_ID;
+static PathId idNextPointBearingMagnetic = INVALID_PATH_ID;
+static PathId idLog = INVALID_PATH_ID;
+static PathId idTripLog = INVALID_PATH_ID;
+
+static void registerBuiltinSentences();
+
+void initNMEA0183Paths() {
+  sourceId = registerSource("nmea0183.GPS");
+  idCrossTrackError = registerPath("navigation.course.crossTrackError", "m", "Cross-track error");
+  idNextPointVelocityMadeGood = registerPath("navigation.course.nextPoint.velocityMadeGood", "m/s", "Velocity made good to waypoint");
+  idCourseOverGroundTrue = registerPath("navigation.courseOverGroundTrue", "rad", "Course over ground (true)");
+  idCurrentDrift = registerPath("navigation.current.drift", "m/s", "Current drift");
+  idCurrentSetTrue = registerPath("navigation.current.setTrue", "rad", "Current set (true)");
+  idGnssAltitude = registerPath("navigation.gnss.altitude", "m", "Altitude");
+  idGnssSatellitesInView = registerPath("navigation.gnss.satellitesInView", "", "Satellites in view");
+  idHeadingMagnetic = registerPath("navigation.headingMagnetic", "rad", "Heading (magnetic)");
+  idHeadingTrue = registerPath("navigation.headingTrue", "rad", "Heading (true)");
+  idSpeedOverGround = registerPath("navigation.speedOverGround", "m/s", "Speed over ground");
+  idSpeedThroughWater = registerPath("navigation.speedThroughWater", "m/s", "Speed through water");
+  idDepthBelowTransducer = registerPath("environment.depth.belowTransducer", "m", "Depth below transducer");
+  idWindAngleApparent = registerPath("environment.wind.angleApparent", "rad", "Apparent wind angle");
+  idWindAngleTrueWater = registerPath("environment.wind.angleTrueWater", "rad", "True wind angle");
+  idWindDirectionMagnetic = registerPath("environment.wind.directionMagnetic", "rad", "Wind direction (magnetic)");
+  idWindDirectionTrue = registerPath("environment.wind.directionTrue", "rad", "Wind direction (true)");
+  idWindSpeedApparent = registerPath("environment.wind.speedApparent", "m/s", "Apparent wind speed");
+  idWindSpeedTrue = registerPath("environment.wind.speedTrue", "m/s", "Wind speed (true)");
+  idMagneticVariation = registerPath("navigation.magneticVariation", "rad", "Magnetic variation");
+  idDepthBelowSurface = registerPath("environment.depth.belowSurface", "m", "Depth below surface");
+  idDepthBelowKeel = registerPath("environment.depth.belowKeel", "m", "Depth below keel");
+  idDepthSurfaceToTransducer = registerPath("environment.depth.surfaceToTransducer", "m", "Transducer depth below surface");
+  idDepthTransducerToKeel = registerPath("environment.depth.transducerToKeel", "m", "Transducer to keel");
+  idWaterTemperature = registerPath("environment.water.temperature", "K", "Water temperature");
+  idRudderAngle = registerPath("steering.rudderAngle", "rad", "Rudder angle");
+  idRateOfTurn = registerPath("navigation.rateOfTurn", "rad/s", "Rate of turn");
+  idOutsideTemperature = registerPath("environment.outside.temperature", "K", "Outside air temperature");
+  idOutsidePressure = registerPath("environment.outside.pressure", "Pa", "Atmospheric pressure");
+  idOutsideHumidity = registerPath("environment.outside.relativeHumidity", "ratio", "Outside relative humidity");
+  idNextPointPosition = registerPath("navigation.course.nextPoint.position", "", "Next waypoint position");
+  idNextPointDistance = registerPath("navigation.course.nextPoint.distance", "m", "Distance to next waypoint");
+  idNextPointBearingTrue = registerPath("navigation.course.nextPoint.bearingTrue", "rad", "Bearing to next waypoint (true)");
+  idNextPointBearingMagnetic = registerPath("navigation.course.nextPoint.bearingMagnetic", "rad", "Bearing to next waypoint (magnetic)");
+  idLog = registerPath("navigation.log", "m", "Total distance through water");
+  idTripLog = registerPath("navigation.trip.log", "m", "Trip distance through water");
+
+  registerBuiltinSentences();
+}
 
-bool validateNmeaChecksum(const String& sentence) {
-  int starPos = sentence.indexOf('*');
-  if (starPos < 0) return true;  // No checksum present, accept sentence
+// ====== NMEA PARSING ======
 
-  String data = sentence.substring(1, starPos);  // Skip '$'
-  String checksumStr = sentence.substring(starPos + 1);
+bool validateNmeaChecksum(const char* sentence, size_t len) {
+  const char* star = (const char*)memchr(sentence, '*', len);
+  if (!star) return true;  // No checksum present, accept sentence
 
-  if (checksumStr.length() != 2) return false;  // Invalid checksum format
+  // Exactly two hex digits after '*'
+  size_t starPos = star - sentence;
+  if (len - (starPos + 1) != 2) return false;  // Invalid checksum format
 
   uint8_t checksum = 0;
-  for (int i = 0; i < data.length(); i++) {
-    checksum ^= data[i];
+  for (size_t i = 1; i < starPos; i++) {  // Skip '$'
+    checksum ^= (uint8_t)sentence[i];
   }
 
-  uint8_t expected = strtol(checksumStr.c_str(), NULL, 16);
+  char hex[3] = {star[1], star[2], '\0'};
+  uint8_t expected = strtol(hex, NULL, 16);
   return checksum == expected;
 }
 
-double nmeaCoordToDec(const String& coord, const String& hemisphere) {
-  if (coord.length() < 4) {
-    Serial.println("Coord too short: " + coord);
+bool validateNmeaChecksum(const String& sentence) {
+  return validateNmeaChecksum(sentence.c_str(), sentence.length());
+}
+
+double nmeaCoordToDec(const NmeaField& coord, const NmeaField& hemisphere) {
+  if (coord.len < 4) {
+    Serial.printf("Coord too short: %s\n", coord.ptr);
     return NAN;
   }
 
-  int dotPos = coord.indexOf('.');
-  if (dotPos < 0) {
-    Serial.println("No dot in coord: " + coord);
+  const char* dot = (const char*)memchr(coord.ptr, '.', coord.len);
+  if (!dot) {
+    Serial.printf("No dot in coord: %s\n", coord.ptr);
     return NAN;
   }
 
@@ -62,347 +137,628 @@ double nmeaCoordToDec(const String& coord, const String& hemisphere) {
   // Determine if this is lat or lon based on the dot position
   // Latitude: dot should be at position 4 (DDMM.M)
   // Longitude: dot should be at position 5 (DDDMM.M)
-  int degLen = (dotPos == 4) ? 2 : 3;
-
-  String degStr = coord.substring(0, degLen);
-  String minStr = coord.substring(degLen);
+  size_t degLen = (dot - coord.ptr == 4) ? 2 : 3;
 
-  double degrees = degStr.toDouble();
-  double minutes = minStr.toDouble();
+  double degrees = parseNmeaNumber(coord.ptr, degLen);
+  double minutes = parseNmeaNumber(coord.ptr + degLen, coord.len - degLen);
   double decimal = degrees + (minutes / 60.0);
 
-  // Serial.printf("Coord: %s, Hemisphere: %s\n", coord.c_str(), hemisphere.c_str());
-  // Serial.printf("  Degrees: %s = %.2f, Minutes: %s = %.6f\n", degStr.c_str(), degrees, minStr.c_str(), minutes);
-  // Serial.printf("  Result: %.6f\n", decimal);
-
-  if (hemisphere == "S" || hemisphere == "W") {
+  if (hemisphere.equals('S') || hemisphere.equals('W')) {
     decimal = -decimal;
   }
 
   return decimal;
 }
 
-std::vector<String> splitNMEA(const String& sentence) {
-  std::vector<String> fields;
-  int start = 0;
-  int idx;
+// ====== SENTENCE HANDLERS ======
+// One handler per formatter; fields[0] is the address ("$GPRMC"). Handlers
+// are only called when the sentence has at least the registered number of
+// fields, so indexing up to minFields - 1 needs no further checks.
+
+// $GPRMC - Recommended Minimum
+static void handleRMC(const NmeaTokenizer& fields) {
+  if (!fields[2].equals('A')) return; // Not valid
+
+  double lat = nmeaCoordToDec(fields[3], fields[4]);
+  double lon = nmeaCoordToDec(fields[5], fields[6]);
+  double sog = fields.number(7); // knots
+  double cog = fields.number(8); // degrees
 
-  String s = sentence;
-  int starPos = s.indexOf('*');
-  if (starPos > 0) {
-    s = s.substring(0, starPos);
+  if (!isnan(lat) && !isnan(lon)) {
+    gpsData.lat = lat;
+    gpsData.lon = lon;
+    gpsData.timestamp = iso8601Now();
+
+    // Only use the combined position object, not separate lat/lon paths
+    updateNavigationPosition(lat, lon, sourceId);
   }
 
-  while ((idx = s.indexOf(',', start)) >= 0) {
-    fields.push_back(s.substring(start, idx));
-    start = idx + 1;
+  if (!isnan(sog) && sog >= 0) {
+    gpsData.sog = knotsToMS(sog);
+    setPathValue(idSpeedOverGround, gpsData.sog, sourceId);
   }
-  fields.push_back(s.substring(start));
 
-  return fields;
+  if (!isnan(cog) && cog >= 0 && cog <= 360) {
+    gpsData.cog = degToRad(cog);
+    setPathValue(idCourseOverGroundTrue, gpsData.cog, sourceId);
+  }
+
+  // Magnetic variation (fields 10-11, East positive)
+  double variation = fields.number(10);
+  if (!isnan(variation) && variation <= 180) {
+    if (fields[11].equals('W')) variation = -variation;
+    setPathValue(idMagneticVariation, degToRad(variation), sourceId);
+  }
 }
 
-void parseNMEASentence(const String& sentence) {
-  if (sentence.length() < 7 || sentence[0] != '$') return;
+// $GPGGA - GPS Fix Data
+static void handleGGA(const NmeaTokenizer& fields) {
+  double lat = nmeaCoordToDec(fields[2], fields[3]);
+  double lon = nmeaCoordToDec(fields[4], fields[5]);
+  const NmeaField& quality = fields[6];
+  int sats = fields.integer(7);
+  double alt = fields.number(9);
+
+  if (!isnan(lat) && !isnan(lon)) {
+    gpsData.lat = lat;
+    gpsData.lon = lon;
+    gpsData.satellites = sats;
+    gpsData.fixQuality = quality.ptr;
+    gpsData.timestamp = iso8601Now();
+
+    // Only use the combined position object, not separate lat/lon paths
+    setPathValue(idGnssSatellitesInView, (double)sats, sourceId);
+    updateNavigationPosition(lat, lon, sourceId);
+  }
 
-  // Validate checksum if present (only warn, don't reject for now)
-  if (!validateNmeaChecksum(sentence)) {
-    Serial.println("NMEA: Warning - checksum validation failed for: " + sentence);
-    // Continue processing anyway - some devices send sentences without checksums
-    // or with incorrect checksums but the data is still valid
+  if (!isnan(alt)) {
+    gpsData.altitude = alt;
+    setPathValue(idGnssAltitude, alt, sourceId);
   }
+}
 
-  std::vector<String> fields = splitNMEA(sentence);
-  if (fields.size() < 3) return;
+// $GPVTG - Track & Speed
+static void handleVTG(const NmeaTokenizer& fields) {
+  double cog = fields.number(1);
+  double sog = fields.number(5); // knots
 
-  String msgType = fields[0];
+  if (!isnan(cog) && cog >= 0 && cog <= 360) {
+    gpsData.cog = degToRad(cog);
+    setPathValue(idCourseOverGroundTrue, gpsData.cog, sourceId);
+  }
 
-  // $GPRMC - Recommended Minimum
-  if (msgType.endsWith("RMC") && fields.size() >= 10) {
-    String status = fields[2];
-    if (status != "A") return; // Not valid
+  if (!isnan(sog) && sog >= 0) {
+    gpsData.sog = knotsToMS(sog);
+    setPathValue(idSpeedOverGround, gpsData.sog, sourceId);
+  }
+}
+
+// $HCHDG - Heading, Deviation & Variation
+static void handleHDG(const NmeaTokenizer& fields) {
+  double heading = fields.number(1);
+  if (!isnan(heading) && heading >= 0 && heading <= 360) {
+    gpsData.heading = degToRad(heading);
+    setPathValue(idHeadingMagnetic, gpsData.heading, sourceId);
+  }
 
-    double lat = nmeaCoordToDec(fields[3], fields[4]);
-    double lon = nmeaCoordToDec(fields[5], fields[6]);
-    double sog = fields[7].toDouble(); // knots
-    double cog = fields[8].toDouble(); // degrees
+  // Variation (fields 4-5, East positive)
+  double variation = fields.number(4);
+  if (!isnan(variation) && variation <= 180) {
+    if (fields[5].equals('W')) variation = -variation;
+    setPathValue(idMagneticVariation, degToRad(variation), sourceId);
+  }
+}
 
-    if (!isnan(lat) && !isnan(lon)) {
-      gpsData.lat = lat;
-      gpsData.lon = lon;
-      gpsData.timestamp = iso8601Now();
+// $GPGLL - Geographic Position - Latitude/Longitude
+static void handleGLL(const NmeaTokenizer& fields) {
+  if (!fields[6].equals('A')) return; // Not valid
 
-      // Only use the combined position object, not separate lat/lon paths
-      updateNavigationPosition(lat, lon, "nmea0183.GPS");
-    }
+  double lat = nmeaCoordToDec(fields[1], fields[2]);
+  double lon = nmeaCoordToDec(fields[3], fields[4]);
 
-    if (!isnan(sog) && sog >= 0) {
-      gpsData.sog = knotsToMS(sog);
-      setPathValue("navigation.speedOverGround", gpsData.sog, "nmea0183.GPS", "m/s", "Speed over ground");
-    }
+  if (!isnan(lat) && !isnan(lon)) {
+    gpsData.lat = lat;
+    gpsData.lon = lon;
+    gpsData.timestamp = iso8601Now();
 
-    if (!isnan(cog) && cog >= 0 && cog <= 360) {
-      gpsData.cog = degToRad(cog);
-      setPathValue("navigation.courseOverGroundTrue", gpsData.cog, "nmea0183.GPS", "rad", "Course over ground (true)");
-    }
+    // Only use the combined position object, not separate lat/lon paths
+    updateNavigationPosition(lat, lon, sourceId);
   }
+}
 
-  // $GPGGA - GPS Fix Data
-  else if (msgType.endsWith("GGA") && fields.size() >= 15) {
-    double lat = nmeaCoordToDec(fields[2], fields[3]);
-    double lon = nmeaCoordToDec(fields[4], fields[5]);
-    String quality = fields[6];
-    int sats = fields[7].toInt();
-    double alt = fields[9].toDouble();
-
-    if (!isnan(lat) && !isnan(lon)) {
-      gpsData.lat = lat;
-      gpsData.lon = lon;
-      gpsData.satellites = sats;
-      gpsData.fixQuality = quality;
-      gpsData.timestamp = iso8601Now();
-
-      // Only use the combined position object, not separate lat/lon paths
-      setPathValue("navigation.gnss.satellitesInView", (double)sats, "nmea0183.GPS", "", "Satellites in view");
-      updateNavigationPosition(lat, lon, "nmea0183.GPS");
-    }
+// $IIHDM - Heading Magnetic
+static void handleHDM(const NmeaTokenizer& fields) {
+  double heading = fields.number(1);
+  if (!isnan(heading) && heading >= 0 && heading <= 360) {
+    setPathValue(idHeadingMagnetic, degToRad(heading), sourceId);
+  }
+}
 
-    if (!isnan(alt)) {
-      gpsData.altitude = alt;
-      setPathValue("navigation.gnss.altitude", alt, "nmea0183.GPS", "m", "Altitude");
-    }
+// $IIHDT - Heading True
+static void handleHDT(const NmeaTokenizer& fields) {
+  double heading = fields.number(1);
+  if (!isnan(heading) && heading >= 0 && heading <= 360) {
+    setPathValue(idHeadingTrue, degToRad(heading), sourceId);
   }
+}
 
-  // $GPVTG - Track & Speed
-  else if (msgType.endsWith("VTG") && fields.size() >= 9) {
-    double cog = fields[1].toDouble();
-    double sog = fields[5].toDouble(); // knots
+// $IIMWD - Meteorological Composite
+static void handleMWD(const NmeaTokenizer& fields) {
+  double windDirTrue = fields.number(1);
+  double windDirMag = fields.number(3);
+  double windSpeedKnots = fields.number(5);
+  double windSpeedMs = knotsToMS(windSpeedKnots);
 
-    if (!isnan(cog) && cog >= 0 && cog <= 360) {
-      gpsData.cog = degToRad(cog);
-      setPathValue("navigation.courseOverGroundTrue", gpsData.cog, "nmea0183.GPS", "rad", "Course over ground");
-    }
+  if (!isnan(windDirTrue) && windDirTrue >= 0 && windDirTrue <= 360) {
+    setPathValue(idWindDirectionTrue, degToRad(windDirTrue), sourceId);
+  }
+  if (!isnan(windDirMag) && windDirMag >= 0 && windDirMag <= 360) {
+    setPathValue(idWindDirectionMagnetic, degToRad(windDirMag), sourceId);
+  }
+  if (!isnan(windSpeedMs) && windSpeedMs >= 0) {
+    setPathValue(idWindSpeedTrue, windSpeedMs, sourceId);
+    // Trigger wind alarm monitoring
+    updateWindAlarm(windSpeedMs);
+  }
+}
 
-    if (!isnan(sog) && sog >= 0) {
-      gpsData.sog = knotsToMS(sog);
-      setPathValue("navigation.speedOverGround", gpsData.sog, "nmea0183.GPS", "m/s", "Speed over ground");
-    }
+// $IIVDR - Set and Drift
+static void handleVDR(const NmeaTokenizer& fields) {
+  double set = fields.number(1);
+  double drift = fields.number(3);
+
+  if (!isnan(set) && set >= 0 && set <= 360) {
+    setPathValue(idCurrentSetTrue, degToRad(set), sourceId);
+  }
+  if (!isnan(drift) && drift >= 0) {
+    setPathValue(idCurrentDrift, knotsToMS(drift), sourceId);
+  }
+}
+
+// $IIVHW - Water speed and heading
+static void handleVHW(const NmeaTokenizer& fields) {
+  double headingTrue = fields.number(1);
+  double headingMag = fields.number(3);
+  double speedKnots = fields.number(5);
+  double speedMs = knotsToMS(speedKnots);
+
+  if (!isnan(headingTrue) && headingTrue >= 0 && headingTrue <= 360) {
+    setPathValue(idHeadingTrue, degToRad(headingTrue), sourceId);
+  }
+  if (!isnan(headingMag) && headingMag >= 0 && headingMag <= 360) {
+    setPathValue(idHeadingMagnetic, degToRad(headingMag), sourceId);
+  }
+  if (!isnan(speedMs) && speedMs >= 0) {
+    setPathValue(idSpeedThroughWater, speedMs, sourceId);
+  }
+}
+
+// $IIVPW - Speed Parallel to Wind
+static void handleVPW(const NmeaTokenizer& fields) {
+  double speedKnots = fields.number(1);
+  double speedMs = knotsToMS(speedKnots);
+
+  if (!isnan(speedMs) && speedMs >= 0) {
+    setPathValue(idSpeedThroughWater, speedMs, sourceId);
   }
+}
 
-  // $HCHDG or $GPHDG - Heading
-  else if (msgType.endsWith("HDG") && fields.size() >= 2) {
-    double heading = fields[1].toDouble();
-    if (!isnan(heading) && heading >= 0 && heading <= 360) {
-      gpsData.heading = degToRad(heading);
-      setPathValue("navigation.headingMagnetic", gpsData.heading, "nmea0183.GPS", "rad", "Heading (magnetic)");
+// $IIMWV - Wind Speed and Angle
+static void handleMWV(const NmeaTokenizer& fields) {
+  double windAngle = fields.number(1);
+  const NmeaField& reference = fields[2];
+  double windSpeedKnots = fields.number(3);
+  double windSpeedMs = knotsToMS(windSpeedKnots);
+
+  if (!fields[5].equals('A')) return; // Not valid
+
+  if (!isnan(windAngle) && windAngle >= 0 && windAngle <= 360 && !isnan(windSpeedMs) && windSpeedMs >= 0) {
+    if (reference.equals('R')) {
+      // Relative wind
+      setPathValue(idWindAngleApparent, degToRad(windAngle), sourceId);
+      setPathValue(idWindSpeedApparent, windSpeedMs, sourceId);
+    } else if (reference.equals('T')) {
+      // True wind
+      setPathValue(idWindAngleTrueWater, degToRad(windAngle), sourceId);
+      setPathValue(idWindSpeedTrue, windSpeedMs, sourceId);
+      // Trigger wind alarm monitoring
+      updateWindAlarm(windSpeedMs);
     }
   }
+}
 
-  // $GPGLL - Geographic Position - Latitude/Longitude
-  else if (msgType.endsWith("GLL") && fields.size() >= 7) {
-    String status = fields[6];
-    if (status != "A") return; // Not valid
+// $IIVWT - Wind Speed and Angle True
+static void handleVWT(const NmeaTokenizer& fields) {
+  double windAngleL = fields.number(1);
+  double windAngleR = fields.number(3);
+  double windSpeedKnots = fields.number(5);
+  double windSpeedMs = knotsToMS(windSpeedKnots);
+
+  if (!isnan(windSpeedMs) && windSpeedMs >= 0) {
+    setPathValue(idWindSpeedTrue, windSpeedMs, sourceId);
+    // Trigger wind alarm monitoring
+    updateWindAlarm(windSpeedMs);
+  }
 
-    double lat = nmeaCoordToDec(fields[1], fields[2]);
-    double lon = nmeaCoordToDec(fields[3], fields[4]);
+  // Use left wind angle if available, otherwise right
+  double windAngle = !isnan(windAngleL) ? windAngleL : windAngleR;
+  if (!isnan(windAngle) && windAngle >= 0 && windAngle <= 360) {
+    setPathValue(idWindAngleTrueWater, degToRad(windAngle), sourceId);
+  }
+}
 
-    if (!isnan(lat) && !isnan(lon)) {
-      gpsData.lat = lat;
-      gpsData.lon = lon;
-      gpsData.timestamp = iso8601Now();
+// $GPWCV - Waypoint Closure Velocity
+static void handleWCV(const NmeaTokenizer& fields) {
+  double velocityKnots = fields.number(1);
+  double velocityMs = knotsToMS(velocityKnots);
 
-      // Only use the combined position object, not separate lat/lon paths
-      updateNavigationPosition(lat, lon, "nmea0183.GPS");
-    }
+  if (!isnan(velocityMs) && velocityMs >= 0) {
+    setPathValue(idNextPointVelocityMadeGood, velocityMs, sourceId);
   }
+}
 
-  // $IIHDM - Heading Magnetic
-  else if (msgType.endsWith("HDM") && fields.size() >= 2) {
-    double heading = fields[1].toDouble();
-    if (!isnan(heading) && heading >= 0 && heading <= 360) {
-      setPathValue("navigation.headingMagnetic", degToRad(heading), "nmea0183.GPS", "rad", "Heading (magnetic)");
-    }
+// $GPXTE - Cross-Track Error
+static void handleXTE(const NmeaTokenizer& fields) {
+  double xteNm = fields.number(3);
+
+  if (fields[1].equals('A') && fields[2].equals('A') && !isnan(xteNm)) {
+    double xteM = xteNm * 1852.0; // Convert nautical miles to meters
+    if (fields[4].equals('L')) xteM = -xteM; // Left is negative
+    setPathValue(idCrossTrackError, xteM, sourceId);
   }
+}
 
-  // $IIHDT - Heading True
-  else if (msgType.endsWith("HDT") && fields.size() >= 2) {
-    double heading = fields[1].toDouble();
-    if (!isnan(heading) && heading >= 0 && heading <= 360) {
-      setPathValue("navigation.headingTrue", degToRad(heading), "nmea0183.GPS", "rad", "Heading (true)");
-    }
+// $GPZDA - Time & Date
+static void handleZDA(const NmeaTokenizer& fields) {
+  int hour = fields.integer(1);
+  int minute = fields.integer(2);
+  int second = fields.integer(3);
+
+  if (hour >= 0 && hour <= 23 && minute >= 0 && minute <= 59 && second >= 0 && second <= 59) {
+    // Could set system time here if needed
+    // For now, just acknowledge the time data
   }
+}
 
-  // $IIMWD - Meteorological Composite
-  else if (msgType.endsWith("MWD") && fields.size() >= 8) {
-    double windDirTrue = fields[1].toDouble();
-    double windDirMag = fields[3].toDouble();
-    double windSpeedKnots = fields[5].toDouble();
-    double windSpeedMs = knotsToMS(windSpeedKnots);
+// $IIDBT - Depth of Water
+static void handleDBT(const NmeaTokenizer& fields) {
+  double depthFeet = fields.number(1);
+  double depthMeters = fields.number(3);
 
-    if (!isnan(windDirTrue) && windDirTrue >= 0 && windDirTrue <= 360) {
-      setPathValue("environment.wind.directionTrue", degToRad(windDirTrue), "nmea0183.GPS", "rad", "Wind direction (true)");
-    }
-    if (!isnan(windDirMag) && windDirMag >= 0 && windDirMag <= 360) {
-      setPathValue("environment.wind.directionMagnetic", degToRad(windDirMag), "nmea0183.GPS", "rad", "Wind direction (magnetic)");
-    }
-    if (!isnan(windSpeedMs) && windSpeedMs >= 0) {
-      setPathValue("environment.wind.speedTrue", windSpeedMs, "nmea0183.GPS", "m/s", "Wind speed (true)");
-      // Trigger wind alarm monitoring
-      updateWindAlarm(windSpeedMs);
-    }
+  // Use meters if available, otherwise convert from feet
+  double depth = !isnan(depthMeters) ? depthMeters : (depthFeet * 0.3048);
+
+  if (!isnan(depth) && depth >= 0) {
+    setPathValue(idDepthBelowTransducer, depth, sourceId);
+    // Trigger depth alarm monitoring
+    updateDepthAlarm(depth);
   }
+}
 
-  // $IIVDR - Set and Drift
-  else if (msgType.endsWith("VDR") && fields.size() >= 6) {
-    double set = fields[1].toDouble();
-    double drift = fields[3].toDouble();
+// $GPGSV - GPS Satellites in View
+static void handleGSV(const NmeaTokenizer& fields) {
+  int satellitesInView = fields.integer(3, -1);
 
-    if (!isnan(set) && set >= 0 && set <= 360) {
-      setPathValue("navigation.current.setTrue", degToRad(set), "nmea0183.GPS", "rad", "Current set (true)");
-    }
-    if (!isnan(drift) && drift >= 0) {
-      setPathValue("navigation.current.drift", knotsToMS(drift), "nmea0183.GPS", "m/s", "Current drift");
+  if (satellitesInView >= 0) {
+    setPathValue(idGnssSatellitesInView, (double)satellitesInView, sourceId);
+  }
+}
+
+// $SDDPT - Depth with transducer offset
+static void handleDPT(const NmeaTokenizer& fields) {
+  double depth = fields.number(1);
+  double offset = fields.number(2);
+  if (isnan(depth) || depth < 0) return;
+
+  setPathValue(idDepthBelowTransducer, depth, sourceId);
+  updateDepthAlarm(depth);
+
+  // Positive offset: transducer to waterline; negative: transducer to keel
+  if (!isnan(offset)) {
+    if (offset >= 0) {
+      setPathValue(idDepthBelowSurface, depth + offset, sourceId);
+      setPathValue(idDepthSurfaceToTransducer, offset, sourceId);
+    } else {
+      setPathValue(idDepthBelowKeel, depth + offset, sourceId);
+      setPathValue(idDepthTransducerToKeel, -offset, sourceId);
     }
   }
+}
 
-  // $IIVHW - Water speed and heading
-  else if (msgType.endsWith("VHW") && fields.size() >= 8) {
-    double headingTrue = fields[1].toDouble();
-    double headingMag = fields[3].toDouble();
-    double speedKnots = fields[5].toDouble();
-    double speedMs = knotsToMS(speedKnots);
+// $IIMTW - Water Temperature
+static void handleMTW(const NmeaTokenizer& fields) {
+  double celsius = fields.number(1);
+  if (!isnan(celsius) && fields[2].equals('C')) {
+    setPathValue(idWaterTemperature, celsius + 273.15, sourceId);
+  }
+}
 
-    if (!isnan(headingTrue) && headingTrue >= 0 && headingTrue <= 360) {
-      setPathValue("navigation.headingTrue", degToRad(headingTrue), "nmea0183.GPS", "rad", "Heading (true)");
-    }
-    if (!isnan(headingMag) && headingMag >= 0 && headingMag <= 360) {
-      setPathValue("navigation.headingMagnetic", degToRad(headingMag), "nmea0183.GPS", "rad", "Heading (magnetic)");
-    }
-    if (!isnan(speedMs) && speedMs >= 0) {
-      setPathValue("navigation.speedThroughWater", speedMs, "nmea0183.GPS", "m/s", "Speed through water");
-    }
+// $IIRSA - Rudder Sensor Angle (starboard / single rudder)
+static void handleRSA(const NmeaTokenizer& fields) {
+  double angle = fields.number(1);
+  if (!isnan(angle) && fields[2].equals('A')) {
+    setPathValue(idRudderAngle, degToRad(angle), sourceId);
   }
+}
 
-  // $IIVPW - Speed Parallel to Wind
-  else if (msgType.endsWith("VPW") && fields.size() >= 3) {
-    double speedKnots = fields[1].toDouble();
-    double speedMs = knotsToMS(speedKnots);
+// $TIROT - Rate of Turn (degrees per minute, negative to port)
+static void handleROT(const NmeaTokenizer& fields) {
+  double rate = fields.number(1);
+  if (!isnan(rate) && fields[2].equals('A')) {
+    setPathValue(idRateOfTurn, degToRad(rate) / 60.0, sourceId);
+  }
+}
 
-    if (!isnan(speedMs) && speedMs >= 0) {
-      setPathValue("navigation.speedThroughWater", speedMs, "nmea0183.GPS", "m/s", "Speed through water");
+// $IIXDR - Transducer Measurements, in (type, value, unit, name) groups.
+// Only air temperature, barometric pressure and humidity are mapped;
+// transducer names are vendor specific and not used.
+static void handleXDR(const NmeaTokenizer& fields) {
+  for (size_t i = 1; i + 2 < fields.count(); i += 4) {
+    const NmeaField& type = fields[i];
+    double value = fields.number(i + 1);
+    const NmeaField& unit = fields[i + 2];
+    if (isnan(value)) continue;
+
+    if (type.equals('C') && unit.equals('C')) {
+      setPathValue(idOutsideTemperature, value + 273.15, sourceId);
+    } else if (type.equals('P') && unit.equals('B')) {
+      setPathValue(idOutsidePressure, value * 100000.0, sourceId);
+    } else if (type.equals('P') && unit.equals('P')) {
+      setPathValue(idOutsidePressure, value, sourceId);
+    } else if (type.equals('H') && unit.equals('P') && value >= 0 && value <= 100) {
+      setPathValue(idOutsideHumidity, value / 100.0, sourceId);
     }
   }
+}
 
-  // $IIMWV - Wind Speed and Angle
-  else if (msgType.endsWith("MWV") && fields.size() >= 6) {
-    double windAngle = fields[1].toDouble();
-    String reference = fields[2];
-    double windSpeedKnots = fields[3].toDouble();
-    double windSpeedMs = knotsToMS(windSpeedKnots);
-    String status = fields[5];
-
-    if (status != "A") return; // Not valid
-
-    if (!isnan(windAngle) && windAngle >= 0 && windAngle <= 360 && !isnan(windSpeedMs) && windSpeedMs >= 0) {
-      if (reference == "R") {
-        // Relative wind
-        setPathValue("environment.wind.angleApparent", degToRad(windAngle), "nmea0183.GPS", "rad", "Apparent wind angle");
-        setPathValue("environment.wind.speedApparent", windSpeedMs, "nmea0183.GPS", "m/s", "Apparent wind speed");
-      } else if (reference == "T") {
-        // True wind
-        setPathValue("environment.wind.angleTrueWater", degToRad(windAngle), "nmea0183.GPS", "rad", "True wind angle");
-        setPathValue("environment.wind.speedTrue", windSpeedMs, "nmea0183.GPS", "m/s", "True wind speed");
-        // Trigger wind alarm monitoring
-        updateWindAlarm(windSpeedMs);
-      }
-    }
+// $GPRMB - Recommended Minimum Navigation Information
+static void handleRMB(const NmeaTokenizer& fields) {
+  if (!fields[1].equals('A')) return; // Not valid
+
+  double xteNm = fields.number(2);
+  if (!isnan(xteNm)) {
+    double xteM = xteNm * 1852.0;
+    if (fields[3].equals('L')) xteM = -xteM; // Steer left: vessel is right of track
+    setPathValue(idCrossTrackError, xteM, sourceId);
   }
 
-  // $IIVWT - Wind Speed and Angle True
-  else if (msgType.endsWith("VWT") && fields.size() >= 7) {
-    double windAngleL = fields[1].toDouble();
-    String dirL = fields[2];
-    double windAngleR = fields[3].toDouble();
-    String dirR = fields[4];
-    double windSpeedKnots = fields[5].toDouble();
-    double windSpeedMs = knotsToMS(windSpeedKnots);
+  double lat = nmeaCoordToDec(fields[6], fields[7]);
+  double lon = nmeaCoordToDec(fields[8], fields[9]);
+  if (!isnan(lat) && !isnan(lon)) {
+    setPathComposite(idNextPointPosition, PV_POSITION, lat, lon, NAN, sourceId);
+  }
 
-    if (!isnan(windSpeedMs) && windSpeedMs >= 0) {
-      setPathValue("environment.wind.speedTrue", windSpeedMs, "nmea0183.GPS", "m/s", "True wind speed");
-      // Trigger wind alarm monitoring
-      updateWindAlarm(windSpeedMs);
-    }
+  double rangeNm = fields.number(10);
+  if (!isnan(rangeNm) && rangeNm >= 0) {
+    setPathValue(idNextPointDistance, rangeNm * 1852.0, sourceId);
+  }
 
-    // Use left wind angle if available, otherwise right
-    double windAngle = !isnan(windAngleL) ? windAngleL : windAngleR;
-    if (!isnan(windAngle) && windAngle >= 0 && windAngle <= 360) {
-      setPathValue("environment.wind.angleTrueWater", degToRad(windAngle), "nmea0183.GPS", "rad", "True wind angle");
-    }
+  double bearing = fields.number(11);
+  if (!isnan(bearing) && bearing >= 0 && bearing <= 360) {
+    setPathValue(idNextPointBearingTrue, degToRad(bearing), sourceId);
   }
 
-  // $GPWCV - Waypoint Closure Velocity
-  else if (msgType.endsWith("WCV") && fields.size() >= 4) {
-    double velocityKnots = fields[1].toDouble();
-    double velocityMs = knotsToMS(velocityKnots);
+  double vmg = fields.number(12);
+  if (!isnan(vmg)) {
+    setPathValue(idNextPointVelocityMadeGood, knotsToMS(vmg), sourceId);
+  }
+}
+
+// $GPAPB - Autopilot Sentence "B"
+static void handleAPB(const NmeaTokenizer& fields) {
+  if (!fields[1].equals('A') || !fields[2].equals('A')) return; // Not valid
+
+  double xte = fields.number(3);
+  if (!isnan(xte) && fields[5].equals('N')) {
+    double xteM = xte * 1852.0;
+    if (fields[4].equals('L')) xteM = -xteM;
+    setPathValue(idCrossTrackError, xteM, sourceId);
+  }
 
-    if (!isnan(velocityMs) && velocityMs >= 0) {
-      setPathValue("navigation.course.nextPoint.velocityMadeGood", velocityMs, "nmea0183.GPS", "m/s", "Velocity made good to waypoint");
+  // Bearing from present position to destination
+  double bearing = fields.number(11);
+  if (!isnan(bearing) && bearing >= 0 && bearing <= 360) {
+    if (fields[12].equals('T')) {
+      setPathValue(idNextPointBearingTrue, degToRad(bearing), sourceId);
+    } else if (fields[12].equals('M')) {
+      setPathValue(idNextPointBearingMagnetic, degToRad(bearing), sourceId);
     }
   }
+}
 
-  // $GPXTE - Cross-Track Error
-  else if (msgType.endsWith("XTE") && fields.size() >= 6) {
-    String status1 = fields[1];
-    String status2 = fields[2];
-    double xteNm = fields[3].toDouble();
-    String direction = fields[4];
+// $IIVLW - Distance Traveled through Water
+static void handleVLW(const NmeaTokenizer& fields) {
+  double totalNm = fields.number(1);
+  double tripNm = fields.number(3);
 
-    if (status1 == "A" && status2 == "A" && !isnan(xteNm)) {
-      double xteM = xteNm * 1852.0; // Convert nautical miles to meters
-      if (direction == "L") xteM = -xteM; // Left is negative
-      setPathValue("navigation.course.crossTrackError", xteM, "nmea0183.GPS", "m", "Cross-track error");
-    }
+  if (!isnan(totalNm) && totalNm >= 0) {
+    setPathValue(idLog, totalNm * 1852.0, sourceId);
   }
+  if (!isnan(tripNm) && tripNm >= 0) {
+    setPathValue(idTripLog, tripNm * 1852.0, sourceId);
+  }
+}
 
-  // $GPZDA - Time & Date
-  else if (msgType.endsWith("ZDA") && fields.size() >= 5) {
-    int hour = fields[1].toInt();
-    int minute = fields[2].toInt();
-    int second = fields[3].toInt();
-    int day = fields[4].toInt();
-    int month = fields[5].toInt();
-    int year = fields[6].toInt();
+// ====== DISPATCH TABLE ======
 
-    if (hour >= 0 && hour <= 23 && minute >= 0 && minute <= 59 && second >= 0 && second <= 59) {
-      // Could set system time here if needed
-      // For now, just acknowledge the time data
+struct NmeaSentenceEntry {
+  uint32_t formatter;         // Packed 3-character formatter, 0 = unused
+  uint8_t minFields;
+  const char* talkers;        // Accepted talker IDs, nullptr = any
+  NmeaSentenceHandler handler;
+  std::atomic<uint32_t> received;
+  std::atomic<uint32_t> checksumErrors;
+  std::atomic<uint32_t> parseErrors;  // Fewer fields than minFields
+};
+
+// Open-addressed hash of packed formatters to entries (2x oversized)
+#define NMEA0183_DISPATCH_SLOTS (NMEA0183_MAX_SENTENCES * 2)
+
+static NmeaSentenceEntry sentenceEntries[NMEA0183_MAX_SENTENCES];
+static uint8_t sentenceCount = 0;
+static uint8_t dispatchSlots[NMEA0183_DISPATCH_SLOTS];  // Entry index + 1, 0 = empty
+
+// Sentences whose formatter has no handler
+static std::atomic<uint32_t> unsupportedReceived(0);
+static std::atomic<uint32_t> unsupportedChecksumErrors(0);
+
+static inline uint32_t packFormatter(const char* f) {
+  return ((uint32_t)(uint8_t)f[0] << 16) | ((uint32_t)(uint8_t)f[1] << 8) | (uint8_t)f[2];
+}
+
+static inline uint8_t dispatchSlot(uint32_t formatter) {
+  return (uint8_t)((formatter * 2654435761u) >> 24) % NMEA0183_DISPATCH_SLOTS;
+}
+
+static NmeaSentenceEntry* findSentence(uint32_t formatter) {
+  for (uint8_t n = 0, slot = dispatchSlot(formatter); n < NMEA0183_DISPATCH_SLOTS; n++) {
+    uint8_t index = dispatchSlots[slot];
+    if (index == 0) return nullptr;
+    if (sentenceEntries[index - 1].formatter == formatter) return &sentenceEntries[index - 1];
+    slot = (slot + 1) % NMEA0183_DISPATCH_SLOTS;
+  }
+  return nullptr;
+}
+
+bool registerNMEA0183Sentence(const char* formatter, uint8_t minFields,
+                              NmeaSentenceHandler handler, const char* talkers) {
+  if (!formatter || strlen(formatter) != 3 || !handler) return false;
+
+  uint32_t packed = packFormatter(formatter);
+  uint8_t slot = dispatchSlot(packed);
+  while (dispatchSlots[slot] != 0) {
+    NmeaSentenceEntry& existing = sentenceEntries[dispatchSlots[slot] - 1];
+    if (existing.formatter == packed) {
+      // Re-registering a formatter replaces its handler
+      existing.minFields = minFields;
+      existing.talkers = talkers;
+      existing.handler = handler;
+      return true;
     }
+    slot = (slot + 1) % NMEA0183_DISPATCH_SLOTS;
   }
 
-  // $IIDBT - Depth of Water
-  else if (msgType.endsWith("DBT") && fields.size() >= 7) {
-    double depthFeet = fields[1].toDouble();
-    double depthMeters = fields[3].toDouble();
-    double depthFathoms = fields[5].toDouble();
+  if (sentenceCount >= NMEA0183_MAX_SENTENCES) {
+    Serial.printf("NMEA: Sentence table full, cannot register %s\n", formatter);
+    return false;
+  }
+  NmeaSentenceEntry& entry = sentenceEntries[sentenceCount++];
+  entry.formatter = packed;
+  entry.minFields = minFields;
+  entry.talkers = talkers;
+  entry.handler = handler;
+  dispatchSlots[slot] = sentenceCount;
+  return true;
+}
 
-    // Use meters if available, otherwise convert from feet
-    double depth = !isnan(depthMeters) ? depthMeters : (depthFeet * 0.3048);
+// True if talkers (concatenated 2-letter IDs, e.g. "GPGN") contains talker
+static bool talkerAccepted(const char* talkers, const char* talker) {
+  if (!talkers) return true;
+  for (; talkers[0] && talkers[1]; talkers += 2) {
+    if (talkers[0] == talker[0] && talkers[1] == talker[1]) return true;
+  }
+  return false;
+}
 
-    if (!isnan(depth) && depth >= 0) {
-      setPathValue("environment.depth.belowTransducer", depth, "nmea0183.GPS", "m", "Depth below transducer");
-      // Trigger depth alarm monitoring
-      updateDepthAlarm(depth);
-    }
+static void registerBuiltinSentences() {
+  registerNMEA0183Sentence("RMC", 10, handleRMC);
+  registerNMEA0183Sentence("GGA", 15, handleGGA);
+  registerNMEA0183Sentence("VTG", 9, handleVTG);
+  registerNMEA0183Sentence("HDG", 2, handleHDG);
+  registerNMEA0183Sentence("GLL", 7, handleGLL);
+  registerNMEA0183Sentence("HDM", 2, handleHDM);
+  registerNMEA0183Sentence("HDT", 2, handleHDT);
+  registerNMEA0183Sentence("MWD", 8, handleMWD);
+  registerNMEA0183Sentence("VDR", 6, handleVDR);
+  registerNMEA0183Sentence("VHW", 8, handleVHW);
+  registerNMEA0183Sentence("VPW", 3, handleVPW);
+  registerNMEA0183Sentence("MWV", 6, handleMWV);
+  registerNMEA0183Sentence("VWT", 7, handleVWT);
+  registerNMEA0183Sentence("WCV", 4, handleWCV);
+  registerNMEA0183Sentence("XTE", 6, handleXTE);
+  registerNMEA0183Sentence("ZDA", 5, handleZDA);
+  registerNMEA0183Sentence("DBT", 7, handleDBT);
+  registerNMEA0183Sentence("GSV", 4, handleGSV);
+  registerNMEA0183Sentence("DPT", 3, handleDPT);
+  registerNMEA0183Sentence("MTW", 3, handleMTW);
+  registerNMEA0183Sentence("RSA", 3, handleRSA);
+  registerNMEA0183Sentence("ROT", 3, handleROT);
+  registerNMEA0183Sentence("XDR", 4, handleXDR);
+  registerNMEA0183Sentence("RMB", 13, handleRMB);
+  registerNMEA0183Sentence("APB", 13, handleAPB);
+  registerNMEA0183Sentence("VLW", 5, handleVLW);
+}
+
+static inline void countRelaxed(std::atomic<uint32_t>& counter) {
+  counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+void parseNMEASentence(const char* sentence, size_t len, InputPort port) {
+  if (len < 7 || sentence[0] != '$') {
+    countInput(port, INPUT_PARSE_ERRORS);
+    return;
   }
+  countInput(port, INPUT_SENTENCES);
 
-  // $GPGSV - GPS Satellites in View
-  else if (msgType.endsWith("GSV") && fields.size() >= 4) {
-    int totalMessages = fields[1].toInt();
-    int messageNumber = fields[2].toInt();
-    int satellitesInView = fields[3].toInt();
+  // Validate checksum if present (only warn, don't reject for now)
+  bool checksumValid = validateNmeaChecksum(sentence, len);
+  if (!checksumValid) {
+    countInput(port, INPUT_CHECKSUM_ERRORS);
+    Serial.printf("NMEA: Warning - checksum validation failed for: %.*s\n", (int)len, sentence);
+    // Continue processing anyway - some devices send sentences without checksums
+    // or with incorrect checksums but the data is still valid
+  }
 
-    if (!isnan(satellitesInView) && satellitesInView >= 0) {
-      setPathValue("navigation.gnss.satellitesInView", (double)satellitesInView, "nmea0183.GPS", "", "Satellites in view");
-    }
+  // Reused across calls; field views point into its buffer
+  static NmeaTokenizer fields;
+  if (!fields.tokenize(sentence, len) || fields.count() < 3 || fields[0].len < 4) {
+    countInput(port, INPUT_PARSE_ERRORS);
+    return;
+  }
+
+  // Address is "$" + talker + formatter; the formatter is the last 3 chars
+  const NmeaField& address = fields[0];
+  NmeaSentenceEntry* entry = findSentence(packFormatter(address.ptr + address.len - 3));
+  if (!entry) {
+    countRelaxed(unsupportedReceived);
+    if (!checksumValid) countRelaxed(unsupportedChecksumErrors);
+    return;
   }
+  countRelaxed(entry->received);
+  if (!checksumValid) countRelaxed(entry->checksumErrors);
+  if (fields.count() < entry->minFields) {
+    countRelaxed(entry->parseErrors);
+    countInput(port, INPUT_PARSE_ERRORS);
+    return;
+  }
+  if (entry->talkers && (address.len != 6 || !talkerAccepted(entry->talkers, address.ptr + 1))) return;
+
+  entry->handler(fields);
+}
+
+void parseNMEASentence(const String& sentence, InputPort port) {
+  parseNMEASentence(sentence.c_str(), sentence.length(), port);
+}
+
+std::vector<NmeaSentenceStats> getNMEA0183SentenceStats() {
+  std::vector<NmeaSentenceStats> stats;
+  stats.reserve(sentenceCount + 1);
+  for (uint8_t i = 0; i < sentenceCount; i++) {
+    const NmeaSentenceEntry& entry = sentenceEntries[i];
+    NmeaSentenceStats s;
+    s.formatter[0] = (char)(entry.formatter >> 16);
+    s.formatter[1] = (char)(entry.formatter >> 8);
+    s.formatter[2] = (char)entry.formatter;
+    s.formatter[3] = '\0';
+    s.received = entry.received.load(std::memory_order_relaxed);
+    s.checksumErrors = entry.checksumErrors.load(std::memory_order_relaxed);
+    s.parseErrors = entry.parseErrors.load(std::memory_order_relaxed);
+    stats.push_back(s);
+  }
+
+  NmeaSentenceStats other = {};
+  other.received = unsupportedReceived.load(std::memory_order_relaxed);
+  other.checksumErrors = unsupportedChecksumErrors.load(std::memory_order_relaxed);
+  stats.push_back(other);
+  return stats;
 }
@@ -2,6 +2,8 @@
 #define NMEA0183_H
 
 #include <Arduino.h>
+#include "../utils/nmea_tokenizer.h"
+#include "../utils/input_stats.h"
 #include <vector>
 
 /**
@@ -14,12 +16,46 @@
 // Forward declarations
 struct GPSData;
 
+// Capacity of the sentence dispatch table
+#define NMEA0183_MAX_SENTENCES 48
+
+/**
+ * Registers the SignalK paths produced by the NMEA 0183 parser and the
+ * built-in sentence handlers
+ * Call once at startup, before any sentence is parsed
+ */
+void initNMEA0183Paths();
+
+/**
+ * Handler for one sentence formatter
+ * fields[0] is the address ("$GPRMC"); at least the registered minimum
+ * number of fields is present.
+ */
+typedef void (*NmeaSentenceHandler)(const NmeaTokenizer& fields);
+
+/**
+ * Registers a handler for a sentence formatter
+ *
+ * Dispatch is a hash lookup on the packed 3-character formatter, so the
+ * number of registered sentences does not affect parse cost. Registering
+ * an already known formatter replaces its handler.
+ *
+ * @param formatter 3-character sentence formatter ("RMC", "DPT", ...)
+ * @param minFields Minimum field count, including the address field
+ * @param handler Function called with the tokenized sentence
+ * @param talkers Accepted talker IDs as concatenated pairs ("GPGN"), or nullptr for any
+ * @return false if the formatter is invalid or the table is full
+ */
+bool registerNMEA0183Sentence(const char* formatter, uint8_t minFields,
+                              NmeaSentenceHandler handler, const char* talkers = nullptr);
+
 /**
  * Validates the checksum of an NMEA sentence
  *
  * @param sentence The NMEA sentence to validate (with or without checksum)
  * @return true if checksum is valid or no checksum present, false if invalid
  */
+bool validateNmeaChecksum(const char* sentence, size_t len);
 bool validateNmeaChecksum(const String& sentence);
 
 /**
@@ -29,19 +65,11 @@ bool validateNmeaChecksum(const String& sentence);
  * - Latitude: DDMM.MMMM (2 digits degrees, 2 digits minutes, decimal minutes)
  * - Longitude: DDDMM.MMMM (3 digits degrees, 2 digits minutes, decimal minutes)
  *
- * @param coord The coordinate string in NMEA format
+ * @param coord The coordinate field in NMEA format
  * @param hemisphere Direction indicator ('N'orth, 'S'outh, 'E'ast, 'W'est)
  * @return Decimal degrees, or NAN if invalid
  */
-double nmeaCoordToDec(const String& coord, const String& hemisphere);
-
-/**
- * Splits an NMEA sentence into comma-separated fields
- *
- * @param sentence The NMEA sentence (with or without checksum)
- * @return Vector of field strings
- */
-std::vector<String> splitNMEA(const String& sentence);
+double nmeaCoordToDec(const NmeaField& coord, const NmeaField& hemisphere);
 
 /**
  * Parses an NMEA 0183 sentence and updates navigation/environmental data
@@ -50,7 +78,7 @@ std::vector<String> splitNMEA(const String& sentence);
  * - RMC: Recommended Minimum Position
  * - GGA: GPS Fix Data
  * - VTG: Track & Speed
- * - HDG/HDM/HDT: Heading
+ * - HDG/HDM/HDT: Heading (HDG also magnetic variation)
  * - GLL: Geographic Position
  * - MWD/MWV: Wind Data
  * - VDR: Set and Drift (Current)
@@ -62,9 +90,41 @@ std::vector<String> splitNMEA(const String& sentence);
  * - ZDA: Time & Date
  * - DBT: Depth of Water
  * - GSV: GPS Satellites in View
+ * - DPT: Depth with transducer offset
+ * - MTW: Water Temperature
+ * - RSA: Rudder Sensor Angle
+ * - ROT: Rate of Turn
+ * - XDR: Transducer Measurements (air temperature, pressure, humidity)
+ * - RMB: Recommended Minimum Navigation Information
+ * - APB: Autopilot Sentence "B"
+ * - VLW: Distance Traveled through Water
+ *
+ * Sentences are dispatched through the registerNMEA0183Sentence() table.
+ * Fields are split in place by NmeaTokenizer, so parsing does not allocate.
+ * Empty numeric fields read as NAN and are skipped rather than stored as 0.
+ *
+ * Counts the sentence, checksum failures and parse errors for its
+ * formatter (see getNMEA0183SentenceStats()) and in inputStats[port].
  *
  * @param sentence The NMEA sentence to parse (starting with '$')
+ * @param len Length of the sentence, without line terminator
+ * @param port Input it arrived on; INPUT_PORT_COUNT = not counted per port
+ */
+void parseNMEASentence(const char* sentence, size_t len, InputPort port = INPUT_PORT_COUNT);
+void parseNMEASentence(const String& sentence, InputPort port = INPUT_PORT_COUNT);
+
+// Counters of one sentence formatter since boot
+struct NmeaSentenceStats {
+  char formatter[4];        // "RMC"; empty for sentences without a handler
+  uint32_t received;
+  uint32_t checksumErrors;
+  uint32_t parseErrors;     // Fewer fields than the handler needs
+};
+
+/**
+ * Counters of every registered formatter, in registration order, followed
+ * by one entry (empty formatter) for sentences no handler is registered for
  */
-void parseNMEASentence(const String& sentence);
+std::vector<NmeaSentenceStats> getNMEA0183SentenceStats();
 
 #endif // NMEA0183_H
@@ -2,43 +2,64 @@
 #include <NMEA2000.h>
 #include <N2kMessages.h>
 #include "../config.h"
+#include "../types.h"
+#include "../signalk/data_store.h"
+#include "../utils/time_utils.h"
 #include "../utils/nmea0183_converter.h"
 #include "../services/nmea0183_tcp.h"
+#include "../services/input_recorder.h"
+#include "../utils/input_stats.h"
+#include <atomic>
 
 // External declaration for NMEA2000 instance (defined in main.cpp)
 class tNMEA2000;
 extern tNMEA2000& NMEA2000;
 
 // External declarations for global variables and functions
-extern struct GPSData {
-  double lat;
-  double lon;
-  double sog;
-  double cog;
-  double heading;
-  double altitude;
-  int satellites;
-  String fixQuality;
-  String timestamp;
-} gpsData;
+extern GPSData gpsData;
 
 extern bool n2kEnabled;
 
 // Helper functions (declared in main)
-extern String iso8601Now();
-extern void setPathValue(const String& path, double value, const String& source,
-                        const String& unit, const String& description);
-extern void setPathValue(const String& path, const String& value, const String& source,
-                        const String& unit, const String& description);
-extern void updateNavigationPosition(double lat, double lon, const String& source);
 extern void updateWindAlarm(double windSpeedMS);
 extern void updateDepthAlarm(double depth);
 extern double RadToDeg(double rad);
 extern double KelvinToC(double kelvin);
 
+// Source ID for all NMEA 2000 inputs
+static SourceId sourceId = INVALID_SOURCE_ID;
+
+// SignalK path IDs, resolved once by registerN2kPaths()
+static PathId idCourseOverGroundTrue = INVALID_PATH_ID;
+static PathId idSpeedOverGround = INVALID_PATH_ID;
+static PathId idWindSpeedApparent = INVALID_PATH_ID;
+static PathId idWindAngleApparent = INVALID_PATH_ID;
+static PathId idWindSpeedTrue = INVALID_PATH_ID;
+static PathId idWindAngleTrueWater = INVALID_PATH_ID;
+static PathId idDepthBelowTransducer = INVALID_PATH_ID;
+static PathId idWaterTemperature = INVALID_PATH_ID;
+static PathId idOutsideTemperature = INVALID_PATH_ID;
+static PathId idOutsidePressure = INVALID_PATH_ID;
+static PathId idAttitude = INVALID_PATH_ID;
+
+static void registerN2kPaths() {
+  sourceId = registerSource("nmea2000.can");
+  idCourseOverGroundTrue = registerPath("navigation.courseOverGroundTrue", "rad", "Course over ground");
+  idSpeedOverGround = registerPath("navigation.speedOverGround", "m/s", "Speed over ground");
+  idWindSpeedApparent = registerPath("environment.wind.speedApparent", "m/s", "Apparent wind speed");
+  idWindAngleApparent = registerPath("environment.wind.angleApparent", "rad", "Apparent wind angle");
+  idWindSpeedTrue = registerPath("environment.wind.speedTrue", "m/s", "True wind speed");
+  idWindAngleTrueWater = registerPath("environment.wind.angleTrueWater", "rad", "True wind angle");
+  idDepthBelowTransducer = registerPath("environment.depth.belowTransducer", "m", "Depth below transducer");
+  idWaterTemperature = registerPath("environment.water.temperature", "K", "Water temperature");
+  idOutsideTemperature = registerPath("environment.outside.temperature", "K", "Outside air temperature");
+  idOutsidePressure = registerPath("environment.outside.pressure", "Pa", "Atmospheric pressure");
+  idAttitude = registerPath("navigation.attitude", "rad", "Vessel attitude (roll, pitch, yaw)");
+}
+
 // ====== NMEA 2000 MESSAGE HANDLERS ======
 
-void HandleN2kPosition(const tN2kMsg &N2kMsg) {
+bool HandleN2kPosition(const tN2kMsg &N2kMsg) {
   unsigned char SID;
   double latitude, longitude;
 
@@ -47,7 +68,7 @@ void HandleN2kPosition(const tN2kMsg &N2kMsg) {
     gpsData.lon = longitude;
     gpsData.timestamp = iso8601Now();
 
-    updateNavigationPosition(latitude, longitude, "nmea2000.can");
+    updateNavigationPosition(latitude, longitude, sourceId);
 
     Serial.printf("N2K Position: %.6f, %.6f\n", latitude, longitude);
 
@@ -62,10 +83,12 @@ void HandleN2kPosition(const tN2kMsg &N2kMsg) {
       String gll = convertToGLL(latitude, longitude, gpsData.timestamp);
       broadcastNMEA0183(gll);
     }
+    return true;
   }
+  return false;
 }
 
-void HandleN2kCOGSOG(const tN2kMsg &N2kMsg) {
+bool HandleN2kCOGSOG(const tN2kMsg &N2kMsg) {
   unsigned char SID;
   tN2kHeadingReference HeadingReference;
   double COG, SOG;
@@ -73,11 +96,11 @@ void HandleN2kCOGSOG(const tN2kMsg &N2kMsg) {
   if (ParseN2kPGN129026(N2kMsg, SID, HeadingReference, COG, SOG)) {
     if (!N2kIsNA(COG)) {
       gpsData.cog = COG;
-      setPathValue("navigation.courseOverGroundTrue", COG, "nmea2000.can", "rad", "Course over ground");
+      setPathValue(idCourseOverGroundTrue, COG, sourceId);
     }
     if (!N2kIsNA(SOG)) {
       gpsData.sog = SOG;
-      setPathValue("navigation.speedOverGround", SOG, "nmea2000.can", "m/s", "Speed over ground");
+      setPathValue(idSpeedOverGround, SOG, sourceId);
     }
 
     Serial.printf("N2K COG/SOG: %.1f deg, %.2f m/s\n", RadToDeg(COG), SOG);
@@ -96,10 +119,12 @@ void HandleN2kCOGSOG(const tN2kMsg &N2kMsg) {
         broadcastNMEA0183(rmc);
       }
     }
+    return true;
   }
+  return false;
 }
 
-void HandleN2kWindSpeed(const tN2kMsg &N2kMsg) {
+bool HandleN2kWindSpeed(const tN2kMsg &N2kMsg) {
   unsigned char SID;
   double WindSpeed, WindAngle;
   tN2kWindReference WindReference;
@@ -107,18 +132,18 @@ void HandleN2kWindSpeed(const tN2kMsg &N2kMsg) {
   if (ParseN2kPGN130306(N2kMsg, SID, WindSpeed, WindAngle, WindReference)) {
     if (WindReference == N2kWind_Apparent) {
       if (!N2kIsNA(WindSpeed)) {
-        setPathValue("environment.wind.speedApparent", WindSpeed, "nmea2000.can", "m/s", "Apparent wind speed");
+        setPathValue(idWindSpeedApparent, WindSpeed, sourceId);
       }
       if (!N2kIsNA(WindAngle)) {
-        setPathValue("environment.wind.angleApparent", WindAngle, "nmea2000.can", "rad", "Apparent wind angle");
+        setPathValue(idWindAngleApparent, WindAngle, sourceId);
       }
     } else if (WindReference == N2kWind_True_water || WindReference == N2kWind_True_North) {
       if (!N2kIsNA(WindSpeed)) {
-        setPathValue("environment.wind.speedTrue", WindSpeed, "nmea2000.can", "m/s", "True wind speed");
+        setPathValue(idWindSpeedTrue, WindSpeed, sourceId);
         updateWindAlarm(WindSpeed);
       }
       if (!N2kIsNA(WindAngle)) {
-        setPathValue("environment.wind.angleTrueWater", WindAngle, "nmea2000.can", "rad", "True wind angle");
+        setPathValue(idWindAngleTrueWater, WindAngle, sourceId);
       }
     }
 
@@ -135,16 +160,18 @@ void HandleN2kWindSpeed(const tN2kMsg &N2kMsg) {
         broadcastNMEA0183(mwv);
       }
     }
+    return true;
   }
+  return false;
 }
 
-void HandleN2kWaterDepth(const tN2kMsg &N2kMsg) {
+bool HandleN2kWaterDepth(const tN2kMsg &N2kMsg) {
   unsigned char SID;
   double DepthBelowTransducer, Offset, Range;
 
   if (ParseN2kPGN128267(N2kMsg, SID, DepthBelowTransducer, Offset, Range)) {
     if (!N2kIsNA(DepthBelowTransducer)) {
-      setPathValue("environment.depth.belowTransducer", DepthBelowTransducer, "nmea2000.can", "m", "Depth below transducer");
+      setPathValue(idDepthBelowTransducer, DepthBelowTransducer, sourceId);
       updateDepthAlarm(DepthBelowTransducer);
       Serial.printf("N2K Depth: %.1f m\n", DepthBelowTransducer);
 
@@ -158,17 +185,19 @@ void HandleN2kWaterDepth(const tN2kMsg &N2kMsg) {
         broadcastNMEA0183(dpt);
       }
     }
+    return true;
   }
+  return false;
 }
 
-void HandleN2kOutsideEnvironment(const tN2kMsg &N2kMsg) {
+bool HandleN2kOutsideEnvironment(const tN2kMsg &N2kMsg) {
   unsigned char SID;
   double WaterTemperature, OutsideAmbientAirTemperature, AtmosphericPressure;
 
   if (ParseN2kPGN130310(N2kMsg, SID, WaterTemperature, OutsideAmbientAirTemperature, AtmosphericPressure)) {
     if (!N2kIsNA(WaterTemperature)) {
       double tempC = KelvinToC(WaterTemperature);
-      setPathValue("environment.water.temperature", WaterTemperature, "nmea2000.can", "K", "Water temperature");
+      setPathValue(idWaterTemperature, WaterTemperature, sourceId);
       Serial.printf("N2K Water Temp: %.1f°C\n", tempC);
 
       // Broadcast NMEA 0183 MTW sentence via TCP
@@ -181,34 +210,90 @@ void HandleN2kOutsideEnvironment(const tN2kMsg &N2kMsg) {
       }
     }
     if (!N2kIsNA(OutsideAmbientAirTemperature)) {
-      setPathValue("environment.outside.temperature", OutsideAmbientAirTemperature, "nmea2000.can", "K", "Outside air temperature");
+      setPathValue(idOutsideTemperature, OutsideAmbientAirTemperature, sourceId);
     }
     if (!N2kIsNA(AtmosphericPressure)) {
-      setPathValue("environment.outside.pressure", AtmosphericPressure, "nmea2000.can", "Pa", "Atmospheric pressure");
+      setPathValue(idOutsidePressure, AtmosphericPressure, sourceId);
     }
+    return true;
   }
+  return false;
 }
  
-// Central dispatcher for the general SetMsgHandler callback.
-static void HandleN2kMessage(const tN2kMsg &N2kMsg) {
-  switch (N2kMsg.PGN) {
-    case 129025UL:
-      HandleN2kPosition(N2kMsg);
-      break;
-    case 129026UL:
-      HandleN2kCOGSOG(N2kMsg);
-      break;
-    case 130306UL:
-      HandleN2kWindSpeed(N2kMsg);
-      break;
-    case 128267UL:
-      HandleN2kWaterDepth(N2kMsg);
-      break;
-    case 130310UL:
-      HandleN2kOutsideEnvironment(N2kMsg);
-      break;
-    default:
-      break;
+bool HandleN2kAttitude(const tN2kMsg &N2kMsg) {
+  unsigned char SID;
+  double Yaw, Pitch, Roll;
+
+  if (ParseN2kPGN127257(N2kMsg, SID, Yaw, Pitch, Roll)) {
+    if (N2kIsNA(Roll) || N2kIsNA(Pitch)) return true;
+    setPathComposite(idAttitude, PV_ATTITUDE, Roll, Pitch, N2kIsNA(Yaw) ? NAN : Yaw, sourceId);
+    return true;
+  }
+  return false;
+}
+
+// Handlers by PGN, in dispatch order
+struct N2kPgnHandler {
+  uint32_t pgn;
+  bool (*handle)(const tN2kMsg &N2kMsg);
+};
+
+static const N2kPgnHandler pgnHandlers[] = {
+  {129025UL, HandleN2kPosition},
+  {129026UL, HandleN2kCOGSOG},
+  {130306UL, HandleN2kWindSpeed},
+  {128267UL, HandleN2kWaterDepth},
+  {130310UL, HandleN2kOutsideEnvironment},
+  {127257UL, HandleN2kAttitude},
+};
+static const size_t PGN_HANDLER_COUNT = sizeof(pgnHandlers) / sizeof(pgnHandlers[0]);
+
+// Messages per handler; the extra slot counts PGNs without one
+static std::atomic<uint32_t> pgnReceived[PGN_HANDLER_COUNT + 1];
+static std::atomic<uint32_t> pgnParseErrors[PGN_HANDLER_COUNT];
+
+// Central dispatcher for received (and replayed) messages.
+bool HandleN2kMessage(const tN2kMsg &N2kMsg) {
+  for (size_t i = 0; i < PGN_HANDLER_COUNT; i++) {
+    if (pgnHandlers[i].pgn == N2kMsg.PGN) {
+      pgnReceived[i].fetch_add(1, std::memory_order_relaxed);
+      if (pgnHandlers[i].handle(N2kMsg)) {
+        return true;
+      }
+      pgnParseErrors[i].fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  pgnReceived[PGN_HANDLER_COUNT].fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+std::vector<N2kPgnStats> getN2kPgnStats() {
+  std::vector<N2kPgnStats> stats;
+  stats.reserve(PGN_HANDLER_COUNT + 1);
+  for (size_t i = 0; i <= PGN_HANDLER_COUNT; i++) {
+    N2kPgnStats s;
+    s.pgn = i < PGN_HANDLER_COUNT ? pgnHandlers[i].pgn : 0;
+    s.received = pgnReceived[i].load(std::memory_order_relaxed);
+    s.parseErrors = i < PGN_HANDLER_COUNT ? pgnParseErrors[i].load(std::memory_order_relaxed) : 0;
+    stats.push_back(s);
+  }
+  return stats;
+}
+
+// Handler registered with the library: counts and records the message,
+// then dispatches it
+static void onN2kMessage(const tN2kMsg &N2kMsg) {
+  countInput(INPUT_PORT_N2K, INPUT_SENTENCES);
+  countInput(INPUT_PORT_N2K, INPUT_BYTES, N2kMsg.DataLen);
+  if (isInputRecording()) {
+    uint8_t payload[INPUT_LOG_MAX_PAYLOAD];
+    size_t len = encodeN2kPayload(payload, N2kMsg.PGN, N2kMsg.Priority, N2kMsg.Source,
+                                  N2kMsg.Destination, N2kMsg.Data, N2kMsg.DataLen);
+    recordInput(INPUT_PORT_N2K, 0, payload, len);
+  }
+  if (!HandleN2kMessage(N2kMsg)) {
+    countInput(INPUT_PORT_N2K, INPUT_PARSE_ERRORS);
   }
 }
 
@@ -239,8 +324,11 @@ void initNMEA2000() {
   );
   Serial.println("Device info set");
 
+  // Resolve SignalK path IDs before any message can arrive
+  registerN2kPaths();
+
   // Single dispatcher registered with the library
-  NMEA2000.SetMsgHandler(HandleN2kMessage);
+  NMEA2000.SetMsgHandler(onN2kMessage);
   Serial.println("Message handler registered");
 
   // Enable forward mode to see ALL raw NMEA2000 messages on Serial
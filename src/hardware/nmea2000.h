@@ -6,6 +6,7 @@
 // Forward declaration for use in this header
 class tN2kMsg;
 #include <N2kMessages.h>
+#include <vector>
 
 /**
  * NMEA 2000 (CAN Bus) Module
@@ -19,40 +20,77 @@ class tN2kMsg;
  * Updates latitude and longitude information
  *
  * @param N2kMsg Reference to the NMEA 2000 message
+ * @return false if the message could not be parsed
  */
-void HandleN2kPosition(const tN2kMsg &N2kMsg);
+bool HandleN2kPosition(const tN2kMsg &N2kMsg);
 
 /**
  * Handles NMEA 2000 Course Over Ground and Speed Over Ground (PGN 129026)
  * Updates COG and SOG navigation data
  *
  * @param N2kMsg Reference to the NMEA 2000 message
+ * @return false if the message could not be parsed
  */
-void HandleN2kCOGSOG(const tN2kMsg &N2kMsg);
+bool HandleN2kCOGSOG(const tN2kMsg &N2kMsg);
 
 /**
  * Handles NMEA 2000 Wind Speed and Angle (PGN 130306)
  * Updates wind speed and direction data
  *
  * @param N2kMsg Reference to the NMEA 2000 message
+ * @return false if the message could not be parsed
  */
-void HandleN2kWindSpeed(const tN2kMsg &N2kMsg);
+bool HandleN2kWindSpeed(const tN2kMsg &N2kMsg);
 
 /**
  * Handles NMEA 2000 Water Depth (PGN 128267)
  * Updates water depth below transducer
  *
  * @param N2kMsg Reference to the NMEA 2000 message
+ * @return false if the message could not be parsed
  */
-void HandleN2kWaterDepth(const tN2kMsg &N2kMsg);
+bool HandleN2kWaterDepth(const tN2kMsg &N2kMsg);
 
 /**
  * Handles NMEA 2000 Outside Environment (PGN 130310)
  * Updates water temperature, air temperature, and atmospheric pressure
  *
  * @param N2kMsg Reference to the NMEA 2000 message
+ * @return false if the message could not be parsed
  */
-void HandleN2kOutsideEnvironment(const tN2kMsg &N2kMsg);
+bool HandleN2kOutsideEnvironment(const tN2kMsg &N2kMsg);
+
+/**
+ * Handles NMEA 2000 Attitude (PGN 127257)
+ * Updates vessel roll, pitch and yaw
+ *
+ * @param N2kMsg Reference to the NMEA 2000 message
+ * @return false if the message could not be parsed
+ */
+bool HandleN2kAttitude(const tN2kMsg &N2kMsg);
+
+/**
+ * Dispatches a message to the handler for its PGN
+ * Called for every message the library receives; also fed by the input
+ * replay. Counts the message per PGN (see getN2kPgnStats()).
+ *
+ * @param N2kMsg Reference to the NMEA 2000 message
+ * @return false if a handler could not parse the message
+ */
+bool HandleN2kMessage(const tN2kMsg &N2kMsg);
+
+// Counters of one PGN since boot
+struct N2kPgnStats {
+  uint32_t pgn;          // 0 for PGNs without a handler
+  uint32_t received;
+  uint32_t parseErrors;
+};
+
+/**
+ * Counters of every handled PGN, followed by one entry (PGN 0) for all
+ * messages without a handler
+ */
+std::vector<N2kPgnStats> getN2kPgnStats();
 
 /**
  * Initializes the NMEA 2000 (CAN bus) interface
@@ -1,6 +1,9 @@
 #include "seatalk1.h"
 #include "../signalk/data_store.h"
 #include "../config.h"
+#include "../services/input_recorder.h"
+#include "../utils/input_stats.h"
+#include <atomic>
 
 #ifdef SEATALK1_USE_SOFTSERIAL
   #include <SoftwareSerial.h>
@@ -20,10 +23,22 @@ static uint8_t expectedLength = 0;
 static bool inMessage = false;
 static unsigned long lastByteTime = 0;
 
-// Statistics
-static uint32_t messagesReceived = 0;
-static uint32_t messagesDecoded = 0;
-static uint32_t parityErrors = 0;
+// Source ID for all Seatalk 1 data
+static SourceId sourceId = INVALID_SOURCE_ID;
+
+// SignalK path IDs, resolved once in initSeatalk1()
+static PathId idDepthBelowTransducer = INVALID_PATH_ID;
+static PathId idWindAngleApparent = INVALID_PATH_ID;
+static PathId idWindSpeedApparent = INVALID_PATH_ID;
+static PathId idSpeedThroughWater = INVALID_PATH_ID;
+static PathId idWaterTemperature = INVALID_PATH_ID;
+static PathId idHeadingMagnetic = INVALID_PATH_ID;
+static PathId idAutopilotTargetHeading = INVALID_PATH_ID;
+
+// Statistics (written by the ingest task, read by the metrics endpoint)
+static std::atomic<uint32_t> messagesReceived(0);
+static std::atomic<uint32_t> messagesDecoded(0);
+static std::atomic<uint32_t> parityErrors(0);
 
 /**
  * Initialize Seatalk 1 interface
@@ -31,6 +46,16 @@ static uint32_t parityErrors = 0;
 bool initSeatalk1(uint8_t rxPin) {
   Serial.println("\n=== Initializing Seatalk 1 ===");
 
+  // Resolve SignalK path IDs before any datagram is decoded
+  sourceId = registerSource("seatalk1");
+  idDepthBelowTransducer = registerPath("environment.depth.belowTransducer", "m", "Depth below transducer");
+  idWindAngleApparent = registerPath("environment.wind.angleApparent", "rad", "Apparent wind angle");
+  idWindSpeedApparent = registerPath("environment.wind.speedApparent", "m/s", "Apparent wind speed");
+  idSpeedThroughWater = registerPath("navigation.speedThroughWater", "m/s", "Speed through water");
+  idWaterTemperature = registerPath("environment.water.temperature", "K", "Water temperature");
+  idHeadingMagnetic = registerPath("navigation.headingMagnetic", "rad", "Magnetic heading");
+  idAutopilotTargetHeading = registerPath("steering.autopilot.target.headingMagnetic", "rad", "Autopilot target heading (magnetic)");
+
 #ifdef SEATALK1_USE_SOFTSERIAL
   // Use SoftwareSerial - no hardware serial conflicts!
   Serial.println("Mode: SoftwareSerial (no RS485/GPS conflicts)");
@@ -93,11 +118,18 @@ bool processSeatalk1() {
     if (debugEnabled) {
       Serial.println("Seatalk: Message timeout, resetting");
     }
+    countInput(INPUT_PORT_SEATALK, INPUT_PARSE_ERRORS);
     inMessage = false;
     msgIndex = 0;
     expectedLength = 0;
   }
 
+#ifdef SEATALK1_USE_SOFTSERIAL
+  if (seatalkSerial->overflow()) {
+    countInput(INPUT_PORT_SEATALK, INPUT_OVERFLOWS);
+  }
+#endif
+
   while (seatalkSerial->available()) {
     // Check for parity/framing errors (indicates command byte)
     bool isCommandByte = false;
@@ -108,6 +140,7 @@ bool processSeatalk1() {
 
     uint8_t byte = seatalkSerial->read();
     lastByteTime = now;
+    countInput(INPUT_PORT_SEATALK, INPUT_BYTES);
 
     // Simple heuristic: After a gap or at start, assume command byte
     if (!inMessage || (now - lastByteTime > 50)) {
@@ -142,18 +175,10 @@ bool processSeatalk1() {
         // Check if we have complete message
         if (expectedLength > 0 && msgIndex >= expectedLength) {
           // Process complete message
-          SeatalkMessage msg;
-          msg.command = msgBuffer[0];
-          msg.attribute = msgBuffer[1];
-          msg.length = msgIndex;
-          msg.valid = true;
-
-          for (uint8_t i = 2; i < msgIndex && i < 18; i++) {
-            msg.data[i - 2] = msgBuffer[i];
-          }
-
-          messagesReceived++;
-          decodeSeatalkMessage(msg);
+          messagesReceived.fetch_add(1, std::memory_order_relaxed);
+          countInput(INPUT_PORT_SEATALK, INPUT_SENTENCES);
+          recordInput(INPUT_PORT_SEATALK, 0, msgBuffer, msgIndex);
+          decodeSeatalkMessage(makeSeatalkMessage(msgBuffer, msgIndex));
           messageProcessed = true;
 
           // Reset for next message
@@ -166,6 +191,7 @@ bool processSeatalk1() {
         if (debugEnabled) {
           Serial.println("Seatalk: Buffer overflow");
         }
+        countInput(INPUT_PORT_SEATALK, INPUT_OVERFLOWS);
         inMessage = false;
         msgIndex = 0;
         expectedLength = 0;
@@ -176,6 +202,26 @@ bool processSeatalk1() {
   return messageProcessed;
 }
 
+// Compass heading as encoded in datagrams 84 and 9C: (U & 3) * 90 + (VW & 0x3F) * 2,
+// plus 1 or 2 degrees from the two high bits of U
+static float seatalkHeading(uint8_t u, uint8_t vw) {
+  uint8_t odd = u & 0x0C;
+  return (u & 0x03) * 90 + (vw & 0x3F) * 2 + (odd ? (odd == 0x0C ? 2 : 1) : 0);
+}
+
+SeatalkMessage makeSeatalkMessage(const uint8_t* bytes, uint8_t len) {
+  SeatalkMessage msg = {};
+  msg.command = bytes[0];
+  msg.attribute = bytes[1];
+  msg.length = len;
+  msg.valid = true;
+
+  for (uint8_t i = 2; i < len && i < SEATALK_MAX_MSG_LEN; i++) {
+    msg.data[i - 2] = bytes[i];
+  }
+  return msg;
+}
+
 /**
  * Decode Seatalk message and update SignalK data
  */
@@ -191,18 +237,17 @@ void decodeSeatalkMessage(const SeatalkMessage& msg) {
     Serial.println();
   }
 
-  messagesDecoded++;
+  messagesDecoded.fetch_add(1, std::memory_order_relaxed);
 
   switch (msg.command) {
     case ST_DEPTH_BELOW_TRANSDUCER: {  // 00 02 YZ XX XX
       if (msg.length >= 5) {
-        // Depth in feet = (XX XX + YZ*256) / 10
+        // Depth in feet = XXXX / 10 (LSB first); YZ holds alarm and unit flags
         uint16_t depthRaw = msg.data[1] | (msg.data[2] << 8);
-        uint8_t yz = msg.attribute;
-        float depthFeet = (depthRaw + (yz & 0x0F) * 256) / 10.0;
+        float depthFeet = depthRaw / 10.0;
         float depthMeters = depthFeet * 0.3048;  // Convert feet to meters
 
-        setPathValue("environment.depth.belowTransducer", depthMeters, "seatalk1");
+        setPathValue(idDepthBelowTransducer, depthMeters, sourceId);
 
         if (debugEnabled) {
           Serial.printf("Depth: %.2f m (%.1f ft)\n", depthMeters, depthFeet);
@@ -213,23 +258,20 @@ void decodeSeatalkMessage(const SeatalkMessage& msg) {
 
     case ST_APPARENT_WIND_ANGLE: {  // 10 01 XX YY
       if (msg.length >= 4) {
-        // Wind angle in degrees = XX * 2
-        // YY bits indicate port/starboard
-        uint8_t angleRaw = msg.data[0];
-        uint8_t direction = msg.data[1];
-
-        float angle = angleRaw * 2.0;
-        if (direction & 0x80) {
-          angle = 360.0 - angle;  // Port side
+        // Wind angle in degrees right of bow = XXYY / 2 (MSB first)
+        uint16_t angleRaw = (msg.data[0] << 8) | msg.data[1];
+        float angle = angleRaw / 2.0;
+        if (angle > 180.0) {
+          angle -= 360.0;  // Port side is negative in SignalK
         }
 
         // Convert to radians for SignalK
         float angleRad = angle * PI / 180.0;
-        setPathValue("environment.wind.angleApparent", angleRad, "seatalk1");
+        setPathValue(idWindAngleApparent, angleRad, sourceId);
 
         if (debugEnabled) {
           Serial.printf("Apparent Wind Angle: %.1f° (%s)\n",
-                       angle, (direction & 0x80) ? "Port" : "Starboard");
+                       angle, angle < 0 ? "Port" : "Starboard");
         }
       }
       break;
@@ -237,14 +279,14 @@ void decodeSeatalkMessage(const SeatalkMessage& msg) {
 
     case ST_APPARENT_WIND_SPEED: {  // 11 01 XX 0Y
       if (msg.length >= 4) {
-        // Wind speed in knots = XX + Y/10
-        uint8_t knots = msg.data[0];
+        // Wind speed in knots = (XX & 0x7F) + Y/10; XX bit 7 only selects display units
+        uint8_t knots = msg.data[0] & 0x7F;
         uint8_t decimal = msg.data[1] & 0x0F;
 
         float speedKnots = knots + decimal / 10.0;
         float speedMs = speedKnots * 0.514444;  // Convert knots to m/s
 
-        setPathValue("environment.wind.speedApparent", speedMs, "seatalk1");
+        setPathValue(idWindSpeedApparent, speedMs, sourceId);
 
         if (debugEnabled) {
           Serial.printf("Apparent Wind Speed: %.1f kn (%.2f m/s)\n", speedKnots, speedMs);
@@ -260,7 +302,7 @@ void decodeSeatalkMessage(const SeatalkMessage& msg) {
         float speedKnots = speedRaw / 10.0;
         float speedMs = speedKnots * 0.514444;  // Convert to m/s
 
-        setPathValue("navigation.speedThroughWater", speedMs, "seatalk1");
+        setPathValue(idSpeedThroughWater, speedMs, sourceId);
 
         if (debugEnabled) {
           Serial.printf("Speed Through Water: %.1f kn (%.2f m/s)\n", speedKnots, speedMs);
@@ -271,12 +313,28 @@ void decodeSeatalkMessage(const SeatalkMessage& msg) {
 
     case ST_WATER_TEMPERATURE: {  // 23 Z1 XX YY
       if (msg.length >= 4) {
-        // Temperature in Celsius = (XX YY - 100) / 10
-        uint16_t tempRaw = msg.data[0] | ((msg.data[1] & 0x0F) << 8);
+        // XX in whole degrees Celsius (YY is the same in Fahrenheit); Z & 4 = sensor fault
+        if (msg.attribute & 0x40) break;
+        float tempC = (int8_t)msg.data[0];
+        float tempK = tempC + 273.15;  // Convert to Kelvin for SignalK
+
+        setPathValue(idWaterTemperature, tempK, sourceId);
+
+        if (debugEnabled) {
+          Serial.printf("Water Temperature: %.1f°C (%.1f K)\n", tempC, tempK);
+        }
+      }
+      break;
+    }
+
+    case ST_WATER_TEMP_2: {  // 27 01 XX XX
+      if (msg.length >= 4) {
+        // Temperature in Celsius = (XXXX - 100) / 10 (LSB first)
+        uint16_t tempRaw = msg.data[0] | (msg.data[1] << 8);
         float tempC = (tempRaw - 100) / 10.0;
         float tempK = tempC + 273.15;  // Convert to Kelvin for SignalK
 
-        setPathValue("environment.water.temperature", tempK, "seatalk1");
+        setPathValue(idWaterTemperature, tempK, sourceId);
 
         if (debugEnabled) {
           Serial.printf("Water Temperature: %.1f°C (%.1f K)\n", tempC, tempK);
@@ -285,15 +343,12 @@ void decodeSeatalkMessage(const SeatalkMessage& msg) {
       break;
     }
 
-    case ST_COMPASS_HEADING_MAG: {  // 9C U1 VW XY
+    case ST_COMPASS_HEADING_MAG: {  // 9C U1 VW RR
       if (msg.length >= 4) {
-        // Heading in degrees = (VW + U*256) / 2
-        uint8_t u = msg.attribute & 0x0F;
-        uint16_t headingRaw = msg.data[0] | (u << 8);
-        float headingDeg = (headingRaw & 0x0FFF) / 2.0;
+        float headingDeg = seatalkHeading(msg.attribute >> 4, msg.data[0]);
         float headingRad = headingDeg * PI / 180.0;
 
-        setPathValue("navigation.headingMagnetic", headingRad, "seatalk1");
+        setPathValue(idHeadingMagnetic, headingRad, sourceId);
 
         if (debugEnabled) {
           Serial.printf("Magnetic Heading: %.1f° (%.3f rad)\n", headingDeg, headingRad);
@@ -302,15 +357,13 @@ void decodeSeatalkMessage(const SeatalkMessage& msg) {
       break;
     }
 
-    case ST_COMPASS_HEADING_AUTO: {  // 84 U6 VW XY Z0 0M
+    case ST_COMPASS_HEADING_AUTO: {  // 84 U6 VW XY 0Z 0M RR SS TT
       if (msg.length >= 6) {
-        // Autopilot course
-        uint8_t u = (msg.attribute >> 4) & 0x0F;
-        uint16_t courseRaw = msg.data[0] | ((u & 0x03) << 8);
-        float courseDeg = courseRaw / 2.0;
+        // Autopilot course in degrees = (two high bits of V) * 90 + XY / 2
+        float courseDeg = ((msg.data[0] >> 6) & 0x03) * 90 + msg.data[1] / 2.0;
         float courseRad = courseDeg * PI / 180.0;
 
-        setPathValue("steering.autopilot.target.headingMagnetic", courseRad, "seatalk1");
+        setPathValue(idAutopilotTargetHeading, courseRad, sourceId);
 
         if (debugEnabled) {
           Serial.printf("Autopilot Course: %.1f° (%.3f rad)\n", courseDeg, courseRad);
@@ -373,9 +426,20 @@ void setSeatalk1Debug(bool enable) {
 
   if (enable) {
     Serial.println("\n=== Seatalk Debug Enabled ===");
-    Serial.printf("Messages Received: %u\n", messagesReceived);
-    Serial.printf("Messages Decoded: %u\n", messagesDecoded);
-    Serial.printf("Parity Errors: %u\n", parityErrors);
+    Serial.printf("Messages Received: %u\n", (unsigned)messagesReceived);
+    Serial.printf("Messages Decoded: %u\n", (unsigned)messagesDecoded);
+    Serial.printf("Parity Errors: %u\n", (unsigned)parityErrors);
     Serial.println("============================\n");
   }
 }
+
+/**
+ * Get statistics
+ */
+SeatalkStats getSeatalk1Stats() {
+  SeatalkStats stats;
+  stats.messagesReceived = messagesReceived.load(std::memory_order_relaxed);
+  stats.messagesDecoded = messagesDecoded.load(std::memory_order_relaxed);
+  stats.parityErrors = parityErrors.load(std::memory_order_relaxed);
+  return stats;
+}
@@ -59,6 +59,14 @@ bool initSeatalk1(uint8_t rxPin);
  */
 bool processSeatalk1();
 
+/**
+ * Build a message from the raw bytes of a datagram
+ *
+ * @param bytes Command, attribute and data bytes
+ * @param len Number of bytes (2 to SEATALK_MAX_MSG_LEN)
+ */
+SeatalkMessage makeSeatalkMessage(const uint8_t* bytes, uint8_t len);
+
 /**
  * Decode a Seatalk message and update SignalK data store
  *
@@ -88,6 +96,21 @@ bool isSeatalk1Enabled();
  */
 void setSeatalk1Debug(bool enable);
 
+// Counters since boot
+struct SeatalkStats {
+  uint32_t messagesReceived;  // Complete datagrams read from the bus
+  uint32_t messagesDecoded;   // Datagrams decoded (including replayed ones)
+  uint32_t parityErrors;
+};
+
+/**
+ * Get Seatalk statistics
+ * Safe to call from any task.
+ *
+ * @return Counters since boot
+ */
+SeatalkStats getSeatalk1Stats();
+
 // Common Seatalk datagram types
 #define ST_DEPTH_BELOW_TRANSDUCER   0x00  // Depth below transducer
 #define ST_EQUIPMENT_ID            0x01  // Equipment ID
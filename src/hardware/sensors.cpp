@@ -1,5 +1,6 @@
 #include "sensors.h"
 #include <Wire.h>
+#include "../signalk/data_store.h"
 
 // External declarations for global variables and functions
 extern Adafruit_BME280 bme;
@@ -11,9 +12,13 @@ extern unsigned long lastSensorRead;
 #define I2C_SDA 21 // I2C Data
 #define I2C_SCL 22 // I2C Clock
 
-// Helper functions (declared in main)
-extern void setPathValue(const String& path, double value, const String& source,
-                        const String& unit, const String& description);
+// Source ID for BME280 readings
+static SourceId sourceId = INVALID_SOURCE_ID;
+
+// SignalK path IDs, resolved once in initI2CSensors()
+static PathId idInsideTemperature = INVALID_PATH_ID;
+static PathId idInsidePressure = INVALID_PATH_ID;
+static PathId idInsideHumidity = INVALID_PATH_ID;
 
 // ====== I2C SENSOR HANDLERS ======
 
@@ -21,6 +26,11 @@ void initI2CSensors() {
   Serial.println("Initializing I2C sensors...");
   Serial.println("I2C pins: SDA=21, SCL=22");
 
+  sourceId = registerSource("i2c.bme280");
+  idInsideTemperature = registerPath("environment.inside.temperature", "K", "Inside temperature");
+  idInsidePressure = registerPath("environment.inside.pressure", "Pa", "Inside pressure");
+  idInsideHumidity = registerPath("environment.inside.humidity", "", "Inside relative humidity");
+
   Wire.begin(I2C_SDA, I2C_SCL);
 
   // Try to initialize BME280
@@ -57,15 +67,15 @@ void readI2CSensors() {
 
   if (!isnan(temp)) {
     double tempK = temp + 273.15;
-    setPathValue("environment.inside.temperature", tempK, "i2c.bme280", "K", "Inside temperature");
+    setPathValue(idInsideTemperature, tempK, sourceId);
   }
 
   if (!isnan(pressure)) {
-    setPathValue("environment.inside.pressure", pressure, "i2c.bme280", "Pa", "Inside pressure");
+    setPathValue(idInsidePressure, (double)pressure, sourceId);
   }
 
   if (!isnan(humidity)) {
     double relativeHumidity = humidity / 100.0;
-    setPathValue("environment.inside.humidity", relativeHumidity, "i2c.bme280", "", "Inside relative humidity");
+    setPathValue(idInsideHumidity, relativeHumidity, sourceId);
   }
 }
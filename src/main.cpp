@@ -53,6 +53,7 @@
 #include "utils/time_utils.h"
 #include "utils/conversions.h"
 #include "utils/nmea0183_converter.h"
+#include "utils/line_assembler.h"
 
 // ====== SIGNALK DATA MODULES ======
 #include "signalk/globals.h"
@@ -65,6 +66,9 @@
 #include "services/websocket.h"
 #include "services/nmea0183_tcp.h"
 #include "services/dyndns.h"
+#include "services/ingest.h"
+#include "services/input_recorder.h"
+#include "services/input_replay.h"
 
 // ====== HARDWARE MODULES ======
 #include "hardware/nmea0183.h"
@@ -92,9 +96,7 @@ WiFiManager wm;
 std::map<uint32_t, ClientSubscription> clientSubscriptions;
 std::map<uint32_t, String> clientTokens;
 
-// SignalK data storage
-std::map<String, PathValue> dataStore;
-std::map<String, PathValue> lastSentValues;
+// SignalK data storage (path values live in signalk/data_store.cpp)
 std::map<String, String> notifications;
 
 // Vessel identification
@@ -125,31 +127,71 @@ int tcpServerPort = 10110;
 bool tcpEnabled = false;
 uint32_t lastTcpReconnect = 0;
 uint32_t tcpConnectedTime = 0;
-String tcpBuffer = "";
 TcpClientState tcpState = TCP_DISCONNECTED;
 
-// Central handler to keep NMEA inputs consistent across all sources
-void handleNmeaSentence(const String& sentence, const char* sourceTag) {
-  if (sentence.length() < 7 || sentence[0] != '$') {
+// Central handler to keep NMEA inputs consistent across all sources.
+// Sentences arriving on the loop task (TCP inputs) are handed to the ingest
+// task so that all parsing happens on one task.
+void handleNmeaSentence(const char* sentence, size_t len, InputPort port, const char* sourceTag) {
+  if (len < 7 || len > NMEA_MAX_SENTENCE_LENGTH || sentence[0] != '$') {
+    countInput(port, INPUT_PARSE_ERRORS);
+    return;
+  }
+
+  if (deferNmeaInput(sentence, len, port, sourceTag)) {
     return;
   }
 
   if (sourceTag != nullptr) {
-    Serial.printf("NMEA [%s]: %s\n", sourceTag, sentence.c_str());
+    Serial.printf("NMEA [%s]: %s\n", sourceTag, sentence);
   }
 
-  parseNMEASentence(sentence);
+  parseNMEASentence(sentence, len, port);
 
   // Re-broadcast to TCP clients so external tools see the same stream
-  String broadcastSentence = sentence;
-  broadcastSentence += "\r\n";
-  broadcastNMEA0183(broadcastSentence);
+  char broadcastSentence[NMEA_MAX_SENTENCE_LENGTH + 2];
+  memcpy(broadcastSentence, sentence, len);
+  broadcastSentence[len] = '\r';
+  broadcastSentence[len + 1] = '\n';
+  broadcastNMEA0183(broadcastSentence, len + 2);
+}
+
+// Line handler shared by the serial and TCP client inputs; context is the
+// tag to log sentences under (nullptr = don't log)
+static bool onInputSentence(const char* line, size_t len, LineAssembler& input, void* context) {
+  handleNmeaSentence(line, len, input.port(), (const char*)context);
+  return true;
+}
+
+// Line assemblers, one per input
+LineAssembler rs485Input("RS485", INPUT_PORT_RS485);
+LineAssembler gpsInput("GPS", INPUT_PORT_GPS);
+LineAssembler singleEndedInput("SingleEnded", INPUT_PORT_SINGLE_ENDED);
+LineAssembler tcpClientInput("TCP", INPUT_PORT_TCP_CLIENT);
+
+// Raw byte tap of the line assemblers; context is the InputPort
+static void onInputBytes(const uint8_t* data, size_t len, void* context) {
+  recordInput((InputPort)(uintptr_t)context, 0, data, len);
 }
 
-// Serial port buffers
-String gpsBuffer = "";
-String nmeaBuffer = "";
-String singleEndedBuffer = "";
+// Log bytes received every 10 s, or warn after 30 s of silence.
+// Returns true when the silence warning was printed.
+static bool reportInputActivity(LineAssembler& input, uint32_t now,
+                                uint32_t& lastReport, uint32_t& lastBytes) {
+  if (now - lastReport < 10000) {
+    return false;
+  }
+  lastReport = now;
+  uint32_t received = input.bytes() - lastBytes;
+  lastBytes = input.bytes();
+  if (received > 0) {
+    Serial.printf("\n[%s] Received %u bytes in last 10s (%u sentences, %u errors total)\n",
+                  input.sourceTag(), (unsigned)received,
+                  (unsigned)input.sentences(), (unsigned)input.errors());
+    return false;
+  }
+  return now - input.lastActivity() > 30000;
+}
 
 // GPS on SoftwareSerial (moved from UART2 to allow Single-Ended NMEA to use UART2)
 #include <SoftwareSerial.h>
@@ -171,6 +213,72 @@ Adafruit_BME280 bme;
 bool bmeEnabled = false;
 unsigned long lastSensorRead = 0;
 
+// ====== INPUT POLLING ======
+// Runs on the ingest task (core 0), see services/ingest.h. Everything the
+// parsers update is queued for the loop task; nothing here may block.
+static void pollInputs() {
+  uint32_t now = millis();
+
+  // Read NMEA sentences from Serial1 (RS485)
+  static uint32_t lastRS485Report = 0;
+  static uint32_t lastRS485Bytes = 0;
+
+  rs485Input.poll(Serial1, onInputSentence, (void*)"RS485");
+
+  // Report RS485 activity status every 10 seconds
+  if (reportInputActivity(rs485Input, now, lastRS485Report, lastRS485Bytes)) {
+    Serial.println("\n[RS485 Status] ⚠️ NO DATA for 30+ seconds");
+    Serial.println("  Check: Wiring, Baud rate, Depth sounder power");
+  }
+
+  // Read GPS data from SoftwareSerial
+  // NOTE: GPS now uses SoftwareSerial (UART2 reserved for Single-Ended NMEA)
+  static uint32_t lastGPSReport = 0;
+  static uint32_t lastGPSBytes = 0;
+
+  gpsInput.poll(gpsSerial, onInputSentence, (void*)"GPS");  // GPS modules send NMEA 0183
+  if (gpsSerial.overflow()) {
+    countInput(INPUT_PORT_GPS, INPUT_OVERFLOWS);  // Bytes lost before they could be read
+  }
+
+  // Report GPS activity status every 10 seconds
+  if (reportInputActivity(gpsInput, now, lastGPSReport, lastGPSBytes)) {
+    Serial.println("\n[GPS] ⚠️ NO DATA for 30+ seconds");
+    Serial.println("  Check: GPS wiring (TX→GPIO25), baud rate (9600), satellite fix");
+  }
+
+  // Read Single-Ended NMEA data (Direct NMEA 0183 - not RS485)
+  // Hardware UART handles inversion automatically - no software processing needed!
+  #ifdef USE_SINGLEENDED_NMEA
+    static uint32_t lastSingleEndedReport = 0;
+    static uint32_t lastSingleEndedBytes = 0;
+
+    singleEndedInput.poll(SingleEndedSerial, onInputSentence, (void*)"SingleEnded");
+
+    // Report Single-Ended NMEA activity status every 10 seconds
+    if (reportInputActivity(singleEndedInput, now, lastSingleEndedReport, lastSingleEndedBytes)) {
+      Serial.println("\n[Single-Ended NMEA] ⚠️ NO DATA for 30+ seconds");
+      Serial.println("  Check: Voltage divider/optocoupler wiring, device power, baud rate");
+      Serial.println("  If using optocoupler: signal may be inverted (need hardware inverter)");
+    }
+  #endif
+
+  // Process NMEA2000 CAN messages
+  if (n2kEnabled) {
+    NMEA2000.ParseMessages();
+  }
+
+  // Process Seatalk 1 data (if enabled)
+  #ifdef USE_SEATALK1
+    if (isSeatalk1Enabled()) {
+      processSeatalk1();
+    }
+  #endif
+
+  // Feed a recorded log back through the same parsers (when requested)
+  pollInputReplay();
+}
+
 // ====== TCP CLIENT HELPER FUNCTIONS ======
 // These functions manage the TCP client connection to external SignalK servers
 
@@ -216,7 +324,7 @@ void connectToTcpServer() {
     if (tcpClient.connect(serverIP, tcpServerPort, 5000)) { // 5 second timeout
       Serial.println("TCP: Connected successfully!");
       Serial.println("Remote IP: " + tcpClient.remoteIP().toString());
-      tcpBuffer = "";
+      tcpClientInput.reset();
       tcpConnectedTime = millis();
       tcpState = TCP_CONNECTED;
     } else {
@@ -240,37 +348,12 @@ void processTcpData() {
   }
 
   // Read available data - process NMEA sentences from TCP
-  while (tcpClient.available()) {
-    char c = tcpClient.read();
-
-    // NMEA sentences end with newline
-      if (c == '\n' || c == '\r') {
-        if (tcpBuffer.length() > 0) {
-          if (tcpBuffer[0] == '$') {
-            // This is an NMEA sentence - parse it
-            handleNmeaSentence(tcpBuffer, nullptr);
-          } else {
-            // Non-NMEA data - just log it for debugging
-            Serial.println("TCP Data (non-NMEA): " + tcpBuffer);
-          }
-        }
-      tcpBuffer = "";
-    } else if (c >= 32 && c <= 126) {
-      // Only accept printable ASCII characters
-      if (tcpBuffer.length() < 120) { // NMEA max length is typically 82 chars
-        tcpBuffer += c;
-      } else {
-        // Buffer overflow protection - reset
-        tcpBuffer = "";
-        Serial.println("TCP: Buffer overflow, resetting");
-      }
-    }
-  }
+  tcpClientInput.poll(tcpClient, onInputSentence);
 
   // Check if connection is still alive
   if (!tcpClient.connected()) {
     Serial.println("TCP: Connection lost");
-    tcpBuffer = "";
+    tcpClientInput.reset();
     tcpState = TCP_DISCONNECTED;
   }
 }
@@ -293,6 +376,9 @@ void setup() {
   Serial.println("Firmware compiled with NMEA TCP server support");
   Serial.println("Ready to receive NMEA data on port 10110\n");
 
+  // loop() runs on this task and is the only writer of the data store
+  setDataStoreWriter();
+
   // Initialize LED status indicators first
   Serial.println("Initializing LED status indicators...");
   initLEDs();
@@ -300,6 +386,16 @@ void setup() {
   // Early debug output to verify we're running
   Serial.println("Setup starting...");
 
+  // Intern the NMEA 0183 SignalK paths before any serial input is opened
+  initNMEA0183Paths();
+
+  // Every input can be recorded; see services/input_recorder.h
+  initInputRecorder();
+  rs485Input.setTap(onInputBytes, (void*)INPUT_PORT_RS485);
+  gpsInput.setTap(onInputBytes, (void*)INPUT_PORT_GPS);
+  singleEndedInput.setTap(onInputBytes, (void*)INPUT_PORT_SINGLE_ENDED);
+  tcpClientInput.setTap(onInputBytes, (void*)INPUT_PORT_TCP_CLIENT);
+
   // Test basic functionality first
   Serial.println("Testing basic operations...");
   String test = "test";
@@ -313,6 +409,7 @@ void setup() {
   // Load Expo push tokens from flash
   Serial.println("Loading Expo push tokens...");
   loadExpoTokens();
+  initExpoPush();
 
   // Load or generate vessel UUID
   Serial.println("Loading preferences...");
@@ -592,7 +689,7 @@ void setup() {
 
   // WebSocket setup
   Serial.println("Setting up WebSocket...");
-  ws.onEvent(onWebSocketEvent);
+  initWebSocket();
   server.addHandler(&ws);
   Serial.println("WebSocket setup complete");
 
@@ -708,6 +805,9 @@ void setup() {
   Serial.println("Pass: " + String(AP_PASSWORD));
   Serial.println("==========================\n");
 
+  // Serial, CAN and Seatalk parsing moves off the loop task from here on
+  startIngestTask(pollInputs);
+
   Serial.println("\n=== System Ready ===\n");
 }
 
@@ -720,8 +820,11 @@ uint32_t lastWifiReconnect = 0;
 uint32_t lastSessionCleanup = 0;
 bool wasWifiConnected = false;
 int wifiReconnectAttempts = 0;
+TaskLoadMeter loopLoad;
 
 void loop() {
+  loopLoad.begin();
+
   // Process WiFiManager (non-blocking)
   wm.process();
 
@@ -788,145 +891,22 @@ void loop() {
     Serial.println("====================\n");
   }
 
-  // Read NMEA sentences from Serial1 (RS485)
-  static unsigned long lastRS485Activity = 0;
-  static unsigned long lastRS485Report = 0;
-  static int rs485BytesReceived = 0;
-
-  while (Serial1.available()) {
-    char c = Serial1.read();
-    lastRS485Activity = now;
-    rs485BytesReceived++;
-
-      if (c == '\n' || c == '\r') {
-        if (nmeaBuffer.length() > 6 && nmeaBuffer[0] == '$') {
-          Serial.printf("RS485 RX: %s\n", nmeaBuffer.c_str());
-          handleNmeaSentence(nmeaBuffer, "RS485");
-        } else if (nmeaBuffer.length() > 0) {
-          // Debug: Show what we received even if it's not valid NMEA
-          Serial.printf("RS485 Invalid: [%s] (len=%d)\n", nmeaBuffer.c_str(), nmeaBuffer.length());
-        }
-        nmeaBuffer = "";
-    } else if (c >= 32 && c <= 126) {
-      if (nmeaBuffer.length() < 120) {
-        nmeaBuffer += c;
-      }
-    } else {
-      // Debug: Show ALL non-printable characters with their hex value
-      Serial.printf("RS485: Non-printable 0x%02X ('%c')\n", (uint8_t)c, (c >= 32 && c <= 126) ? c : '?');
-    }
-  }
+  // Serial, CAN and Seatalk inputs are polled by the ingest task; apply
+  // what it parsed and send its NMEA 0183 output from here (core 1)
+  processIngestQueues();
 
-  // Report RS485 activity status every 10 seconds
-  if (now - lastRS485Report >= 10000) {
-    lastRS485Report = now;
-    if (rs485BytesReceived > 0) {
-      Serial.printf("\n[RS485 Status] Received %d bytes in last 10s\n", rs485BytesReceived);
-      rs485BytesReceived = 0;
-    } else if (now - lastRS485Activity > 30000) {
-      // No activity for 30 seconds
-      Serial.println("\n[RS485 Status] ⚠️ NO DATA for 30+ seconds");
-      Serial.println("  Check: Wiring, Baud rate, Depth sounder power");
-    }
-  }
+  // Write out recorded input (SPIFFS or TCP sink)
+  processInputRecorder();
 
-  // Read GPS data from SoftwareSerial
-  // NOTE: GPS now uses SoftwareSerial (UART2 reserved for Single-Ended NMEA)
-  static unsigned long lastGPSActivity = 0;
-  static unsigned long lastGPSReport = 0;
-  static int gpsBytesReceived = 0;
-
-  while (gpsSerial.available()) {
-    char c = gpsSerial.read();
-    lastGPSActivity = now;
-    gpsBytesReceived++;
-
-      if (c == '\n' || c == '\r') {
-        if (gpsBuffer.length() > 6 && gpsBuffer[0] == '$') {
-          Serial.printf("GPS RX: %s\n", gpsBuffer.c_str());
-          handleNmeaSentence(gpsBuffer, nullptr);  // GPS modules send NMEA 0183
-        }
-        gpsBuffer = "";
-    } else if (c >= 32 && c <= 126) {
-      if (gpsBuffer.length() < 120) {
-        gpsBuffer += c;
-      }
-    }
-  }
+  // Apply updates received by the web server (WebSocket deltas, HTTP PUT)
+  processDeferredStoreWrites();
 
-  // Report GPS activity status every 10 seconds
-  if (now - lastGPSReport >= 10000) {
-    lastGPSReport = now;
-    if (gpsBytesReceived > 0) {
-      Serial.printf("\n[GPS] Received %d bytes in last 10s\n", gpsBytesReceived);
-      gpsBytesReceived = 0;
-    } else if (now - lastGPSActivity > 30000) {
-      Serial.println("\n[GPS] ⚠️ NO DATA for 30+ seconds");
-      Serial.println("  Check: GPS wiring (TX→GPIO25), baud rate (9600), satellite fix");
-    }
-  }
-
-  // Read Single-Ended NMEA data (Direct NMEA 0183 - not RS485)
-  #ifdef USE_SINGLEENDED_NMEA
-    static unsigned long lastSingleEndedActivity = 0;
-    static unsigned long lastSingleEndedReport = 0;
-    static int singleEndedBytesReceived = 0;
-    static bool debugRawBytes = true;  // Set to true to debug inverted signal issues
-
-    while (SingleEndedSerial.available()) {
-      char c = SingleEndedSerial.read();
-      lastSingleEndedActivity = now;
-      singleEndedBytesReceived++;
-
-      // Hardware UART handles inversion automatically - no software processing needed!
-
-      // Debug: Print first 20 raw bytes to verify correct reception
-      if (debugRawBytes && singleEndedBytesReceived <= 20) {
-        Serial.printf("Raw byte: 0x%02X ('%c') [hw-inverted]\n", (unsigned char)c, (c >= 32 && c <= 126) ? c : '.');
-      }
-
-      if (c == '\n' || c == '\r') {
-        if (singleEndedBuffer.length() > 6 && singleEndedBuffer[0] == '$') {
-          Serial.printf("Single-Ended RX: %s\n", singleEndedBuffer.c_str());
-          handleNmeaSentence(singleEndedBuffer, "SingleEnded");
-        }
-        singleEndedBuffer = "";
-      } else if (c >= 32 && c <= 126) {
-        if (singleEndedBuffer.length() < 120) {
-          singleEndedBuffer += c;
-        }
-      }
-    }
-
-    // Report Single-Ended NMEA activity status every 10 seconds
-    if (now - lastSingleEndedReport >= 10000) {
-      lastSingleEndedReport = now;
-      if (singleEndedBytesReceived > 0) {
-        Serial.printf("\n[Single-Ended NMEA] Received %d bytes in last 10s\n", singleEndedBytesReceived);
-        singleEndedBytesReceived = 0;
-      } else if (now - lastSingleEndedActivity > 30000) {
-        Serial.println("\n[Single-Ended NMEA] ⚠️ NO DATA for 30+ seconds");
-        Serial.println("  Check: Voltage divider/optocoupler wiring, device power, baud rate");
-        Serial.println("  If using optocoupler: signal may be inverted (need hardware inverter)");
-      }
-    }
-  #endif
-
-  // Process NMEA2000 CAN messages
-  if (n2kEnabled) {
-    NMEA2000.ParseMessages();
-  }
+  // Apply WebSocket subscribe/unsubscribe/disconnect requests
+  processWebSocketRequests();
 
   // Read I2C sensors
   readI2CSensors();
 
-  // Process Seatalk 1 data (if enabled)
-  #ifdef USE_SEATALK1
-    if (isSeatalk1Enabled()) {
-      processSeatalk1();
-    }
-  #endif
-
   // Flush anchor persistence (ensures NVS writes happen on main task)
   flushAnchorPersist();
 
@@ -963,7 +943,7 @@ void loop() {
 
       String heartbeatMsg;
       serializeJson(heartbeat, heartbeatMsg);
-      ws.textAll(heartbeatMsg);
+      broadcastText(heartbeatMsg);
     }
   }
 
@@ -979,5 +959,6 @@ void loop() {
     cleanupWebSessions();
   }
 
+  loopLoad.end();
   delay(1);
 }
@@ -0,0 +1,43 @@
+// Stand-ins for the firmware globals and hooks that main.cpp, alarms.cpp
+// and ingest.cpp provide on the ESP32. Only compiled by [env:native], whose
+// build_src_filter takes the portable parsing, conversion and data store
+// sources without those modules.
+#ifdef SIGNALK_NATIVE
+
+#include "../signalk/globals.h"
+#include "../hardware/nmea0183.h"
+#include "../services/ingest.h"
+#include "../services/input_recorder.h"
+
+Preferences prefs;
+std::map<String, String> notifications;
+GPSData gpsData;
+GeofenceConfig geofence;
+DepthAlarmConfig depthAlarm;
+WindAlarmConfig windAlarm;
+
+// Alarm monitoring is not part of the native build
+void updateGeofence(double lat, double lon) {}
+void updateDepthAlarm(double depth) {}
+void updateWindAlarm(double windSpeedMS) {}
+
+// No ingest task: every update is applied by the caller
+bool deferIngestUpdate(IngestOp op, PathId id, PathValueKind kind, SourceId source,
+                       double v0, double v1, double v2) {
+  return false;
+}
+
+bool deferNmeaOutput(const char* sentence, size_t len) {
+  return false;
+}
+
+// main.cpp's sentence handler, without the hand-off to the ingest task and
+// the re-broadcast to TCP clients
+void handleNmeaSentence(const char* sentence, size_t len, InputPort port, const char* sourceTag) {
+  parseNMEASentence(sentence, len, port);
+}
+
+// Nothing is recorded in the native build
+void recordInput(InputPort port, uint8_t channel, const uint8_t* data, size_t len) {}
+
+#endif // SIGNALK_NATIVE
@@ -1,17 +1,17 @@
 #include "alarms.h"
 #include "expo_push.h"
+#include "ingest.h"
 #include "../signalk/data_store.h"
 #include "../utils/conversions.h"
 #include <N2kMessages.h> // For msToKnots
 
 // External globals
-extern GPSData gpsData;
 extern GeofenceConfig geofence;
 extern DepthAlarmConfig depthAlarm;
 extern WindAlarmConfig windAlarm;
 
-// Geofence monitoring
-void updateGeofence() {
+// Geofence monitoring (lat/lon: the position just stored)
+void updateGeofence(double lat, double lon) {
   if (!geofence.enabled) {
     if (geofence.alarmActive) {
       clearNotification("geofence.exit");
@@ -24,13 +24,12 @@ void updateGeofence() {
   if (isnan(geofence.anchorLat) || isnan(geofence.anchorLon)) {
     return;
   }
-  if (isnan(gpsData.lat) || isnan(gpsData.lon)) {
+  if (isnan(lat) || isnan(lon)) {
     return;
   }
 
   // Calculate distance
-  double distance = haversineDistance(gpsData.lat, gpsData.lon,
-                                       geofence.anchorLat, geofence.anchorLon);
+  double distance = haversineDistance(lat, lon, geofence.anchorLat, geofence.anchorLon);
   geofence.lastDistance = distance;
 
   // Check if outside geofence
@@ -59,6 +58,10 @@ void updateGeofence() {
 
 // Depth alarm monitoring
 void updateDepthAlarm(double depth) {
+  if (deferIngestUpdate(INGEST_DEPTH_SAMPLE, INVALID_PATH_ID, PV_NONE, INVALID_SOURCE_ID, depth)) {
+    return;
+  }
+
   depthAlarm.lastDepth = depth;
   depthAlarm.lastSampleTime = millis();
 
@@ -96,6 +99,10 @@ void updateDepthAlarm(double depth) {
 
 // Wind alarm monitoring
 void updateWindAlarm(double windSpeedMS) {
+  if (deferIngestUpdate(INGEST_WIND_SAMPLE, INVALID_PATH_ID, PV_NONE, INVALID_SOURCE_ID, windSpeedMS)) {
+    return;
+  }
+
   const double RESET_HYSTERESIS_KNOTS = 1.0;
 
   // Convert m/s to knots
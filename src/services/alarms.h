@@ -4,7 +4,7 @@
 #include "../signalk/globals.h"
 
 // Alarm monitoring functions
-void updateGeofence();
+void updateGeofence(double lat, double lon);
 void updateDepthAlarm(double depth);
 void updateWindAlarm(double windSpeedMS);
 
@@ -2,16 +2,56 @@
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <WiFiClientSecure.h>
+#include <atomic>
+#include "../config.h"
 #include "../types.h"
 #include "../utils/time_utils.h"
 
 extern DynDnsConfig dynDnsConfig;
 
+// Updates run on a worker task: processDynDnsService() only decides when
+// one is due, hands the worker a copy of the configuration and later
+// publishes the result, so loop() never waits on DNS, TCP or TLS.
+
 namespace {
   constexpr uint32_t kDynDnsIntervalMs = 15UL * 60UL * 1000UL;  // 15 minutes
+  constexpr uint32_t kDynDnsRefreshMs = 24UL * 60UL * 60UL * 1000UL;  // Update daily even if the IP is unchanged
+  constexpr uint16_t kHttpTimeoutMs = 10000;
   bool forceUpdate = false;
   uint32_t lastAttempt = 0;
 
+  // Handed to the worker (written by loop() only while the worker is idle)
+  struct DynDnsJob {
+    String provider;
+    String hostname;
+    String username;
+    String password;
+    String token;
+    bool force = false;
+  };
+
+  // Handed back to loop() (written by the worker before resultReady is set)
+  struct DynDnsResult {
+    String message;
+    String publicIp;
+    bool success = false;
+    bool skipped = false;
+    uint32_t lookupMs = 0;
+    uint32_t connectMs = 0;
+    uint32_t requestMs = 0;
+    uint32_t totalMs = 0;
+  };
+
+  TaskHandle_t workerTask = nullptr;
+  DynDnsJob job;
+  DynDnsResult result;
+  std::atomic<bool> busy(false);
+  std::atomic<bool> resultReady(false);
+
+  // Worker-owned: IP the provider last accepted, and when
+  String registeredIp;
+  uint32_t registeredAt = 0;
+
   void setStatus(const String& message, bool success) {
     dynDnsConfig.lastResult = message;
     dynDnsConfig.lastSuccess = success;
@@ -28,69 +68,174 @@ namespace {
            dynDnsConfig.password.length() > 0;
   }
 
-  void performUpdate() {
-    if (!dynDnsConfig.enabled) {
-      forceUpdate = false;
-      return;
+  // ====== WORKER ======
+
+  // Plain HTTP lookup of the public IP; empty on failure
+  String lookupPublicIp() {
+    HTTPClient http;
+    WiFiClient client;
+    http.setConnectTimeout(kHttpTimeoutMs);
+    http.setTimeout(kHttpTimeoutMs);
+    if (!http.begin(client, "http://" DYNDNS_IP_CHECK_HOST "/")) {
+      return String();
     }
 
-    if (!credentialsReady()) {
-      setStatus("Missing DynDNS hostname or credentials", false);
-      lastAttempt = millis();
-      forceUpdate = false;
-      return;
+    String ip;
+    if (http.GET() == 200) {
+      ip = http.getString();
+      ip.trim();
+      IPAddress parsed;
+      if (!parsed.fromString(ip)) {
+        ip = "";
+      }
     }
+    http.end();
+    return ip;
+  }
 
-    if (WiFi.status() != WL_CONNECTED) {
-      setStatus("Waiting for WiFi connection", false);
-      lastAttempt = millis();
-      forceUpdate = false;
+  void runUpdate(DynDnsResult& out) {
+    uint32_t started = millis();
+    bool duckdns = job.provider == "duckdns";
+
+    // Phase 1: public IP check, so an unchanged address skips the HTTPS call
+    out.publicIp = lookupPublicIp();
+    out.lookupMs = millis() - started;
+
+    if (!job.force && out.publicIp.length() > 0 && out.publicIp == registeredIp &&
+        millis() - registeredAt < kDynDnsRefreshMs) {
+      out.success = true;
+      out.skipped = true;
+      out.message = "IP unchanged (" + out.publicIp + "), update skipped";
+      out.totalMs = millis() - started;
       return;
     }
 
-    HTTPClient http;
-    WiFiClientSecure client;
-    client.setInsecure();
+    // Phase 2: TLS connection to the provider
+    const char* host = duckdns ? "www.duckdns.org" : "members.dyndns.org";
     String url;
-
-    if (dynDnsConfig.provider == "duckdns") {
-      url = "https://www.duckdns.org/update?domains=" + dynDnsConfig.hostname +
-            "&token=" + dynDnsConfig.token + "&ip=";
+    if (duckdns) {
+      url = "https://www.duckdns.org/update?domains=" + job.hostname +
+            "&token=" + job.token + "&ip=" + out.publicIp;
     } else {
-      url = "https://members.dyndns.org/nic/update?hostname=" + dynDnsConfig.hostname;
+      url = "https://members.dyndns.org/nic/update?hostname=" + job.hostname;
+      if (out.publicIp.length() > 0) {
+        url += "&myip=" + out.publicIp;
+      }
     }
 
-    if (!http.begin(client, url)) {
-      setStatus("Failed to contact DynDNS endpoint", false);
-      lastAttempt = millis();
-      forceUpdate = false;
+    WiFiClientSecure client;
+    client.setInsecure();
+
+    uint32_t phaseStart = millis();
+    bool connected = client.connect(host, 443);
+    out.connectMs = millis() - phaseStart;
+
+    HTTPClient http;
+    http.setTimeout(kHttpTimeoutMs);
+    if (!connected || !http.begin(client, url)) {
+      out.message = "Failed to contact DynDNS endpoint";
+      out.totalMs = millis() - started;
       return;
     }
 
-    if (dynDnsConfig.provider == "duckdns") {
-      // DuckDNS uses token in query params; no auth header needed
-    } else {
-      http.setAuthorization(dynDnsConfig.username.c_str(), dynDnsConfig.password.c_str());
+    if (!duckdns) {
+      http.setAuthorization(job.username.c_str(), job.password.c_str());
     }
     http.setUserAgent("ESP32-SignalK/1.0");
 
+    // Phase 3: request and response on the already open connection
+    phaseStart = millis();
     int code = http.GET();
 
     if (code > 0) {
       String payload = http.getString();
       payload.trim();
-      bool success;
-      if (dynDnsConfig.provider == "duckdns") {
-        success = payload == "OK";
+      if (duckdns) {
+        out.success = payload == "OK";
       } else {
-        success = code == 200 && (payload.startsWith("good") || payload.startsWith("nochg"));
+        out.success = code == 200 && (payload.startsWith("good") || payload.startsWith("nochg"));
       }
-      setStatus("HTTP " + String(code) + ": " + payload, success);
+      out.message = "HTTP " + String(code) + ": " + payload;
     } else {
-      setStatus("HTTP error: " + String(code), false);
+      out.message = "HTTP error: " + String(code);
     }
+    out.requestMs = millis() - phaseStart;
 
     http.end();
+
+    if (out.success && out.publicIp.length() > 0) {
+      registeredIp = out.publicIp;
+      registeredAt = millis();
+    }
+    out.totalMs = millis() - started;
+  }
+
+  void workerMain(void* arg) {
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+      DynDnsResult out;
+      runUpdate(out);
+      result = out;
+
+      resultReady.store(true, std::memory_order_release);
+      busy.store(false, std::memory_order_release);
+    }
+  }
+
+  // ====== LOOP SIDE ======
+
+  void publishResult() {
+    dynDnsConfig.publicIp = result.publicIp;
+    dynDnsConfig.lastSkipped = result.skipped;
+    dynDnsConfig.lookupMs = result.lookupMs;
+    dynDnsConfig.connectMs = result.connectMs;
+    dynDnsConfig.requestMs = result.requestMs;
+    dynDnsConfig.totalMs = result.totalMs;
+    setStatus(result.message, result.success);
+
+    Serial.printf("DynDNS: %s (lookup %u ms, connect %u ms, request %u ms, total %u ms)\n",
+                  result.message.c_str(), (unsigned)result.lookupMs, (unsigned)result.connectMs,
+                  (unsigned)result.requestMs, (unsigned)result.totalMs);
+  }
+
+  void startUpdate() {
+    if (!dynDnsConfig.enabled) {
+      forceUpdate = false;
+      return;
+    }
+
+    if (!credentialsReady()) {
+      setStatus("Missing DynDNS hostname or credentials", false);
+      lastAttempt = millis();
+      forceUpdate = false;
+      return;
+    }
+
+    if (WiFi.status() != WL_CONNECTED) {
+      setStatus("Waiting for WiFi connection", false);
+      lastAttempt = millis();
+      forceUpdate = false;
+      return;
+    }
+
+    if (workerTask == nullptr) {
+      setStatus("DynDNS worker not running", false);
+      lastAttempt = millis();
+      forceUpdate = false;
+      return;
+    }
+
+    job.provider = dynDnsConfig.provider;
+    job.hostname = dynDnsConfig.hostname;
+    job.username = dynDnsConfig.username;
+    job.password = dynDnsConfig.password;
+    job.token = dynDnsConfig.token;
+    job.force = forceUpdate;
+
+    busy.store(true, std::memory_order_release);
+    xTaskNotifyGive(workerTask);
+
     forceUpdate = false;
     lastAttempt = millis();
   }
@@ -102,16 +247,34 @@ void initDynDnsService() {
   if (!dynDnsConfig.lastResult.length()) {
     dynDnsConfig.lastResult = "DynDNS not updated yet";
   }
+
+  if (workerTask == nullptr) {
+    BaseType_t created = xTaskCreatePinnedToCore(workerMain, "dyndns", DYNDNS_TASK_STACK, nullptr,
+                                                 DYNDNS_TASK_PRIORITY, &workerTask, DYNDNS_TASK_CORE);
+    if (created != pdPASS) {
+      workerTask = nullptr;
+      Serial.println("ERROR: Failed to create DynDNS worker task");
+    }
+  }
 }
 
 void processDynDnsService() {
+  if (resultReady.load(std::memory_order_acquire)) {
+    publishResult();
+    resultReady.store(false, std::memory_order_release);
+  }
+
+  if (busy.load(std::memory_order_acquire) || resultReady.load(std::memory_order_acquire)) {
+    return;  // An update is in progress
+  }
+
   if (!dynDnsConfig.enabled && !forceUpdate) {
     return;
   }
 
   uint32_t now = millis();
   if (forceUpdate || (now - lastAttempt >= kDynDnsIntervalMs)) {
-    performUpdate();
+    startUpdate();
   }
 }
 
@@ -1,10 +1,12 @@
 #ifndef SERVICES_DYNDNS_H
 #define SERVICES_DYNDNS_H
 
-// Initialize internal state for DynDNS updater
+// Initialize internal state for DynDNS updater and start its worker task
 void initDynDnsService();
 
-// Run periodic DynDNS update checks (call from loop)
+// Run periodic DynDNS update checks (call from loop; never blocks).
+// Due updates run on the worker task; their result and phase timings are
+// published to dynDnsConfig on a later call.
 void processDynDnsService();
 
 // Request an immediate DynDNS update attempt
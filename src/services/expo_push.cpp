@@ -1,12 +1,118 @@
 #include "expo_push.h"
+#include "expo_push_client.h"
 #include "storage.h"
+#include "../config.h"
+#include <WiFi.h>
 #include <WiFiClientSecure.h>
-#include <ArduinoJson.h>
+#include <deque>
 
 // Expo push notification state (extern - defined in main.cpp)
 extern unsigned long lastPushNotification;
 const unsigned long PUSH_NOTIFICATION_COOLDOWN = 10000;  // 10 seconds
 
+// ====== DELIVERY QUEUE ======
+// Filled by sendExpoPushNotification() (loop task), drained by the push task.
+
+static std::deque<ExpoPushJob> pendingJobs;
+static SemaphoreHandle_t pendingLock = nullptr;  // Guards pendingJobs
+static TaskHandle_t pushTask = nullptr;
+static ExpoPushStats stats;
+
+#if EXPO_PUSH_USE_TLS
+static WiFiClientSecure pushTransport;
+#else
+static WiFiClient pushTransport;
+#endif
+static ExpoPushClient pushClient(pushTransport, EXPO_PUSH_HOST, EXPO_PUSH_PORT);
+
+// Move queued jobs into batch, up to EXPO_PUSH_MAX_BATCH messages in total
+static void takeBatch(std::vector<ExpoPushJob>& batch) {
+  xSemaphoreTake(pendingLock, portMAX_DELAY);
+  takeExpoPushBatch(pendingJobs, batch);
+  xSemaphoreGive(pendingLock);
+}
+
+static bool pendingEmpty() {
+  xSemaphoreTake(pendingLock, portMAX_DELAY);
+  bool empty = pendingJobs.empty();
+  xSemaphoreGive(pendingLock);
+  return empty;
+}
+
+// Send one batch, retrying with backoff; returns the final result
+static ExpoPushResult deliver(const std::vector<ExpoPushJob>& batch) {
+  ExpoPushResult result = EXPO_PUSH_RETRY;
+  for (uint8_t attempt = 1; attempt <= EXPO_PUSH_MAX_ATTEMPTS; attempt++) {
+    if (WiFi.status() == WL_CONNECTED) {
+      result = pushClient.send(batch);
+      if (result != EXPO_PUSH_RETRY) break;
+      Serial.printf("Push API attempt %u failed (HTTP %d)\n", attempt, pushClient.lastStatus());
+    } else {
+      Serial.printf("Push API attempt %u skipped - WiFi not connected\n", attempt);
+    }
+
+    if (attempt < EXPO_PUSH_MAX_ATTEMPTS) {
+      stats.retries++;
+      vTaskDelay(pdMS_TO_TICKS(expoPushBackoffMs(attempt)));
+    }
+  }
+  return result;
+}
+
+static void pushTaskMain(void* arg) {
+  std::vector<ExpoPushJob> batch;
+
+  for (;;) {
+    // Sleep until work arrives; close the kept-alive connection when idle
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(EXPO_PUSH_IDLE_CLOSE_MS)) == 0 && pendingEmpty()) {
+      pushClient.disconnect();
+      continue;
+    }
+
+    for (takeBatch(batch); !batch.empty(); takeBatch(batch)) {
+      size_t messages = 0;
+      for (const ExpoPushJob& job : batch) messages += job.tokens.size();
+
+      uint32_t started = millis();
+      ExpoPushResult result = deliver(batch);
+      uint32_t elapsed = millis() - started;
+
+      if (result == EXPO_PUSH_SENT) {
+        stats.sent += messages;
+        Serial.printf("Push API: %u message(s) sent in one request (HTTP %d, %u ms, %u connection(s) opened)\n",
+                      (unsigned)messages, pushClient.lastStatus(), (unsigned)elapsed,
+                      (unsigned)pushClient.connects());
+      } else {
+        stats.failed += messages;
+        Serial.printf("Push API: %u message(s) failed (HTTP %d)\n",
+                      (unsigned)messages, pushClient.lastStatus());
+      }
+    }
+  }
+}
+
+void initExpoPush() {
+  if (pushTask != nullptr) {
+    return;
+  }
+
+  pendingLock = xSemaphoreCreateMutex();
+
+#if EXPO_PUSH_USE_TLS
+  pushTransport.setInsecure();  // Skip certificate validation for simplicity
+#endif
+
+  BaseType_t result = xTaskCreatePinnedToCore(pushTaskMain, "expo_push", EXPO_PUSH_TASK_STACK,
+                                              nullptr, EXPO_PUSH_TASK_PRIORITY, &pushTask,
+                                              EXPO_PUSH_TASK_CORE);
+  if (result != pdPASS) {
+    pushTask = nullptr;
+    Serial.println("ERROR: Failed to create push notification task");
+  }
+}
+
+// ====== PUBLIC API ======
+
 void sendExpoPushNotification(const String& title, const String& body,
                                const String& alarmType, const String& data) {
   unsigned long now = millis();
@@ -22,68 +128,41 @@ void sendExpoPushNotification(const String& title, const String& body,
     return;
   }
 
+  if (pushTask == nullptr) {
+    Serial.println("Push notification task not running");
+    return;
+  }
+
   lastPushNotification = now;
 
-  // Send to each registered token
-  for (const auto& token : expoTokens) {
-    Serial.printf("Sending push notification to: %s\n", token.substring(0, 30).c_str());
-
-    // Build JSON payload for Expo push API
-    DynamicJsonDocument doc(512);
-    doc["to"] = token;
-    doc["title"] = title;
-    doc["body"] = body;
-    doc["priority"] = "high";
-
-    // Set sound and channelId based on alarm type
-    if (alarmType == "geofence") {
-      doc["sound"] = "geofence_alarm.wav";
-      doc["channelId"] = "geofence-alarms";
-    } else if (alarmType == "depth") {
-      doc["sound"] = "geofence_alarm.wav";
-      doc["channelId"] = "geofence-alarms";
-    } else if (alarmType == "wind") {
-      doc["sound"] = "geofence_alarm.wav";
-      doc["channelId"] = "geofence-alarms";
-    } else {
-      doc["sound"] = "default";
-    }
+  ExpoPushJob job;
+  job.title = title;
+  job.body = body;
+  job.alarmType = alarmType;
+  job.data = data;
+  job.tokens = expoTokens;
 
-    if (data.length() > 0) {
-      doc["data"] = data;
-    }
+  // Queue and return; the push task does the network I/O
+  xSemaphoreTake(pendingLock, portMAX_DELAY);
+  if (pendingJobs.size() >= EXPO_PUSH_QUEUE_DEPTH) {
+    pendingJobs.pop_front();  // Newest alarm state matters most
+    stats.dropped++;
+  }
+  pendingJobs.push_back(std::move(job));
+  stats.queued++;
+  xSemaphoreGive(pendingLock);
 
-    String payload;
-    serializeJson(doc, payload);
-
-    // Send HTTP POST to Expo push API
-    WiFiClientSecure client;
-    client.setInsecure();  // Skip certificate validation for simplicity
-
-    if (client.connect("exp.host", 443)) {
-      client.println("POST /--/api/v2/push/send HTTP/1.1");
-      client.println("Host: exp.host");
-      client.println("Content-Type: application/json");
-      client.println("Accept: application/json");
-      client.print("Content-Length: ");
-      client.println(payload.length());
-      client.println("Connection: close");
-      client.println();
-      client.print(payload);
-
-      // Wait for response
-      unsigned long timeout = millis() + 5000;
-      while (client.connected() && millis() < timeout) {
-        if (client.available()) {
-          String line = client.readStringUntil('\n');
-          if (line.startsWith("HTTP/")) {
-            Serial.printf("Push API response: %s\n", line.c_str());
-          }
-        }
-      }
-      client.stop();
-    } else {
-      Serial.println("Failed to connect to Expo push API");
-    }
+  xTaskNotifyGive(pushTask);
+  Serial.printf("Push notification queued for %u token(s)\n", (unsigned)expoTokens.size());
+}
+
+ExpoPushStats getExpoPushStats() {
+  ExpoPushStats snapshot = stats;
+  if (pendingLock != nullptr) {
+    xSemaphoreTake(pendingLock, portMAX_DELAY);
+    snapshot.pending = pendingJobs.size();
+    xSemaphoreGive(pendingLock);
   }
+  snapshot.connects = pushClient.connects();
+  return snapshot;
 }
@@ -7,8 +7,31 @@
 extern unsigned long lastPushNotification;
 extern const unsigned long PUSH_NOTIFICATION_COOLDOWN;
 
-// Functions
+// Delivery counters since boot
+struct ExpoPushStats {
+  uint32_t queued = 0;    // Notifications accepted
+  uint32_t dropped = 0;   // Notifications discarded because the queue was full
+  uint32_t sent = 0;      // Messages (notification x token) delivered
+  uint32_t failed = 0;    // Messages given up on after all attempts
+  uint32_t retries = 0;   // Request attempts repeated after a failure
+  uint32_t connects = 0;  // Connections (TLS handshakes) opened
+  uint32_t pending = 0;   // Notifications waiting in the queue
+};
+
+/**
+ * Start the push delivery task
+ * Call once from setup(); notifications are dropped until it runs.
+ */
+void initExpoPush();
+
+/**
+ * Queue a push notification to every registered token
+ * Returns immediately; a background task batches queued notifications into
+ * one Expo API request and retries with backoff.
+ */
 void sendExpoPushNotification(const String& title, const String& body,
                                const String& alarmType = "", const String& data = "");
 
+ExpoPushStats getExpoPushStats();
+
 #endif // SERVICES_EXPO_PUSH_H
@@ -0,0 +1,278 @@
+#include "expo_push_client.h"
+#include "../utils/json_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <iterator>
+
+// Longest status/header line kept; longer lines are truncated
+static const size_t kMaxHeaderLine = 256;
+
+// ====== PAYLOAD ======
+
+// Alarm notifications use the alarm sound and Android channel
+static bool isAlarm(const String& alarmType) {
+  return alarmType == "geofence" || alarmType == "depth" || alarmType == "wind";
+}
+
+String buildExpoPushPayload(const std::vector<ExpoPushJob>& jobs) {
+  // Upper bound: escaped strings plus the fixed keys and punctuation
+  size_t capacity = 2;
+  for (const ExpoPushJob& job : jobs) {
+    size_t perMessage = 160 + JsonWriter::quotedLength(job.title) +
+                        JsonWriter::quotedLength(job.body) +
+                        JsonWriter::quotedLength(job.data);
+    for (const String& token : job.tokens) {
+      capacity += perMessage + JsonWriter::quotedLength(token);
+    }
+  }
+
+  char* buffer = (char*)malloc(capacity);
+  if (buffer == nullptr) {
+    return String();
+  }
+
+  JsonWriter w(buffer, capacity);
+  bool first = true;
+  w.raw('[');
+  for (const ExpoPushJob& job : jobs) {
+    for (const String& token : job.tokens) {
+      if (!first) w.raw(',');
+      first = false;
+
+      w.raw('{');
+      w.key("to");
+      w.string(token);
+      w.raw(',');
+      w.key("title");
+      w.string(job.title);
+      w.raw(',');
+      w.key("body");
+      w.string(job.body);
+      w.raw(",\"priority\":\"high\"");
+      if (isAlarm(job.alarmType)) {
+        w.raw(",\"sound\":\"geofence_alarm.wav\",\"channelId\":\"geofence-alarms\"");
+      } else {
+        w.raw(",\"sound\":\"default\"");
+      }
+      if (job.data.length() > 0) {
+        w.raw(',');
+        w.key("data");
+        w.string(job.data);
+      }
+      w.raw('}');
+    }
+  }
+  w.raw(']');
+
+  String payload;
+  if (!w.overflowed()) {
+    payload.reserve(w.length());
+    payload.concat(buffer, w.length());
+  }
+  free(buffer);
+  return payload;
+}
+
+// ====== BATCHING ======
+
+void takeExpoPushBatch(std::deque<ExpoPushJob>& pending, std::vector<ExpoPushJob>& batch) {
+  batch.clear();
+  size_t messages = 0;
+
+  while (!pending.empty() && messages < EXPO_PUSH_MAX_BATCH) {
+    ExpoPushJob& job = pending.front();
+    size_t room = EXPO_PUSH_MAX_BATCH - messages;
+    if (job.tokens.size() <= room) {
+      messages += job.tokens.size();
+      batch.push_back(std::move(job));
+      pending.pop_front();
+      continue;
+    }
+
+    // Send the first tokens that fit; the job keeps the rest
+    ExpoPushJob part;
+    part.title = job.title;
+    part.body = job.body;
+    part.alarmType = job.alarmType;
+    part.data = job.data;
+    auto split = job.tokens.begin() + room;
+    part.tokens.assign(std::make_move_iterator(job.tokens.begin()), std::make_move_iterator(split));
+    job.tokens.erase(job.tokens.begin(), split);
+    batch.push_back(std::move(part));
+    messages += room;
+  }
+}
+
+uint32_t expoPushBackoffMs(uint8_t attempt) {
+  if (attempt == 0) attempt = 1;
+  if (attempt > 6) return 30000;
+  uint32_t delayMs = 1000UL << (attempt - 1);
+  return delayMs > 30000 ? 30000 : delayMs;
+}
+
+// ====== CLIENT ======
+
+ExpoPushClient::ExpoPushClient(Client& transport, const char* host, uint16_t port, const char* path)
+  : _client(transport), _host(host), _port(port), _path(path), _lastStatus(0), _connects(0) {}
+
+void ExpoPushClient::disconnect() {
+  _client.stop();
+}
+
+ExpoPushResult ExpoPushClient::send(const std::vector<ExpoPushJob>& jobs) {
+  _lastStatus = 0;
+
+  String payload = buildExpoPushPayload(jobs);
+  if (payload.length() == 0) {
+    return EXPO_PUSH_REJECTED;  // Out of memory
+  }
+  if (payload.length() == 2) {
+    return EXPO_PUSH_SENT;  // "[]": no tokens registered
+  }
+
+  // A kept-alive connection may have been closed by the server since the
+  // last request; that shows up as a failed write or an immediate EOF and
+  // is retried once on a fresh connection.
+  for (int pass = 0; pass < 2; pass++) {
+    bool reused = _client.connected();
+    if (!reused) {
+      if (!_client.connect(_host, _port)) {
+        return EXPO_PUSH_RETRY;
+      }
+      _connects++;
+    }
+
+    bool keepAlive = false;
+    bool received = writeRequest(payload) && readResponse(keepAlive);
+    if (received) {
+      if (!keepAlive) _client.stop();
+      break;
+    }
+
+    bool stale = reused && !_client.connected();
+    _client.stop();
+    if (!stale) break;
+  }
+
+  if (_lastStatus >= 200 && _lastStatus < 300) return EXPO_PUSH_SENT;
+  if (_lastStatus == 0 || _lastStatus == 429 || _lastStatus >= 500) return EXPO_PUSH_RETRY;
+  return EXPO_PUSH_REJECTED;
+}
+
+bool ExpoPushClient::writeRequest(const String& payload) {
+  char header[256];
+  int headerLen = snprintf(header, sizeof(header),
+                           "POST %s HTTP/1.1\r\n"
+                           "Host: %s\r\n"
+                           "Content-Type: application/json\r\n"
+                           "Accept: application/json\r\n"
+                           "Content-Length: %u\r\n"
+                           "Connection: keep-alive\r\n"
+                           "\r\n",
+                           _path, _host, (unsigned)payload.length());
+  if (headerLen <= 0 || (size_t)headerLen >= sizeof(header)) {
+    return false;
+  }
+
+  if (_client.write((const uint8_t*)header, headerLen) != (size_t)headerLen) {
+    return false;
+  }
+  return _client.write((const uint8_t*)payload.c_str(), payload.length()) == payload.length();
+}
+
+bool ExpoPushClient::readLine(String& line, uint32_t deadline) {
+  line = "";
+  for (;;) {
+    if (_client.available() > 0) {
+      int c = _client.read();
+      if (c < 0) continue;
+      if (c == '\n') return true;
+      if (c != '\r' && line.length() < kMaxHeaderLine) line += (char)c;
+    } else if (!_client.connected() || (int32_t)(millis() - deadline) >= 0) {
+      return false;
+    } else {
+      delay(5);
+    }
+  }
+}
+
+bool ExpoPushClient::skipBytes(size_t n, uint32_t deadline) {
+  uint8_t scratch[128];
+  while (n > 0) {
+    int avail = _client.available();
+    if (avail > 0) {
+      size_t chunk = (size_t)avail < n ? (size_t)avail : n;
+      if (chunk > sizeof(scratch)) chunk = sizeof(scratch);
+      int got = _client.read(scratch, chunk);
+      if (got > 0) n -= (size_t)got;
+    } else if (!_client.connected() || (int32_t)(millis() - deadline) >= 0) {
+      return false;
+    } else {
+      delay(5);
+    }
+  }
+  return true;
+}
+
+bool ExpoPushClient::readResponse(bool& keepAlive) {
+  uint32_t deadline = millis() + EXPO_PUSH_TIMEOUT_MS;
+  String line;
+
+  // Status line: "HTTP/1.1 200 OK"
+  if (!readLine(line, deadline)) {
+    return false;
+  }
+  const char* space = strchr(line.c_str(), ' ');
+  _lastStatus = (strncmp(line.c_str(), "HTTP/", 5) == 0 && space) ? atoi(space + 1) : 0;
+  keepAlive = strncmp(line.c_str(), "HTTP/1.1", 8) == 0;
+
+  // Headers
+  long contentLength = -1;
+  bool chunked = false;
+  for (;;) {
+    if (!readLine(line, deadline)) {
+      keepAlive = false;
+      return true;
+    }
+    if (line.length() == 0) break;
+
+    const char* h = line.c_str();
+    if (strncasecmp(h, "Content-Length:", 15) == 0) {
+      contentLength = atol(h + 15);
+    } else if (strncasecmp(h, "Transfer-Encoding:", 18) == 0) {
+      chunked = strstr(h + 18, "chunked") != nullptr;
+    } else if (strncasecmp(h, "Connection:", 11) == 0) {
+      keepAlive = strstr(h + 11, "close") == nullptr && strstr(h + 11, "Close") == nullptr;
+    }
+  }
+
+  // Body is discarded; it only has to be consumed to keep the connection usable
+  if (chunked) {
+    for (;;) {
+      if (!readLine(line, deadline)) {
+        keepAlive = false;
+        break;
+      }
+      size_t size = strtoul(line.c_str(), nullptr, 16);
+      if (size == 0) {
+        // Trailers up to the terminating blank line
+        while (readLine(line, deadline) && line.length() > 0) {}
+        break;
+      }
+      if (!skipBytes(size + 2, deadline)) {  // Chunk data and its CRLF
+        keepAlive = false;
+        break;
+      }
+    }
+  } else if (contentLength >= 0) {
+    if (!skipBytes((size_t)contentLength, deadline)) {
+      keepAlive = false;
+    }
+  } else {
+    keepAlive = false;  // Body runs until the server closes
+  }
+
+  return true;
+}
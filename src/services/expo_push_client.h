@@ -0,0 +1,106 @@
+#ifndef SERVICES_EXPO_PUSH_CLIENT_H
+#define SERVICES_EXPO_PUSH_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <deque>
+#include <vector>
+
+// Expo push API endpoint; override with build flags to test against a
+// local stand-in (e.g. -DEXPO_PUSH_HOST=\"192.168.4.2\" -DEXPO_PUSH_PORT=8080 -DEXPO_PUSH_USE_TLS=0)
+#ifndef EXPO_PUSH_HOST
+#define EXPO_PUSH_HOST "exp.host"
+#endif
+#ifndef EXPO_PUSH_PORT
+#define EXPO_PUSH_PORT 443
+#endif
+#ifndef EXPO_PUSH_USE_TLS
+#define EXPO_PUSH_USE_TLS 1
+#endif
+#define EXPO_PUSH_PATH "/--/api/v2/push/send"
+
+// Messages per request accepted by the Expo API
+#define EXPO_PUSH_MAX_BATCH 100
+
+// Response timeout per request
+#define EXPO_PUSH_TIMEOUT_MS 5000
+
+// One notification and the tokens it goes to
+struct ExpoPushJob {
+  String title;
+  String body;
+  String alarmType;  // "geofence", "depth", "wind" or "" (default sound)
+  String data;
+  std::vector<String> tokens;
+};
+
+enum ExpoPushResult : uint8_t {
+  EXPO_PUSH_SENT = 0,  // 2xx
+  EXPO_PUSH_RETRY,     // Connect/write failure, timeout, 429 or 5xx
+  EXPO_PUSH_REJECTED   // Any other status; retrying will not help
+};
+
+/**
+ * Expo push API client over an Arduino Client
+ *
+ * Sends every job x token pair as one JSON array in a single POST and
+ * keeps the connection (and with WiFiClientSecure the TLS session) open
+ * for the next request. A kept-alive connection the server has closed in
+ * the meantime is detected and re-opened once per send().
+ *
+ * Blocks for up to EXPO_PUSH_TIMEOUT_MS; call it from the push task only.
+ */
+class ExpoPushClient {
+public:
+  ExpoPushClient(Client& transport, const char* host, uint16_t port, const char* path = EXPO_PUSH_PATH);
+
+  ExpoPushResult send(const std::vector<ExpoPushJob>& jobs);
+
+  // Close the kept-alive connection
+  void disconnect();
+
+  // HTTP status of the last response (0 if none was received)
+  int lastStatus() const { return _lastStatus; }
+
+  // Connections opened so far (each one is a TLS handshake)
+  uint32_t connects() const { return _connects; }
+
+private:
+  // Write the request; false if the connection failed
+  bool writeRequest(const String& payload);
+
+  // Read status line, headers and body; false if nothing was received
+  bool readResponse(bool& keepAlive);
+
+  // Read one header line (CRLF stripped) into line; false on timeout/close
+  bool readLine(String& line, uint32_t deadline);
+
+  // Read and discard n body bytes; false on timeout/close
+  bool skipBytes(size_t n, uint32_t deadline);
+
+  Client& _client;
+  const char* _host;
+  uint16_t _port;
+  const char* _path;
+  int _lastStatus;
+  uint32_t _connects;
+};
+
+/**
+ * JSON array body for a batch: one message object per job x token
+ */
+String buildExpoPushPayload(const std::vector<ExpoPushJob>& jobs);
+
+/**
+ * Move the next request's worth of jobs from pending into batch: at most
+ * EXPO_PUSH_MAX_BATCH messages in total. A job with more tokens than fit
+ * is split; its remaining tokens stay at the front of pending.
+ */
+void takeExpoPushBatch(std::deque<ExpoPushJob>& pending, std::vector<ExpoPushJob>& batch);
+
+/**
+ * Delay before retry number attempt (1-based): 1 s, 2 s, 4 s ... capped at 30 s
+ */
+uint32_t expoPushBackoffMs(uint8_t attempt);
+
+#endif // SERVICES_EXPO_PUSH_CLIENT_H
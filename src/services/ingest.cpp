@@ -0,0 +1,248 @@
+#include "ingest.h"
+#include "alarms.h"
+#include "nmea0183_tcp.h"
+#include "input_replay.h"
+#include "../signalk/data_store.h"
+#include "../utils/nmea_tokenizer.h"
+#include "../utils/spsc_queue.h"
+#include <cstring>
+
+// Forward declaration for NMEA handler defined in main.cpp
+extern void handleNmeaSentence(const char* sentence, size_t len, InputPort port, const char* sourceTag);
+
+// A sentence in flight between the two tasks
+struct IngestSentence {
+  const char* tag;
+  InputPort port;
+  uint8_t len;
+  char text[NMEA_MAX_SENTENCE_LENGTH + 3];  // Sentence, CRLF and NUL
+};
+
+typedef SpscQueue<IngestSentence, INGEST_SENTENCE_QUEUE_SIZE> SentenceQueue;
+
+static SpscQueue<IngestUpdate, INGEST_UPDATE_QUEUE_SIZE> updateQueue;  // ingest -> loop
+static SentenceQueue outputQueue;  // ingest -> loop (TCP rebroadcast)
+static SentenceQueue inputQueue;   // loop -> ingest (TCP inputs)
+
+static TaskHandle_t ingestTask = nullptr;
+static TaskHandle_t loopTask = nullptr;
+static IngestPollFn ingestPoll = nullptr;
+static TaskLoadMeter ingestLoad;
+
+// ====== TASK LOAD ======
+
+void TaskLoadMeter::end() {
+  uint32_t now = micros();
+  _busy += now - _start;
+
+  uint32_t window = now - _windowStart;
+  if (window >= 1000000) {
+    uint32_t percent = (uint32_t)((uint64_t)_busy * 100 / window);
+    _percent = percent > 100 ? 100 : percent;
+    _busy = 0;
+    _windowStart = now;
+  }
+}
+
+// ====== INGEST TASK ======
+
+static void ingestTaskMain(void* arg) {
+  ingestTask = xTaskGetCurrentTaskHandle();
+
+  for (;;) {
+    ingestLoad.begin();
+
+    ingestPoll();
+
+    IngestSentence sentence;
+    while (inputQueue.pop(sentence)) {
+      handleNmeaSentence(sentence.text, sentence.len, sentence.port, sentence.tag);
+    }
+
+    ingestLoad.end();
+
+    // One tick lets lower priority tasks on this core (idle, watchdog) run
+    vTaskDelay(1);
+  }
+}
+
+void startIngestTask(IngestPollFn poll) {
+  if (ingestTask != nullptr || poll == nullptr) {
+    return;
+  }
+
+  ingestPoll = poll;
+  loopTask = xTaskGetCurrentTaskHandle();
+
+  BaseType_t result = xTaskCreatePinnedToCore(ingestTaskMain, "ingest", INGEST_TASK_STACK,
+                                              nullptr, INGEST_TASK_PRIORITY, &ingestTask,
+                                              INGEST_TASK_CORE);
+  if (result != pdPASS) {
+    ingestTask = nullptr;
+    Serial.println("ERROR: Failed to create ingest task - inputs will be polled from loop()");
+    return;
+  }
+
+  Serial.printf("Ingest task started on core %d (priority %d)\n",
+                INGEST_TASK_CORE, INGEST_TASK_PRIORITY);
+}
+
+bool isIngestTask() {
+  return ingestTask != nullptr && xTaskGetCurrentTaskHandle() == ingestTask;
+}
+
+// ====== HANDOFF ======
+
+static bool pushSentence(SentenceQueue& queue, const char* text, size_t len, InputPort port,
+                         const char* tag) {
+  if (len > NMEA_MAX_SENTENCE_LENGTH + 2) {
+    return false;
+  }
+
+  IngestSentence item;
+  item.tag = tag;
+  item.port = port;
+  item.len = (uint8_t)len;
+  memcpy(item.text, text, len);
+  item.text[len] = '\0';
+  return queue.push(item);
+}
+
+bool deferIngestUpdate(IngestOp op, PathId id, PathValueKind kind, SourceId source,
+                       double v0, double v1, double v2) {
+  if (!isIngestTask()) {
+    return false;
+  }
+
+  IngestUpdate update;
+  update.op = op;
+  update.kind = kind;
+  update.source = source;
+  update.id = id;
+  update.v[0] = v0;
+  update.v[1] = v1;
+  update.v[2] = v2;
+  updateQueue.push(update);  // When full the sample is dropped and counted
+  return true;
+}
+
+bool ingestQueuesBusy() {
+  return updateQueue.size() > updateQueue.capacity() / 2 ||
+         outputQueue.size() > outputQueue.capacity() / 2;
+}
+
+bool deferNmeaOutput(const char* sentence, size_t len) {
+  if (!isIngestTask()) {
+    return false;
+  }
+  pushSentence(outputQueue, sentence, len, INPUT_PORT_COUNT, nullptr);
+  return true;
+}
+
+bool deferNmeaInput(const char* sentence, size_t len, InputPort port, const char* sourceTag) {
+  if (ingestTask == nullptr || isIngestTask()) {
+    return false;
+  }
+  if (!pushSentence(inputQueue, sentence, len, port, sourceTag)) {
+    countInput(port, INPUT_OVERFLOWS);
+  }
+  return true;
+}
+
+// ====== LOOP TASK SIDE ======
+
+static void applyUpdate(const IngestUpdate& u) {
+  switch (u.op) {
+    case INGEST_SET_NUMBER:
+      setPathValue(u.id, u.v[0], u.source);
+      break;
+    case INGEST_SET_COMPOSITE:
+      setPathComposite(u.id, u.kind, u.v[0], u.v[1], u.v[2], u.source);
+      break;
+    case INGEST_SET_POSITION:
+      updateNavigationPosition(u.v[0], u.v[1], u.source);
+      break;
+    case INGEST_DEPTH_SAMPLE:
+      updateDepthAlarm(u.v[0]);
+      break;
+    case INGEST_WIND_SAMPLE:
+      updateWindAlarm(u.v[0]);
+      break;
+    case INGEST_REPLAY_MARK:
+      noteInputReplayApplied((uint32_t)u.v[0]);
+      break;
+  }
+}
+
+static uint32_t stackFree(TaskHandle_t task) {
+  return task != nullptr ? uxTaskGetStackHighWaterMark(task) : 0;
+}
+
+static void logIngestStats() {
+  static uint32_t lastLog = 0;
+  uint32_t now = millis();
+  if (now - lastLog < INGEST_STATS_LOG_MS) {
+    return;
+  }
+  lastLog = now;
+
+  Serial.printf("[Tasks] ingest: %u%% CPU, %u bytes stack free | loop: %u%% CPU, %u bytes stack free\n",
+                ingestLoad.percent(), (unsigned)stackFree(ingestTask),
+                loopLoad.percent(), (unsigned)stackFree(loopTask));
+  Serial.printf("[Tasks] queue high water: updates %u/%u (%u dropped), "
+                "NMEA out %u/%u (%u dropped), NMEA in %u/%u (%u dropped)\n",
+                (unsigned)updateQueue.highWater(), (unsigned)updateQueue.capacity(),
+                (unsigned)updateQueue.dropped(),
+                (unsigned)outputQueue.highWater(), (unsigned)outputQueue.capacity(),
+                (unsigned)outputQueue.dropped(),
+                (unsigned)inputQueue.highWater(), (unsigned)inputQueue.capacity(),
+                (unsigned)inputQueue.dropped());
+}
+
+void processIngestQueues() {
+  // Task could not be created: poll the inputs inline as before
+  if (ingestTask == nullptr && ingestPoll != nullptr) {
+    ingestPoll();
+  }
+
+  // Bounded to one queue's worth so a flood cannot starve the rest of loop()
+  IngestUpdate update;
+  for (size_t n = 0; n < updateQueue.capacity() && updateQueue.pop(update); n++) {
+    applyUpdate(update);
+  }
+
+  IngestSentence sentence;
+  for (size_t n = 0; n < outputQueue.capacity() && outputQueue.pop(sentence); n++) {
+    broadcastNMEA0183(sentence.text, sentence.len);
+  }
+
+  logIngestStats();
+}
+
+// ====== STATS ======
+
+template <typename Q>
+static void writeQueueStats(JsonObject obj, const Q& queue) {
+  obj["depth"] = queue.size();
+  obj["highWater"] = queue.highWater();
+  obj["capacity"] = queue.capacity();
+  obj["dropped"] = queue.dropped();
+}
+
+void writeIngestStats(JsonObject obj) {
+  JsonObject ingest = obj.createNestedObject("ingest");
+  ingest["running"] = ingestTask != nullptr;
+  ingest["core"] = INGEST_TASK_CORE;
+  ingest["cpuPercent"] = ingestLoad.percent();
+  ingest["stackFree"] = stackFree(ingestTask);
+
+  JsonObject loop = obj.createNestedObject("loop");
+  loop["core"] = ARDUINO_RUNNING_CORE;
+  loop["cpuPercent"] = loopLoad.percent();
+  loop["stackFree"] = stackFree(loopTask);
+
+  JsonObject queues = obj.createNestedObject("queues");
+  writeQueueStats(queues.createNestedObject("updates"), updateQueue);
+  writeQueueStats(queues.createNestedObject("nmeaOut"), outputQueue);
+  writeQueueStats(queues.createNestedObject("nmeaIn"), inputQueue);
+}
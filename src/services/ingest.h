@@ -0,0 +1,123 @@
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+#include "../types.h"
+#include "../utils/input_stats.h"
+
+/**
+ * Ingest task
+ *
+ * Serial, CAN and Seatalk input is read and parsed by a dedicated task
+ * pinned to INGEST_TASK_CORE, so a slow network call in loop() (DynDNS,
+ * Expo push, a stalled TCP peer) no longer delays sentence parsing.
+ *
+ * The ingest task never touches the data store, alarms or sockets directly.
+ * Functions that do (setPathValue by ID with a number, setPathComposite,
+ * updateNavigationPosition, the depth/wind alarms, broadcastNMEA0183)
+ * check deferIngestUpdate()/deferNmeaOutput() first; on the ingest task the
+ * call is copied into a lock-free SPSC queue and replayed on the loop task
+ * by processIngestQueues(). Sentences received over the network go the
+ * other way, so every sentence is parsed on the same task.
+ */
+
+// Deferred operation carried by an IngestUpdate
+enum IngestOp : uint8_t {
+  INGEST_SET_NUMBER = 0,  // setPathValue(id, v[0], source)
+  INGEST_SET_COMPOSITE,   // setPathComposite(id, kind, v[0..2], source)
+  INGEST_SET_POSITION,    // updateNavigationPosition(v[0], v[1], source)
+  INGEST_DEPTH_SAMPLE,    // updateDepthAlarm(v[0])
+  INGEST_WIND_SAMPLE,     // updateWindAlarm(v[0])
+  INGEST_REPLAY_MARK      // noteInputReplayApplied(v[0]): end of a replayed batch
+};
+
+struct IngestUpdate {
+  IngestOp op;
+  PathValueKind kind;
+  SourceId source;
+  PathId id;
+  double v[3];
+};
+
+/**
+ * Busy-time meter for a polling task
+ * Call begin()/end() around each pass; percent() is the share of the last
+ * full second spent between the two.
+ */
+class TaskLoadMeter {
+public:
+  TaskLoadMeter() : _start(0), _busy(0), _windowStart(0), _percent(0) {}
+
+  void begin() { _start = micros(); }
+  void end();
+
+  uint8_t percent() const { return _percent; }
+
+private:
+  uint32_t _start;
+  uint32_t _busy;
+  uint32_t _windowStart;
+  volatile uint8_t _percent;
+};
+
+// Busy time of the Arduino loop task, measured in main.cpp
+extern TaskLoadMeter loopLoad;
+
+// Polls the inputs once; called repeatedly by the ingest task
+typedef void (*IngestPollFn)();
+
+/**
+ * Start the ingest task
+ * Call at the end of setup(), once every input has been initialized.
+ */
+void startIngestTask(IngestPollFn poll);
+
+/**
+ * True when called from the ingest task
+ */
+bool isIngestTask();
+
+/**
+ * Queue a store/alarm update for the loop task
+ * @return true if the caller is the ingest task (the update was queued, or
+ *         dropped because the queue is full); false if the caller should
+ *         apply it directly
+ */
+bool deferIngestUpdate(IngestOp op, PathId id, PathValueKind kind, SourceId source,
+                       double v0, double v1 = NAN, double v2 = NAN);
+
+/**
+ * True when a queue to the loop task is more than half full
+ * Producers that can wait (input replay) hold back instead of causing drops.
+ */
+bool ingestQueuesBusy();
+
+/**
+ * Queue an outgoing NMEA 0183 sentence (including CRLF) for the TCP server
+ * @return true if the caller is the ingest task; false if it should send directly
+ */
+bool deferNmeaOutput(const char* sentence, size_t len);
+
+/**
+ * Queue a sentence received on the loop task (TCP inputs) for parsing
+ * A sentence dropped because the queue is full counts as an overflow of port.
+ * @param sourceTag Log tag; must point to a string with static lifetime
+ * @return true if the sentence was handed to the ingest task; false if the
+ *         caller is the ingest task or it is not running
+ */
+bool deferNmeaInput(const char* sentence, size_t len, InputPort port, const char* sourceTag);
+
+/**
+ * Apply queued updates and send queued sentences
+ * Call every loop() pass, before broadcastDeltas().
+ */
+void processIngestQueues();
+
+/**
+ * Task load, stack headroom and queue statistics
+ */
+void writeIngestStats(JsonObject obj);
+
+#endif // INGEST_H
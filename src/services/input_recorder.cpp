@@ -0,0 +1,385 @@
+#include "input_recorder.h"
+#include <SPIFFS.h>
+#include <WiFi.h>
+#include <atomic>
+#include <time.h>
+
+enum RecorderState : uint8_t {
+  RECORDER_IDLE = 0,
+  RECORDER_OPENING,     // Requested; loop() opens the sink
+  RECORDER_CONNECTING,  // TCP sink connecting on the connect task
+  RECORDER_RECORDING
+};
+
+enum ConnectResult : uint8_t {
+  CONNECT_PENDING = 0,
+  CONNECT_OK,
+  CONNECT_FAILED
+};
+
+static std::atomic<uint8_t> state(RECORDER_IDLE);
+static std::atomic<bool> recording(false);      // recordInput() fast path
+static std::atomic<bool> stopRequested(false);
+static std::atomic<bool> storageMounted(false);
+static std::atomic<uint8_t> connectResult(CONNECT_PENDING);
+
+// Guards the buffer, the counters and the requested sink
+static SemaphoreHandle_t recorderLock = nullptr;
+static SemaphoreHandle_t storageLock = nullptr;  // Mounting, from the loop or ingest task
+static uint8_t buffer[INPUT_RECORDER_BUFFER_SIZE];
+static size_t bufferHead = 0;   // Next write position
+static size_t bufferTail = 0;   // Next byte to write out
+static size_t bufferCount = 0;
+static uint32_t lastRecordMicros = 0;
+static uint32_t portRecords[INPUT_PORT_COUNT];
+static uint32_t portBytes[INPUT_PORT_COUNT];
+static uint32_t droppedRecords = 0;
+
+static InputRecorderSink sinkType = RECORDER_SINK_SPIFFS;
+static String sinkTarget;
+static uint16_t sinkPort = 0;
+
+// Used by the loop task only (sinkClient by the connect task while it runs)
+static File sinkFile;
+static WiFiClient sinkClient;
+static uint32_t bytesWritten = 0;
+static uint32_t startedAt = 0;
+static uint32_t stoppedAt = 0;
+static uint32_t lastFlush = 0;
+static const char* stopReason = nullptr;  // Why the last recording ended early
+
+void initInputRecorder() {
+  if (recorderLock == nullptr) {
+    recorderLock = xSemaphoreCreateMutex();
+    storageLock = xSemaphoreCreateMutex();
+  }
+}
+
+bool mountInputLogStorage() {
+  if (storageMounted) {
+    return true;
+  }
+
+  xSemaphoreTake(storageLock, portMAX_DELAY);
+  if (!storageMounted && SPIFFS.begin(true)) {
+    storageMounted = true;
+    Serial.printf("SPIFFS mounted: %u of %u bytes used\n",
+                  (unsigned)SPIFFS.usedBytes(), (unsigned)SPIFFS.totalBytes());
+  }
+  xSemaphoreGive(storageLock);
+
+  if (!storageMounted) {
+    Serial.println("ERROR: SPIFFS mount failed");
+  }
+  return storageMounted;
+}
+
+bool startInputRecorder(InputRecorderSink sink, const String& target, uint16_t port) {
+  if (target.length() == 0 || (sink == RECORDER_SINK_TCP && port == 0)) {
+    return false;
+  }
+
+  xSemaphoreTake(recorderLock, portMAX_DELAY);
+  bool started = state == RECORDER_IDLE;
+  if (started) {
+    sinkType = sink;
+    sinkTarget = target;
+    sinkPort = port;
+    stopRequested = false;
+    state = RECORDER_OPENING;
+  }
+  xSemaphoreGive(recorderLock);
+  return started;
+}
+
+void stopInputRecorder() {
+  stopRequested = true;
+}
+
+bool isInputRecording() {
+  return recording.load(std::memory_order_relaxed);
+}
+
+bool isInputRecorderFile(const String& path) {
+  return state != RECORDER_IDLE && sinkType == RECORDER_SINK_SPIFFS && sinkTarget == path;
+}
+
+// ====== HOT PATH ======
+
+static void appendLocked(const uint8_t* data, size_t len) {
+  size_t first = INPUT_RECORDER_BUFFER_SIZE - bufferHead;
+  if (first > len) first = len;
+  memcpy(buffer + bufferHead, data, first);
+  memcpy(buffer, data + first, len - first);
+  bufferHead = (bufferHead + len) % INPUT_RECORDER_BUFFER_SIZE;
+  bufferCount += len;
+}
+
+void recordInput(InputPort port, uint8_t channel, const uint8_t* data, size_t len) {
+  if (!recording.load(std::memory_order_relaxed) || len == 0 || port >= INPUT_PORT_COUNT) {
+    return;
+  }
+
+  uint8_t record[INPUT_LOG_MAX_RECORD];
+
+  xSemaphoreTake(recorderLock, portMAX_DELAY);
+  if (recording) {  // May have stopped while waiting for the lock
+    uint32_t now = micros();
+    uint32_t delta = now - lastRecordMicros;
+    while (len > 0) {
+      size_t n = len < INPUT_LOG_MAX_PAYLOAD ? len : INPUT_LOG_MAX_PAYLOAD;
+      size_t size = encodeInputRecord(record, sizeof(record), port, channel, delta, data, n);
+      if (size > INPUT_RECORDER_BUFFER_SIZE - bufferCount) {
+        droppedRecords++;
+      } else {
+        appendLocked(record, size);
+        portRecords[port]++;
+        portBytes[port] += n;
+        // Deltas are relative to the last record kept, so a drop does
+        // not shift the timing of the rest of the log
+        lastRecordMicros = now;
+        delta = 0;
+      }
+      data += n;
+      len -= n;
+    }
+  }
+  xSemaphoreGive(recorderLock);
+}
+
+// ====== SINK ======
+
+static bool writeSink(const uint8_t* data, size_t len) {
+  size_t written = sinkType == RECORDER_SINK_SPIFFS ? sinkFile.write(data, len)
+                                                    : sinkClient.write(data, len);
+  bytesWritten += written;
+  return written == len;
+}
+
+// Write out buffered records; everything if all is set, else at most one
+// buffer's worth
+static bool flushBuffer(bool all) {
+  static uint8_t chunk[1024];
+  size_t budget = INPUT_RECORDER_BUFFER_SIZE;
+
+  for (;;) {
+    xSemaphoreTake(recorderLock, portMAX_DELAY);
+    size_t n = bufferCount < sizeof(chunk) ? bufferCount : sizeof(chunk);
+    size_t first = INPUT_RECORDER_BUFFER_SIZE - bufferTail;
+    if (first > n) first = n;
+    memcpy(chunk, buffer + bufferTail, first);
+    memcpy(chunk + first, buffer, n - first);
+    bufferTail = (bufferTail + n) % INPUT_RECORDER_BUFFER_SIZE;
+    bufferCount -= n;
+    xSemaphoreGive(recorderLock);
+
+    if (n == 0) break;
+    if (!writeSink(chunk, n)) return false;
+    if (!all && (budget -= n) < sizeof(chunk)) break;
+  }
+
+  if (sinkType == RECORDER_SINK_SPIFFS) {
+    sinkFile.flush();
+  }
+  return true;
+}
+
+static void closeSink() {
+  if (sinkType == RECORDER_SINK_SPIFFS) {
+    sinkFile.close();
+  } else {
+    sinkClient.stop();
+  }
+}
+
+static void failOpen(const char* reason) {
+  stopReason = reason;
+  Serial.printf("Recorder: %s (%s)\n", stopReason, sinkTarget.c_str());
+  stoppedAt = millis();
+  state = RECORDER_IDLE;
+}
+
+// Write the log header and let the inputs append
+static void beginRecording() {
+  uint8_t header[INPUT_LOG_HEADER_SIZE];
+  time_t now = time(nullptr);
+  writeInputLogHeader(header, now > 100000 ? (uint32_t)now : 0);
+  if (!writeSink(header, sizeof(header))) {
+    closeSink();
+    failOpen("Write failed");
+    return;
+  }
+
+  xSemaphoreTake(recorderLock, portMAX_DELAY);
+  bufferHead = bufferTail = bufferCount = 0;
+  memset(portRecords, 0, sizeof(portRecords));
+  memset(portBytes, 0, sizeof(portBytes));
+  droppedRecords = 0;
+  lastRecordMicros = micros();
+  recording = true;
+  xSemaphoreGive(recorderLock);
+
+  startedAt = lastFlush = millis();
+  state = RECORDER_RECORDING;
+  if (sinkType == RECORDER_SINK_SPIFFS) {
+    Serial.printf("Recorder: recording inputs to SPIFFS %s\n", sinkTarget.c_str());
+  } else {
+    Serial.printf("Recorder: recording inputs to %s:%u\n", sinkTarget.c_str(), sinkPort);
+  }
+}
+
+// connect() blocks for up to INPUT_RECORDER_CONNECT_MS, so it runs on a
+// task of its own; loop() picks up the result from connectResult
+static void connectTaskMain(void* arg) {
+  bool connected = sinkClient.connect(sinkTarget.c_str(), sinkPort, INPUT_RECORDER_CONNECT_MS);
+  connectResult.store(connected ? CONNECT_OK : CONNECT_FAILED, std::memory_order_release);
+  vTaskDelete(nullptr);
+}
+
+static void openSink() {
+  stopReason = nullptr;
+  bytesWritten = 0;
+
+  if (sinkType == RECORDER_SINK_TCP) {
+    connectResult.store(CONNECT_PENDING, std::memory_order_relaxed);
+    state = RECORDER_CONNECTING;
+    BaseType_t created = xTaskCreatePinnedToCore(connectTaskMain, "recorder_connect",
+                                                 INPUT_RECORDER_TASK_STACK, nullptr,
+                                                 INPUT_RECORDER_TASK_PRIORITY, nullptr,
+                                                 INPUT_RECORDER_TASK_CORE);
+    if (created != pdPASS) {
+      failOpen("Cannot start connect task");
+    }
+    return;
+  }
+
+  if (!mountInputLogStorage()) {
+    failOpen("SPIFFS mount failed");
+  } else if (!(sinkFile = SPIFFS.open(sinkTarget, FILE_WRITE))) {
+    failOpen("Cannot create file");
+  } else {
+    beginRecording();
+  }
+}
+
+static void finishConnect() {
+  uint8_t result = connectResult.load(std::memory_order_acquire);
+  if (result == CONNECT_PENDING) {
+    return;
+  }
+  if (result == CONNECT_FAILED) {
+    failOpen("TCP connect failed");
+  } else if (stopRequested) {
+    sinkClient.stop();
+    state = RECORDER_IDLE;
+  } else {
+    beginRecording();
+  }
+}
+
+static void finishRecording(const char* reason) {
+  // After the lock has been taken once with recording cleared, no input
+  // can append any more
+  xSemaphoreTake(recorderLock, portMAX_DELAY);
+  recording = false;
+  xSemaphoreGive(recorderLock);
+
+  if (reason == nullptr && !flushBuffer(true)) {
+    reason = "Write failed";
+  }
+  closeSink();
+
+  stopReason = reason;
+  stoppedAt = millis();
+  state = RECORDER_IDLE;
+  Serial.printf("Recorder: stopped after %u bytes%s%s\n", (unsigned)bytesWritten,
+                reason != nullptr ? " - " : "", reason != nullptr ? reason : "");
+}
+
+void processInputRecorder() {
+  if (state == RECORDER_OPENING) {
+    if (stopRequested) {
+      state = RECORDER_IDLE;
+      return;
+    }
+    openSink();
+    return;
+  }
+
+  if (state == RECORDER_CONNECTING) {
+    finishConnect();
+    return;
+  }
+
+  if (state != RECORDER_RECORDING) {
+    return;
+  }
+
+  if (stopRequested) {
+    finishRecording(nullptr);
+    return;
+  }
+
+  if (sinkType == RECORDER_SINK_TCP && !sinkClient.connected()) {
+    finishRecording("TCP sink disconnected");
+    return;
+  }
+
+  uint32_t now = millis();
+  if (bufferCount < INPUT_RECORDER_BUFFER_SIZE / 4 && now - lastFlush < INPUT_RECORDER_FLUSH_MS) {
+    return;
+  }
+  lastFlush = now;
+
+  if (!flushBuffer(false)) {
+    finishRecording(sinkType == RECORDER_SINK_SPIFFS ? "Write failed (SPIFFS full?)"
+                                                     : "TCP sink disconnected");
+  } else if (sinkType == RECORDER_SINK_SPIFFS && bytesWritten >= INPUT_RECORDER_MAX_FILE) {
+    finishRecording("File size limit reached");
+  }
+}
+
+// ====== STATUS ======
+
+void writeInputRecorderStatus(JsonObject obj) {
+  uint8_t current = state;
+  obj["state"] = current == RECORDER_RECORDING ? "recording"
+               : current == RECORDER_CONNECTING ? "connecting"
+               : current == RECORDER_OPENING ? "opening" : "idle";
+  obj["sink"] = sinkType == RECORDER_SINK_SPIFFS ? "spiffs" : "tcp";
+  obj["target"] = sinkTarget;
+  if (sinkType == RECORDER_SINK_TCP) {
+    obj["port"] = sinkPort;
+  }
+  obj["durationMs"] = current == RECORDER_RECORDING ? millis() - startedAt : stoppedAt - startedAt;
+  obj["bytesWritten"] = bytesWritten;
+  obj["bufferSize"] = INPUT_RECORDER_BUFFER_SIZE;
+  if (stopReason != nullptr) {
+    obj["stopReason"] = stopReason;
+  }
+
+  JsonObject ports = obj.createNestedObject("ports");
+  xSemaphoreTake(recorderLock, portMAX_DELAY);
+  obj["buffered"] = bufferCount;
+  obj["dropped"] = droppedRecords;
+  for (uint8_t p = 0; p < INPUT_PORT_COUNT; p++) {
+    JsonObject port = ports.createNestedObject(inputPortName((InputPort)p));
+    port["records"] = portRecords[p];
+    port["bytes"] = portBytes[p];
+  }
+  xSemaphoreGive(recorderLock);
+
+  // Listing needs a mounted partition; mounting is left to start requests
+  if (storageMounted) {
+    JsonObject storage = obj.createNestedObject("storage");
+    storage["totalBytes"] = SPIFFS.totalBytes();
+    storage["usedBytes"] = SPIFFS.usedBytes();
+    JsonArray files = storage.createNestedArray("files");
+    File root = SPIFFS.open("/");
+    for (File f = root.openNextFile(); f; f = root.openNextFile()) {
+      JsonObject file = files.createNestedObject();
+      file["path"] = f.path();
+      file["size"] = f.size();
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+#include "../utils/input_log.h"
+
+/**
+ * Raw input recorder
+ *
+ * Captures what every input receives - the serial ports and TCP inputs
+ * byte for byte, Seatalk datagrams and NMEA 2000 messages - with its
+ * arrival time, in the format of utils/input_log.h. The log goes to a file
+ * on SPIFFS or to a TCP sink (e.g. `nc -l 9000 > capture.bin`) and can be
+ * fed back through the parsers by services/input_replay.h.
+ *
+ * Inputs call recordInput() from whichever task reads them (ingest,
+ * AsyncTCP, loop); while nothing is being recorded that is one atomic
+ * load. Records are appended to a RAM buffer under a mutex and written out
+ * by processInputRecorder() on the loop task, so a slow flash write or TCP
+ * peer never holds up an input. A record that does not fit in the buffer
+ * is dropped and counted.
+ */
+
+/**
+ * Create the recorder's lock
+ * Call in setup() before any input is started.
+ */
+void initInputRecorder();
+
+/**
+ * Mount SPIFFS, formatting it the first time it is used
+ * Shared with the replay engine; the first format can take several seconds.
+ * @return false if the partition cannot be mounted
+ */
+bool mountInputLogStorage();
+
+enum InputRecorderSink : uint8_t {
+  RECORDER_SINK_SPIFFS = 0,  // target = file path, e.g. "/capture.bin"
+  RECORDER_SINK_TCP          // target = host, plus port
+};
+
+/**
+ * Start recording
+ * The sink is opened by the next processInputRecorder() call; a TCP sink
+ * is connected on a short-lived task so loop() does not wait for it. A
+ * failure is reported in the status.
+ * @return false if a recording is already in progress or target is empty
+ */
+bool startInputRecorder(InputRecorderSink sink, const String& target, uint16_t port = 0);
+
+/**
+ * Stop recording; buffered records are written out first
+ */
+void stopInputRecorder();
+
+/**
+ * Record bytes received on an input
+ * Longer chunks are split into INPUT_LOG_MAX_PAYLOAD byte records.
+ * Safe to call from any task.
+ */
+void recordInput(InputPort port, uint8_t channel, const uint8_t* data, size_t len);
+
+/**
+ * True while a recording is in progress
+ * Lets an input skip preparing a record (e.g. packing an N2K message)
+ * when nothing would keep it.
+ */
+bool isInputRecording();
+
+/**
+ * True while the SPIFFS file at path is being written
+ */
+bool isInputRecorderFile(const String& path);
+
+/**
+ * Open and close the sink and write out buffered records
+ * Call this in the main loop
+ */
+void processInputRecorder();
+
+/**
+ * Recorder state, per-port counters and the files on SPIFFS
+ */
+void writeInputRecorderStatus(JsonObject obj);
+
+#endif // INPUT_RECORDER_H
@@ -0,0 +1,350 @@
+#include "input_replay.h"
+#include "input_recorder.h"
+#include "ingest.h"
+#include "../hardware/nmea2000.h"
+#include "../hardware/seatalk1.h"
+#include "../utils/input_log.h"
+#include "../utils/line_assembler.h"
+#include "../utils/spsc_queue.h"
+#include <NMEA2000.h>
+#include <SPIFFS.h>
+#include <atomic>
+
+// Forward declaration for NMEA handler defined in main.cpp
+extern void handleNmeaSentence(const char* sentence, size_t len, InputPort port, const char* sourceTag);
+
+enum ReplayState : uint8_t {
+  REPLAY_IDLE = 0,
+  REPLAY_RUNNING,
+  REPLAY_FINISHED,  // Reached the end of the file
+  REPLAY_STOPPED,   // By request
+  REPLAY_FAILED
+};
+
+// Requests from the web server task, applied by the ingest task
+struct ReplayCommand {
+  bool start;
+  float speed;
+  char path[32];  // SPIFFS names are at most 31 characters
+};
+static SpscQueue<ReplayCommand, 4> commandQueue;
+
+static std::atomic<uint8_t> state(REPLAY_IDLE);
+static const char* failReason = nullptr;
+static char replayPath[32] = "";
+static float replaySpeed = 1.0f;
+
+// Counters: written by the ingest task (latency by the loop task), read
+// by the status handler
+static std::atomic<uint32_t> recordsReplayed(0);
+static std::atomic<uint32_t> bytesReplayed(0);
+static std::atomic<uint32_t> sentencesReplayed(0);
+static std::atomic<uint32_t> portRecords[INPUT_PORT_COUNT];
+static std::atomic<uint32_t> durationMs(0);
+static std::atomic<uint32_t> positionMs(0);  // Virtual clock: recorded time replayed so far
+static std::atomic<uint32_t> maxLagMicros(0);
+static std::atomic<uint32_t> latencySamples(0);
+static std::atomic<uint32_t> latencyMin(0);
+static std::atomic<uint32_t> latencyMax(0);
+static std::atomic<uint32_t> latencyAvg(0);
+static uint64_t latencySum = 0;  // Loop task only
+
+// Used by the ingest task only
+static File replayFile;
+static uint8_t readBuffer[INPUT_LOG_MAX_RECORD * 2];
+static size_t readLen = 0;
+static size_t readPos = 0;
+static InputRecord pending;
+static bool havePending = false;
+static uint64_t logMicros = 0;      // Recorded arrival time of the last injected record
+static uint64_t elapsedMicros = 0;  // Real time since the replay started
+static uint32_t lastPollMicros = 0;
+
+// One assembler per serial port and TCP connection seen in the log,
+// allocated on first use and freed when the replay ends
+static LineAssembler* assemblers[INPUT_PORT_COUNT][INPUT_LOG_CHANNELS];
+
+// ====== CONTROL ======
+
+bool startInputReplay(const String& path, float speed) {
+  if (path.length() == 0 || path.length() >= sizeof(ReplayCommand::path) || !(speed >= 0) ||
+      state == REPLAY_RUNNING || isInputRecorderFile(path)) {
+    return false;
+  }
+
+  ReplayCommand command;
+  command.start = true;
+  command.speed = speed;
+  strncpy(command.path, path.c_str(), sizeof(command.path));
+  return commandQueue.push(command);
+}
+
+void stopInputReplay() {
+  ReplayCommand command = {};
+  command.start = false;
+  commandQueue.push(command);
+}
+
+// ====== INGEST TASK ======
+
+static void freeAssemblers() {
+  for (auto& port : assemblers) {
+    for (LineAssembler*& input : port) {
+      delete input;
+      input = nullptr;
+    }
+  }
+}
+
+static void finishReplay(ReplayState result, const char* reason) {
+  replayFile.close();
+  freeAssemblers();
+  havePending = false;
+  failReason = reason;
+  positionMs = (uint32_t)(logMicros / 1000);
+  state = result;
+
+  uint32_t ms = durationMs;
+  Serial.printf("Replay: %s after %u records (%u bytes, %u ms recorded) in %u ms%s%s\n",
+                result == REPLAY_FINISHED ? "finished" : result == REPLAY_STOPPED ? "stopped" : "failed",
+                (unsigned)recordsReplayed, (unsigned)bytesReplayed, (unsigned)positionMs,
+                (unsigned)ms, reason != nullptr ? " - " : "", reason != nullptr ? reason : "");
+}
+
+static void beginReplay(const ReplayCommand& command) {
+  if (state == REPLAY_RUNNING) {
+    return;
+  }
+
+  strncpy(replayPath, command.path, sizeof(replayPath));
+  replaySpeed = command.speed;
+  recordsReplayed = 0;
+  bytesReplayed = 0;
+  sentencesReplayed = 0;
+  for (auto& count : portRecords) count = 0;
+  durationMs = 0;
+  positionMs = 0;
+  maxLagMicros = 0;
+  latencySamples = 0;
+  latencyMin = 0;
+  latencyMax = 0;
+  latencyAvg = 0;
+  readLen = readPos = 0;
+  havePending = false;
+  logMicros = elapsedMicros = 0;
+  lastPollMicros = micros();
+  state = REPLAY_RUNNING;
+
+  if (!mountInputLogStorage()) {
+    finishReplay(REPLAY_FAILED, "SPIFFS mount failed");
+    return;
+  }
+  replayFile = SPIFFS.open(replayPath, FILE_READ);
+  if (!replayFile) {
+    finishReplay(REPLAY_FAILED, "File not found");
+    return;
+  }
+
+  uint8_t header[INPUT_LOG_HEADER_SIZE];
+  if (replayFile.read(header, sizeof(header)) != sizeof(header) ||
+      !readInputLogHeader(header, sizeof(header), nullptr)) {
+    finishReplay(REPLAY_FAILED, "Not an input recording");
+    return;
+  }
+
+  if (replaySpeed > 0) {
+    Serial.printf("Replay: %s at %.1fx\n", replayPath, replaySpeed);
+  } else {
+    Serial.printf("Replay: %s at full speed\n", replayPath);
+  }
+}
+
+// Next record from the file; false at the end (or on a corrupt record,
+// which fails the replay)
+static bool readRecord(InputRecord& rec) {
+  for (;;) {
+    int used = decodeInputRecord(readBuffer + readPos, readLen - readPos, rec);
+    if (used > 0) {
+      readPos += used;
+      return true;
+    }
+    if (used < 0) {
+      finishReplay(REPLAY_FAILED, "Corrupt record");
+      return false;
+    }
+
+    // Keep the partial record and refill behind it
+    memmove(readBuffer, readBuffer + readPos, readLen - readPos);
+    readLen -= readPos;
+    readPos = 0;
+    size_t n = replayFile.read(readBuffer + readLen, sizeof(readBuffer) - readLen);
+    if (n == 0) {
+      // A recording cut off by a reset may end in a partial record
+      finishReplay(REPLAY_FINISHED, readLen > 0 ? "Truncated last record" : nullptr);
+      return false;
+    }
+    readLen += n;
+  }
+}
+
+static bool onReplaySentence(const char* line, size_t len, LineAssembler& input, void* context) {
+  sentencesReplayed++;
+  // Not logged: replay can run far above line rate. Not counted per port
+  // either, so the live input counters stay clean
+  handleNmeaSentence(line, len, INPUT_PORT_COUNT, nullptr);
+  return true;
+}
+
+static void injectN2k(const InputRecord& rec) {
+  if (rec.len < INPUT_LOG_N2K_HEADER || rec.len - INPUT_LOG_N2K_HEADER > tN2kMsg::MaxDataLen) {
+    return;
+  }
+  const uint8_t* p = rec.data;
+  tN2kMsg msg;
+  msg.Init(p[3], (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16), p[4], p[5]);
+  msg.DataLen = rec.len - INPUT_LOG_N2K_HEADER;
+  memcpy(msg.Data, p + INPUT_LOG_N2K_HEADER, msg.DataLen);
+  msg.MsgTime = millis();
+  HandleN2kMessage(msg);
+}
+
+static void inject(const InputRecord& rec) {
+  switch (rec.port) {
+    case INPUT_PORT_SEATALK:
+      if (rec.len >= 2 && rec.len <= SEATALK_MAX_MSG_LEN) {
+        decodeSeatalkMessage(makeSeatalkMessage(rec.data, rec.len));
+      }
+      break;
+    case INPUT_PORT_N2K:
+      injectN2k(rec);
+      break;
+    default: {
+      LineAssembler*& input = assemblers[rec.port][rec.channel];
+      if (input == nullptr) {
+        input = new LineAssembler(inputPortName(rec.port));
+      }
+      input->feed(rec.data, rec.len, onReplaySentence);
+      break;
+    }
+  }
+
+  recordsReplayed++;
+  bytesReplayed += rec.len;
+  portRecords[rec.port]++;
+}
+
+static void applyCommands() {
+  ReplayCommand command;
+  while (commandQueue.pop(command)) {
+    if (command.start) {
+      beginReplay(command);
+    } else if (state == REPLAY_RUNNING) {
+      finishReplay(REPLAY_STOPPED, nullptr);
+    }
+  }
+}
+
+void pollInputReplay() {
+  applyCommands();
+  if (state != REPLAY_RUNNING) {
+    return;
+  }
+
+  uint32_t now = micros();
+  elapsedMicros += now - lastPollMicros;
+  lastPollMicros = now;
+  durationMs = (uint32_t)(elapsedMicros / 1000);
+
+  uint32_t firstInjected = 0;
+  size_t injected = 0;
+  while (injected < INPUT_REPLAY_RECORDS_PER_POLL && !ingestQueuesBusy()) {
+    if (!havePending) {
+      if (!readRecord(pending)) break;
+      havePending = true;
+    }
+
+    // Virtual clock: the record is due once speed x real time has caught
+    // up with its recorded arrival time
+    uint64_t recordMicros = logMicros + pending.deltaMicros;
+    if (replaySpeed > 0) {
+      uint64_t due = (uint64_t)(recordMicros / replaySpeed);
+      if (due > elapsedMicros) break;
+      uint64_t lag = elapsedMicros - due;
+      if (lag > maxLagMicros) maxLagMicros = lag > UINT32_MAX ? UINT32_MAX : (uint32_t)lag;
+    }
+
+    if (injected++ == 0) {
+      firstInjected = micros();
+    }
+    inject(pending);
+    havePending = false;
+    logMicros = recordMicros;
+  }
+  positionMs = (uint32_t)(logMicros / 1000);
+
+  // Marks the end of this batch in the update queue; the loop task reports
+  // back when it gets there
+  if (injected > 0 &&
+      !deferIngestUpdate(INGEST_REPLAY_MARK, INVALID_PATH_ID, PV_NONE, INVALID_SOURCE_ID,
+                         firstInjected)) {
+    noteInputReplayApplied(firstInjected);  // No ingest task: already applied
+  }
+}
+
+// ====== LOOP TASK ======
+
+void noteInputReplayApplied(uint32_t injectedMicros) {
+  uint32_t latency = micros() - injectedMicros;
+  uint32_t samples = latencySamples;
+  if (samples == 0) {
+    latencySum = 0;
+    latencyMin = latency;
+    latencyMax = latency;
+  } else {
+    if (latency < latencyMin) latencyMin = latency;
+    if (latency > latencyMax) latencyMax = latency;
+  }
+  latencySum += latency;
+  latencySamples = ++samples;
+  latencyAvg = (uint32_t)(latencySum / samples);
+}
+
+// ====== STATUS ======
+
+void writeInputReplayStatus(JsonObject obj) {
+  static const char* const stateNames[] = {"idle", "running", "finished", "stopped", "failed"};
+  uint8_t current = state;
+  obj["state"] = stateNames[current];
+  if (current == REPLAY_IDLE) {
+    return;
+  }
+
+  obj["file"] = replayPath;
+  obj["speed"] = replaySpeed;
+  if (failReason != nullptr && current != REPLAY_RUNNING) {
+    obj["error"] = failReason;
+  }
+
+  uint32_t records = recordsReplayed;
+  uint32_t bytes = bytesReplayed;
+  uint32_t ms = durationMs;
+  obj["records"] = records;
+  obj["bytes"] = bytes;
+  obj["sentences"] = sentencesReplayed.load();
+  obj["durationMs"] = ms;
+  obj["virtualTimeMs"] = positionMs.load();
+  obj["recordsPerSecond"] = ms > 0 ? (uint32_t)((uint64_t)records * 1000 / ms) : 0;
+  obj["bytesPerSecond"] = ms > 0 ? (uint32_t)((uint64_t)bytes * 1000 / ms) : 0;
+  obj["maxLagMicros"] = maxLagMicros.load();
+
+  JsonObject latency = obj.createNestedObject("latencyMicros");
+  latency["samples"] = latencySamples.load();
+  latency["min"] = latencyMin.load();
+  latency["avg"] = latencyAvg.load();
+  latency["max"] = latencyMax.load();
+
+  JsonObject ports = obj.createNestedObject("ports");
+  for (uint8_t p = 0; p < INPUT_PORT_COUNT; p++) {
+    ports[inputPortName((InputPort)p)] = portRecords[p].load();
+  }
+}
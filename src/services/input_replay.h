@@ -0,0 +1,56 @@
+#ifndef INPUT_REPLAY_H
+#define INPUT_REPLAY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config.h"
+
+/**
+ * Raw input replay
+ *
+ * Feeds a recording made by services/input_recorder.h back through the
+ * entry points the live inputs use: serial and TCP bytes through a
+ * LineAssembler into handleNmeaSentence(), NMEA 2000 messages through
+ * HandleN2kMessage() and Seatalk datagrams through decodeSeatalkMessage().
+ * It runs on the ingest task next to the live inputs, so the parsed
+ * updates reach the data store, alarms and TCP clients the same way.
+ *
+ * A virtual clock maps the recorded arrival times onto the replay: speed 1
+ * keeps the original timing, N runs N times faster and 0 as fast as the
+ * loop task can apply the updates (the replay waits while the ingest
+ * queues are more than half full rather than have them drop). Throughput
+ * and end-to-end latency - from injecting a record to the loop task
+ * applying what it produced - are reported in the status.
+ */
+
+/**
+ * Start replaying a SPIFFS file
+ * @param speed Playback speed; 0 = as fast as possible
+ * @return false if a replay is already running, the file is being recorded
+ *         or the arguments are invalid
+ */
+bool startInputReplay(const String& path, float speed);
+
+/**
+ * Stop the running replay
+ */
+void stopInputReplay();
+
+/**
+ * Inject the records that are due
+ * Called from the ingest task's input poll.
+ */
+void pollInputReplay();
+
+/**
+ * The loop task applied the updates of records injected at injectedMicros
+ * Called by processIngestQueues().
+ */
+void noteInputReplayApplied(uint32_t injectedMicros);
+
+/**
+ * Replay state, throughput and latency
+ */
+void writeInputReplayStatus(JsonObject obj);
+
+#endif // INPUT_REPLAY_H
@@ -0,0 +1,155 @@
+#include "metrics.h"
+#include "nmea0183_tcp.h"
+#include "websocket.h"
+#include "../hardware/nmea0183.h"
+#include "../hardware/nmea2000.h"
+#include "../hardware/seatalk1.h"
+#include "../signalk/data_store.h"
+#include "../utils/input_stats.h"
+
+// ====== FORMAT ======
+
+static void writeFamily(Print& out, const char* name, const char* type, const char* help) {
+  out.printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void writeSample(Print& out, const char* name, uint32_t value) {
+  out.printf("%s %u\n", name, (unsigned)value);
+}
+
+static void writeSample(Print& out, const char* name, const char* label, const char* labelValue,
+                        uint32_t value) {
+  out.printf("%s{%s=\"%s\"} %u\n", name, label, labelValue, (unsigned)value);
+}
+
+static void writeGauge(Print& out, const char* name, const char* help, uint32_t value) {
+  writeFamily(out, name, "gauge", help);
+  writeSample(out, name, value);
+}
+
+static void writeCounter(Print& out, const char* name, const char* help, uint32_t value) {
+  writeFamily(out, name, "counter", help);
+  writeSample(out, name, value);
+}
+
+// ====== INPUTS ======
+
+static void writeInputMetrics(Print& out) {
+  static const char* const help[INPUT_COUNTER_COUNT] = {
+    "Raw bytes received per input.",
+    "Sentences parsed, NMEA 2000 messages or Seatalk datagrams received per input.",
+    "Sentences with a wrong checksum per input (parsed anyway).",
+    "Input lost to a full buffer or queue, or too long to keep, per input.",
+    "Line noise, malformed sentences and cut-off datagrams per input.",
+  };
+
+  char name[48];
+  for (uint8_t c = 0; c < INPUT_COUNTER_COUNT; c++) {
+    snprintf(name, sizeof(name), "signalk_input_%s_total", inputCounterName((InputCounter)c));
+    writeFamily(out, name, "counter", help[c]);
+    for (uint8_t p = 0; p < INPUT_PORT_COUNT; p++) {
+      writeSample(out, name, "port", inputPortName((InputPort)p), inputStats[p].get((InputCounter)c));
+    }
+  }
+}
+
+static void writeNmea0183Metrics(Print& out) {
+  std::vector<NmeaSentenceStats> sentences = getNMEA0183SentenceStats();
+
+  writeFamily(out, "signalk_nmea0183_sentences_total", "counter",
+              "NMEA 0183 sentences parsed per sentence type (other = no handler).");
+  for (const NmeaSentenceStats& s : sentences) {
+    writeSample(out, "signalk_nmea0183_sentences_total", "type",
+                s.formatter[0] ? s.formatter : "other", s.received);
+  }
+
+  writeFamily(out, "signalk_nmea0183_checksum_errors_total", "counter",
+              "NMEA 0183 sentences with a wrong checksum per sentence type.");
+  for (const NmeaSentenceStats& s : sentences) {
+    writeSample(out, "signalk_nmea0183_checksum_errors_total", "type",
+                s.formatter[0] ? s.formatter : "other", s.checksumErrors);
+  }
+
+  writeFamily(out, "signalk_nmea0183_parse_errors_total", "counter",
+              "NMEA 0183 sentences with too few fields per sentence type.");
+  for (const NmeaSentenceStats& s : sentences) {
+    if (s.formatter[0]) {
+      writeSample(out, "signalk_nmea0183_parse_errors_total", "type", s.formatter, s.parseErrors);
+    }
+  }
+}
+
+static void writeN2kMetrics(Print& out) {
+  std::vector<N2kPgnStats> pgns = getN2kPgnStats();
+  char pgn[12];
+
+  writeFamily(out, "signalk_n2k_messages_total", "counter",
+              "NMEA 2000 messages received per PGN (other = no handler).");
+  for (const N2kPgnStats& s : pgns) {
+    snprintf(pgn, sizeof(pgn), "%u", (unsigned)s.pgn);
+    writeSample(out, "signalk_n2k_messages_total", "pgn", s.pgn != 0 ? pgn : "other", s.received);
+  }
+
+  writeFamily(out, "signalk_n2k_parse_errors_total", "counter",
+              "NMEA 2000 messages that could not be parsed per PGN.");
+  for (const N2kPgnStats& s : pgns) {
+    if (s.pgn != 0) {
+      snprintf(pgn, sizeof(pgn), "%u", (unsigned)s.pgn);
+      writeSample(out, "signalk_n2k_parse_errors_total", "pgn", pgn, s.parseErrors);
+    }
+  }
+}
+
+static void writeSeatalkMetrics(Print& out) {
+  SeatalkStats seatalk = getSeatalk1Stats();
+  writeCounter(out, "signalk_seatalk_datagrams_received_total",
+               "Complete Seatalk 1 datagrams read from the bus.", seatalk.messagesReceived);
+  writeCounter(out, "signalk_seatalk_datagrams_decoded_total",
+               "Seatalk 1 datagrams decoded.", seatalk.messagesDecoded);
+  writeCounter(out, "signalk_seatalk_parity_errors_total",
+               "Seatalk 1 parity errors.", seatalk.parityErrors);
+}
+
+// ====== OUTPUTS ======
+
+static void writeOutputMetrics(Print& out) {
+  writeGauge(out, "signalk_data_store_paths", "Registered SignalK paths.", getPathCount());
+  writeGauge(out, "signalk_data_store_capacity", "Maximum number of SignalK paths.", MAX_SIGNALK_PATHS);
+  writeCounter(out, "signalk_data_store_coalesced_updates_total",
+               "Path updates overwritten before they were broadcast.", getTotalCoalescedUpdates());
+  writeCounter(out, "signalk_data_store_dropped_writes_total",
+               "Updates from other tasks dropped because the queue was full.", getDroppedStoreWrites());
+
+  DeltaStats deltas = getDeltaStats();
+  writeCounter(out, "signalk_delta_path_changes_total",
+               "Changed paths picked up for WebSocket deltas.", deltas.pathChanges);
+  writeGauge(out, "signalk_delta_paths_per_second",
+             "Changed paths per second over the last full second.", deltas.pathsPerSecond);
+  writeCounter(out, "signalk_websocket_messages_sent_total",
+               "Messages queued to WebSocket clients.", deltas.messagesSent);
+  writeCounter(out, "signalk_websocket_messages_dropped_total",
+               "Messages held back from busy WebSocket clients.", deltas.messagesDropped);
+
+  writeGauge(out, "signalk_websocket_clients", "Connected WebSocket clients.", ws.count());
+  writeGauge(out, "signalk_nmea0183_tcp_clients", "Connected NMEA 0183 TCP clients.",
+             getNMEA0183ClientCount());
+}
+
+// ====== SYSTEM ======
+
+static void writeSystemMetrics(Print& out) {
+  writeGauge(out, "signalk_heap_free_bytes", "Free heap.", ESP.getFreeHeap());
+  writeGauge(out, "signalk_heap_min_free_bytes", "Lowest free heap since boot.", ESP.getMinFreeHeap());
+  writeGauge(out, "signalk_heap_largest_free_block_bytes", "Largest block that can be allocated.",
+             ESP.getMaxAllocHeap());
+  writeGauge(out, "signalk_uptime_seconds", "Seconds since boot.", millis() / 1000);
+}
+
+void writeMetrics(Print& out) {
+  writeInputMetrics(out);
+  writeNmea0183Metrics(out);
+  writeN2kMetrics(out);
+  writeSeatalkMetrics(out);
+  writeOutputMetrics(out);
+  writeSystemMetrics(out);
+}
@@ -0,0 +1,35 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+/**
+ * Prometheus metrics
+ *
+ * Renders the gateway's counters in the Prometheus text exposition format
+ * (version 0.0.4), served at GET /metrics:
+ *
+ * - per input port (utils/input_stats.h): bytes, sentences, checksum
+ *   failures, buffer/queue overflows and parse errors
+ * - per NMEA 0183 sentence type and NMEA 2000 PGN: received, checksum
+ *   failures and parse errors (these include replayed input)
+ * - Seatalk datagram and parity counters
+ * - data store size, delta throughput, WebSocket and TCP client counts
+ * - free heap and largest free block
+ *
+ * Everything is read from counters the inputs keep anyway (relaxed atomics
+ * or loop-task totals), so a scrape takes no lock the inputs wait on.
+ * Counters are totals since boot; rates are left to the scraper
+ * (rate(signalk_input_bytes_total[1m])).
+ */
+
+// Content type of the exposition format
+#define METRICS_CONTENT_TYPE "text/plain; version=0.0.4; charset=utf-8"
+
+/**
+ * Write every metric to out
+ * Call from the web server task (reads the WebSocket and TCP client lists).
+ */
+void writeMetrics(Print& out);
+
+#endif // METRICS_H
@@ -1,44 +1,238 @@
 #include "nmea0183_tcp.h"
-#include "../config.h"
+#include "ingest.h"
+#include "input_recorder.h"
+#include "../utils/line_assembler.h"
+#include "../utils/broadcast_ring.h"
+#include "../utils/object_pool.h"
+#include "../utils/spsc_queue.h"
+#include <AsyncTCP.h>
+#include <atomic>
 
 // Forward declaration for NMEA handler defined in main.cpp
-extern void handleNmeaSentence(const String& sentence, const char* sourceTag);
+extern void handleNmeaSentence(const char* sentence, size_t len, InputPort port, const char* sourceTag);
+
+// Each client's input is recorded under its pool slot
+static_assert(MAX_NMEA_CLIENTS <= INPUT_LOG_CHANNELS, "input log channel per TCP client");
 
 // TCP Server instance
-static WiFiServer nmeaServer(NMEA_TCP_PORT);
+static AsyncServer nmeaServer(NMEA_TCP_PORT);
+
+static const char* INPUT_SOURCE_TAG = "NMEA TCP Input";
 
-// Client management
+// Per-connection state, taken from connectionPool when a client connects
+// and returned when it disconnects. Fields marked (async) are only used by
+// the AsyncTCP callbacks; the rest are guarded by poolLock.
 struct NMEAClient {
-  WiFiClient client;
-  uint32_t lastActivity;
-  bool active;
-  bool allowSend;
-  uint16_t sentenceCount;
-  uint32_t sentenceWindowStart;
-  String rxBuffer;
+  AsyncClient* client;
+  std::atomic<bool> allowSend;
+  bool attached;                // out positioned in txRing yet
+  bool dropRequested;           // (async) close on the next poll
+  uint32_t lastActivity;        // (async) last data or ACK received
+  uint16_t sentenceCount;       // (async)
+  uint32_t sentenceWindowStart; // (async)
+  LineAssembler input{INPUT_SOURCE_TAG, INPUT_PORT_TCP_SERVER};  // (async)
+  BroadcastCursor out;          // Position in txRing and delivery counters
+  String remoteIp;
+  uint32_t connectedAt;
+  uint32_t rateWindowStart;     // Throughput over the last full second
+  uint32_t rateWindowBytes;
+  uint32_t bytesPerSecond;
+  uint32_t lastDropReport;
 };
 
-static NMEAClient clients[MAX_NMEA_CLIENTS];
+static ObjectPool<NMEAClient, MAX_NMEA_CLIENTS> connectionPool;
+static SemaphoreHandle_t poolLock = nullptr;  // Recursive: close() may disconnect synchronously
 static bool serverStarted = false;
-static const char* INPUT_SOURCE_TAG = "NMEA TCP Input";
+
+// Outbound data is written once and drained per client from loop(); see
+// flushClient()
+static BroadcastRing<NMEA_TX_RING_SIZE, NMEA_TX_RING_SENTENCES> txRing;
+static uint32_t flushedSentences = 0;        // txRing.sentencesWritten() at the last flush
+static std::atomic<bool> sendReady(false);   // A client connected or had data acknowledged
+
+// Sentences received from clients (mock feeds), AsyncTCP task -> loop
+struct ReceivedSentence {
+  uint8_t len;
+  char text[NMEA_MAX_SENTENCE_LENGTH + 1];
+};
+static SpscQueue<ReceivedSentence, NMEA_TCP_INPUT_QUEUE_SIZE> receivedQueue;
+
+// ====== ASYNCTCP CALLBACKS ======
+
+// Inbound sentence from a client; enforces the per-client rate limit
+static bool onClientSentence(const char* line, size_t len, LineAssembler& input, void* context) {
+  NMEAClient& c = *static_cast<NMEAClient*>(context);
+  uint32_t now = millis();
+
+  if (now - c.sentenceWindowStart > 1000) {
+    c.sentenceWindowStart = now;
+    c.sentenceCount = 0;
+  }
+
+  if (c.sentenceCount >= MAX_SENTENCES_PER_SECOND) {
+    // Closed from the poll callback: the client must not be deleted inside its own data callback
+    Serial.printf("NMEA TCP: Client [%u] exceeded rate limit, disconnecting\n",
+                  (unsigned)connectionPool.indexOf(&c));
+    c.dropRequested = true;
+    return false;
+  }
+
+  c.sentenceCount++;
+  c.allowSend = false;  // Don't echo data back to this client
+
+  ReceivedSentence item;
+  item.len = (uint8_t)len;
+  memcpy(item.text, line, len + 1);
+  if (!receivedQueue.push(item)) {  // When full the sentence is dropped and counted
+    countInput(INPUT_PORT_TCP_SERVER, INPUT_OVERFLOWS);
+  }
+  return true;
+}
+
+static void onClientData(void* arg, AsyncClient* client, void* data, size_t len) {
+  NMEAClient& c = *static_cast<NMEAClient*>(arg);
+  if (c.dropRequested) return;
+
+  c.lastActivity = millis();
+  recordInput(INPUT_PORT_TCP_SERVER, (uint8_t)connectionPool.indexOf(&c),
+              static_cast<const uint8_t*>(data), len);
+  c.input.feed(static_cast<const uint8_t*>(data), len, onClientSentence, &c);
+}
+
+static void onClientAck(void* arg, AsyncClient* client, size_t len, uint32_t time) {
+  NMEAClient& c = *static_cast<NMEAClient*>(arg);
+  c.lastActivity = millis();
+  sendReady = true;  // Room in the send buffer; loop() resumes any backlog
+}
+
+static void onClientPoll(void* arg, AsyncClient* client) {
+  NMEAClient& c = *static_cast<NMEAClient*>(arg);
+  if (c.dropRequested) {
+    client->close(true);
+  } else if (millis() - c.lastActivity > CLIENT_TIMEOUT_MS) {
+    Serial.printf("NMEA TCP: Client [%u] timeout, disconnecting\n",
+                  (unsigned)connectionPool.indexOf(&c));
+    client->close(true);
+  }
+}
+
+static void onClientDisconnect(void* arg, AsyncClient* client) {
+  NMEAClient* c = static_cast<NMEAClient*>(arg);
+
+  xSemaphoreTakeRecursive(poolLock, portMAX_DELAY);
+  Serial.printf("NMEA TCP: Client [%u] disconnected\n", (unsigned)connectionPool.indexOf(c));
+  c->client = nullptr;
+  connectionPool.release(c);
+  xSemaphoreGiveRecursive(poolLock);
+
+  delete client;
+}
+
+static void onNewClient(void* arg, AsyncClient* client) {
+  uint32_t now = millis();
+
+  xSemaphoreTakeRecursive(poolLock, portMAX_DELAY);
+  NMEAClient* c = connectionPool.acquire();
+  if (c == nullptr) {
+    xSemaphoreGiveRecursive(poolLock);
+    Serial.println("NMEA TCP: Max clients reached, rejecting connection");
+    client->onDisconnect([](void* arg, AsyncClient* rejected) { delete rejected; }, nullptr);
+    client->close(true);
+    return;
+  }
+
+  c->client = client;
+  c->allowSend = true;
+  c->attached = false;  // Done by loop(), which owns txRing
+  c->dropRequested = false;
+  c->lastActivity = now;
+  c->sentenceCount = 0;
+  c->sentenceWindowStart = now;
+  c->input.reset();
+  c->out = BroadcastCursor();
+  c->remoteIp = client->remoteIP().toString();
+  c->connectedAt = now;
+  c->rateWindowStart = now;
+  c->rateWindowBytes = 0;
+  c->bytesPerSecond = 0;
+  c->lastDropReport = 0;
+  size_t inUse = connectionPool.size();
+  xSemaphoreGiveRecursive(poolLock);
+
+  client->setNoDelay(true);  // Disable Nagle algorithm for low latency
+  client->onData(onClientData, c);
+  client->onAck(onClientAck, c);
+  client->onPoll(onClientPoll, c);
+  client->onDisconnect(onClientDisconnect, c);
+  sendReady = true;
+
+  Serial.printf("NMEA TCP: New client [%u] connected from %s (%u/%d)\n",
+                (unsigned)connectionPool.indexOf(c), c->remoteIp.c_str(),
+                (unsigned)inUse, MAX_NMEA_CLIENTS);
+}
+
+// ====== LOOP SIDE ======
+
+// Queue as much of the client's backlog as its send buffer has room for;
+// the rest goes out after the next ACK. Call with poolLock held.
+static void flushClient(NMEAClient& c, uint32_t now) {
+  if (!c.attached) {
+    txRing.attach(c.out);
+    c.attached = true;
+  }
+  if (!c.allowSend) {
+    txRing.skipAll(c.out);
+    return;
+  }
+
+  uint32_t dropped = c.out.sentencesDropped;
+  size_t queuedTotal = 0;
+
+  // At most two chunks: the backlog may wrap around the end of the ring
+  for (int chunk = 0; chunk < 2; chunk++) {
+    const uint8_t* data;
+    size_t len = txRing.pending(c.out, &data);
+    if (len == 0) break;
+
+    size_t room = c.client->space();
+    if (room == 0) break;  // Send buffer full; the client is reading slowly
+
+    size_t queued = c.client->add(reinterpret_cast<const char*>(data), len < room ? len : room,
+                                  ASYNC_WRITE_FLAG_COPY);
+    if (queued == 0) break;
+    txRing.consume(c.out, queued, micros());
+    queuedTotal += queued;
+    if (queued < len) break;
+  }
+  if (queuedTotal > 0) {
+    c.client->send();
+  }
+
+  if (c.out.sentencesDropped != dropped && now - c.lastDropReport > 10000) {
+    c.lastDropReport = now;
+    Serial.printf("NMEA TCP: Client [%u] too slow, %u sentences dropped so far\n",
+                  (unsigned)connectionPool.indexOf(&c), (unsigned)c.out.sentencesDropped);
+  }
+
+  if (now - c.rateWindowStart >= 1000) {
+    c.bytesPerSecond = (uint32_t)((uint64_t)(c.out.bytesSent - c.rateWindowBytes) * 1000 /
+                                  (now - c.rateWindowStart));
+    c.rateWindowBytes = c.out.bytesSent;
+    c.rateWindowStart = now;
+  }
+}
 
 // Initialize NMEA 0183 TCP server
 void initNMEA0183Server() {
   Serial.println("\n=== Initializing NMEA 0183 TCP Server ===");
 
-  // Initialize client array
-  for (int i = 0; i < MAX_NMEA_CLIENTS; i++) {
-    clients[i].active = false;
-    clients[i].lastActivity = 0;
-    clients[i].allowSend = true;
-    clients[i].sentenceCount = 0;
-    clients[i].sentenceWindowStart = 0;
-    clients[i].rxBuffer = "";
+  if (poolLock == nullptr) {
+    poolLock = xSemaphoreCreateRecursiveMutex();
   }
 
-  // Start TCP server
-  nmeaServer.begin();
+  nmeaServer.onClient(onNewClient, nullptr);
   nmeaServer.setNoDelay(true);  // Disable Nagle algorithm for low latency
+  nmeaServer.begin();
 
   serverStarted = true;
 
@@ -48,148 +242,81 @@ void initNMEA0183Server() {
   Serial.println("======================================\n");
 }
 
-// Process TCP server - accept new clients and handle disconnections
+// Hand received sentences to the parser and send queued output. Returns
+// straight away when nothing was broadcast or acknowledged since last time,
+// however many clients are connected.
 void processNMEA0183Server() {
   if (!serverStarted) return;
 
-  uint32_t now = millis();
+  ReceivedSentence sentence;
+  while (receivedQueue.pop(sentence)) {
+    handleNmeaSentence(sentence.text, sentence.len, INPUT_PORT_TCP_SERVER, INPUT_SOURCE_TAG);
+  }
 
-  // Check for new client connections
-  WiFiClient newClient = nmeaServer.available();
-  if (newClient) {
-    // Find free slot
-    int freeSlot = -1;
-    for (int i = 0; i < MAX_NMEA_CLIENTS; i++) {
-      if (!clients[i].active) {
-        freeSlot = i;
-        break;
-      }
-    }
-
-    if (freeSlot >= 0) {
-      clients[freeSlot].client = newClient;
-      clients[freeSlot].client.setNoDelay(true);
-      clients[freeSlot].lastActivity = now;
-      clients[freeSlot].active = true;
-      clients[freeSlot].allowSend = true;
-      clients[freeSlot].sentenceCount = 0;
-      clients[freeSlot].sentenceWindowStart = now;
-      clients[freeSlot].rxBuffer = "";
-
-      Serial.printf("NMEA TCP: New client [%d] connected from %s\n",
-                    freeSlot, newClient.remoteIP().toString().c_str());
-    } else {
-      // No free slots - reject connection
-      Serial.println("NMEA TCP: Max clients reached, rejecting connection");
-      newClient.stop();
-    }
-  }
-
-  // Check existing clients for disconnections and timeouts
-  for (int i = 0; i < MAX_NMEA_CLIENTS; i++) {
-    if (!clients[i].active) continue;
-
-    // Check if client is still connected
-    if (!clients[i].client.connected()) {
-      Serial.printf("NMEA TCP: Client [%d] disconnected\n", i);
-      clients[i].client.stop();
-      clients[i].active = false;
-      continue;
-    }
-
-    // Process inbound data (for mock feeds)
-    bool hadData = false;
-    while (clients[i].client.available()) {
-      hadData = true;
-      clients[i].lastActivity = now;
-
-      char c = clients[i].client.read();
-      if (c == '\n' || c == '\r') {
-        if (clients[i].rxBuffer.length() > 6 && clients[i].rxBuffer[0] == '$') {
-          if (now - clients[i].sentenceWindowStart > 1000) {
-            clients[i].sentenceWindowStart = now;
-            clients[i].sentenceCount = 0;
-          }
-
-          if (clients[i].sentenceCount >= MAX_SENTENCES_PER_SECOND) {
-            Serial.printf("NMEA TCP: Client [%d] exceeded rate limit, disconnecting\n", i);
-            clients[i].client.stop();
-            clients[i].active = false;
-            clients[i].rxBuffer = "";
-            break;
-          }
-
-          clients[i].sentenceCount++;
-          clients[i].allowSend = false;  // Don't echo data back to this client
-          handleNmeaSentence(clients[i].rxBuffer, INPUT_SOURCE_TAG);
-          yield();
-        }
-        clients[i].rxBuffer = "";
-      } else if (c >= 32 && c <= 126) {
-        if (clients[i].rxBuffer.length() < 120) {
-          clients[i].rxBuffer += c;
-        } else {
-          clients[i].rxBuffer = "";
-          Serial.printf("NMEA TCP: Client [%d] payload overflow, resetting buffer\n", i);
-        }
-      }
-    }
-
-    if (!hadData && (now - clients[i].lastActivity > CLIENT_TIMEOUT_MS)) {
-      Serial.printf("NMEA TCP: Client [%d] timeout, disconnecting\n", i);
-      clients[i].client.stop();
-      clients[i].active = false;
-      continue;
-    }
+  bool acked = sendReady.exchange(false);
+  if (txRing.sentencesWritten() == flushedSentences && !acked) {
+    return;
   }
+  flushedSentences = txRing.sentencesWritten();
+
+  uint32_t now = millis();
+  xSemaphoreTakeRecursive(poolLock, portMAX_DELAY);
+  for (size_t i = connectionPool.size(); i-- > 0;) {
+    flushClient(connectionPool.at(i), now);
+  }
+  xSemaphoreGiveRecursive(poolLock);
 }
 
 // Broadcast NMEA 0183 sentence to all connected clients
 void broadcastNMEA0183(const String& sentence) {
-  if (!serverStarted || sentence.length() == 0) return;
+  broadcastNMEA0183(sentence.c_str(), sentence.length());
+}
+
+void broadcastNMEA0183(const char* sentence, size_t len) {
+  if (!serverStarted || len == 0) return;
+
+  // Sockets are only written from the loop task
+  if (deferNmeaOutput(sentence, len)) return;
+
+  // Queued once for all clients; processNMEA0183Server() sends it
+  txRing.append(sentence, len, micros());
+}
+
+// Per-client delivery counters
+std::vector<NMEA0183ClientStats> getNMEA0183ClientStats() {
+  std::vector<NMEA0183ClientStats> result;
+  if (!serverStarted) return result;
 
   uint32_t now = millis();
-  int sentCount = 0;
-
-  for (int i = 0; i < MAX_NMEA_CLIENTS; i++) {
-    if (!clients[i].active || !clients[i].allowSend) continue;
-
-    if (clients[i].client.connected()) {
-      // Try to send
-      size_t written = clients[i].client.write(sentence.c_str(), sentence.length());
-
-      if (written == sentence.length()) {
-        clients[i].lastActivity = now;
-        sentCount++;
-      } else {
-        // Write failed - mark for disconnect
-        Serial.printf("NMEA TCP: Client [%d] write failed, disconnecting\n", i);
-        clients[i].client.stop();
-        clients[i].active = false;
-      }
-    } else {
-      // Not connected anymore
-      clients[i].client.stop();
-      clients[i].active = false;
-    }
-  }
-
-  // Debug output (throttled)
-  static uint32_t lastDebug = 0;
-  if (sentCount > 0 && (now - lastDebug > 10000)) {
-    lastDebug = now;
-    Serial.printf("NMEA TCP: Broadcasting to %d clients\n", sentCount);
+  xSemaphoreTakeRecursive(poolLock, portMAX_DELAY);
+  result.reserve(connectionPool.size());
+  for (size_t i = 0; i < connectionPool.size(); i++) {
+    const NMEAClient& c = connectionPool.at(i);
+    NMEA0183ClientStats s;
+    s.slot = (uint16_t)connectionPool.indexOf(&c);
+    s.remoteIp = c.remoteIp;
+    s.connectedMs = now - c.connectedAt;
+    s.receiving = c.allowSend;
+    s.bytesSent = c.out.bytesSent;
+    s.bytesPerSecond = now - c.rateWindowStart > 2000 ? 0 : c.bytesPerSecond;  // Nothing sent lately
+    s.sentencesSent = c.out.sentencesSent;
+    s.sentencesDropped = c.out.sentencesDropped;
+    s.backlogBytes = c.attached ? txRing.backlog(c.out) : 0;
+    s.latencyAvgUs = c.out.latencyAvgUs;
+    s.latencyMaxUs = c.out.latencyMaxUs;
+    result.push_back(s);
   }
+  xSemaphoreGiveRecursive(poolLock);
+  return result;
 }
 
 // Get number of connected clients
 int getNMEA0183ClientCount() {
-  int count = 0;
-  for (int i = 0; i < MAX_NMEA_CLIENTS; i++) {
-    if (clients[i].active && clients[i].client.connected()) {
-      count++;
-    }
-  }
+  if (!serverStarted) return 0;
+
+  xSemaphoreTakeRecursive(poolLock, portMAX_DELAY);
+  int count = (int)connectionPool.size();
+  xSemaphoreGiveRecursive(poolLock);
   return count;
 }
 
@@ -199,20 +326,18 @@ void stopNMEA0183Server() {
 
   Serial.println("NMEA TCP: Stopping server...");
 
-  // Disconnect all clients
-  for (int i = 0; i < MAX_NMEA_CLIENTS; i++) {
-    if (clients[i].active) {
-      clients[i].client.stop();
-      clients[i].active = false;
-    }
-    clients[i].allowSend = true;
-    clients[i].sentenceCount = 0;
-    clients[i].sentenceWindowStart = 0;
-    clients[i].rxBuffer = "";
+  // Disconnect all clients; each one returns its slot from onClientDisconnect
+  xSemaphoreTakeRecursive(poolLock, portMAX_DELAY);
+  for (size_t i = connectionPool.size(); i-- > 0;) {
+    connectionPool.at(i).client->close(true);
   }
+  xSemaphoreGiveRecursive(poolLock);
 
-  nmeaServer.stop();
+  nmeaServer.end();
   serverStarted = false;
 
+  ReceivedSentence discarded;
+  while (receivedQueue.pop(discarded)) {}
+
   Serial.println("NMEA TCP: Server stopped");
 }
@@ -2,36 +2,46 @@
 #define NMEA0183_TCP_H
 
 #include <Arduino.h>
-#include <WiFi.h>
 #include <vector>
+#include "../config.h"
 
 /**
  * NMEA 0183 TCP Server
  *
  * Broadcasts NMEA 0183 sentences over TCP on port 10110
- * Supports multiple simultaneous clients
+ * Supports up to MAX_NMEA_CLIENTS simultaneous clients
+ *
+ * Event driven (AsyncTCP): connections, received data and acknowledged
+ * sends arrive as callbacks on the AsyncTCP task, and per-connection state
+ * comes from a fixed pool. loop() only does work when there is something
+ * to send, so idle clients cost nothing per iteration.
  */
 
-// TCP Server port (standard NMEA 0183 TCP port)
-#define NMEA_TCP_PORT 10110
-
-// Maximum number of simultaneous clients
-#define MAX_NMEA_CLIENTS 8
-
-// Client timeout in milliseconds
-#define CLIENT_TIMEOUT_MS 30000
-
-// Buffer size per client
-#define CLIENT_BUFFER_SIZE 512
+/**
+ * Delivery counters for one connected client
+ */
+struct NMEA0183ClientStats {
+  uint16_t slot;
+  String remoteIp;
+  uint32_t connectedMs;
+  bool receiving;               // False once the client has sent data (not echoed back)
+  uint32_t bytesSent;
+  uint32_t bytesPerSecond;
+  uint32_t sentencesSent;
+  uint32_t sentencesDropped;
+  uint32_t backlogBytes;
+  uint32_t latencyAvgUs;
+  uint32_t latencyMaxUs;
+};
 
 /**
  * Initialize NMEA 0183 TCP server
- * Starts listening on port 10110
+ * Starts listening on NMEA_TCP_PORT
  */
 void initNMEA0183Server();
 
 /**
- * Process TCP server - accept new clients and handle disconnections
+ * Send queued output and hand received sentences to the parser
  * Call this in the main loop
  */
 void processNMEA0183Server();
@@ -39,9 +49,15 @@ void processNMEA0183Server();
 /**
  * Broadcast NMEA 0183 sentence to all connected clients
  *
+ * Never blocks: the sentence is copied once into a shared ring and sent to
+ * each client by processNMEA0183Server() as its send buffer has room. A
+ * client that falls NMEA_TX_RING_SIZE bytes behind loses its oldest
+ * sentences instead of stalling the others.
+ *
  * @param sentence NMEA 0183 sentence (must include checksum and CRLF)
  */
 void broadcastNMEA0183(const String& sentence);
+void broadcastNMEA0183(const char* sentence, size_t len);
 
 /**
  * Get number of connected clients
@@ -50,6 +66,13 @@ void broadcastNMEA0183(const String& sentence);
  */
 int getNMEA0183ClientCount();
 
+/**
+ * Snapshot of per-client throughput, drop and latency counters
+ *
+ * @return One entry per connected client
+ */
+std::vector<NMEA0183ClientStats> getNMEA0183ClientStats();
+
 /**
  * Stop NMEA 0183 TCP server and disconnect all clients
  */
@@ -1,8 +1,15 @@
 #include "websocket.h"
+#include "../signalk/data_store.h"
+#include "../signalk/delta_writer.h"
+#include "../signalk/subscriptions.h"
+#include "../utils/time_utils.h"
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <memory>
 #include <vector>
 
 // ====== EXTERN DECLARATIONS ======
@@ -16,232 +23,486 @@ extern String vesselUUID;
 
 // Forward declarations of functions from main.cpp
 extern String iso8601Now();
-extern void setPathValue(const String& path, double value, const String& source, const String& units, const String& description);
-extern void setPathValue(const String& path, const String& value, const String& source, const String& units, const String& description);
-extern void setPathValueJson(const String& path, const String& jsonValue, const String& source, const String& units, const String& description);
-extern bool handleAnchorPartialUpdate(const String& path, bool isNumeric, double numericValue,
-                                      const String& strValue, const String& source,
-                                      const String& units, const String& description);
-
-// Helper to match subscription patterns like "*", "navigation.*", "environment.wind.*"
-static bool matchesSubscriptionPattern(const String& pattern, const String& path) {
-  if (pattern == "*" || pattern.length() == 0) {
-    return true;
-  }
 
-  int starPos = pattern.indexOf('*');
-  if (starPos < 0) {
-    return pattern == path;
+// SignalK "policy" field; anything unknown falls back to the spec default
+static SubscriptionPolicy parseSubscriptionPolicy(const String& policy) {
+  if (policy == "instant") return POLICY_INSTANT;
+  if (policy == "fixed") return POLICY_FIXED;
+  return POLICY_IDEAL;
+}
+
+// ====== WEBSOCKET DELTA BROADCAST ======
+// Serialize a delta for the given paths into a buffer that AsyncWebSocket
+// can share between clients. Used for the initial state after a subscribe;
+// the values are copied from the store first.
+// Returns nullptr if there is nothing to send or the allocation fails.
+static AsyncWebSocketSharedBuffer buildDeltaBuffer(const PathId* ids, size_t count) {
+  static String context;
+  if (context.length() == 0) {
+    context = "vessels." + vesselUUID;
   }
 
-  String prefix = pattern.substring(0, starPos);
-  String suffix = pattern.substring(starPos + 1);
+  static DeltaSnapshot snapshot;
+  snapshot.capture(ids, count);
+  if (snapshot.ids.empty()) {
+    return nullptr;
+  }
 
-  if (!path.startsWith(prefix)) {
-    return false;
+  size_t capacity = estimateDeltaSize(context, snapshot);
+  AsyncWebSocketSharedBuffer buffer = std::make_shared<std::vector<uint8_t>>(capacity);
+  if (!buffer || buffer->size() < capacity) {
+    Serial.printf("ERROR: Failed to allocate %u byte delta buffer\n", (unsigned)capacity);
+    return nullptr;
   }
 
-  if (suffix.length() == 0) {
-    return true;
+  JsonWriter out(reinterpret_cast<char*>(buffer->data()), capacity);
+  size_t values = writeDelta(out, context, epochMillisNow(), snapshot);
+  if (values == 0) {
+    return nullptr;
+  }
+  if (out.overflowed()) {
+    // The estimate is an upper bound, so this indicates a bug
+    Serial.printf("ERROR: Delta exceeded its %u byte estimate, dropping\n", (unsigned)capacity);
+    return nullptr;
   }
 
-  return path.endsWith(suffix);
+  buffer->resize(out.length());  // Shrink without reallocating
+  return buffer;
 }
 
-static bool isPathSubscribed(const ClientSubscription& sub, const String& path) {
-  if (sub.paths.empty()) {
-    return false;
-  }
+// Recipients of one broadcast pass that are due exactly the same paths
+struct DeltaGroup {
+  std::vector<PathId> ids;
+  AsyncWebSocketSharedBuffer buffer;
+};
+
+static DeltaFragmentCache fragmentCache;
 
-  for (const auto& pattern : sub.paths) {
-    if (matchesSubscriptionPattern(pattern, path)) {
-      return true;
+// Shared delta for a due-set, assembled from cached fragments on first use
+static AsyncWebSocketSharedBuffer deltaForGroup(std::vector<DeltaGroup>& groups,
+                                                const std::vector<PathId>& ids) {
+  for (const DeltaGroup& group : groups) {
+    if (group.ids == ids) {
+      return group.buffer;
     }
   }
-  return false;
-}
 
-// ====== WEBSOCKET DELTA BROADCAST ======
-void broadcastDeltas() {
-  // Removed throttling - broadcast immediately when data is available
+  static String context;
+  if (context.length() == 0) {
+    context = "vessels." + vesselUUID;
+  }
 
-  // Debug: Log dataStore size and changed items
-  static uint32_t lastDebugDataStore = 0;
-  if (millis() - lastDebugDataStore > 10000) {  // Every 10 seconds
-    Serial.printf("DEBUG: dataStore size = %d\n", dataStore.size());
-    int changedCount = 0;
-    for (auto& kv : dataStore) {
-      if (kv.second.changed) {
-        changedCount++;
-        Serial.printf("  - CHANGED: %s\n", kv.first.c_str());
-      }
+  DeltaGroup group;
+  group.ids = ids;
+  size_t size = fragmentCache.deltaSize(context, ids.data(), ids.size());
+  group.buffer = std::make_shared<std::vector<uint8_t>>(size);
+  if (group.buffer && group.buffer->size() == size) {
+    JsonWriter out(reinterpret_cast<char*>(group.buffer->data()), size);
+    size_t values = fragmentCache.writeDelta(out, context, ids.data(), ids.size());
+    if (values == 0 || out.overflowed() || out.length() != size) {
+      group.buffer = nullptr;
     }
-    Serial.printf("DEBUG: Changed items = %d\n", changedCount);
-    lastDebugDataStore = millis();
+  } else {
+    Serial.printf("ERROR: Failed to allocate %u byte delta buffer\n", (unsigned)size);
+    group.buffer = nullptr;
   }
 
-  // Build delta message
-  DynamicJsonDocument doc(4096);
-  doc["context"] = "vessels." + vesselUUID;
-
-  JsonArray updates = doc.createNestedArray("updates");
-  JsonObject update = updates.createNestedObject();
+  groups.push_back(group);
+  return groups.back().buffer;
+}
 
-  update["timestamp"] = iso8601Now();
+// ====== BACKPRESSURE ======
+// AsyncWebSocket queues without limit until its hard cap, so a client on a
+// weak link would otherwise hold heap for every delta it cannot keep up
+// with. Busy clients have their paths deferred instead; since the store
+// only keeps the latest value, the eventual send carries fresh data.
+//
+// Send states and subscriptions are only changed on the loop task. The
+// lock is held while the loop task uses them and while the client status
+// API reads them, never while waiting on anything else.
+static std::map<uint32_t, ClientSendState> clientSendStates;
+static SemaphoreHandle_t clientStateLock = nullptr;
+
+// Queue a broadcast made on another task for the loop task (see below)
+static void queueBroadcastText(const String& message);
+
+// Totals across clients, kept after they disconnect (loop task writes)
+static std::atomic<uint32_t> pathChanges(0);
+static std::atomic<uint32_t> pathsPerSecond(0);
+static std::atomic<uint32_t> pathsPerSecondAt(0);
+static std::atomic<uint32_t> messagesSent(0);
+static std::atomic<uint32_t> messagesDropped(0);
+
+static inline void countRelaxed(std::atomic<uint32_t>& counter, uint32_t n = 1) {
+  counter.fetch_add(n, std::memory_order_relaxed);
+}
 
-  JsonObject source = update.createNestedObject("source");
-  source["label"] = "ESP32-SignalK";
-  source["type"] = "NMEA0183";
+// Changed paths per second, measured over one-second windows. Deltas only
+// run while clients are connected; the rate reads 0 once windows stop.
+static void updateDeltaRate(uint32_t changed, uint32_t now) {
+  static uint32_t windowStart = 0;
+  static uint32_t windowChanges = 0;
+  windowChanges += changed;
+  uint32_t elapsed = now - windowStart;
+  if (elapsed >= 1000) {
+    pathsPerSecond.store((uint32_t)((uint64_t)windowChanges * 1000 / elapsed), std::memory_order_relaxed);
+    pathsPerSecondAt.store(now, std::memory_order_relaxed);
+    windowChanges = 0;
+    windowStart = now;
+  }
+}
 
-  JsonArray values = update.createNestedArray("values");
+// True if the client can take another message right now. Tracks how long
+// the client has been busy and closes it once that exceeds the timeout.
+static bool clientReady(AsyncWebSocketClient& client, ClientSendState& st, uint32_t now) {
+  if (!client.queueIsFull() && client.queueLen() < WS_CLIENT_QUEUE_LIMIT) {
+    st.busy = false;
+    return true;
+  }
+  if (!st.busy) {
+    st.busy = true;
+    st.busySince = now;
+  } else if (now - st.busySince > WS_SATURATED_TIMEOUT_MS) {
+    Serial.printf("WS: Client #%u saturated for %u ms (queue %u), disconnecting\n",
+                  client.id(), (unsigned)(now - st.busySince), (unsigned)client.queueLen());
+    client.close(1008, "Client too slow");
+  }
+  return false;
+}
 
-  bool hasChanges = false;
-  std::vector<String> changedPaths;
-  changedPaths.reserve(dataStore.size());
+// Merge sorted ids into the client's deferred set, counting superseded values
+static void deferPaths(ClientSendState& st, const std::vector<PathId>& ids) {
+  std::vector<PathId> merged;
+  merged.reserve(st.deferred.size() + ids.size());
+  auto a = st.deferred.begin();
+  auto b = ids.begin();
+  while (a != st.deferred.end() || b != ids.end()) {
+    if (b == ids.end() || (a != st.deferred.end() && *a < *b)) {
+      merged.push_back(*a++);
+    } else if (a == st.deferred.end() || *b < *a) {
+      merged.push_back(*b++);
+    } else {
+      st.conflated++;
+      merged.push_back(*a++);
+      b++;
+    }
+  }
+  st.deferred.swap(merged);
+}
 
-  for (auto& kv : dataStore) {
-    if (!kv.second.changed) continue;
+void broadcastText(const String& message) {
+  if (!isDataStoreWriter()) {
+    queueBroadcastText(message);
+    return;
+  }
 
-    // Skip items with empty or invalid paths
-    if (kv.first.length() == 0) {
-      Serial.printf("WARNING: Skipping empty path\n");
-      kv.second.changed = false;
+  uint32_t now = millis();
+  AsyncWebSocketSharedBuffer buffer;
+  xSemaphoreTake(clientStateLock, portMAX_DELAY);
+  for (auto& client : ws.getClients()) {
+    if (client.status() != WS_CONNECTED) continue;
+    ClientSendState& st = clientSendStates[client.id()];
+    if (!clientReady(client, st, now)) {
+      st.dropped++;
+      countRelaxed(messagesDropped);
       continue;
     }
-
-    // Additional check for whitespace-only paths
-    String trimmedPath = kv.first;
-    trimmedPath.trim();
-    if (trimmedPath.length() == 0) {
-      Serial.printf("WARNING: Skipping whitespace path: '%s' len=%d\n", kv.first.c_str(), kv.first.length());
-      kv.second.changed = false;
-      continue;
+    if (!buffer) {
+      buffer = std::make_shared<std::vector<uint8_t>>(
+          (const uint8_t*)message.c_str(), (const uint8_t*)message.c_str() + message.length());
     }
+    client.text(buffer);
+    st.sent++;
+    countRelaxed(messagesSent);
+  }
+  xSemaphoreGive(clientStateLock);
+}
+
+DeltaStats getDeltaStats() {
+  DeltaStats stats;
+  stats.pathChanges = pathChanges.load(std::memory_order_relaxed);
+  bool rateCurrent = millis() - pathsPerSecondAt.load(std::memory_order_relaxed) < 2000;
+  stats.pathsPerSecond = rateCurrent ? pathsPerSecond.load(std::memory_order_relaxed) : 0;
+  stats.messagesSent = messagesSent.load(std::memory_order_relaxed);
+  stats.messagesDropped = messagesDropped.load(std::memory_order_relaxed);
+  return stats;
+}
 
-    JsonObject val = values.createNestedObject();
-    val["path"] = kv.first;
+void writeWebSocketClientStats(JsonArray out) {
+  static const ClientSendState kNotSentYet;
+  uint32_t now = millis();
+  xSemaphoreTake(clientStateLock, portMAX_DELAY);
+  for (auto& client : ws.getClients()) {
+    if (client.status() != WS_CONNECTED) continue;
+    auto it = clientSendStates.find(client.id());
+    const ClientSendState& st = it != clientSendStates.end() ? it->second : kNotSentYet;
+    JsonObject obj = out.createNestedObject();
+    obj["id"] = client.id();
+    obj["ip"] = client.remoteIP().toString();
+    obj["queueDepth"] = client.queueLen();
+    obj["deferredPaths"] = st.deferred.size();
+    obj["sent"] = st.sent;
+    obj["dropped"] = st.dropped;
+    obj["conflated"] = st.conflated;
+    obj["busyMs"] = st.busy ? now - st.busySince : 0;
+    obj["subscribed"] = clientSubscriptions.count(client.id()) > 0;
+  }
+  xSemaphoreGive(clientStateLock);
+}
 
-    if (kv.second.isJson) {
-      DynamicJsonDocument valueDoc(256);
-      DeserializationError err = deserializeJson(valueDoc, kv.second.jsonValue);
-      if (!err) {
-        val["value"] = valueDoc.as<JsonVariant>();
-      } else {
-        val["value"] = kv.second.jsonValue;
-      }
-    } else if (kv.second.isNumeric) {
-      val["value"] = kv.second.numValue;
-    } else {
-      val["value"] = kv.second.strValue;
+void broadcastDeltas() {
+  // Debug: Log dataStore size and pending changes
+  static uint32_t lastDebugDataStore = 0;
+  if (millis() - lastDebugDataStore > 10000) {  // Every 10 seconds
+    Serial.printf("DEBUG: dataStore size = %d, changed = %d, coalesced total = %u\n",
+                  getPathCount(), getDirtyCount(), (unsigned)getTotalCoalescedUpdates());
+    lastDebugDataStore = millis();
+  }
+
+  PathId dirtyCount = getDirtyCount();
+  const PathId* dirtyPaths = getDirtyPaths();
+
+  // Every dirty ID is a registered, validated path; snapshot and clear the
+  // list before serializing so updates arriving meanwhile are kept. Sorted
+  // so it compares equal to scheduler output for the same paths.
+  std::vector<PathId> changedPaths(dirtyPaths, dirtyPaths + dirtyCount);
+  clearDirtyPaths();
+  std::sort(changedPaths.begin(), changedPaths.end());
+  countRelaxed(pathChanges, changedPaths.size());
+
+  // Route changes to subscribed clients via the per-path subscriber mask
+  markSubscriptionsChanged(changedPaths.data(), changedPaths.size());
+
+  // Clients with identical due-sets share one buffer, and every path is
+  // serialized once per pass no matter how many groups include it
+  fragmentCache.beginTick(epochMillisNow());
+  std::vector<DeltaGroup> groups;
+  std::vector<PathId> due;
+  uint32_t now = millis();
+  updateDeltaRate(changedPaths.size(), now);
+
+  xSemaphoreTake(clientStateLock, portMAX_DELAY);
+  for (auto& client : ws.getClients()) {
+    if (client.status() != WS_CONNECTED) continue;
+
+    const std::vector<PathId>* ids = &changedPaths;
+    auto it = clientSubscriptions.find(client.id());
+    if (it != clientSubscriptions.end()) {
+      // Changes are coalesced into the subscription and sent according to
+      // its policy, period and minPeriod
+      ClientSubscription& sub = it->second;
+      due.clear();
+      collectDuePaths(sub, now, due);
+      ids = &due;
     }
+    // Clients that never subscribed get every change (SignalK default)
+    ClientSendState& st = clientSendStates[client.id()];
+    if (ids->empty() && st.deferred.empty()) continue;
 
-    if (kv.second.units.length() > 0) {
-      val["units"] = kv.second.units;
+    if (!st.deferred.empty()) {
+      deferPaths(st, *ids);
+      ids = &st.deferred;
     }
-    if (kv.second.description.length() > 0) {
-      val["description"] = kv.second.description;
+    if (!clientReady(client, st, now)) {
+      // Hold the paths back; newer values replace older ones in the store
+      if (ids != &st.deferred) {
+        deferPaths(st, *ids);
+      }
+      st.dropped++;
+      countRelaxed(messagesDropped);
+      continue;
     }
 
-    // Store for next comparison
-    lastSentValues[kv.first] = kv.second;
-    kv.second.changed = false;
-    hasChanges = true;
-    changedPaths.push_back(kv.first);
+    AsyncWebSocketSharedBuffer buffer = deltaForGroup(groups, *ids);
+    if (buffer) {
+      client.text(buffer);
+      st.sent++;
+      countRelaxed(messagesSent);
+    }
+    st.deferred.clear();
   }
+  xSemaphoreGive(clientStateLock);
 
-  if (!hasChanges) return;
-
-  // Clean up any empty objects in the values array before sending
-  JsonArray values_check = updates[0]["values"];
-  for (int i = values_check.size() - 1; i >= 0; i--) {
-    JsonObject obj = values_check[i];
-    if (!obj.containsKey("path") || obj["path"].isNull() || obj["path"].as<String>().length() == 0) {
-      Serial.printf("ERROR: Removing invalid item from values array at index %d\n", i);
-      values_check.remove(i);
+  // Debug: Log WebSocket broadcast
+  static uint32_t lastDebugLog = 0;
+  if (!groups.empty() && millis() - lastDebugLog > 5000) {  // Log every 5 seconds to avoid spam
+    Serial.printf("=== WebSocket Broadcast (%u groups) ===\n", (unsigned)groups.size());
+    if (groups[0].buffer) {
+      Serial.write(groups[0].buffer->data(), groups[0].buffer->size());
+      Serial.println();
     }
+    Serial.println("=======================================");
+    lastDebugLog = millis();
   }
+}
 
-  // If all items were removed, don't send anything
-  if (values_check.size() == 0) {
-    Serial.println("WARNING: All items in values array were invalid, not broadcasting");
-    return;
+// ====== CLIENT REQUESTS ======
+// Subscribe, unsubscribe, disconnect and re-broadcast of client deltas
+// arrive on the AsyncTCP task, but subscriptions and send states are
+// walked by broadcastDeltas() on the loop task. They are queued here and
+// applied by processWebSocketRequests(), so only the loop task changes
+// them. The mutex is only held to append to or swap the list.
+enum WsRequestOp : uint8_t {
+  WS_REQUEST_SUBSCRIBE,
+  WS_REQUEST_UNSUBSCRIBE,
+  WS_REQUEST_DISCONNECT,
+  WS_REQUEST_BROADCAST
+};
+
+struct WsRequest {
+  WsRequestOp op;
+  uint32_t clientId;
+  std::vector<SubscriptionEntry> entries;  // Subscribe: entries to add
+  std::vector<String> patterns;            // Unsubscribe: patterns to remove
+  String text;                             // Subscribe: format; broadcast: message
+};
+
+static SemaphoreHandle_t requestLock = nullptr;
+static std::vector<WsRequest> pendingRequests;
+
+// False if the queue is full. Disconnects are always queued so a client's
+// subscriber slot is never leaked.
+static bool queueRequest(WsRequest&& request) {
+  xSemaphoreTake(requestLock, portMAX_DELAY);
+  bool queued = request.op == WS_REQUEST_DISCONNECT || pendingRequests.size() < WS_REQUEST_QUEUE_SIZE;
+  if (queued) {
+    pendingRequests.push_back(std::move(request));
+  }
+  xSemaphoreGive(requestLock);
+  if (!queued) {
+    Serial.printf("WS: Request queue full, dropping request from client #%u\n", request.clientId);
   }
+  return queued;
+}
 
+// {"error": message}, for requests the server could not honour
+static void sendClientError(AsyncWebSocketClient& client, const String& message) {
+  DynamicJsonDocument doc(256);
+  doc["error"] = message;
   String output;
   serializeJson(doc, output);
+  client.text(output);
+}
 
-  // CRITICAL VALIDATION: Parse the serialized JSON and verify no empty objects in values array
-  DynamicJsonDocument verify(4096);
-  DeserializationError error = deserializeJson(verify, output);
-  if (error) {
-    Serial.printf("ERROR: Failed to parse serialized JSON for validation: %s\n", error.c_str());
-    return; // Don't send corrupted JSON
-  }
-
-  // Check if updates array exists and has at least one update
-  if (verify.containsKey("updates") && verify["updates"].size() > 0) {
-    JsonArray updates_array = verify["updates"];
-    for (JsonVariant update_var : updates_array) {
-      JsonObject update_obj = update_var.as<JsonObject>();
-      if (update_obj.containsKey("values")) {
-        JsonArray vals = update_obj["values"];
-        for (JsonVariant v : vals) {
-          JsonObject obj = v.as<JsonObject>();
-          // Check if object is empty or has no path
-          if (obj.size() == 0) {
-            Serial.println("ERROR: Found completely empty object {} in serialized JSON, dropping entire message");
-            return; // Don't send this message at all
-          }
-          if (!obj.containsKey("path")) {
-            Serial.println("ERROR: Found object without 'path' field in serialized JSON, dropping entire message");
-            return; // Don't send this message at all
-          }
-          String path_check = obj["path"].as<String>();
-          if (path_check.length() == 0) {
-            Serial.println("ERROR: Found object with empty path string in serialized JSON, dropping entire message");
-            return; // Don't send this message at all
-          }
-        }
-      }
+static void applySubscribe(AsyncWebSocketClient& client, const WsRequest& request) {
+  ClientSubscription& sub = clientSubscriptions[request.clientId];
+  for (const SubscriptionEntry& entry : request.entries) {
+    if (addSubscription(sub, entry)) {
+      continue;
+    }
+    if (sub.slot == SUBSCRIPTION_NO_SLOT) {
+      // Without a subscriber slot the client would never be due anything;
+      // drop the subscription so it keeps getting every change instead
+      Serial.printf("WS: No free subscriber slot for client #%u, sending all deltas\n",
+                    request.clientId);
+      clientSubscriptions.erase(request.clientId);
+      sendClientError(client, "Too many subscribed clients, sending all deltas instead");
+      return;
     }
+    Serial.printf("WS: Client #%u has too many subscriptions, ignoring %s\n",
+                  request.clientId, entry.pattern.c_str());
+    sendClientError(client, "Too many subscriptions, ignoring " + entry.pattern);
   }
+  sub.format = request.text;
+
+  // Send hello message
+  DynamicJsonDocument hello(512);
+  hello["self"] = "vessels." + vesselUUID;
+  hello["version"] = "1.0.0";
+  hello["timestamp"] = iso8601Now();
+
+  String helloOutput;
+  serializeJson(hello, helloOutput);
+  client.text(helloOutput);
+
+  // Send initial state for all subscribed paths
+  std::vector<PathId> snapshot;
+  collectSnapshotPaths(sub, millis(), snapshot);
+  if (!snapshot.empty()) {
+    AsyncWebSocketSharedBuffer buffer = buildDeltaBuffer(snapshot.data(), snapshot.size());
+    if (buffer) {
+      client.text(buffer);
+      Serial.printf("Sent initial state with %u values to client #%u\n",
+                    (unsigned)snapshot.size(), request.clientId);
+    }
+  }
+}
 
-  // Debug: Log WebSocket broadcast
-  static uint32_t lastDebugLog = 0;
-  if (millis() - lastDebugLog > 5000) {  // Log every 5 seconds to avoid spam
-    Serial.println("=== WebSocket Broadcast (validated) ===");
-    Serial.println(output);
-    Serial.println("=======================================");
-    lastDebugLog = millis();
+static void applyUnsubscribe(const WsRequest& request) {
+  ClientSubscription& sub = clientSubscriptions[request.clientId];
+  for (const String& pattern : request.patterns) {
+    removeSubscription(sub, pattern);
+  }
+  auto st = clientSendStates.find(request.clientId);
+  if (st != clientSendStates.end()) {
+    st->second.deferred.clear();
   }
+}
 
-  if (clientSubscriptions.empty()) {
-    // Legacy behavior: broadcast to everyone when no one negotiated subscriptions
-    ws.textAll(output);
-    return;
+static void removeClient(uint32_t clientId) {
+  auto sub = clientSubscriptions.find(clientId);
+  if (sub != clientSubscriptions.end()) {
+    detachSubscription(sub->second);
+    clientSubscriptions.erase(sub);
   }
+  clientSendStates.erase(clientId);
+}
 
-  // Send to all subscribed clients immediately (no throttling)
-  for (auto it = clientSubscriptions.begin(); it != clientSubscriptions.end();) {
-    AsyncWebSocketClient* client = ws.client(it->first);
-    if (!client) {
-      it = clientSubscriptions.erase(it);
-      continue;
-    }
+static void queueBroadcastText(const String& message) {
+  WsRequest request;
+  request.op = WS_REQUEST_BROADCAST;
+  request.clientId = 0;
+  request.text = message;
+  queueRequest(std::move(request));
+}
+
+void initWebSocket() {
+  if (requestLock == nullptr) {
+    requestLock = xSemaphoreCreateMutex();
+    clientStateLock = xSemaphoreCreateMutex();
+  }
+  ws.onEvent(onWebSocketEvent);
+}
+
+void processWebSocketRequests() {
+  if (requestLock == nullptr) {
+    return;
+  }
 
-    bool shouldSend = false;
-    for (const String& path : changedPaths) {
-      if (isPathSubscribed(it->second, path)) {
-        shouldSend = true;
+  static std::vector<WsRequest> batch;
+  xSemaphoreTake(requestLock, portMAX_DELAY);
+  batch.swap(pendingRequests);
+  xSemaphoreGive(requestLock);
+
+  xSemaphoreTake(clientStateLock, portMAX_DELAY);
+  for (const WsRequest& request : batch) {
+    switch (request.op) {
+      case WS_REQUEST_SUBSCRIBE: {
+        // The client may have gone since; its disconnect follows in the batch
+        AsyncWebSocketClient* client = ws.client(request.clientId);
+        if (client) {
+          applySubscribe(*client, request);
+        }
         break;
       }
+      case WS_REQUEST_UNSUBSCRIBE:
+        applyUnsubscribe(request);
+        break;
+      case WS_REQUEST_DISCONNECT:
+        removeClient(request.clientId);
+        break;
+      case WS_REQUEST_BROADCAST:
+        break;  // Sent below, once the lock is released
     }
+  }
+  xSemaphoreGive(clientStateLock);
 
-    if (shouldSend) {
-      client->text(output);
+  for (const WsRequest& request : batch) {
+    if (request.op == WS_REQUEST_BROADCAST) {
+      broadcastText(request.text);
     }
-    ++it;
   }
+  batch.clear();
 }
 
 // ====== WEBSOCKET MESSAGE HANDLER ======
@@ -337,124 +598,54 @@ void handleWebSocketMessage(AsyncWebSocketClient* client, uint8_t* data, size_t
     Serial.println("WS: Broadcasting received delta to all connected clients");
     String deltaJson;
     serializeJson(doc, deltaJson);
-    ws.textAll(deltaJson);
+    broadcastText(deltaJson);
 
     return;
   }
 
-  // Handle subscription
+  // Subscriptions are applied on the loop task, see processWebSocketRequests()
   if (doc.containsKey("subscribe")) {
-    JsonArray subArray = doc["subscribe"].as<JsonArray>();
-    ClientSubscription& sub = clientSubscriptions[client->id()];
+    WsRequest request;
+    request.op = WS_REQUEST_SUBSCRIBE;
+    request.clientId = client->id();
+    request.text = doc["format"] | "delta";
 
+    JsonArray subArray = doc["subscribe"].as<JsonArray>();
     for (JsonVariant v : subArray) {
       JsonObject subObj = v.as<JsonObject>();
-      String path = subObj["path"] | "*";
-      if (path.length() == 0) {
-        continue;
-      }
-      sub.paths.insert(path);
-    }
-
-    sub.format = doc["format"] | "delta";
-
-    // Send hello message
-    DynamicJsonDocument hello(512);
-    hello["self"] = "vessels." + vesselUUID;
-    hello["version"] = "1.0.0";
-    hello["timestamp"] = iso8601Now();
-
-    String helloOutput;
-    serializeJson(hello, helloOutput);
-    client->text(helloOutput);
-
-    // Send initial state for all subscribed paths
-    DynamicJsonDocument initialDoc(4096);
-    initialDoc["context"] = "vessels." + vesselUUID;
-
-    JsonArray updates = initialDoc.createNestedArray("updates");
-    JsonObject update = updates.createNestedObject();
-    update["timestamp"] = iso8601Now();
-
-    JsonObject source = update.createNestedObject("source");
-    source["label"] = "ESP32-SignalK";
-
-    JsonArray values = update.createNestedArray("values");
-    bool hasData = false;
-
-    // Send current values for subscribed paths
-    Serial.printf("DEBUG subscription: dataStore has %d items\n", dataStore.size());
-    for (auto& kv : dataStore) {
-      Serial.printf("DEBUG subscription: checking path='%s' len=%d\n", kv.first.c_str(), kv.first.length());
-
-      // Skip items with empty or invalid paths
-      if (kv.first.length() == 0) {
-        Serial.printf("WARNING: Skipping empty path in subscription\n");
-        continue;
-      }
-
-      // Additional check for whitespace-only paths
-      String trimmedPath = kv.first;
-      trimmedPath.trim();
-      if (trimmedPath.length() == 0) {
-        Serial.printf("WARNING: Skipping whitespace path in subscription: '%s' len=%d\n",
-                      kv.first.c_str(), kv.first.length());
-        continue;
-      }
-
-      // Check if this path is subscribed
-      if (!isPathSubscribed(sub, kv.first)) {
-        Serial.printf("DEBUG subscription: path NOT subscribed, skipping\n");
+      SubscriptionEntry entry;
+      entry.pattern = subObj["path"] | "*";
+      if (entry.pattern.length() == 0) {
         continue;
       }
-
-      Serial.printf("DEBUG subscription: Adding to JSON\n");
-      hasData = true;
-      JsonObject val = values.createNestedObject();
-      val["path"] = kv.first;
-
-      if (kv.second.isJson) {
-        DynamicJsonDocument valueDoc(512);
-        DeserializationError err = deserializeJson(valueDoc, kv.second.jsonValue);
-        if (!err) {
-          val["value"] = valueDoc.as<JsonVariant>();
-        } else {
-          val["value"] = kv.second.jsonValue;
-        }
-      } else if (kv.second.isNumeric) {
-        val["value"] = kv.second.numValue;
-      } else {
-        val["value"] = kv.second.strValue;
-      }
-
-      if (kv.second.units.length() > 0) {
-        val["units"] = kv.second.units;
-      }
-      if (kv.second.description.length() > 0) {
-        val["description"] = kv.second.description;
-      }
+      entry.period = subObj["period"] | SUBSCRIPTION_DEFAULT_PERIOD;
+      entry.minPeriod = subObj["minPeriod"] | 0;
+      entry.policy = parseSubscriptionPolicy(subObj["policy"] | "ideal");
+      request.entries.push_back(entry);
     }
 
-    if (hasData) {
-      String initialOutput;
-      serializeJson(initialDoc, initialOutput);
-      client->text(initialOutput);
-      Serial.printf("Sent initial state with %d values to client #%u\n", values.size(), client->id());
+    if (!queueRequest(std::move(request))) {
+      sendClientError(*client, "Server busy, subscribe again later");
     }
   }
 
-  // Handle unsubscribe
   if (doc.containsKey("unsubscribe")) {
-    ClientSubscription& sub = clientSubscriptions[client->id()];
-    JsonArray unsubArray = doc["unsubscribe"].as<JsonArray>();
+    WsRequest request;
+    request.op = WS_REQUEST_UNSUBSCRIBE;
+    request.clientId = client->id();
 
+    JsonArray unsubArray = doc["unsubscribe"].as<JsonArray>();
     for (JsonVariant v : unsubArray) {
       JsonObject unsubObj = v.as<JsonObject>();
       String path = unsubObj["path"] | "";
       if (path.length() > 0) {
-        sub.paths.erase(path);
+        request.patterns.push_back(path);
       }
     }
+
+    if (!queueRequest(std::move(request))) {
+      sendClientError(*client, "Server busy, unsubscribe again later");
+    }
   }
 }
 
@@ -505,7 +696,12 @@ void onWebSocketEvent(AsyncWebSocket* server, AsyncWebSocketClient* client,
       Serial.println("\n========================================");
       Serial.printf("=== WEBSOCKET: Client #%u DISCONNECTED ===\n", client->id());
       Serial.println("========================================\n");
-      clientSubscriptions.erase(client->id());
+      {
+        WsRequest request;
+        request.op = WS_REQUEST_DISCONNECT;
+        request.clientId = client->id();
+        queueRequest(std::move(request));
+      }
       clientTokens.erase(client->id());  // Clean up token
       break;
 
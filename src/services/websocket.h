@@ -23,22 +23,69 @@ extern std::map<uint32_t, ClientSubscription> clientSubscriptions;
 // Client authentication tokens
 extern std::map<uint32_t, String> clientTokens;
 
-// Data storage
-extern std::map<String, PathValue> dataStore;
-extern std::map<String, PathValue> lastSentValues;
+// Data storage (flat array indexed by PathId, see signalk/data_store.h)
+extern PathValue dataStore[MAX_SIGNALK_PATHS];
 
 // Vessel identification
 extern String vesselUUID;
 
 // ====== FUNCTION DECLARATIONS ======
 
+/**
+ * @brief Create the request queue and register onWebSocketEvent()
+ * Call once in setup() before the server starts.
+ */
+void initWebSocket();
+
+/**
+ * @brief Apply subscribe, unsubscribe and disconnect requests
+ * These arrive on the AsyncTCP task and are queued so that only the loop
+ * task changes subscriptions and send states; the initial state after a
+ * subscribe and broadcasts queued by other tasks are sent from here. Call
+ * every loop() pass, before broadcastDeltas().
+ */
+void processWebSocketRequests();
+
 /**
  * @brief Broadcast delta messages to all subscribed WebSocket clients
- * Iterates through changed data in dataStore and sends to clients
- * that have subscribed to those paths
+ * Walks the data store dirty list (O(changed paths)) and feeds each client's
+ * subscription scheduler, which applies the instant/ideal/fixed policies
+ * and sends only the paths that are due. Call every loop() pass.
  */
 void broadcastDeltas();
 
+/**
+ * @brief Send a text message to every connected client that is not busy
+ * Clients whose send queue is at WS_CLIENT_QUEUE_LIMIT skip the message and
+ * have it counted as dropped. Use instead of ws.textAll(). Called on another
+ * task, the message is queued and sent by processWebSocketRequests().
+ *
+ * @param message The message to send
+ */
+void broadcastText(const String& message);
+
+/**
+ * @brief Append per-client send statistics to a JSON array
+ * One object per connected client with its queue depth, deferred paths and
+ * sent/dropped/conflated counters.
+ *
+ * @param out The array to fill
+ */
+void writeWebSocketClientStats(JsonArray out);
+
+/**
+ * @brief Delta throughput since boot
+ * Updated by broadcastDeltas() and broadcastText(); safe to read from any task.
+ */
+struct DeltaStats {
+  uint32_t pathChanges;     // Changed paths taken from the data store
+  uint32_t pathsPerSecond;  // Changed paths over the last full second
+  uint32_t messagesSent;    // Messages queued to clients
+  uint32_t messagesDropped; // Messages held back from busy clients
+};
+
+DeltaStats getDeltaStats();
+
 /**
  * @brief Process incoming WebSocket messages
  * Handles:
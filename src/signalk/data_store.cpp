@@ -1,18 +1,417 @@
 #include "data_store.h"
 #include "globals.h"
+#include "../services/ingest.h"
 #include "../utils/time_utils.h"
 #include "../utils/conversions.h"
 #include <ArduinoJson.h>
+#include <atomic>
 #include <cstring>
+#include <vector>
 #include <math.h>
 
-// Global data store - these are defined in main.cpp
-extern std::map<String, PathValue> dataStore;
-extern std::map<String, PathValue> lastSentValues;
+// Global data store - flat value array indexed by PathId
+PathValue dataStore[MAX_SIGNALK_PATHS];
+
+// Notifications are defined in main.cpp
 extern std::map<String, String> notifications;
 
+// ====== CONCURRENCY ======
+// Per-path sequence counter: odd while the writer is updating the value
+static std::atomic<uint32_t> valueSeq[MAX_SIGNALK_PATHS];
+static TaskHandle_t writerTask = nullptr;
+
+// Spins before a reader sleeps a tick, so a writer it preempted on the same
+// core can finish its update
+static const uint8_t kReadSpinLimit = 16;
+
+static SemaphoreHandle_t pathIndexLock = nullptr;     // Writer inserts vs. lookups from other tasks
+static SemaphoreHandle_t pendingWritesLock = nullptr; // See processDeferredStoreWrites()
+
+void setDataStoreWriter() {
+  if (pathIndexLock == nullptr) {
+    pathIndexLock = xSemaphoreCreateMutex();
+    pendingWritesLock = xSemaphoreCreateMutex();
+  }
+  writerTask = xTaskGetCurrentTaskHandle();
+}
+
+bool isDataStoreWriter() {
+  return writerTask == nullptr || xTaskGetCurrentTaskHandle() == writerTask;
+}
+
+static inline void beginValueWrite(PathId id) {
+  valueSeq[id].store(valueSeq[id].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+static inline void endValueWrite(PathId id) {
+  valueSeq[id].store(valueSeq[id].load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Replace a payload; a reader still holding the old one keeps it alive
+static inline void storeText(PathValue& pv, PathText text) {
+  std::atomic_store(&pv.text, std::move(text));
+}
+
+// ====== PATH REGISTRY ======
+// Path names are interned once; the map is only consulted when a path is
+// registered or looked up by name, never on the ID-based update path.
+// Names, groups and metadata of an ID are in place before pathCount is
+// raised past it, so other tasks only need an acquire load of the count.
+static String pathNames[MAX_SIGNALK_PATHS];
+static PathMetaRef pathMeta[MAX_SIGNALK_PATHS];
+static std::map<String, PathId> pathIndex;
+static std::atomic<PathId> pathCount(0);
+static const PathMetaRef kEmptyMeta = std::make_shared<const PathMeta>();
+static const String kEmptyName;
+
+// Top-level group of each path and a change counter per group
+static GroupId pathGroup[MAX_SIGNALK_PATHS];
+static String groupNames[MAX_SIGNALK_GROUPS];
+static std::atomic<uint32_t> groupVersions[MAX_SIGNALK_GROUPS];
+static std::atomic<GroupId> groupCount(0);
+static const String kEmptyGroup;
+
+// Lookups on the writer task need no lock: it is the only one inserting
+static PathId lookupPath(const String& path) {
+  auto it = pathIndex.find(path);
+  if (it == pathIndex.end()) {
+    return INVALID_PATH_ID;
+  }
+  return it->second;
+}
+
+PathId findPath(const String& path) {
+  if (isDataStoreWriter()) {
+    return lookupPath(path);
+  }
+  xSemaphoreTake(pathIndexLock, portMAX_DELAY);
+  PathId id = lookupPath(path);
+  xSemaphoreGive(pathIndexLock);
+  return id;
+}
+
+// SignalK paths are dot-separated segments of printable characters. Invalid
+// names are rejected here so serializers never have to re-check them.
+static bool isValidPathName(const String& path) {
+  size_t len = path.length();
+  if (len == 0 || path[0] == '.' || path[len - 1] == '.') {
+    return false;
+  }
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)path[i];
+    if (c <= ' ' || c == '"' || c == '\\' || c == 0x7F) {
+      return false;
+    }
+    if (c == '.' && path[i - 1] == '.') {
+      return false;
+    }
+  }
+  return true;
+}
+
+static GroupId internGroup(const String& path) {
+  int dot = path.indexOf('.');
+  String name = dot < 0 ? path : path.substring(0, dot);
+  GroupId count = groupCount.load(std::memory_order_relaxed);
+  for (GroupId i = 0; i < count; i++) {
+    if (groupNames[i] == name) {
+      return i;
+    }
+  }
+  if (count >= MAX_SIGNALK_GROUPS) {
+    Serial.printf("ERROR: SignalK group table full (%d), %s left out of the full model\n",
+                  MAX_SIGNALK_GROUPS, path.c_str());
+    return INVALID_GROUP_ID;
+  }
+  groupNames[count] = name;
+  groupCount.store(count + 1, std::memory_order_release);
+  return count;
+}
+
+static inline void bumpGroup(PathId id) {
+  if (pathGroup[id] != INVALID_GROUP_ID) {
+    std::atomic<uint32_t>& version = groupVersions[pathGroup[id]];
+    version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+}
+
+PathId registerPath(const String& path, const String& units, const String& description) {
+  if (!isValidPathName(path)) {
+    Serial.printf("ERROR: Rejecting invalid SignalK path '%s'\n", path.c_str());
+    return INVALID_PATH_ID;
+  }
+
+  PathId id = lookupPath(path);
+  if (id == INVALID_PATH_ID) {
+    id = pathCount.load(std::memory_order_relaxed);
+    if (id >= MAX_SIGNALK_PATHS) {
+      Serial.printf("ERROR: SignalK path table full (%d), dropping %s\n", MAX_SIGNALK_PATHS, path.c_str());
+      return INVALID_PATH_ID;
+    }
+    pathNames[id] = path;
+    pathGroup[id] = internGroup(path);
+    pathMeta[id] = kEmptyMeta;
+
+    if (pathIndexLock != nullptr) xSemaphoreTake(pathIndexLock, portMAX_DELAY);
+    pathIndex[path] = id;
+    if (pathIndexLock != nullptr) xSemaphoreGive(pathIndexLock);
+
+    pathCount.store(id + 1, std::memory_order_release);
+  }
+
+  // Metadata is only ever filled in, so this allocates at most twice per path
+  const PathMeta& current = *pathMeta[id];
+  bool addUnits = current.units.length() == 0 && units.length() > 0;
+  bool addDescription = current.description.length() == 0 && description.length() > 0;
+  if (addUnits || addDescription) {
+    std::shared_ptr<PathMeta> meta = std::make_shared<PathMeta>(current);
+    if (addUnits) meta->units = units;
+    if (addDescription) meta->description = description;
+    std::atomic_store(&pathMeta[id], PathMetaRef(meta));
+    bumpGroup(id);
+  }
+  return id;
+}
+
+const PathMeta& getPathMeta(PathId id) {
+  if (id >= pathCount.load(std::memory_order_acquire)) {
+    return *kEmptyMeta;
+  }
+  return *pathMeta[id];
+}
+
+PathMetaRef readPathMeta(PathId id) {
+  if (id >= pathCount.load(std::memory_order_acquire)) {
+    return kEmptyMeta;
+  }
+  return std::atomic_load(&pathMeta[id]);
+}
+
+const String& getPathName(PathId id) {
+  if (id >= pathCount.load(std::memory_order_acquire)) {
+    return kEmptyName;
+  }
+  return pathNames[id];
+}
+
+PathId getPathCount() {
+  return pathCount.load(std::memory_order_acquire);
+}
+
+GroupId getPathGroup(PathId id) {
+  return id < getPathCount() ? pathGroup[id] : INVALID_GROUP_ID;
+}
+
+GroupId getGroupCount() {
+  return groupCount.load(std::memory_order_acquire);
+}
+
+const String& getGroupName(GroupId group) {
+  return group < getGroupCount() ? groupNames[group] : kEmptyGroup;
+}
+
+uint32_t getGroupVersion(GroupId group) {
+  return group < getGroupCount() ? groupVersions[group].load(std::memory_order_acquire) : 0;
+}
+
+// ====== SNAPSHOT READS ======
+
+bool readPathValue(PathId id, PathValue& out) {
+  if (id >= getPathCount()) {
+    out = PathValue();
+    return false;
+  }
+
+  const PathValue& pv = dataStore[id];
+  uint8_t spins = 0;
+  for (;;) {
+    uint32_t seq = valueSeq[id].load(std::memory_order_acquire);
+    if ((seq & 1) == 0) {
+      memcpy(out.fields, pv.fields, sizeof(out.fields));
+      out.timestamp = pv.timestamp;
+      out.source = pv.source;
+      out.kind = pv.kind;
+      out.text = std::atomic_load(&pv.text);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (valueSeq[id].load(std::memory_order_relaxed) == seq) {
+        break;
+      }
+    }
+    if (++spins >= kReadSpinLimit) {
+      spins = 0;
+      delay(1);
+    }
+  }
+
+  out.changed = false;
+  return out.kind != PV_NONE;
+}
+
+// ====== CHANGE TRACKING ======
+// A path is queued the first time it changes after clearDirtyPaths(); later
+// updates before the consumer runs only bump its coalesced counter, so the
+// broadcaster never has to scan the whole store.
+static PathId dirtyList[MAX_SIGNALK_PATHS];
+static PathId dirtyCount = 0;
+static uint32_t coalescedUpdates[MAX_SIGNALK_PATHS];
+static uint32_t totalCoalesced = 0;
+
+static inline void markChanged(PathId id, PathValue& pv) {
+  bumpGroup(id);
+  if (pv.changed) {
+    coalescedUpdates[id]++;
+    totalCoalesced++;
+    return;
+  }
+  pv.changed = true;
+  dirtyList[dirtyCount++] = id;
+}
+
+PathId getDirtyCount() {
+  return dirtyCount;
+}
+
+const PathId* getDirtyPaths() {
+  return dirtyList;
+}
+
+void clearDirtyPaths() {
+  for (PathId i = 0; i < dirtyCount; i++) {
+    dataStore[dirtyList[i]].changed = false;
+  }
+  dirtyCount = 0;
+}
+
+uint32_t getCoalescedUpdates(PathId id) {
+  if (id >= getPathCount()) {
+    return 0;
+  }
+  return coalescedUpdates[id];
+}
+
+uint32_t getTotalCoalescedUpdates() {
+  return totalCoalesced;
+}
+
+// ====== SOURCE REGISTRY ======
+// A handful of source labels are shared by every path, so a linear scan of
+// a small table is cheaper than a map and keeps PathValue at one byte.
+// Labels are published by sourceCount, like path names.
+static String sourceNames[MAX_SIGNALK_SOURCES];
+static std::atomic<SourceId> sourceCount(0);
+static const String kEmptySource = "";
+
+SourceId registerSource(const String& label) {
+  SourceId count = sourceCount.load(std::memory_order_relaxed);
+  for (SourceId i = 0; i < count; i++) {
+    if (sourceNames[i] == label) {
+      return i;
+    }
+  }
+  if (count >= MAX_SIGNALK_SOURCES) {
+    Serial.printf("ERROR: SignalK source table full (%d), dropping %s\n", MAX_SIGNALK_SOURCES, label.c_str());
+    return INVALID_SOURCE_ID;
+  }
+  sourceNames[count] = label;
+  sourceCount.store(count + 1, std::memory_order_release);
+  return count;
+}
+
+const String& getSourceName(SourceId id) {
+  if (id >= sourceCount.load(std::memory_order_acquire)) {
+    return kEmptySource;
+  }
+  return sourceNames[id];
+}
+
+// ====== WRITES FROM OTHER TASKS ======
+// Name-based updates made on another task (AsyncTCP: WebSocket deltas,
+// HTTP PUT) are copied here and applied on the writer task by
+// processDeferredStoreWrites(). The mutex is only held to append to or
+// swap the list, never while a write is applied.
+enum StoreWriteOp : uint8_t {
+  STORE_WRITE_NUMBER,         // setPathValue(path, number, ...)
+  STORE_WRITE_STRING,         // setPathValue(path, text, ...)
+  STORE_WRITE_JSON,           // setPathValueJson(path, text, ...)
+  STORE_WRITE_ANCHOR_NUMBER,  // handleAnchorPartialUpdate(path, true, number, ...)
+  STORE_WRITE_ANCHOR_STRING   // handleAnchorPartialUpdate(path, false, 0, text, ...)
+};
+
+struct StoreWrite {
+  StoreWriteOp op;
+  double number;
+  String path;
+  String text;
+  String source;
+  String units;
+  String description;
+};
+
+static std::vector<StoreWrite> pendingWrites;
+static uint32_t deferredWrites = 0;
+static uint32_t droppedWrites = 0;
+
+// Queue the write if the caller is not the writer task
+static bool deferStoreWrite(StoreWriteOp op, const String& path, double number, const String& text,
+                            const String& source, const String& units, const String& description) {
+  if (isDataStoreWriter()) {
+    return false;
+  }
+
+  xSemaphoreTake(pendingWritesLock, portMAX_DELAY);
+  if (pendingWrites.size() >= DATA_STORE_WRITE_QUEUE_SIZE) {
+    droppedWrites++;
+  } else {
+    pendingWrites.push_back({op, number, path, text, source, units, description});
+    deferredWrites++;
+  }
+  xSemaphoreGive(pendingWritesLock);
+  return true;
+}
+
+void processDeferredStoreWrites() {
+  if (pendingWritesLock == nullptr) {
+    return;
+  }
+
+  static std::vector<StoreWrite> batch;
+  xSemaphoreTake(pendingWritesLock, portMAX_DELAY);
+  batch.swap(pendingWrites);
+  xSemaphoreGive(pendingWritesLock);
+
+  for (const StoreWrite& w : batch) {
+    switch (w.op) {
+      case STORE_WRITE_NUMBER:
+        setPathValue(w.path, w.number, w.source, w.units, w.description);
+        break;
+      case STORE_WRITE_STRING:
+        setPathValue(w.path, w.text, w.source, w.units, w.description);
+        break;
+      case STORE_WRITE_JSON:
+        setPathValueJson(w.path, w.text, w.source, w.units, w.description);
+        break;
+      case STORE_WRITE_ANCHOR_NUMBER:
+        handleAnchorPartialUpdate(w.path, true, w.number, "", w.source, w.units, w.description);
+        break;
+      case STORE_WRITE_ANCHOR_STRING:
+        handleAnchorPartialUpdate(w.path, false, 0.0, w.text, w.source, w.units, w.description);
+        break;
+    }
+  }
+  batch.clear();
+}
+
+uint32_t getDeferredStoreWrites() {
+  return deferredWrites;
+}
+
+uint32_t getDroppedStoreWrites() {
+  return droppedWrites;
+}
+
 // Forward declaration for updateGeofence (will be in services/alarms)
-extern void updateGeofence();
+extern void updateGeofence(double lat, double lon);
 extern GeofenceConfig geofence;
 extern DepthAlarmConfig depthAlarm;
 extern WindAlarmConfig windAlarm;
@@ -36,12 +435,16 @@ bool handleAnchorPartialUpdate(const String& path, bool isNumeric,
   if (field.length() == 0) {
     return false;
   }
+  if (deferStoreWrite(isNumeric ? STORE_WRITE_ANCHOR_NUMBER : STORE_WRITE_ANCHOR_STRING, path,
+                      numericValue, strValue, source, units, description)) {
+    return true;
+  }
 
   // Load existing anchor object if present
   DynamicJsonDocument doc(1024);
-  auto existing = dataStore.find("navigation.anchor.akat");
-  if (existing != dataStore.end() && existing->second.isJson && existing->second.jsonValue.length() > 0) {
-    DeserializationError err = deserializeJson(doc, existing->second.jsonValue);
+  PathId existing = findPath("navigation.anchor.akat");
+  if (existing != INVALID_PATH_ID && dataStore[existing].kind == PV_JSON && dataStore[existing].textValue().length() > 0) {
+    DeserializationError err = deserializeJson(doc, dataStore[existing].textValue());
     if (err) {
       doc.clear();
     }
@@ -243,6 +646,48 @@ static String normalizeAnchorConfig(const String& jsonValue) {
   return result;
 }
 
+void setPathValue(PathId id, double value, SourceId source) {
+  if (id >= getPathCount()) {
+    return;
+  }
+  if (deferIngestUpdate(INGEST_SET_NUMBER, id, PV_NUMBER, source, value)) {
+    return;
+  }
+
+  PathValue& pv = dataStore[id];
+  beginValueWrite(id);
+  pv.numValue = value;
+  if (pv.text) {
+    storeText(pv, PathText());  // Release any string/JSON payload
+  }
+  pv.kind = PV_NUMBER;
+  pv.timestamp = epochMillisNow();
+  pv.source = source;
+  endValueWrite(id);
+  markChanged(id, pv);
+}
+
+void setPathValue(PathId id, const String& value, SourceId source) {
+  if (id >= getPathCount()) {
+    return;
+  }
+  // No ingest handoff for strings: the SPSC queue only carries doubles
+  if (!isDataStoreWriter()) {
+    Serial.printf("ERROR: String update of %s off the loop task dropped\n", getPathName(id).c_str());
+    return;
+  }
+
+  PathText text = std::make_shared<const String>(value);
+  PathValue& pv = dataStore[id];
+  beginValueWrite(id);
+  storeText(pv, text);
+  pv.kind = PV_STRING;
+  pv.timestamp = epochMillisNow();
+  pv.source = source;
+  endValueWrite(id);
+  markChanged(id, pv);
+}
+
 void setPathValue(const String& path, double value, const String& source,
                   const String& units, const String& description) {
   // Validate path
@@ -250,21 +695,15 @@ void setPathValue(const String& path, double value, const String& source,
     Serial.println("ERROR: setPathValue called with empty path (double)");
     return;
   }
+  if (deferStoreWrite(STORE_WRITE_NUMBER, path, value, "", source, units, description)) {
+    return;
+  }
 
   if (handleAnchorPartialUpdate(path, true, value, "", source, units, description)) {
     return;
   }
 
-  PathValue& pv = dataStore[path];
-  pv.numValue = value;
-  pv.isNumeric = true;
-  pv.isJson = false;
-  pv.jsonValue = "";
-  pv.timestamp = iso8601Now();
-  pv.source = source;
-  pv.units = units;
-  pv.description = description;
-  pv.changed = true;
+  setPathValue(registerPath(path, units, description), value, registerSource(source));
 }
 
 void setPathValue(const String& path, const String& value, const String& source,
@@ -274,21 +713,15 @@ void setPathValue(const String& path, const String& value, const String& source,
     Serial.println("ERROR: setPathValue called with empty path (string)");
     return;
   }
+  if (deferStoreWrite(STORE_WRITE_STRING, path, 0.0, value, source, units, description)) {
+    return;
+  }
 
   if (handleAnchorPartialUpdate(path, false, 0.0, value, source, units, description)) {
     return;
   }
 
-  PathValue& pv = dataStore[path];
-  pv.strValue = value;
-  pv.isNumeric = false;
-  pv.isJson = false;
-  pv.jsonValue = "";
-  pv.timestamp = iso8601Now();
-  pv.source = source;
-  pv.units = units;
-  pv.description = description;
-  pv.changed = true;
+  setPathValue(registerPath(path, units, description), value, registerSource(source));
 }
 
 static bool anchorPersistPending = false;
@@ -337,6 +770,154 @@ void flushAnchorPersist() {
   }
 }
 
+// Stored JSON is written verbatim into deltas and the full model, so only
+// what ArduinoJson re-serializes is kept: that drops trailing garbage and
+// normalizes whitespace. Input that does not parse is stored as a string;
+// empty input stays empty and is written as null.
+static void storePathJson(PathId id, const String& jsonValue, SourceId source) {
+  if (id >= getPathCount()) {
+    return;
+  }
+
+  String canonical;
+  if (jsonValue.length() > 0) {
+    DynamicJsonDocument doc(jsonValue.length() * 4 + 256);
+    DeserializationError err = deserializeJson(doc, jsonValue);
+    if (err) {
+      Serial.printf("WARNING: %s is not valid JSON (%s), storing it as a string\n",
+                    getPathName(id).c_str(), err.c_str());
+      setPathValue(id, jsonValue, source);
+      return;
+    }
+    serializeJson(doc, canonical);
+  }
+
+  PathText text = std::make_shared<const String>(std::move(canonical));
+  PathValue& pv = dataStore[id];
+  beginValueWrite(id);
+  storeText(pv, text);
+  pv.kind = PV_JSON;
+  pv.timestamp = epochMillisNow();
+  pv.source = source;
+  endValueWrite(id);
+  markChanged(id, pv);
+}
+
+// ====== COMPOSITE VALUES ======
+static const char* const kPositionFields[] = {"latitude", "longitude", "altitude"};
+static const char* const kAttitudeFields[] = {"roll", "pitch", "yaw"};
+static const char* const kCurrentFields[] = {"drift", "setTrue"};
+
+uint8_t compositeFieldCount(PathValueKind kind) {
+  switch (kind) {
+    case PV_POSITION: return 3;
+    case PV_ATTITUDE: return 3;
+    case PV_CURRENT:  return 2;
+    default:          return 0;
+  }
+}
+
+const char* compositeFieldName(PathValueKind kind, uint8_t index) {
+  if (index >= compositeFieldCount(kind)) {
+    return nullptr;
+  }
+  switch (kind) {
+    case PV_POSITION: return kPositionFields[index];
+    case PV_ATTITUDE: return kAttitudeFields[index];
+    case PV_CURRENT:  return kCurrentFields[index];
+    default:          return nullptr;
+  }
+}
+
+void setPathComposite(PathId id, PathValueKind kind, double f0, double f1, double f2, SourceId source) {
+  if (id >= getPathCount() || compositeFieldCount(kind) == 0) {
+    return;
+  }
+  if (deferIngestUpdate(INGEST_SET_COMPOSITE, id, kind, source, f0, f1, f2)) {
+    return;
+  }
+
+  PathValue& pv = dataStore[id];
+  beginValueWrite(id);
+  if (pv.text) {
+    storeText(pv, PathText());  // Release any string/JSON payload
+  }
+  pv.fields[0] = f0;
+  pv.fields[1] = f1;
+  pv.fields[2] = f2;
+  pv.kind = kind;
+  pv.timestamp = epochMillisNow();
+  pv.source = source;
+  endValueWrite(id);
+  markChanged(id, pv);
+}
+
+// Composite kind for the well-known object paths (PV_NONE for all others)
+static PathValueKind compositeKindForPath(const String& path) {
+  if (path == "navigation.position") return PV_POSITION;
+  if (path == "navigation.attitude") return PV_ATTITUDE;
+  if (path == "environment.current") return PV_CURRENT;
+  return PV_NONE;
+}
+
+// Store an incoming JSON object natively if it fits a composite kind.
+// Every member except altitude must be present and numeric.
+static bool storeCompositeJson(PathId id, PathValueKind kind, const String& jsonValue, SourceId source) {
+  StaticJsonDocument<192> doc;
+  if (deserializeJson(doc, jsonValue) || !doc.is<JsonObject>()) {
+    return false;
+  }
+
+  double f[PATH_VALUE_MAX_FIELDS] = {NAN, NAN, NAN};
+  uint8_t count = compositeFieldCount(kind);
+  for (uint8_t i = 0; i < count; i++) {
+    JsonVariant member = doc[compositeFieldName(kind, i)];
+    if (member.is<double>() || member.is<int>()) {
+      f[i] = member.as<double>();
+    } else if (!(kind == PV_POSITION && i == 2)) {
+      return false;
+    }
+  }
+
+  setPathComposite(id, kind, f[0], f[1], f[2], source);
+  return true;
+}
+
+void pathValueToJson(const PathValue& pv, JsonObject obj, const char* key) {
+  switch (pv.kind) {
+    case PV_NUMBER:
+      obj[key] = pv.numValue;
+      break;
+    case PV_STRING:
+      obj[key] = pv.textValue();
+      break;
+    case PV_JSON: {
+      DynamicJsonDocument valueDoc(512);
+      DeserializationError err = deserializeJson(valueDoc, pv.textValue());
+      if (!err) {
+        obj[key] = valueDoc.as<JsonVariant>();
+      } else {
+        obj[key] = pv.textValue();
+      }
+      break;
+    }
+    case PV_POSITION:
+    case PV_ATTITUDE:
+    case PV_CURRENT: {
+      JsonObject value = obj.createNestedObject(key);
+      uint8_t count = compositeFieldCount(pv.kind);
+      for (uint8_t i = 0; i < count; i++) {
+        if (!isnan(pv.fields[i])) {
+          value[compositeFieldName(pv.kind, i)] = pv.fields[i];
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 void setPathValueJson(const String& path, const String& jsonValue, const String& source,
                       const String& units, const String& description) {
   // Validate path
@@ -344,21 +925,21 @@ void setPathValueJson(const String& path, const String& jsonValue, const String&
     Serial.println("ERROR: setPathValueJson called with empty path");
     return;
   }
+  if (deferStoreWrite(STORE_WRITE_JSON, path, 0.0, jsonValue, source, units, description)) {
+    return;
+  }
 
   String normalized = jsonValue;
   if (path == "navigation.anchor.akat") {
     normalized = normalizeAnchorConfig(jsonValue);
   }
 
-  PathValue& pv = dataStore[path];
-  pv.isNumeric = false;
-  pv.isJson = true;
-  pv.jsonValue = normalized;
-  pv.timestamp = iso8601Now();
-  pv.source = source;
-  pv.units = units;
-  pv.description = description;
-  pv.changed = true;
+  PathId id = registerPath(path, units, description);
+  SourceId sourceId = registerSource(source);
+  PathValueKind composite = compositeKindForPath(path);
+  if (composite == PV_NONE || !storeCompositeJson(id, composite, normalized, sourceId)) {
+    storePathJson(id, normalized, sourceId);
+  }
 
   // Persist important configuration paths to flash
   if (path == "navigation.anchor.akat") {
@@ -366,23 +947,24 @@ void setPathValueJson(const String& path, const String& jsonValue, const String&
   }
 }
 
-void updateNavigationPosition(double lat, double lon, const String& source) {
+void updateNavigationPosition(double lat, double lon, SourceId source) {
   if (isnan(lat) || isnan(lon)) {
     Serial.println("Position update rejected - NaN values");
     return;
   }
+  if (deferIngestUpdate(INGEST_SET_POSITION, INVALID_PATH_ID, PV_POSITION, source, lat, lon)) {
+    return;
+  }
 
-  DynamicJsonDocument doc(128);
-  doc["latitude"] = lat;
-  doc["longitude"] = lon;
-
-  String json;
-  serializeJson(doc, json);
-
-  setPathValueJson("navigation.position", json, source, "", "Vessel position");
+  static PathId positionId = registerPath("navigation.position", "", "Vessel position");
+  setPathComposite(positionId, PV_POSITION, lat, lon, NAN, source);
 
   // Trigger geofence monitoring
-  updateGeofence();
+  updateGeofence(lat, lon);
+}
+
+void updateNavigationPosition(double lat, double lon, const String& source) {
+  updateNavigationPosition(lat, lon, registerSource(source));
 }
 
 void setNotification(const String& path, const String& state, const String& message) {
@@ -3,23 +3,128 @@
 
 #include <Arduino.h>
 #include <map>
+#include "../config.h"
 #include "../types.h"
 
-// Global data store for SignalK paths
-extern std::map<String, PathValue> dataStore;
-extern std::map<String, PathValue> lastSentValues;
+// Global data store for SignalK paths.
+// Every path is interned once into a PathId; values live in a flat array
+// indexed by that ID so hot-path updates are O(1) and allocation-free.
+extern PathValue dataStore[MAX_SIGNALK_PATHS];
 extern std::map<String, String> notifications;
 
-// Path operations
+// Concurrency
+// The loop task is the only writer and may use dataStore[] and
+// getPathMeta() directly. Other tasks (AsyncTCP handlers) read through
+// readPathValue()/readPathMeta() and never block it:
+// - each value has a sequence counter (seqlock); a reader copies the value
+//   and retries if a write overlapped
+// - string/JSON payloads and metadata are immutable shared objects that are
+//   replaced, never modified, so a snapshot stays valid while it is
+//   serialized
+// - name-based setters called on another task are queued and applied by
+//   processDeferredStoreWrites()
+// Path names, groups and sources never change once registered, so their
+// getters are safe from any task.
+
+// Make the calling task the writer (call once, early in setup())
+void setDataStoreWriter();
+
+// True on the writer task (and on any task before setDataStoreWriter())
+bool isDataStoreWriter();
+
+// Consistent copy of a value; false if the path has no value yet
+bool readPathValue(PathId id, PathValue& out);
+
+// Current metadata of a path, for use on any task
+PathMetaRef readPathMeta(PathId id);
+
+// Apply name-based updates queued by other tasks (call every loop() pass)
+void processDeferredStoreWrites();
+
+// Updates queued by other tasks, and those dropped because the queue was full
+uint32_t getDeferredStoreWrites();
+uint32_t getDroppedStoreWrites();
+
+// Path registry
+// Returns the existing ID if the path is already registered. Units and
+// description are only applied when the path is first created or when the
+// stored metadata is empty. Returns INVALID_PATH_ID when the table is full.
+PathId registerPath(const String& path, const String& units = "", const String& description = "");
+
+// Look up a path without registering it (INVALID_PATH_ID if unknown)
+PathId findPath(const String& path);
+
+// Static metadata (units, description) of a registered path; writer task only,
+// other tasks use readPathMeta()
+const PathMeta& getPathMeta(PathId id);
+
+// Name of a registered path
+const String& getPathName(PathId id);
+
+// Number of registered paths (valid IDs are 0 .. getPathCount() - 1)
+PathId getPathCount();
+
+// Top-level groups
+// Each path belongs to the group named by its first segment. A group's
+// version changes whenever a value or metadata under it does, so cached
+// serializations can be checked per subtree.
+GroupId getPathGroup(PathId id);
+GroupId getGroupCount();
+const String& getGroupName(GroupId group);
+uint32_t getGroupVersion(GroupId group);
+
+// Change tracking
+// Paths changed since the last clearDirtyPaths(), in first-change order.
+// Further updates to an already-dirty path are coalesced and counted.
+PathId getDirtyCount();
+const PathId* getDirtyPaths();
+
+// Reset the changed flags of all dirty paths and empty the list
+void clearDirtyPaths();
+
+// Updates to a path that were overwritten before being broadcast
+uint32_t getCoalescedUpdates(PathId id);
+uint32_t getTotalCoalescedUpdates();
+
+// Source registry
+// Interns an update source label; returns the existing ID if already known
+// and INVALID_SOURCE_ID when the table is full.
+SourceId registerSource(const String& label);
+
+// Label of a registered source ("" if unknown)
+const String& getSourceName(SourceId id);
+
+// Path operations by ID (hot path - IDs resolved once at startup)
+// Numbers set on the ingest task are queued for the loop task; the string
+// variant is loop-task only and drops (with an error) updates from any other
+// task. Parsers that need strings use the name-based setter.
+void setPathValue(PathId id, double value, SourceId source);
+void setPathValue(PathId id, const String& value, SourceId source);
+
+// Path operations by name (interns the path on first use)
 void setPathValue(const String& path, double value, const String& source = "nmea0183.GPS",
                   const String& units = "", const String& description = "");
 
 void setPathValue(const String& path, const String& value, const String& source = "nmea0183.GPS",
                   const String& units = "", const String& description = "");
 
+// Stores jsonValue as re-serialized by ArduinoJson; input that does not parse
+// is stored as a string value instead
 void setPathValueJson(const String& path, const String& jsonValue, const String& source = "nmea0183.GPS",
                       const String& units = "", const String& description = "");
 
+// Composite values: small fixed objects (position, attitude, current) kept
+// as native doubles in PathValue::fields, in compositeFieldName() order.
+// NaN members are left out when the value is serialized.
+uint8_t compositeFieldCount(PathValueKind kind);
+const char* compositeFieldName(PathValueKind kind, uint8_t index);
+void setPathComposite(PathId id, PathValueKind kind, double f0, double f1, double f2, SourceId source);
+
+// Write a stored value as obj[key]. Numbers, strings and composite kinds
+// are written directly; only PV_JSON needs a parse.
+void pathValueToJson(const PathValue& pv, JsonObject obj, const char* key);
+
+void updateNavigationPosition(double lat, double lon, SourceId source);
 void updateNavigationPosition(double lat, double lon, const String& source = "nmea0183.GPS");
 
 bool handleAnchorPartialUpdate(const String& path, bool isNumeric, double numericValue,
@@ -0,0 +1,231 @@
+#include "delta_writer.h"
+#include "data_store.h"
+#include "../utils/time_utils.h"
+#include <math.h>
+#include <string.h>
+
+// Fixed pieces of the delta envelope, shared by the writer and the estimate
+static const char kDeltaOpen[] = "{\"context\":";
+static const char kUpdatesOpen[] = ",\"updates\":[{\"timestamp\":";
+static const char kSourceAndValues[] =
+  ",\"source\":{\"label\":\"ESP32-SignalK\",\"type\":\"NMEA0183\"},\"values\":[";
+static const char kDeltaClose[] = "]}]}";
+
+static const char kPathKey[] = "{\"path\":";
+static const char kValueKey[] = ",\"value\":";
+static const char kUnitsKey[] = ",\"units\":";
+static const char kDescriptionKey[] = ",\"description\":";
+
+#define LITERAL_LEN(s) (sizeof(s) - 1)
+
+size_t estimatePathValueSize(const PathValue& pv) {
+  switch (pv.kind) {
+    case PV_NUMBER:
+      return JsonWriter::kMaxNumberLength;
+    case PV_STRING:
+      return JsonWriter::quotedLength(pv.textValue());
+    case PV_JSON:
+      return pv.textValue().length() > 0 ? pv.textValue().length() : 4;
+    case PV_POSITION:
+    case PV_ATTITUDE:
+    case PV_CURRENT: {
+      size_t size = 2;
+      uint8_t count = compositeFieldCount(pv.kind);
+      for (uint8_t i = 0; i < count; i++) {
+        size += strlen(compositeFieldName(pv.kind, i)) + 4 + JsonWriter::kMaxNumberLength;
+      }
+      return size;
+    }
+    default:
+      return 4;
+  }
+}
+
+void writePathValue(JsonWriter& out, const PathValue& pv) {
+  switch (pv.kind) {
+    case PV_NUMBER:
+      out.number(pv.numValue);
+      break;
+    case PV_STRING:
+      out.string(pv.textValue());
+      break;
+    case PV_JSON: {
+      // Re-serialized by ArduinoJson when stored (storePathJson), so valid
+      // JSON that can be emitted verbatim
+      const String& json = pv.textValue();
+      if (json.length() > 0) {
+        out.raw(json.c_str(), json.length());
+      } else {
+        out.raw("null");
+      }
+      break;
+    }
+    case PV_POSITION:
+    case PV_ATTITUDE:
+    case PV_CURRENT: {
+      out.raw('{');
+      bool first = true;
+      uint8_t count = compositeFieldCount(pv.kind);
+      for (uint8_t i = 0; i < count; i++) {
+        if (isnan(pv.fields[i])) continue;
+        if (!first) out.raw(',');
+        out.key(compositeFieldName(pv.kind, i));
+        out.number(pv.fields[i]);
+        first = false;
+      }
+      out.raw('}');
+      break;
+    }
+    default:
+      out.raw("null");
+      break;
+  }
+}
+
+// Exact size of the envelope around the values array
+static size_t deltaEnvelopeSize(const String& context, size_t timestampLen) {
+  return LITERAL_LEN(kDeltaOpen) + JsonWriter::quotedLength(context) +
+         LITERAL_LEN(kUpdatesOpen) + 2 + timestampLen +
+         LITERAL_LEN(kSourceAndValues) + LITERAL_LEN(kDeltaClose);
+}
+
+static void writeDeltaOpen(JsonWriter& out, const String& context, const char* ts, size_t tsLen) {
+  out.raw(kDeltaOpen, LITERAL_LEN(kDeltaOpen));
+  out.string(context);
+  out.raw(kUpdatesOpen, LITERAL_LEN(kUpdatesOpen));
+  out.string(ts, tsLen);
+  out.raw(kSourceAndValues, LITERAL_LEN(kSourceAndValues));
+}
+
+static void writeDeltaClose(JsonWriter& out) {
+  out.raw(kDeltaClose, LITERAL_LEN(kDeltaClose));
+}
+
+// Upper bound for one {"path":...,"value":...} entry
+static size_t estimateDeltaValueSize(PathId id, const PathValue& pv, const PathMeta& meta) {
+  size_t size = LITERAL_LEN(kPathKey) + JsonWriter::quotedLength(getPathName(id)) +
+                LITERAL_LEN(kValueKey) + estimatePathValueSize(pv) + 1;
+  if (meta.units.length() > 0) {
+    size += LITERAL_LEN(kUnitsKey) + JsonWriter::quotedLength(meta.units);
+  }
+  if (meta.description.length() > 0) {
+    size += LITERAL_LEN(kDescriptionKey) + JsonWriter::quotedLength(meta.description);
+  }
+  return size;
+}
+
+static void writeDeltaValue(JsonWriter& out, PathId id, const PathValue& pv, const PathMeta& meta) {
+  out.raw(kPathKey, LITERAL_LEN(kPathKey));
+  out.string(getPathName(id));
+  out.raw(kValueKey, LITERAL_LEN(kValueKey));
+  writePathValue(out, pv);
+  if (meta.units.length() > 0) {
+    out.raw(kUnitsKey, LITERAL_LEN(kUnitsKey));
+    out.string(meta.units);
+  }
+  if (meta.description.length() > 0) {
+    out.raw(kDescriptionKey, LITERAL_LEN(kDescriptionKey));
+    out.string(meta.description);
+  }
+  out.raw('}');
+}
+
+// ====== SNAPSHOT DELTAS ======
+
+void DeltaSnapshot::capture(const PathId* pathIds, size_t count) {
+  ids.clear();
+  values.clear();
+  metas.clear();
+  PathValue pv;
+  for (size_t i = 0; i < count; i++) {
+    if (!readPathValue(pathIds[i], pv)) continue;
+    ids.push_back(pathIds[i]);
+    values.push_back(pv);
+    metas.push_back(readPathMeta(pathIds[i]));
+  }
+}
+
+size_t estimateDeltaSize(const String& context, const DeltaSnapshot& snapshot) {
+  size_t size = deltaEnvelopeSize(context, ISO8601_BUF_LEN);
+  for (size_t i = 0; i < snapshot.ids.size(); i++) {
+    size += 1 + estimateDeltaValueSize(snapshot.ids[i], snapshot.values[i], *snapshot.metas[i]);
+  }
+  return size;
+}
+
+size_t writeDelta(JsonWriter& out, const String& context, uint64_t timestamp,
+                  const DeltaSnapshot& snapshot) {
+  char ts[ISO8601_BUF_LEN];
+  size_t tsLen = formatIso8601(timestamp, ts, sizeof(ts));
+
+  writeDeltaOpen(out, context, ts, tsLen);
+  for (size_t i = 0; i < snapshot.ids.size(); i++) {
+    if (i > 0) out.raw(',');
+    writeDeltaValue(out, snapshot.ids[i], snapshot.values[i], *snapshot.metas[i]);
+  }
+  writeDeltaClose(out);
+  return snapshot.ids.size();
+}
+
+// ====== FRAGMENT CACHE ======
+
+void DeltaFragmentCache::beginTick(uint64_t timestamp) {
+  _tick++;
+  if (_tick == 0) {
+    // Wrapped: stale stamps could alias the new tick, so clear them
+    memset(_stamp, 0, sizeof(_stamp));
+    _tick = 1;
+  }
+  _used = 0;
+  _tsLen = formatIso8601(timestamp, _ts, sizeof(_ts));
+}
+
+bool DeltaFragmentCache::ensure(PathId id) {
+  if (id >= MAX_SIGNALK_PATHS || dataStore[id].kind == PV_NONE) {
+    return false;
+  }
+  if (_stamp[id] == _tick) {
+    return true;
+  }
+
+  size_t estimate = estimateDeltaValueSize(id, dataStore[id], getPathMeta(id));
+  if (_pool.size() < _used + estimate) {
+    _pool.resize(_used + estimate);  // High-water mark; never shrinks
+  }
+  JsonWriter out(_pool.data() + _used, estimate);
+  writeDeltaValue(out, id, dataStore[id], getPathMeta(id));
+  if (out.overflowed()) {
+    return false;
+  }
+
+  _offset[id] = _used;
+  _length[id] = out.length();
+  _stamp[id] = _tick;
+  _used += out.length();
+  return true;
+}
+
+size_t DeltaFragmentCache::deltaSize(const String& context, const PathId* ids, size_t count) {
+  size_t size = deltaEnvelopeSize(context, _tsLen);
+  size_t values = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!ensure(ids[i])) continue;
+    size += _length[ids[i]] + (values > 0 ? 1 : 0);
+    values++;
+  }
+  return size;
+}
+
+size_t DeltaFragmentCache::writeDelta(JsonWriter& out, const String& context,
+                                      const PathId* ids, size_t count) {
+  writeDeltaOpen(out, context, _ts, _tsLen);
+  size_t written = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!ensure(ids[i])) continue;
+    if (written > 0) out.raw(',');
+    out.raw(_pool.data() + _offset[ids[i]], _length[ids[i]]);
+    written++;
+  }
+  writeDeltaClose(out);
+  return written;
+}
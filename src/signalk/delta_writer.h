@@ -0,0 +1,84 @@
+#ifndef SIGNALK_DELTA_WRITER_H
+#define SIGNALK_DELTA_WRITER_H
+
+#include <Arduino.h>
+#include <vector>
+#include "../config.h"
+#include "../types.h"
+#include "../utils/json_writer.h"
+#include "../utils/time_utils.h"
+
+/**
+ * Streaming SignalK delta serializer
+ *
+ * Writes a delta message straight from the data store into a caller buffer:
+ *   {"context":"...","updates":[{"timestamp":"...","source":{...},"values":[...]}]}
+ * Paths are validated when they are registered, so no post-serialization
+ * check is needed. IDs without a value are skipped.
+ */
+
+/**
+ * Values captured for serialization off the loop task
+ * capture() copies each path with readPathValue()/readPathMeta(), so the
+ * size estimate and the delta written from it always agree while the store
+ * keeps changing. Paths without a value are left out.
+ */
+struct DeltaSnapshot {
+  std::vector<PathId> ids;
+  std::vector<PathValue> values;
+  std::vector<PathMetaRef> metas;
+
+  void capture(const PathId* pathIds, size_t count);
+};
+
+// Upper bound on the bytes writeDelta() produces for a snapshot
+size_t estimateDeltaSize(const String& context, const DeltaSnapshot& snapshot);
+
+/**
+ * Serialize a delta for the captured paths
+ * @param out Destination writer (check out.overflowed() afterwards)
+ * @param context SignalK context, e.g. "vessels.urn:mrn:signalk:uuid:..."
+ * @param timestamp Update timestamp in epoch millis (0 = clock not set)
+ * @return Number of values written
+ */
+size_t writeDelta(JsonWriter& out, const String& context, uint64_t timestamp,
+                  const DeltaSnapshot& snapshot);
+
+// Upper bound on the bytes writePathValue() produces
+size_t estimatePathValueSize(const PathValue& pv);
+
+// Write a stored value as a JSON value (number, string, object or null)
+void writePathValue(JsonWriter& out, const PathValue& pv);
+
+/**
+ * Per-broadcast cache of serialized delta values
+ *
+ * Each path is serialized at most once per tick into a shared pool, however
+ * many client groups include it. Deltas are then assembled by copying the
+ * cached fragments, and their exact size is known before allocation.
+ */
+class DeltaFragmentCache {
+public:
+  // Invalidate all fragments and fix the update timestamp for this tick
+  void beginTick(uint64_t timestamp);
+
+  // Exact size of the delta writeDelta() will produce for these paths
+  size_t deltaSize(const String& context, const PathId* ids, size_t count);
+
+  // Assemble a delta from cached fragments; returns the number of values
+  size_t writeDelta(JsonWriter& out, const String& context, const PathId* ids, size_t count);
+
+private:
+  bool ensure(PathId id);
+
+  std::vector<char> _pool;
+  size_t _used = 0;
+  uint32_t _tick = 0;
+  uint32_t _stamp[MAX_SIGNALK_PATHS] = {};   // Tick a fragment was written in
+  uint32_t _offset[MAX_SIGNALK_PATHS] = {};
+  uint16_t _length[MAX_SIGNALK_PATHS] = {};
+  char _ts[ISO8601_BUF_LEN] = {};
+  size_t _tsLen = 0;
+};
+
+#endif // SIGNALK_DELTA_WRITER_H
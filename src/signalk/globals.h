@@ -5,10 +5,11 @@
 #include <Preferences.h>
 #include <map>
 #include <vector>
+#include "../config.h"
 #include "../types.h"
 
 // Forward declarations for external dependencies
-void updateGeofence();
+void updateGeofence(double lat, double lon);
 void updateDepthAlarm(double depth);
 void updateWindAlarm(double windSpeedMS);
 
@@ -16,8 +17,7 @@ void updateWindAlarm(double windSpeedMS);
 extern Preferences prefs;
 
 // ====== SIGNALK DATA ======
-extern std::map<String, PathValue> dataStore;
-extern std::map<String, PathValue> lastSentValues;
+extern PathValue dataStore[MAX_SIGNALK_PATHS];
 extern std::map<String, String> notifications;
 
 // ====== GPS DATA ======
@@ -0,0 +1,272 @@
+#include "subscriptions.h"
+#include "data_store.h"
+#include <algorithm>
+#include <string.h>
+
+// Upper bound on how long a client with only idle paths goes unchecked
+static const uint32_t kMaxCheckInterval = 60000;
+
+// ====== SUBSCRIBER TABLE ======
+// Every subscribed client owns one bit; subscriberMask[id] has the bits of
+// all clients subscribed to path id, so fanning a change out is a lookup.
+static ClientSubscription* slots[WS_MAX_SUBSCRIBERS];
+static uint32_t subscriberMask[MAX_SIGNALK_PATHS];
+
+// ====== PATTERN MATCHING ======
+
+// Classic glob within one segment: '*' matches any run of characters
+static bool globMatch(const char* p, size_t pn, const char* s, size_t sn) {
+  size_t pi = 0, si = 0;
+  size_t starP = SIZE_MAX, starS = 0;
+  while (si < sn) {
+    if (pi < pn && p[pi] == '*') {
+      starP = pi++;
+      starS = si;
+    } else if (pi < pn && p[pi] == s[si]) {
+      pi++;
+      si++;
+    } else if (starP != SIZE_MAX) {
+      pi = starP + 1;
+      si = ++starS;
+    } else {
+      return false;
+    }
+  }
+  while (pi < pn && p[pi] == '*') pi++;
+  return pi == pn;
+}
+
+// Segment-aware SignalK wildcard match. Each pattern segment matches one
+// path segment and may contain '*' anywhere ("propulsion.*.oilTemperature",
+// "environment.wind.speed*"). A '*' ending the pattern also swallows any
+// further segments, so "navigation.*" covers "navigation.course.bearing".
+bool subscriptionPatternMatches(const char* pattern, const char* path) {
+  if (pattern[0] == '\0' || strcmp(pattern, "*") == 0) {
+    return true;
+  }
+
+  while (true) {
+    const char* patternEnd = strchr(pattern, '.');
+    const char* pathEnd = strchr(path, '.');
+    size_t pn = patternEnd ? (size_t)(patternEnd - pattern) : strlen(pattern);
+    size_t sn = pathEnd ? (size_t)(pathEnd - path) : strlen(path);
+
+    if (!patternEnd) {
+      // Last pattern segment; a trailing '*' may span the rest of the path
+      if (pn > 0 && pattern[pn - 1] == '*') {
+        return globMatch(pattern, pn, path, strlen(path));
+      }
+      return !pathEnd && globMatch(pattern, pn, path, sn);
+    }
+
+    if (!pathEnd || !globMatch(pattern, pn, path, sn)) {
+      return false;
+    }
+    pattern = patternEnd + 1;
+    path = pathEnd + 1;
+  }
+}
+
+bool subscriptionPatternMatches(const String& pattern, const String& path) {
+  return subscriptionPatternMatches(pattern.c_str(), path.c_str());
+}
+
+// ====== PATH RESOLUTION ======
+
+// Match paths registered since the last call against the entries and
+// publish them in the subscriber mask. When an entry is added or removed
+// everything is re-matched, but per-path send history is kept so policies
+// stay continuous.
+static void resolveSubscriptionPaths(ClientSubscription& sub) {
+  PathId count = getPathCount();
+  if (sub.resolvedCount == count) {
+    return;
+  }
+  if (sub.paths.size() < count) {
+    sub.paths.resize(count);
+  }
+  uint32_t bit = sub.slot < WS_MAX_SUBSCRIBERS ? (1UL << sub.slot) : 0;
+
+  for (PathId id = sub.resolvedCount; id < count; id++) {
+    const char* path = getPathName(id).c_str();
+    uint8_t entry = SUBSCRIPTION_NO_ENTRY;
+    // Later entries override earlier ones for the same path
+    for (size_t i = sub.entries.size(); i-- > 0;) {
+      if (subscriptionPatternMatches(sub.entries[i].pattern.c_str(), path)) {
+        entry = (uint8_t)i;
+        break;
+      }
+    }
+    sub.paths[id].entry = entry;
+    if (entry != SUBSCRIPTION_NO_ENTRY) {
+      sub.subscribedIds.push_back(id);
+      subscriberMask[id] |= bit;
+    } else {
+      subscriberMask[id] &= ~bit;
+    }
+  }
+  sub.resolvedCount = count;
+}
+
+// Recompile after the entries changed
+static void rebuildSubscriptionPaths(ClientSubscription& sub) {
+  sub.resolvedCount = 0;
+  sub.subscribedIds.clear();
+  resolveSubscriptionPaths(sub);
+  sub.nextCheck = millis();  // Re-evaluate on the next scan
+}
+
+static bool attachSubscription(ClientSubscription& sub) {
+  if (sub.slot != SUBSCRIPTION_NO_SLOT) {
+    return true;
+  }
+  for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS; i++) {
+    if (!slots[i]) {
+      slots[i] = &sub;
+      sub.slot = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+void detachSubscription(ClientSubscription& sub) {
+  if (sub.slot >= WS_MAX_SUBSCRIBERS) {
+    return;
+  }
+  uint32_t bit = 1UL << sub.slot;
+  for (PathId id : sub.subscribedIds) {
+    subscriberMask[id] &= ~bit;
+  }
+  slots[sub.slot] = nullptr;
+  sub.slot = SUBSCRIPTION_NO_SLOT;
+}
+
+bool addSubscription(ClientSubscription& sub, const SubscriptionEntry& entry) {
+  if (!attachSubscription(sub)) {
+    return false;
+  }
+  for (auto& existing : sub.entries) {
+    if (existing.pattern == entry.pattern) {
+      existing = entry;
+      rebuildSubscriptionPaths(sub);
+      return true;
+    }
+  }
+  if (sub.entries.size() >= MAX_SUBSCRIPTION_ENTRIES) {
+    return false;
+  }
+  sub.entries.push_back(entry);
+  rebuildSubscriptionPaths(sub);
+  return true;
+}
+
+void removeSubscription(ClientSubscription& sub, const String& pattern) {
+  if (pattern == "*") {
+    sub.entries.clear();
+  } else {
+    for (auto it = sub.entries.begin(); it != sub.entries.end(); ++it) {
+      if (it->pattern == pattern) {
+        sub.entries.erase(it);
+        break;
+      }
+    }
+  }
+  rebuildSubscriptionPaths(sub);
+}
+
+bool isPathSubscribed(ClientSubscription& sub, PathId id) {
+  resolveSubscriptionPaths(sub);
+  return id < sub.paths.size() && sub.paths[id].entry != SUBSCRIPTION_NO_ENTRY;
+}
+
+uint32_t getPathSubscribers(PathId id) {
+  return id < MAX_SIGNALK_PATHS ? subscriberMask[id] : 0;
+}
+
+void markSubscriptionsChanged(const PathId* ids, size_t count) {
+  // Publish paths registered since the last pass before using the mask
+  for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS; i++) {
+    if (slots[i]) {
+      resolveSubscriptionPaths(*slots[i]);
+    }
+  }
+
+  for (size_t n = 0; n < count; n++) {
+    PathId id = ids[n];
+    uint32_t mask = getPathSubscribers(id);
+    while (mask) {
+      uint8_t slot = __builtin_ctz(mask);
+      mask &= mask - 1;
+      ClientSubscription& sub = *slots[slot];
+      sub.paths[id].pending = true;
+      sub.hasPending = true;
+    }
+  }
+}
+
+// ====== SCHEDULING ======
+
+void collectDuePaths(ClientSubscription& sub, uint32_t now, std::vector<PathId>& due) {
+  // Nothing changed and no periodic send is due yet
+  if (!sub.hasPending && (int32_t)(now - sub.nextCheck) < 0) {
+    return;
+  }
+  resolveSubscriptionPaths(sub);
+
+  uint32_t wait = kMaxCheckInterval;
+  for (PathId id : sub.subscribedIds) {
+    ClientPathState& st = sub.paths[id];
+    if (dataStore[id].kind == PV_NONE) continue;
+
+    const SubscriptionEntry& e = sub.entries[st.entry];
+    uint32_t since = now - st.lastSent;
+    bool rateOk = !st.sent || since >= e.minPeriod;
+    bool periodic = e.period > 0 && (!st.sent || since >= e.period);
+
+    bool isDue;
+    switch (e.policy) {
+      case POLICY_INSTANT:
+        isDue = st.pending && rateOk;
+        break;
+      case POLICY_FIXED:
+        isDue = e.period > 0 ? periodic : (st.pending && rateOk);
+        break;
+      case POLICY_IDEAL:
+      default:
+        isDue = (st.pending && rateOk) || (st.sent && periodic);
+        break;
+    }
+
+    if (isDue) {
+      due.push_back(id);
+      st.lastSent = now;
+      st.pending = false;
+      st.sent = true;
+      since = 0;
+    }
+
+    // Earliest time this path can become due again
+    if (st.pending && e.policy != POLICY_FIXED && e.minPeriod > since) {
+      wait = std::min(wait, e.minPeriod - since);
+    }
+    if (e.policy != POLICY_INSTANT && e.period > 0) {
+      wait = std::min(wait, e.period > since ? e.period - since : (uint32_t)0);
+    }
+  }
+
+  sub.hasPending = false;
+  sub.nextCheck = now + wait;
+}
+
+void collectSnapshotPaths(ClientSubscription& sub, uint32_t now, std::vector<PathId>& out) {
+  resolveSubscriptionPaths(sub);
+  for (PathId id : sub.subscribedIds) {
+    if (dataStore[id].kind == PV_NONE) continue;
+    ClientPathState& st = sub.paths[id];
+    st.lastSent = now;
+    st.pending = false;
+    st.sent = true;
+    out.push_back(id);
+  }
+}
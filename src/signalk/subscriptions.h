@@ -0,0 +1,73 @@
+#ifndef SIGNALK_SUBSCRIPTIONS_H
+#define SIGNALK_SUBSCRIPTIONS_H
+
+#include <Arduino.h>
+#include <vector>
+#include "../types.h"
+
+/**
+ * SignalK subscription scheduler
+ *
+ * Tracks, per client, which paths are subscribed under which policy and
+ * when each path was last sent. Changes are coalesced: a path changing ten
+ * times between sends is delivered once with its latest value.
+ *
+ * Subscribe patterns are compiled once per subscribe/unsubscribe into a
+ * per-path bitmask of interested clients (one bit per client slot, up to
+ * WS_MAX_SUBSCRIBERS), so routing a change costs one lookup instead of a
+ * pattern match per client.
+ *
+ * Transport-agnostic; the WebSocket service feeds it changes and sends
+ * whatever collectDuePaths() returns.
+ *
+ * Not thread-safe: call only from the loop task. The WebSocket service
+ * queues subscribe, unsubscribe and disconnect from the AsyncTCP task and
+ * applies them in processWebSocketRequests().
+ */
+
+// Maximum subscribe entries per client
+#define MAX_SUBSCRIPTION_ENTRIES 32
+
+/**
+ * Add an entry, replacing any existing entry with the same pattern
+ * @return false if the client already has MAX_SUBSCRIPTION_ENTRIES entries
+ *         or all WS_MAX_SUBSCRIBERS slots are taken
+ */
+bool addSubscription(ClientSubscription& sub, const SubscriptionEntry& entry);
+
+// Remove the entry for pattern; "*" removes every entry
+void removeSubscription(ClientSubscription& sub, const String& pattern);
+
+// Release the client's subscriber slot (call before destroying sub)
+void detachSubscription(ClientSubscription& sub);
+
+/**
+ * True if path matches a subscription pattern
+ * '*' matches within a segment ("propulsion.*.oilTemperature",
+ * "environment.wind.speed*"); a trailing '*' also matches deeper segments
+ * ("navigation.*"). "" and "*" match everything.
+ */
+bool subscriptionPatternMatches(const char* pattern, const char* path);
+bool subscriptionPatternMatches(const String& pattern, const String& path);
+
+// True if the client is subscribed to the path
+bool isPathSubscribed(ClientSubscription& sub, PathId id);
+
+// Bitmask of client slots subscribed to a path
+uint32_t getPathSubscribers(PathId id);
+
+// Record changes to paths for every subscribed client
+void markSubscriptionsChanged(const PathId* ids, size_t count);
+
+/**
+ * Append the paths that are due for this client at time now
+ * Applies instant/ideal/fixed policies, minPeriod and period, and marks
+ * the returned paths as sent. Cheap when nothing is pending or due.
+ */
+void collectDuePaths(ClientSubscription& sub, uint32_t now, std::vector<PathId>& due);
+
+// Append every subscribed path that has a value and mark them as sent
+// (initial state after a subscribe message)
+void collectSnapshotPaths(ClientSubscription& sub, uint32_t now, std::vector<PathId>& out);
+
+#endif // SIGNALK_SUBSCRIPTIONS_H
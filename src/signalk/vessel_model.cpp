@@ -0,0 +1,299 @@
+#include "vessel_model.h"
+#include "data_store.h"
+#include "delta_writer.h"
+#include "../utils/json_writer.h"
+#include "../utils/time_utils.h"
+#include <algorithm>
+#include <string.h>
+
+// Fixed pieces of a leaf: "value":...,"timestamp":"...","meta":{...},"$source":{"label":"..."}
+static const char kValueKey[] = "\"value\":";
+static const char kTimestampKey[] = ",\"timestamp\":";
+static const char kMetaOpen[] = ",\"meta\":{";
+static const char kUnitsKey[] = "\"units\":";
+static const char kDescriptionKey[] = "\"description\":";
+static const char kSourceOpen[] = "},\"$source\":{\"label\":";
+
+#define LITERAL_LEN(s) (sizeof(s) - 1)
+
+// One dot-separated piece of an interned path name
+struct Segment {
+  const char* text;
+  size_t len;
+};
+
+// Cached serialization of one top-level group: ,"group":{...}
+struct GroupCache {
+  std::vector<PathId> ids;   // Paths in the group, in segment order
+  ModelFragment fragment;    // nullptr until first built
+  size_t values = 0;         // Paths with a value in fragment
+  uint32_t version = 0;      // getGroupVersion() the fragment was built from
+  uint32_t builtAt = 0;
+};
+
+static GroupCache groups[MAX_SIGNALK_GROUPS];
+static PathId indexedPaths = 0;
+static VesselModelStats stats;
+
+// ====== SNAPSHOT ======
+
+void VesselModelSnapshot::append(const ModelFragment& fragment) {
+  _parts.push_back(fragment);
+  _length += fragment->size();
+}
+
+size_t VesselModelSnapshot::read(size_t offset, uint8_t* buffer, size_t maxLen) const {
+  size_t copied = 0;
+  for (const ModelFragment& part : _parts) {
+    if (copied == maxLen) break;
+    size_t size = part->size();
+    if (offset >= size) {
+      offset -= size;
+      continue;
+    }
+    size_t n = std::min(size - offset, maxLen - copied);
+    memcpy(buffer + copied, part->data() + offset, n);
+    copied += n;
+    offset = 0;
+  }
+  return copied;
+}
+
+// ====== PATH ORDER ======
+
+// Order by segment: "a.b" < "a.b.c" < "a.b-x" < "a.bc", so all paths under
+// a prefix are adjacent and each nested object is opened exactly once
+static bool segmentLess(PathId a, PathId b) {
+  const char* x = getPathName(a).c_str();
+  const char* y = getPathName(b).c_str();
+  for (;; x++, y++) {
+    unsigned char cx = *x == '.' ? 1 : (unsigned char)*x;
+    unsigned char cy = *y == '.' ? 1 : (unsigned char)*y;
+    if (cx != cy) return cx < cy;
+    if (cx == 0) return false;
+  }
+}
+
+// Add paths registered since the last call to their group's ordered list
+static void indexNewPaths() {
+  PathId count = getPathCount();
+  for (; indexedPaths < count; indexedPaths++) {
+    GroupId group = getPathGroup(indexedPaths);
+    if (group == INVALID_GROUP_ID) continue;
+    std::vector<PathId>& ids = groups[group].ids;
+    ids.insert(std::upper_bound(ids.begin(), ids.end(), indexedPaths, segmentLess), indexedPaths);
+  }
+}
+
+// Segments of path after the group name (none for a path equal to its group)
+static void splitSegments(const String& path, size_t skip, std::vector<Segment>& out) {
+  out.clear();
+  const char* p = path.c_str();
+  size_t len = path.length();
+  size_t start = skip;
+  while (start < len) {
+    const char* dot = (const char*)memchr(p + start, '.', len - start);
+    size_t end = dot ? (size_t)(dot - p) : len;
+    out.push_back({p + start, end - start});
+    start = end + 1;
+  }
+}
+
+// ====== GROUP SERIALIZATION ======
+
+// A path's value and metadata as read at the start of a group rebuild
+struct LeafSnapshot {
+  PathId id;
+  PathValue value;
+  PathMetaRef meta;
+};
+
+// Upper bound on the bytes writeLeaf() produces
+static size_t leafSize(const LeafSnapshot& leaf) {
+  const PathValue& pv = leaf.value;
+  const PathMeta& meta = *leaf.meta;
+  size_t size = LITERAL_LEN(kValueKey) + estimatePathValueSize(pv) +
+                LITERAL_LEN(kTimestampKey) + ISO8601_BUF_LEN + 2 +
+                LITERAL_LEN(kMetaOpen) + LITERAL_LEN(kSourceOpen) +
+                JsonWriter::quotedLength(getSourceName(pv.source)) + 1;
+  size += LITERAL_LEN(kUnitsKey) + JsonWriter::quotedLength(meta.units) + 1;
+  size += LITERAL_LEN(kDescriptionKey) + JsonWriter::quotedLength(meta.description);
+  return size;
+}
+
+static void writeLeaf(JsonWriter& w, const LeafSnapshot& leaf) {
+  const PathValue& pv = leaf.value;
+  const PathMeta& meta = *leaf.meta;
+
+  w.raw(kValueKey, LITERAL_LEN(kValueKey));
+  writePathValue(w, pv);
+
+  char ts[ISO8601_BUF_LEN];
+  size_t tsLen = formatIso8601(pv.timestamp, ts, sizeof(ts));
+  w.raw(kTimestampKey, LITERAL_LEN(kTimestampKey));
+  w.string(ts, tsLen);
+
+  w.raw(kMetaOpen, LITERAL_LEN(kMetaOpen));
+  if (meta.units.length() > 0) {
+    w.raw(kUnitsKey, LITERAL_LEN(kUnitsKey));
+    w.string(meta.units);
+  }
+  if (meta.description.length() > 0) {
+    if (meta.units.length() > 0) w.raw(',');
+    w.raw(kDescriptionKey, LITERAL_LEN(kDescriptionKey));
+    w.string(meta.description);
+  }
+
+  w.raw(kSourceOpen, LITERAL_LEN(kSourceOpen));
+  w.string(getSourceName(pv.source));
+  w.raw('}');
+}
+
+// Serialize one group as ,"group":{...}. Paths arrive in segment order, so
+// the nesting is kept as a stack of open objects: close down to the prefix
+// shared with the previous path, open the rest. A leaf stays open until
+// the next path leaves it, so a value may also carry children (e.g.
+// navigation.anchor and navigation.anchor.akat).
+//
+// This runs on the web server task: every value is copied once with
+// readPathValue(), so sizing and writing see the same data while the loop
+// task keeps updating the store.
+static ModelFragment buildGroup(GroupCache& cache, const String& name, size_t& values) {
+  static std::vector<LeafSnapshot> leaves;
+  leaves.clear();
+  size_t capacity = JsonWriter::quotedLength(name) + 4;
+  for (PathId id : cache.ids) {
+    LeafSnapshot leaf;
+    if (!readPathValue(id, leaf.value)) continue;
+    leaf.id = id;
+    leaf.meta = readPathMeta(id);
+    const String& path = getPathName(id);
+    size_t depth = 1;
+    for (size_t i = 0; i < path.length(); i++) {
+      if (path[i] == '.') depth++;
+    }
+    capacity += JsonWriter::quotedLength(path) + 6 * depth + leafSize(leaf);
+    leaves.push_back(leaf);
+  }
+
+  std::shared_ptr<std::vector<char>> buffer = std::make_shared<std::vector<char>>(capacity);
+  JsonWriter w(buffer->data(), capacity);
+
+  static std::vector<Segment> segments;
+  static std::vector<Segment> open;
+  static std::vector<bool> hasMembers;  // Per open object, group object first
+  open.clear();
+  hasMembers.assign(1, false);
+  values = 0;
+
+  w.raw(',');
+  w.string(name);
+  w.raw(":{");
+
+  size_t skip = name.length() + 1;
+  for (const LeafSnapshot& leaf : leaves) {
+    splitSegments(getPathName(leaf.id), skip, segments);
+
+    size_t shared = 0;
+    while (shared < open.size() && shared < segments.size() &&
+           open[shared].len == segments[shared].len &&
+           memcmp(open[shared].text, segments[shared].text, segments[shared].len) == 0) {
+      shared++;
+    }
+    while (open.size() > shared) {
+      w.raw('}');
+      open.pop_back();
+      hasMembers.pop_back();
+    }
+    for (size_t i = shared; i < segments.size(); i++) {
+      if (hasMembers.back()) w.raw(',');
+      hasMembers.back() = true;
+      w.string(segments[i].text, segments[i].len);
+      w.raw(":{");
+      open.push_back(segments[i]);
+      hasMembers.push_back(false);
+    }
+
+    if (hasMembers.back()) w.raw(',');
+    hasMembers.back() = true;
+    writeLeaf(w, leaf);
+    values++;
+  }
+  leaves.clear();  // Drop the payload references until the next rebuild
+
+  for (size_t i = 0; i < open.size(); i++) {
+    w.raw('}');
+  }
+  w.raw('}');
+
+  if (w.overflowed()) {
+    Serial.printf("ERROR: Full model group '%s' exceeded its size estimate\n", name.c_str());
+    return nullptr;
+  }
+  buffer->resize(w.length());
+  buffer->shrink_to_fit();
+  return buffer;
+}
+
+// ====== PUBLIC API ======
+
+// "uuid" and "name" are written by the snapshot itself
+static bool isReservedGroup(const String& name) {
+  return name == "uuid" || name == "name";
+}
+
+VesselModelSnapshot getVesselModelSnapshot(const String& uuid, const String& name) {
+  static const ModelFragment kClose = std::make_shared<std::vector<char>>(1, '}');
+
+  stats.requests++;
+  indexNewPaths();
+
+  VesselModelSnapshot snapshot;
+
+  size_t headerCapacity = 20 + JsonWriter::quotedLength(uuid) + JsonWriter::quotedLength(name);
+  std::shared_ptr<std::vector<char>> header = std::make_shared<std::vector<char>>(headerCapacity);
+  JsonWriter w(header->data(), headerCapacity);
+  w.raw('{');
+  w.key("uuid");
+  w.string(uuid);
+  w.raw(',');
+  w.key("name");
+  w.string(name);
+  header->resize(w.length());
+  snapshot.append(header);
+
+  uint32_t now = millis();
+  for (GroupId g = 0; g < getGroupCount(); g++) {
+    GroupCache& cache = groups[g];
+    const String& groupName = getGroupName(g);
+    if (cache.ids.empty() || isReservedGroup(groupName)) continue;
+
+    uint32_t version = getGroupVersion(g);
+    bool stale = !cache.fragment || cache.version != version;
+    if (stale && (!cache.fragment || now - cache.builtAt >= VESSEL_MODEL_MIN_REBUILD_MS)) {
+      size_t values = 0;
+      ModelFragment rebuilt = buildGroup(cache, groupName, values);
+      if (rebuilt) {
+        cache.fragment = rebuilt;
+        cache.values = values;
+        cache.version = version;
+        cache.builtAt = now;
+        stats.groupsRebuilt++;
+      }
+    } else {
+      stats.groupsReused++;
+    }
+
+    if (cache.fragment && cache.values > 0) {
+      snapshot.append(cache.fragment);
+    }
+  }
+
+  snapshot.append(kClose);
+  stats.lastLength = snapshot.length();
+  return snapshot;
+}
+
+VesselModelStats getVesselModelStats() {
+  return stats;
+}
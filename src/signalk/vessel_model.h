@@ -0,0 +1,64 @@
+#ifndef SIGNALK_VESSEL_MODEL_H
+#define SIGNALK_VESSEL_MODEL_H
+
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+#include "../config.h"
+#include "../types.h"
+
+/**
+ * Cached full SignalK model (GET /signalk/v1/api/vessels/self)
+ *
+ * Every top-level group (navigation, environment, steering, notifications,
+ * ...) is serialized once into its own fragment and kept until a value or
+ * metadata in that group changes (see getGroupVersion()). A changed group
+ * is rebuilt on the next request, but not more often than every
+ * VESSEL_MODEL_MIN_REBUILD_MS, so polling clients share one rebuild.
+ *
+ * Paths are emitted in segment order straight from the data store with
+ * JsonWriter, without building a JSON document. Fragments are immutable
+ * and reference counted: a snapshot taken for one response stays valid
+ * while it streams, even if the group is rebuilt meanwhile.
+ */
+
+typedef std::shared_ptr<const std::vector<char>> ModelFragment;
+
+/**
+ * Serialized model as fragments that concatenate to one JSON document
+ */
+class VesselModelSnapshot {
+public:
+  void append(const ModelFragment& fragment);
+
+  // Total bytes
+  size_t length() const { return _length; }
+
+  // Copy up to maxLen bytes starting at offset; returns bytes copied (0 at the end)
+  size_t read(size_t offset, uint8_t* buffer, size_t maxLen) const;
+
+private:
+  std::vector<ModelFragment> _parts;
+  size_t _length = 0;
+};
+
+/**
+ * Current model, rebuilding only groups that changed
+ * @param uuid Vessel UUID ("urn:mrn:signalk:uuid:...")
+ * @param name Vessel name
+ */
+VesselModelSnapshot getVesselModelSnapshot(const String& uuid, const String& name);
+
+/**
+ * Cache effectiveness counters
+ */
+struct VesselModelStats {
+  uint32_t requests = 0;
+  uint32_t groupsRebuilt = 0;
+  uint32_t groupsReused = 0;   // Served from cache (unchanged or rebuilt recently)
+  uint32_t lastLength = 0;     // Bytes in the most recent snapshot
+};
+
+VesselModelStats getVesselModelStats();
+
+#endif // SIGNALK_VESSEL_MODEL_H
@@ -0,0 +1,28 @@
+// WS2812 LED for the simulator: colours are kept, nothing is lit
+#ifndef SIM_ADAFRUIT_NEOPIXEL_H
+#define SIM_ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel {
+public:
+  Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, uint16_t type = NEO_GRB + NEO_KHZ800) {}
+
+  void begin() {}
+  void show() {}
+  void clear() { _color = 0; }
+  void setBrightness(uint8_t b) {}
+  void setPixelColor(uint16_t n, uint32_t c) { if (n == 0) _color = c; }
+  uint32_t getPixelColor(uint16_t n) const { return n == 0 ? _color : 0; }
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  }
+
+private:
+  uint32_t _color = 0;
+};
+
+#endif // SIM_ADAFRUIT_NEOPIXEL_H
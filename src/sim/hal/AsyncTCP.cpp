@@ -0,0 +1,470 @@
+#ifdef SIGNALK_SIM
+
+#include <AsyncTCP.h>
+#include "../sim.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// lwIP error codes passed to onError
+static const int8_t ERR_CONN = -11;
+
+struct SimTcpConn {
+  std::mutex lock;  // Guards everything below except the atomics
+  int fd;
+  AsyncClient* owner = nullptr;  // Cleared by ~AsyncClient
+  std::string out;               // Added, not yet handed to the kernel
+  size_t acked = 0;              // Handed to the kernel since the last onAck
+  bool noDelay = false;
+  IPAddress remoteIp;
+  uint16_t remotePort = 0;
+  IPAddress localIp;
+  uint16_t localPort = 0;
+  uint32_t lastPoll = 0;
+
+  std::atomic<bool> claimed{false};         // Whoever sets it reports the disconnect
+  std::atomic<bool> closeRequested{false};  // close() from the client's own callback
+
+  AcDataHandler dataCb;
+  void* dataArg = nullptr;
+  AcAckHandler ackCb;
+  void* ackArg = nullptr;
+  AcErrorHandler errorCb;
+  void* errorArg = nullptr;
+  AcConnectHandler pollCb;
+  void* pollArg = nullptr;
+  AcConnectHandler disconnectCb;
+  void* disconnectArg = nullptr;
+
+  explicit SimTcpConn(int fd) : fd(fd) {}
+};
+
+// ====== EVENT LOOP ======
+// Servers and connections are registered here; the registry lock is never
+// held while a callback runs.
+
+struct SimTcpLoop {
+  std::mutex lock;
+  std::vector<AsyncServer*> servers;
+  std::vector<std::shared_ptr<SimTcpConn>> conns;
+  int wakeFd = -1;
+  bool started = false;
+
+  void start();
+  void wake();
+  void unregister(const std::shared_ptr<SimTcpConn>& conn);
+  void run();
+  void accept(AsyncServer* server);
+  void service(const std::shared_ptr<SimTcpConn>& conn, short revents, uint32_t now);
+  static void disconnect(const std::shared_ptr<SimTcpConn>& conn, bool error);
+  static bool flushLocked(SimTcpConn& conn);
+};
+
+static SimTcpLoop tcpLoop;
+static thread_local bool onEventThread = false;
+static thread_local SimTcpConn* servicing = nullptr;  // Connection whose callback is running
+
+static void eventTask(void* parameter) {
+  onEventThread = true;
+  tcpLoop.run();
+}
+
+void SimTcpLoop::start() {
+  std::lock_guard<std::mutex> guard(lock);
+  if (started) return;
+  started = true;
+  wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  xTaskCreatePinnedToCore(eventTask, "async_tcp", 8192, nullptr, 3, nullptr,
+                          CONFIG_ASYNC_TCP_RUNNING_CORE);
+}
+
+void SimTcpLoop::wake() {
+  uint64_t one = 1;
+  if (wakeFd >= 0 && ::write(wakeFd, &one, sizeof(one)) < 0) {}
+}
+
+void SimTcpLoop::unregister(const std::shared_ptr<SimTcpConn>& conn) {
+  std::lock_guard<std::mutex> guard(lock);
+  for (size_t i = 0; i < conns.size(); i++) {
+    if (conns[i] == conn) {
+      conns.erase(conns.begin() + i);
+      break;
+    }
+  }
+}
+
+void SimTcpLoop::run() {
+  std::vector<pollfd> fds;
+  std::vector<AsyncServer*> polledServers;
+  std::vector<std::shared_ptr<SimTcpConn>> polledConns;
+
+  while (true) {
+    fds.clear();
+    polledServers.clear();
+    fds.push_back({wakeFd, POLLIN, 0});
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      for (AsyncServer* server : servers) {
+        fds.push_back({server->_listen, POLLIN, 0});
+        polledServers.push_back(server);
+      }
+      polledConns = conns;
+    }
+    for (const auto& conn : polledConns) {
+      std::lock_guard<std::mutex> guard(conn->lock);
+      short events = POLLIN;
+      if (!conn->out.empty()) events |= POLLOUT;
+      fds.push_back({conn->fd, events, 0});
+    }
+
+    // Short timeout: onPoll runs every 500 ms and ACKs from send() on other
+    // tasks are reported after the wakeup
+    ::poll(fds.data(), fds.size(), 100);
+    uint64_t wakeups;
+    if (::read(wakeFd, &wakeups, sizeof(wakeups)) < 0) {}
+
+    for (size_t i = 0; i < polledServers.size(); i++) {
+      if (fds[1 + i].revents & POLLIN) accept(polledServers[i]);
+    }
+    uint32_t now = millis();
+    for (size_t i = 0; i < polledConns.size(); i++) {
+      service(polledConns[i], fds[1 + polledServers.size() + i].revents, now);
+    }
+    polledConns.clear();
+  }
+}
+
+void SimTcpLoop::accept(AsyncServer* server) {
+  AcConnectHandler connectCb;
+  void* connectArg;
+  bool noDelay;
+  int fd;
+  sockaddr_in remote = {};
+  {
+    // Held so that end() cannot close the socket under us
+    std::lock_guard<std::mutex> guard(lock);
+    bool listening = false;
+    for (AsyncServer* s : servers) listening |= s == server;
+    if (!listening) return;
+    socklen_t len = sizeof(remote);
+    fd = accept4(server->_listen, (sockaddr*)&remote, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+    connectCb = server->_connectCb;
+    connectArg = server->_connectArg;
+    noDelay = server->_noDelay;
+  }
+
+  // Sized like lwIP's send buffer, so a slow reader pushes back early
+  int sendBuffer = (int)AsyncClient::kSendBuffer;
+  setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+  int flag = noDelay ? 1 : 0;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+  auto conn = std::make_shared<SimTcpConn>(fd);
+  conn->noDelay = noDelay;
+  conn->remoteIp = IPAddress((uint32_t)remote.sin_addr.s_addr);
+  conn->remotePort = ntohs(remote.sin_port);
+  sockaddr_in local = {};
+  socklen_t len = sizeof(local);
+  getsockname(fd, (sockaddr*)&local, &len);
+  conn->localIp = IPAddress((uint32_t)local.sin_addr.s_addr);
+  conn->localPort = ntohs(local.sin_port);
+  conn->lastPoll = millis();
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    conns.push_back(conn);
+  }
+
+  AsyncClient* client = new AsyncClient(conn);
+  if (connectCb) {
+    servicing = conn.get();
+    connectCb(connectArg, client);
+    servicing = nullptr;
+  } else {
+    delete client;
+    return;
+  }
+  if (conn->closeRequested && !conn->claimed.exchange(true)) disconnect(conn, false);
+}
+
+void SimTcpLoop::service(const std::shared_ptr<SimTcpConn>& conn, short revents, uint32_t now) {
+  if (conn->claimed) return;
+  servicing = conn.get();
+  bool failed = false;
+  bool remoteClosed = false;
+
+  // Output first: whatever the kernel took is reported as acknowledged
+  size_t acked;
+  AcAckHandler ackCb;
+  void* ackArg;
+  AsyncClient* owner;
+  {
+    std::lock_guard<std::mutex> guard(conn->lock);
+    if (!conn->out.empty() && !flushLocked(*conn)) failed = true;
+    acked = conn->acked;
+    conn->acked = 0;
+    ackCb = conn->ackCb;
+    ackArg = conn->ackArg;
+    owner = conn->owner;
+  }
+  if (acked > 0 && ackCb && owner) ackCb(ackArg, owner, acked, 0);
+
+  // Input in chunks of at most one segment, as lwIP would deliver it
+  if (!failed && (revents & (POLLIN | POLLHUP | POLLERR))) {
+    char buffer[AsyncClient::kMss];
+    for (int chunk = 0; chunk < 16 && !conn->claimed && !conn->closeRequested; chunk++) {
+      ssize_t n;
+      AcDataHandler dataCb;
+      void* dataArg;
+      {
+        std::lock_guard<std::mutex> guard(conn->lock);
+        if (conn->fd < 0) break;
+        n = ::recv(conn->fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        dataCb = conn->dataCb;
+        dataArg = conn->dataArg;
+        owner = conn->owner;
+      }
+      if (n == 0) {
+        remoteClosed = true;
+        break;
+      }
+      if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) failed = true;
+        break;
+      }
+      if (dataCb && owner) dataCb(dataArg, owner, buffer, (size_t)n);
+    }
+  }
+
+  if (!failed && !remoteClosed && !conn->claimed && now - conn->lastPoll >= AsyncClient::kPollIntervalMs) {
+    conn->lastPoll = now;
+    AcConnectHandler pollCb;
+    void* pollArg;
+    {
+      std::lock_guard<std::mutex> guard(conn->lock);
+      pollCb = conn->pollCb;
+      pollArg = conn->pollArg;
+      owner = conn->owner;
+    }
+    if (pollCb && owner) pollCb(pollArg, owner);
+  }
+
+  servicing = nullptr;
+  if ((failed || remoteClosed || conn->closeRequested) && !conn->claimed.exchange(true)) {
+    disconnect(conn, failed);
+  }
+}
+
+// Hand queued output to the kernel; false on a socket error
+bool SimTcpLoop::flushLocked(SimTcpConn& conn) {
+  while (!conn.out.empty() && conn.fd >= 0) {
+    ssize_t n = ::send(conn.fd, conn.out.data(), conn.out.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n > 0) {
+      conn.out.erase(0, (size_t)n);
+      conn.acked += (size_t)n;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Close the socket and report the disconnect; the caller has claimed it.
+// The handler may delete the client, so it runs last.
+void SimTcpLoop::disconnect(const std::shared_ptr<SimTcpConn>& conn, bool error) {
+  tcpLoop.unregister(conn);
+
+  AcConnectHandler disconnectCb;
+  void* disconnectArg;
+  AcErrorHandler errorCb;
+  void* errorArg;
+  AsyncClient* owner;
+  {
+    std::lock_guard<std::mutex> guard(conn->lock);
+    if (!error && !conn->out.empty()) {
+      // Best effort, as a graceful lwIP close sends what was queued
+      for (int attempt = 0; attempt < 20 && !conn->out.empty(); attempt++) {
+        if (!flushLocked(*conn)) break;
+        if (!conn->out.empty()) {
+          pollfd pfd = {conn->fd, POLLOUT, 0};
+          ::poll(&pfd, 1, 10);
+        }
+      }
+    }
+    if (conn->fd >= 0) ::close(conn->fd);
+    conn->fd = -1;
+    conn->out.clear();
+    disconnectCb = conn->disconnectCb;
+    disconnectArg = conn->disconnectArg;
+    errorCb = conn->errorCb;
+    errorArg = conn->errorArg;
+    owner = conn->owner;
+  }
+  if (owner == nullptr) return;
+  if (error && errorCb) errorCb(errorArg, owner, ERR_CONN);
+  if (disconnectCb) disconnectCb(disconnectArg, owner);
+}
+
+// ====== ASYNCCLIENT ======
+
+AsyncClient::AsyncClient(std::shared_ptr<SimTcpConn> conn) : _conn(conn) {
+  _conn->owner = this;
+}
+
+AsyncClient::~AsyncClient() {
+  {
+    std::lock_guard<std::mutex> guard(_conn->lock);
+    _conn->owner = nullptr;
+  }
+  // Deleted while connected: close without reporting
+  if (!_conn->claimed.exchange(true)) {
+    tcpLoop.unregister(_conn);
+    std::lock_guard<std::mutex> guard(_conn->lock);
+    if (_conn->fd >= 0) ::close(_conn->fd);
+    _conn->fd = -1;
+  }
+}
+
+void AsyncClient::close(bool now) {
+  if (onEventThread && servicing == _conn.get()) {
+    _conn->closeRequested = true;  // Reported when the callback returns
+    return;
+  }
+  if (_conn->claimed.exchange(true)) return;
+  SimTcpLoop::disconnect(_conn, false);
+}
+
+bool AsyncClient::connected() const {
+  return !_conn->claimed && !_conn->closeRequested;
+}
+
+size_t AsyncClient::space() {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  if (_conn->fd < 0 || _conn->claimed) return 0;
+  return _conn->out.size() < kSendBuffer ? kSendBuffer - _conn->out.size() : 0;
+}
+
+size_t AsyncClient::add(const char* data, size_t size, uint8_t apiflags) {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  if (_conn->fd < 0 || _conn->claimed || data == nullptr) return 0;
+  size_t room = _conn->out.size() < kSendBuffer ? kSendBuffer - _conn->out.size() : 0;
+  size_t queued = size < room ? size : room;
+  _conn->out.append(data, queued);
+  return queued;
+}
+
+bool AsyncClient::send() {
+  bool ok;
+  {
+    std::lock_guard<std::mutex> guard(_conn->lock);
+    if (_conn->fd < 0) return false;
+    ok = SimTcpLoop::flushLocked(*_conn);
+  }
+  if (!onEventThread) tcpLoop.wake();  // ACKs and POLLOUT are handled there
+  return ok;
+}
+
+void AsyncClient::setNoDelay(bool nodelay) {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  _conn->noDelay = nodelay;
+  int flag = nodelay ? 1 : 0;
+  if (_conn->fd >= 0) setsockopt(_conn->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+bool AsyncClient::getNoDelay() {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  return _conn->noDelay;
+}
+
+IPAddress AsyncClient::remoteIP() const { return _conn->remoteIp; }
+uint16_t AsyncClient::remotePort() const { return _conn->remotePort; }
+IPAddress AsyncClient::localIP() const { return _conn->localIp; }
+uint16_t AsyncClient::localPort() const { return _conn->localPort; }
+
+void AsyncClient::onDisconnect(AcConnectHandler cb, void* arg) {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  _conn->disconnectCb = cb;
+  _conn->disconnectArg = arg;
+}
+
+void AsyncClient::onAck(AcAckHandler cb, void* arg) {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  _conn->ackCb = cb;
+  _conn->ackArg = arg;
+}
+
+void AsyncClient::onError(AcErrorHandler cb, void* arg) {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  _conn->errorCb = cb;
+  _conn->errorArg = arg;
+}
+
+void AsyncClient::onData(AcDataHandler cb, void* arg) {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  _conn->dataCb = cb;
+  _conn->dataArg = arg;
+}
+
+void AsyncClient::onPoll(AcConnectHandler cb, void* arg) {
+  std::lock_guard<std::mutex> guard(_conn->lock);
+  _conn->pollCb = cb;
+  _conn->pollArg = arg;
+}
+
+// ====== ASYNCSERVER ======
+
+void AsyncServer::begin() {
+  if (_listen >= 0) return;
+
+  IPAddress addr = _addr;
+  if (!_fixedAddr && !addr.fromString(simOptions.bindAddress)) addr = IPAddress(127, 0, 0, 1);
+
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return;
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in sa = {};
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(_port);
+  sa.sin_addr.s_addr = (uint32_t)addr;
+  if (bind(fd, (sockaddr*)&sa, sizeof(sa)) != 0 || listen(fd, 8) != 0) {
+    simLog("sim: cannot listen on %s:%u: %s\n", addr.toString().c_str(), _port, strerror(errno));
+    ::close(fd);
+    return;
+  }
+  simLog("sim: listening on %s:%u\n", addr.toString().c_str(), _port);
+
+  tcpLoop.start();
+  std::lock_guard<std::mutex> guard(tcpLoop.lock);
+  _listen = fd;
+  tcpLoop.servers.push_back(this);
+  tcpLoop.wake();
+}
+
+void AsyncServer::end() {
+  std::lock_guard<std::mutex> guard(tcpLoop.lock);
+  if (_listen < 0) return;
+  for (size_t i = 0; i < tcpLoop.servers.size(); i++) {
+    if (tcpLoop.servers[i] == this) {
+      tcpLoop.servers.erase(tcpLoop.servers.begin() + i);
+      break;
+    }
+  }
+  ::close(_listen);
+  _listen = -1;
+}
+
+#endif // SIGNALK_SIM
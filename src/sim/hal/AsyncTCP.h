@@ -0,0 +1,124 @@
+// AsyncTCP (ESP32Async) for the simulator, on host sockets
+//
+// One "async_tcp" task runs every callback - accept, data, ACK, poll and
+// disconnect - as on the ESP32, where the library's task services lwIP
+// events. The same contracts hold:
+//  - space() is bounded by lwIP's TCP_SND_BUF (5744 bytes); a write is
+//    acknowledged once the host kernel has taken it
+//  - onPoll fires about every 500 ms
+//  - close() reports the disconnect synchronously, and the disconnect
+//    handler may delete the client. Called from inside one of the client's
+//    own callbacks, the disconnect is reported when that callback returns.
+//  - add(), send() and space() may be called from other tasks
+#ifndef SIM_ASYNCTCP_H
+#define SIM_ASYNCTCP_H
+
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+
+#define ASYNC_WRITE_FLAG_COPY 0x01
+#define ASYNC_WRITE_FLAG_MORE 0x02
+
+#ifndef CONFIG_ASYNC_TCP_RUNNING_CORE
+#define CONFIG_ASYNC_TCP_RUNNING_CORE 1
+#endif
+
+class AsyncClient;
+class AsyncServer;
+struct SimTcpConn;
+
+typedef std::function<void(void*, AsyncClient*)> AcConnectHandler;
+typedef std::function<void(void*, AsyncClient*, size_t len, uint32_t time)> AcAckHandler;
+typedef std::function<void(void*, AsyncClient*, int8_t error)> AcErrorHandler;
+typedef std::function<void(void*, AsyncClient*, void* data, size_t len)> AcDataHandler;
+typedef std::function<void(void*, AsyncClient*, uint32_t time)> AcTimeoutHandler;
+
+class AsyncClient {
+public:
+  static const size_t kSendBuffer = 5744;  // TCP_SND_BUF
+  static const size_t kMss = 1436;         // Largest data callback, TCP_MSS
+  static const uint32_t kPollIntervalMs = 500;
+
+  ~AsyncClient();
+
+  /**
+   * Disconnect; queued data is still delivered. onDisconnect runs before
+   * this returns (or, from the client's own callback, right after it).
+   */
+  void close(bool now = false);
+  void abort() { close(true); }
+
+  bool connected() const;
+  bool disconnected() const { return !connected(); }
+  bool freeable() const { return !connected(); }
+
+  size_t space();
+  size_t add(const char* data, size_t size, uint8_t apiflags = ASYNC_WRITE_FLAG_COPY);
+  bool canSend() { return space() > 0; }
+  bool send();
+  size_t write(const char* data) { return write(data, strlen(data)); }
+  size_t write(const char* data, size_t size, uint8_t apiflags = ASYNC_WRITE_FLAG_COPY) {
+    size_t queued = add(data, size, apiflags);
+    send();
+    return queued;
+  }
+
+  void setNoDelay(bool nodelay);
+  bool getNoDelay();
+  void setRxTimeout(uint32_t timeout) {}
+  void setAckTimeout(uint32_t timeout) {}
+
+  IPAddress remoteIP() const;
+  uint16_t remotePort() const;
+  IPAddress localIP() const;
+  uint16_t localPort() const;
+
+  void onConnect(AcConnectHandler cb, void* arg = nullptr) {}
+  void onDisconnect(AcConnectHandler cb, void* arg = nullptr);
+  void onAck(AcAckHandler cb, void* arg = nullptr);
+  void onError(AcErrorHandler cb, void* arg = nullptr);
+  void onData(AcDataHandler cb, void* arg = nullptr);
+  void onTimeout(AcTimeoutHandler cb, void* arg = nullptr) {}
+  void onPoll(AcConnectHandler cb, void* arg = nullptr);
+
+private:
+  friend struct SimTcpLoop;
+
+  explicit AsyncClient(std::shared_ptr<SimTcpConn> conn);
+
+  // Socket, buffers and callbacks live in the connection so that the
+  // event loop never touches a client the firmware has deleted
+  std::shared_ptr<SimTcpConn> _conn;
+};
+
+class AsyncServer {
+public:
+  explicit AsyncServer(uint16_t port) : _port(port) {}
+  AsyncServer(IPAddress addr, uint16_t port) : _addr(addr), _fixedAddr(true), _port(port) {}
+  ~AsyncServer() { end(); }
+
+  void onClient(AcConnectHandler cb, void* arg) { _connectCb = cb; _connectArg = arg; }
+  void setNoDelay(bool nodelay) { _noDelay = nodelay; }
+  bool getNoDelay() { return _noDelay; }
+
+  /**
+   * Listen on the --bind address (or the one given to the constructor)
+   */
+  void begin();
+  void end();
+  uint8_t status() const { return _listen >= 0 ? 1 : 0; }
+
+private:
+  friend struct SimTcpLoop;
+
+  IPAddress _addr;
+  bool _fixedAddr = false;
+  uint16_t _port;
+  int _listen = -1;
+  bool _noDelay = false;
+  AcConnectHandler _connectCb;
+  void* _connectArg = nullptr;
+};
+
+#endif // SIM_ASYNCTCP_H
@@ -0,0 +1,378 @@
+#ifdef SIGNALK_SIM
+
+#include <ESPAsyncWebServer.h>
+#include "../sim.h"
+#include "sim_sha.h"
+
+static const char kWebSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+static const size_t kMaxFrameSize = 64 * 1024;   // Larger frames close the connection (1009)
+static const uint32_t kCloseTimeoutMs = 2000;    // For the peer to answer our close frame
+
+// ====== CLIENT ======
+
+AsyncWebSocketClient::AsyncWebSocketClient(AsyncClient* client, AsyncWebSocket* server)
+  : _server(server), _client(client), _id(server->_nextId++),
+    _remoteIp(client->remoteIP()), _remotePort(client->remotePort()) {
+  client->onData([](void* r, AsyncClient* c, void* data, size_t len) {
+    static_cast<AsyncWebSocketClient*>(r)->onData(static_cast<uint8_t*>(data), len);
+  }, this);
+  client->onAck([](void* r, AsyncClient* c, size_t len, uint32_t time) {
+    static_cast<AsyncWebSocketClient*>(r)->onAck();
+  }, this);
+  client->onPoll([](void* r, AsyncClient* c) {
+    static_cast<AsyncWebSocketClient*>(r)->onPoll();
+  }, this);
+  client->onError([](void* r, AsyncClient* c, int8_t error) {
+    AsyncWebSocketClient* ws = static_cast<AsyncWebSocketClient*>(r);
+    ws->_server->handleEvent(ws, WS_EVT_ERROR, &error, nullptr, 0);
+  }, this);
+  client->onDisconnect([](void* r, AsyncClient* c) {
+    static_cast<AsyncWebSocketClient*>(r)->onDisconnect(c);
+  }, this);
+}
+
+AsyncWebSocketClient::~AsyncWebSocketClient() {
+  // Only when the server itself goes away while the client is connected
+  delete _client;
+}
+
+size_t AsyncWebSocketClient::queueLen() const {
+  std::lock_guard<std::recursive_mutex> guard(_lock);
+  return _queue.size();
+}
+
+bool AsyncWebSocketClient::queueIsFull() const {
+  std::lock_guard<std::recursive_mutex> guard(_lock);
+  return _queue.size() >= WS_MAX_QUEUED_MESSAGES || _status != WS_CONNECTED;
+}
+
+bool AsyncWebSocketClient::text(const char* message, size_t len) {
+  return queueMessage(std::make_shared<std::vector<uint8_t>>((const uint8_t*)message,
+                                                             (const uint8_t*)message + len), WS_TEXT);
+}
+
+bool AsyncWebSocketClient::text(AsyncWebSocketSharedBuffer buffer) {
+  return buffer ? queueMessage(buffer, WS_TEXT) : false;
+}
+
+bool AsyncWebSocketClient::binary(const uint8_t* message, size_t len) {
+  return queueMessage(std::make_shared<std::vector<uint8_t>>(message, message + len), WS_BINARY);
+}
+
+bool AsyncWebSocketClient::binary(AsyncWebSocketSharedBuffer buffer) {
+  return buffer ? queueMessage(buffer, WS_BINARY) : false;
+}
+
+void AsyncWebSocketClient::ping(const uint8_t* data, size_t len) {
+  auto payload = std::make_shared<std::vector<uint8_t>>();
+  if (data) payload->assign(data, data + len);
+  queueMessage(payload, WS_PING, true);
+}
+
+void AsyncWebSocketClient::close(uint16_t code, const char* message) {
+  std::lock_guard<std::recursive_mutex> guard(_lock);
+  if (_status != WS_CONNECTED || _client == nullptr) return;
+
+  auto payload = std::make_shared<std::vector<uint8_t>>();
+  if (code != 0) {
+    payload->push_back((uint8_t)(code >> 8));
+    payload->push_back((uint8_t)code);
+    if (message) payload->insert(payload->end(), message, message + strlen(message));
+  }
+  _status = WS_DISCONNECTING;
+  queueMessage(payload, WS_DISCONNECT, true);
+}
+
+bool AsyncWebSocketClient::queueMessage(AsyncWebSocketSharedBuffer payload, uint8_t opcode, bool control) {
+  std::lock_guard<std::recursive_mutex> guard(_lock);
+  if (_client == nullptr || (_status != WS_CONNECTED && !control)) return false;
+
+  if (!control && _queue.size() >= WS_MAX_QUEUED_MESSAGES) {
+    // As the library does by default: a client this far behind is dropped.
+    // The close itself happens on the async_tcp task, like the disconnect
+    // event it raises.
+    simLog("sim: WebSocket client #%u: too many messages queued, closing\n", _id);
+    _queue.clear();
+    _status = WS_DISCONNECTING;
+    _abort = true;
+    return false;
+  }
+
+  Message msg;
+  msg.payload = payload;
+  msg.opcode = opcode;
+  size_t len = payload->size();
+  msg.header += (char)(0x80 | opcode);  // FIN; server frames are not masked
+  if (len < 126) {
+    msg.header += (char)len;
+  } else if (len < 65536) {
+    msg.header += (char)126;
+    msg.header += (char)(len >> 8);
+    msg.header += (char)len;
+  } else {
+    msg.header += (char)127;
+    for (int shift = 56; shift >= 0; shift -= 8) msg.header += (char)((uint64_t)len >> shift);
+  }
+  if (opcode == WS_DISCONNECT) {
+    _closeSent = true;
+    _closeSentAt = millis();
+  }
+  _queue.push_back(std::move(msg));
+  runQueue();
+  return true;
+}
+
+void AsyncWebSocketClient::runQueue() {
+  if (_client == nullptr) return;
+  bool wrote = false;
+  while (!_queue.empty()) {
+    Message& msg = _queue.front();
+    size_t total = msg.header.size() + msg.payload->size();
+    while (msg.sent < total) {
+      size_t queued;
+      if (msg.sent < msg.header.size()) {
+        queued = _client->add(msg.header.data() + msg.sent, msg.header.size() - msg.sent);
+      } else {
+        size_t offset = msg.sent - msg.header.size();
+        queued = _client->add((const char*)msg.payload->data() + offset, msg.payload->size() - offset);
+      }
+      if (queued == 0) break;
+      msg.sent += queued;
+      wrote = true;
+    }
+    if (msg.sent < total) break;  // Send buffer full; continued after the next ACK
+    _queue.pop_front();
+  }
+  if (wrote) _client->send();
+}
+
+void AsyncWebSocketClient::onAck() {
+  std::lock_guard<std::recursive_mutex> guard(_lock);
+  runQueue();
+}
+
+void AsyncWebSocketClient::onPoll() {
+  AsyncClient* client;
+  {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    runQueue();
+    if (_status != WS_DISCONNECTING || _client == nullptr) return;
+    if (!_abort && !(_closeSent && _queue.empty() && millis() - _closeSentAt > kCloseTimeoutMs)) return;
+    client = _client;
+  }
+  client->close(true);
+}
+
+void AsyncWebSocketClient::onData(const uint8_t* data, size_t len) {
+  _input.append((const char*)data, len);
+
+  size_t pos = 0;
+  while (_input.size() - pos >= 2) {
+    const uint8_t* p = (const uint8_t*)_input.data() + pos;
+    size_t available = _input.size() - pos;
+    bool final = p[0] & 0x80;
+    uint8_t opcode = p[0] & 0x0F;
+    bool masked = p[1] & 0x80;
+    uint64_t payloadLen = p[1] & 0x7F;
+    size_t headerLen = 2;
+    if (payloadLen == 126) {
+      if (available < 4) break;
+      payloadLen = ((uint64_t)p[2] << 8) | p[3];
+      headerLen = 4;
+    } else if (payloadLen == 127) {
+      if (available < 10) break;
+      payloadLen = 0;
+      for (int i = 0; i < 8; i++) payloadLen = (payloadLen << 8) | p[2 + i];
+      headerLen = 10;
+    }
+    if (payloadLen > kMaxFrameSize) {
+      _input.clear();
+      close(1009, "Message too big");
+      return;
+    }
+    const uint8_t* mask = p + headerLen;
+    if (masked) headerLen += 4;
+    if (available < headerLen + payloadLen) break;
+
+    // Unmasked copy with a terminating NUL, so text can be used as a C string
+    std::vector<uint8_t> payload(payloadLen + 1);
+    for (size_t i = 0; i < payloadLen; i++) {
+      payload[i] = p[headerLen + i] ^ (masked ? mask[i % 4] : 0);
+    }
+    payload[payloadLen] = 0;
+    pos += headerLen + payloadLen;
+    handleFrame(opcode, final, payload.data(), payloadLen);
+    if (_client == nullptr) return;
+  }
+  _input.erase(0, pos);
+}
+
+void AsyncWebSocketClient::handleFrame(uint8_t opcode, bool final, uint8_t* payload, size_t len) {
+  if (opcode == WS_DISCONNECT) {
+    AsyncClient* client;
+    {
+      std::lock_guard<std::recursive_mutex> guard(_lock);
+      if (_client == nullptr) return;
+      if (!_closeSent) {
+        // Answer with the same status code, then close once it is sent
+        _queue.clear();
+        queueMessage(std::make_shared<std::vector<uint8_t>>(payload, payload + (len >= 2 ? 2 : 0)),
+                     WS_DISCONNECT, true);
+      }
+      _status = WS_DISCONNECTING;
+      client = _client;
+    }
+    client->close(true);
+    return;
+  }
+  if (opcode == WS_PING) {
+    queueMessage(std::make_shared<std::vector<uint8_t>>(payload, payload + len), WS_PONG, true);
+    _server->handleEvent(this, WS_EVT_PING, nullptr, payload, len);
+    return;
+  }
+  if (opcode == WS_PONG) {
+    _server->handleEvent(this, WS_EVT_PONG, nullptr, payload, len);
+    return;
+  }
+  if (_status != WS_CONNECTED) return;
+
+  AwsFrameInfo info = {};
+  if (opcode != WS_CONTINUATION) {
+    _messageOpcode = opcode;
+    _fragment = 0;
+  }
+  info.message_opcode = _messageOpcode;
+  info.num = _fragment++;
+  info.final = final ? 1 : 0;
+  info.masked = 1;
+  info.opcode = opcode;
+  info.len = len;
+  info.index = 0;
+  _server->handleEvent(this, WS_EVT_DATA, &info, payload, len);
+}
+
+void AsyncWebSocketClient::onDisconnect(AsyncClient* client) {
+  {
+    std::lock_guard<std::recursive_mutex> guard(_lock);
+    _client = nullptr;
+    _queue.clear();
+  }
+  _server->handleEvent(this, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+  {
+    // From here on cleanupClients() may destroy this client
+    std::lock_guard<std::mutex> guard(_server->_lock);
+    _status = WS_DISCONNECTED;
+  }
+  delete client;
+}
+
+// ====== SERVER ======
+
+AsyncWebSocket::~AsyncWebSocket() {
+  std::lock_guard<std::mutex> guard(_lock);
+  _clients.clear();
+}
+
+bool AsyncWebSocket::canHandle(AsyncWebServerRequest* request) const {
+  return _enabled && request->isWebSocketUpgrade() && request->method() == HTTP_GET &&
+         request->url() == _url;
+}
+
+void AsyncWebSocket::handleRequest(AsyncWebServerRequest* request) {
+  if (!request->hasHeader("Sec-WebSocket-Key") || request->header("Sec-WebSocket-Version") != "13") {
+    request->send(400);
+    return;
+  }
+
+  String key = request->header("Sec-WebSocket-Key") + kWebSocketGuid;
+  uint8_t digest[20];
+  SimSha1 sha;
+  sha.update((const uint8_t*)key.c_str(), key.length());
+  sha.finish(digest);
+
+  String head = "HTTP/1.1 101 Switching Protocols\r\n"
+                "Upgrade: websocket\r\n"
+                "Connection: Upgrade\r\n"
+                "Sec-WebSocket-Accept: ";
+  head += simBase64(digest, sizeof(digest)).c_str();
+  head += "\r\n";
+  for (const AsyncWebHeader& header : DefaultHeaders::Instance()) head += header.toString();
+  head += "\r\n";
+  AsyncClient* tcp = request->client();
+  tcp->add(head.c_str(), head.length());
+  tcp->send();
+
+  AsyncWebSocketClient* client;
+  {
+    std::lock_guard<std::mutex> guard(_lock);
+    _clients.emplace_back(tcp, this);
+    client = &_clients.back();
+  }
+  request->_webSocket = client;  // The request is deleted, the connection kept
+  handleEvent(client, WS_EVT_CONNECT, request, nullptr, 0);
+}
+
+void AsyncWebSocket::handleEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg,
+                                 uint8_t* data, size_t len) {
+  if (_eventHandler) _eventHandler(this, client, type, arg, data, len);
+}
+
+size_t AsyncWebSocket::count() const {
+  std::lock_guard<std::mutex> guard(_lock);
+  size_t connected = 0;
+  for (const AsyncWebSocketClient& client : _clients) {
+    if (client.status() == WS_CONNECTED) connected++;
+  }
+  return connected;
+}
+
+AsyncWebSocketClient* AsyncWebSocket::client(uint32_t id) {
+  std::lock_guard<std::mutex> guard(_lock);
+  for (AsyncWebSocketClient& client : _clients) {
+    if (client.id() == id && client.status() == WS_CONNECTED) return &client;
+  }
+  return nullptr;
+}
+
+void AsyncWebSocket::cleanupClients(uint16_t maxClients) {
+  std::lock_guard<std::mutex> guard(_lock);
+  size_t connected = 0;
+  for (auto it = _clients.begin(); it != _clients.end();) {
+    if (it->status() == WS_DISCONNECTED) {
+      it = _clients.erase(it);
+    } else {
+      if (it->status() == WS_CONNECTED) connected++;
+      ++it;
+    }
+  }
+  for (AsyncWebSocketClient& client : _clients) {
+    if (connected <= maxClients) break;
+    if (client.status() == WS_CONNECTED) {
+      client.close();
+      connected--;
+    }
+  }
+}
+
+void AsyncWebSocket::closeAll(uint16_t code, const char* message) {
+  std::lock_guard<std::mutex> guard(_lock);
+  for (AsyncWebSocketClient& client : _clients) client.close(code, message);
+}
+
+void AsyncWebSocket::textAll(const char* message, size_t len) {
+  textAll(std::make_shared<std::vector<uint8_t>>((const uint8_t*)message, (const uint8_t*)message + len));
+}
+
+void AsyncWebSocket::textAll(AsyncWebSocketSharedBuffer buffer) {
+  std::lock_guard<std::mutex> guard(_lock);
+  for (AsyncWebSocketClient& client : _clients) {
+    if (client.status() == WS_CONNECTED) client.text(buffer);
+  }
+}
+
+bool AsyncWebSocket::text(uint32_t id, const String& message) {
+  AsyncWebSocketClient* c = client(id);
+  return c != nullptr && c->text(message);
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,532 @@
+#ifdef SIGNALK_SIM
+
+#include <ESPAsyncWebServer.h>
+#include "../sim.h"
+
+// Requests larger than this are refused rather than buffered
+static const size_t kMaxHeaderLine = 4096;
+
+static String urlDecode(const String& text, bool plusIsSpace) {
+  std::string out;
+  const char* s = text.c_str();
+  for (size_t i = 0; i < text.length(); i++) {
+    if (s[i] == '%' && i + 2 < text.length() && isxdigit((unsigned char)s[i + 1]) &&
+        isxdigit((unsigned char)s[i + 2])) {
+      char hex[3] = {s[i + 1], s[i + 2], 0};
+      out += (char)strtol(hex, nullptr, 16);
+      i += 2;
+    } else if (s[i] == '+' && plusIsSpace) {
+      out += ' ';
+    } else {
+      out += s[i];
+    }
+  }
+  return String(out.c_str(), out.size());
+}
+
+// ====== RESPONSES ======
+
+AsyncWebServerResponse::AsyncWebServerResponse() {
+  for (const AsyncWebHeader& header : DefaultHeaders::Instance()) {
+    _headers.push_back(header);
+  }
+}
+
+bool AsyncWebServerResponse::addHeader(const char* name, const char* value, bool replaceExisting) {
+  for (auto it = _headers.begin(); it != _headers.end(); ++it) {
+    if (it->name().equalsIgnoreCase(name)) {
+      if (!replaceExisting) return false;
+      _headers.erase(it);
+      break;
+    }
+  }
+  _headers.emplace_back(String(name), String(value));
+  return true;
+}
+
+const char* AsyncWebServerResponse::responseCodeToString(int code) {
+  switch (code) {
+    case 100: return "Continue";
+    case 101: return "Switching Protocols";
+    case 200: return "OK";
+    case 201: return "Created";
+    case 202: return "Accepted";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 413: return "Request Entity Too Large";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 501: return "Not Implemented";
+    case 503: return "Service Unavailable";
+    default: return "";
+  }
+}
+
+void AsyncWebServerResponse::start(AsyncWebServerRequest* request) {
+  _request = request;
+  _encodeChunks = chunked() && request->version() == 1;
+
+  String head = "HTTP/1." + String((unsigned)request->version()) + " " + String(_code) + " " +
+                responseCodeToString(_code) + "\r\n";
+  head += "Connection: close\r\n";
+  if (_contentType.length() > 0) head += "Content-Type: " + _contentType + "\r\n";
+  if (!chunked()) head += "Content-Length: " + String((unsigned long)_contentLength) + "\r\n";
+  if (_encodeChunks) head += "Transfer-Encoding: chunked\r\n";
+  for (const AsyncWebHeader& header : _headers) head += header.toString();
+  head += "\r\n";
+  _pending.assign(head.c_str(), head.length());
+
+  if (request->method() == HTTP_HEAD) _finished = true;
+  resume();
+}
+
+void AsyncWebServerResponse::resume() {
+  AsyncClient* client = _request->client();
+  bool wrote = false;
+
+  while (client->connected()) {
+    if (!_pending.empty()) {
+      size_t queued = client->add(_pending.data(), _pending.size());
+      _pending.erase(0, queued);
+      _inFlight += queued;
+      wrote |= queued > 0;
+      if (!_pending.empty()) break;  // Resumed after the next ACK
+      continue;
+    }
+    if (_finished) {
+      if (_inFlight == 0) {
+        _request->responseFinished();
+        return;
+      }
+      break;
+    }
+    if (!chunked() && _index >= _contentLength) {
+      _finished = true;
+      continue;
+    }
+
+    // Room for the chunk size line and trailing CRLF
+    size_t room = client->space();
+    size_t framing = _encodeChunks ? 12 : 0;
+    if (room <= framing + 16) break;
+    std::vector<uint8_t> buffer(room - framing);
+    size_t len = fill(buffer.data(), buffer.size(), _index);
+    if (len == RESPONSE_TRY_AGAIN) break;  // Retried on the next poll
+    if (len > buffer.size()) len = buffer.size();
+    if (len == 0) {
+      if (_encodeChunks) _pending = "0\r\n\r\n";
+      _finished = true;
+      continue;
+    }
+    _index += len;
+    if (_encodeChunks) {
+      char size[12];
+      snprintf(size, sizeof(size), "%x\r\n", (unsigned)len);
+      _pending = size;
+      _pending.append((const char*)buffer.data(), len);
+      _pending += "\r\n";
+    } else {
+      _pending.assign((const char*)buffer.data(), len);
+    }
+  }
+  if (wrote) client->send();
+}
+
+void AsyncWebServerResponse::acknowledged(size_t len) {
+  _inFlight -= len < _inFlight ? len : _inFlight;
+  resume();
+}
+
+AsyncBasicResponse::AsyncBasicResponse(int code, const String& contentType, const String& content)
+  : _content(content) {
+  _code = code;
+  _contentType = contentType;
+  _contentLength = content.length();
+  if (_contentLength > 0 && _contentType.length() == 0) _contentType = "text/plain";
+}
+
+size_t AsyncBasicResponse::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+  size_t len = _content.length() - index < maxLen ? _content.length() - index : maxLen;
+  memcpy(buffer, _content.c_str() + index, len);
+  return len;
+}
+
+AsyncProgmemResponse::AsyncProgmemResponse(int code, const String& contentType,
+                                           const uint8_t* content, size_t len)
+  : _content(content) {
+  _code = code;
+  _contentType = contentType;
+  _contentLength = len;
+}
+
+size_t AsyncProgmemResponse::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+  size_t len = _contentLength - index < maxLen ? _contentLength - index : maxLen;
+  memcpy(buffer, _content + index, len);
+  return len;
+}
+
+AsyncChunkedResponse::AsyncChunkedResponse(const String& contentType, AwsResponseFiller callback)
+  : _callback(callback) {
+  _contentType = contentType;
+}
+
+size_t AsyncChunkedResponse::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+  return _callback ? _callback(buffer, maxLen, index) : 0;
+}
+
+AsyncResponseStream::AsyncResponseStream(const String& contentType, size_t bufferSize) {
+  _contentType = contentType;
+  _content.reserve(bufferSize);
+}
+
+size_t AsyncResponseStream::write(const uint8_t* data, size_t len) {
+  _content.append((const char*)data, len);
+  _contentLength = _content.size();
+  return len;
+}
+
+size_t AsyncResponseStream::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+  size_t len = _content.size() - index < maxLen ? _content.size() - index : maxLen;
+  memcpy(buffer, _content.data() + index, len);
+  return len;
+}
+
+// ====== REQUEST ======
+
+AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer* server, AsyncClient* client)
+  : _server(server), _client(client) {
+  client->onData([](void* r, AsyncClient* c, void* data, size_t len) {
+    static_cast<AsyncWebServerRequest*>(r)->onData(static_cast<uint8_t*>(data), len);
+  }, this);
+  client->onAck([](void* r, AsyncClient* c, size_t len, uint32_t time) {
+    AsyncWebServerRequest* request = static_cast<AsyncWebServerRequest*>(r);
+    if (request->_response) request->_response->acknowledged(len);
+  }, this);
+  client->onPoll([](void* r, AsyncClient* c) {
+    AsyncWebServerRequest* request = static_cast<AsyncWebServerRequest*>(r);
+    if (request->_response) request->_response->resume();
+  }, this);
+  client->onDisconnect([](void* r, AsyncClient* c) {
+    delete static_cast<AsyncWebServerRequest*>(r);
+    delete c;
+  }, this);
+}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+  delete _response;
+}
+
+const char* AsyncWebServerRequest::methodToString() const {
+  switch (_method) {
+    case HTTP_GET: return "GET";
+    case HTTP_POST: return "POST";
+    case HTTP_DELETE: return "DELETE";
+    case HTTP_PUT: return "PUT";
+    case HTTP_PATCH: return "PATCH";
+    case HTTP_HEAD: return "HEAD";
+    case HTTP_OPTIONS: return "OPTIONS";
+    default: return "UNKNOWN";
+  }
+}
+
+const AsyncWebHeader* AsyncWebServerRequest::getHeader(const char* name) const {
+  for (const AsyncWebHeader& header : _headers) {
+    if (header.name().equalsIgnoreCase(name)) return &header;
+  }
+  return nullptr;
+}
+
+const AsyncWebHeader* AsyncWebServerRequest::getHeader(size_t num) const {
+  for (const AsyncWebHeader& header : _headers) {
+    if (num-- == 0) return &header;
+  }
+  return nullptr;
+}
+
+const String& AsyncWebServerRequest::header(const char* name) const {
+  static const String empty;
+  const AsyncWebHeader* found = getHeader(name);
+  return found ? found->value() : empty;
+}
+
+const AsyncWebParameter* AsyncWebServerRequest::getParam(const char* name, bool post, bool file) const {
+  for (const AsyncWebParameter& param : _params) {
+    if (param.name() == name && param.isPost() == post && !file) return &param;
+  }
+  return nullptr;
+}
+
+const AsyncWebParameter* AsyncWebServerRequest::getParam(size_t num) const {
+  for (const AsyncWebParameter& param : _params) {
+    if (num-- == 0) return &param;
+  }
+  return nullptr;
+}
+
+const String& AsyncWebServerRequest::arg(const char* name) const {
+  static const String empty;
+  for (const AsyncWebParameter& param : _params) {
+    if (param.name() == name) return param.value();
+  }
+  return empty;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+  if (response == nullptr) return;
+  if (_response != nullptr || _webSocket != nullptr) {
+    simLog("sim: response already sent for %s, discarded\n", _url.c_str());
+    delete response;
+    return;
+  }
+  _response = response;
+  response->start(this);
+}
+
+void AsyncWebServerRequest::redirect(const char* url, int code) {
+  AsyncWebServerResponse* response = beginResponse(code);
+  response->addHeader("Location", url);
+  send(response);
+}
+
+void AsyncWebServerRequest::responseFinished() {
+  _client->close();
+}
+
+void AsyncWebServerRequest::onData(uint8_t* data, size_t len) {
+  size_t pos = 0;
+  while (pos < len && _webSocket == nullptr) {
+    if (_state == kRequestLine || _state == kHeaders) {
+      uint8_t* end = (uint8_t*)memchr(data + pos, '\n', len - pos);
+      size_t take = end ? (size_t)(end - (data + pos)) + 1 : len - pos;
+      _line.append((const char*)data + pos, take);
+      pos += take;
+      if (_line.size() > kMaxHeaderLine) {
+        _state = kComplete;
+        send(400);
+        return;
+      }
+      if (end == nullptr) break;
+
+      size_t lineLen = _line.size();
+      while (lineLen > 0 && (_line[lineLen - 1] == '\n' || _line[lineLen - 1] == '\r')) lineLen--;
+      String line(_line.c_str(), (unsigned)lineLen);
+      _line.clear();
+
+      if (_state == kRequestLine) {
+        if (!parseRequestLine(line)) {
+          _state = kComplete;
+          send(400);
+          return;
+        }
+        _state = kHeaders;
+      } else if (line.length() > 0) {
+        parseHeader(line);
+      } else {
+        headersComplete();
+      }
+    } else if (_state == kBody) {
+      size_t take = len - pos < _contentLength - _bodyIndex ? len - pos : _contentLength - _bodyIndex;
+      if (_handler) _handler->handleBody(this, data + pos, take, _bodyIndex, _contentLength);
+      _bodyIndex += take;
+      pos += take;
+      if (_bodyIndex >= _contentLength) bodyComplete();
+    } else {
+      break;  // No keep-alive: anything after the request is ignored
+    }
+  }
+
+  if (_webSocket != nullptr) {
+    // The WebSocket client owns the connection now; frames that arrived
+    // with the handshake are passed on
+    if (pos < len) _webSocket->onData(data + pos, len - pos);
+    delete this;
+  }
+}
+
+bool AsyncWebServerRequest::parseRequestLine(const String& line) {
+  int space1 = line.indexOf(' ');
+  int space2 = space1 < 0 ? -1 : line.indexOf(' ', space1 + 1);
+  if (space1 <= 0 || space2 <= space1) return false;
+
+  String method = line.substring(0, space1);
+  if (method == "GET") _method = HTTP_GET;
+  else if (method == "POST") _method = HTTP_POST;
+  else if (method == "DELETE") _method = HTTP_DELETE;
+  else if (method == "PUT") _method = HTTP_PUT;
+  else if (method == "PATCH") _method = HTTP_PATCH;
+  else if (method == "HEAD") _method = HTTP_HEAD;
+  else if (method == "OPTIONS") _method = HTTP_OPTIONS;
+  else return false;
+
+  String target = line.substring(space1 + 1, space2);
+  _version = line.substring(space2 + 1) == "HTTP/1.0" ? 0 : 1;
+
+  int query = target.indexOf('?');
+  if (query >= 0) {
+    String params = target.substring(query + 1);
+    target = target.substring(0, query);
+    int start = 0;
+    while (start < (int)params.length()) {
+      int end = params.indexOf('&', start);
+      if (end < 0) end = params.length();
+      String pair = params.substring(start, end);
+      int equals = pair.indexOf('=');
+      if (pair.length() > 0) {
+        _params.emplace_back(urlDecode(equals < 0 ? pair : pair.substring(0, equals), true),
+                             urlDecode(equals < 0 ? String() : pair.substring(equals + 1), true));
+      }
+      start = end + 1;
+    }
+  }
+  _url = urlDecode(target, false);
+  return true;
+}
+
+void AsyncWebServerRequest::parseHeader(const String& line) {
+  int colon = line.indexOf(':');
+  if (colon <= 0) return;
+  String name = line.substring(0, colon);
+  String value = line.substring(colon + 1);
+  value.trim();
+
+  if (name.equalsIgnoreCase("Host")) {
+    _host = value;
+  } else if (name.equalsIgnoreCase("Content-Type")) {
+    _contentType = value;
+  } else if (name.equalsIgnoreCase("Content-Length")) {
+    _contentLength = strtoul(value.c_str(), nullptr, 10);
+  } else if (name.equalsIgnoreCase("Expect") && value.equalsIgnoreCase("100-continue")) {
+    _expectingContinue = true;
+  } else if (name.equalsIgnoreCase("Upgrade") && value.equalsIgnoreCase("websocket")) {
+    _isWebSocketUpgrade = true;
+  }
+  _headers.emplace_back(name, value);
+}
+
+void AsyncWebServerRequest::headersComplete() {
+  _handler = _server->findHandler(this);
+  if (_expectingContinue && _contentLength > 0) {
+    static const char kContinue[] = "HTTP/1.1 100 Continue\r\n\r\n";
+    _client->add(kContinue, sizeof(kContinue) - 1);
+    _client->send();
+  }
+  if (_contentLength > 0 && !_isWebSocketUpgrade) {
+    _state = kBody;
+  } else {
+    bodyComplete();
+  }
+}
+
+void AsyncWebServerRequest::bodyComplete() {
+  _state = kComplete;
+  _handler->handleRequest(this);
+}
+
+// ====== HANDLERS ======
+
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest* request) const {
+  if (!_onRequest || !request->isHTTP() || !(_method & request->method())) return false;
+
+  if (_uri.length() && _uri.startsWith("/*.")) {
+    String extension = _uri.substring(_uri.lastIndexOf('.'));
+    return request->url().endsWith(extension);
+  }
+  if (_uri.length() && _uri.endsWith("*")) {
+    return request->url().startsWith(_uri.substring(0, _uri.length() - 1));
+  }
+  if (_uri.length() && _uri != request->url() && !request->url().startsWith(_uri + "/")) {
+    return false;
+  }
+  return true;
+}
+
+void AsyncCallbackWebHandler::handleRequest(AsyncWebServerRequest* request) {
+  if (_onRequest) {
+    _onRequest(request);
+  } else {
+    request->send(404, "text/plain", "Not found");
+  }
+}
+
+void AsyncCallbackWebHandler::handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                                         size_t index, size_t total) {
+  if (_onBody) _onBody(request, data, len, index, total);
+}
+
+// ====== SERVER ======
+
+AsyncWebServer::AsyncWebServer(uint16_t port) : _server(port) {
+  _server.onClient([](void* s, AsyncClient* client) {
+    new AsyncWebServerRequest(static_cast<AsyncWebServer*>(s), client);
+  }, this);
+}
+
+AsyncWebServer::~AsyncWebServer() {
+  reset();
+  end();
+}
+
+void AsyncWebServer::begin() {
+  _server.setNoDelay(true);
+  _server.begin();
+}
+
+void AsyncWebServer::end() {
+  _server.end();
+}
+
+AsyncWebHandler& AsyncWebServer::addHandler(AsyncWebHandler* handler) {
+  _handlers.push_back(handler);
+  return *handler;
+}
+
+bool AsyncWebServer::removeHandler(AsyncWebHandler* handler) {
+  for (size_t i = 0; i < _handlers.size(); i++) {
+    if (_handlers[i] == handler) {
+      _handlers.erase(_handlers.begin() + i);
+      return true;
+    }
+  }
+  return false;
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest,
+                                            ArUploadHandlerFunction onUpload,
+                                            ArBodyHandlerFunction onBody) {
+  AsyncCallbackWebHandler* handler = new AsyncCallbackWebHandler();
+  handler->setUri(uri);
+  handler->setMethod(method);
+  handler->onRequest(onRequest);
+  handler->onUpload(onUpload);
+  handler->onBody(onBody);
+  _ownedHandlers.push_back(handler);
+  addHandler(handler);
+  return *handler;
+}
+
+void AsyncWebServer::reset() {
+  _handlers.clear();
+  for (AsyncCallbackWebHandler* handler : _ownedHandlers) delete handler;
+  _ownedHandlers.clear();
+  _catchAllHandler.onRequest(nullptr);
+  _catchAllHandler.onUpload(nullptr);
+  _catchAllHandler.onBody(nullptr);
+}
+
+AsyncWebHandler* AsyncWebServer::findHandler(AsyncWebServerRequest* request) {
+  for (AsyncWebHandler* handler : _handlers) {
+    if (handler->canHandle(request)) return handler;
+  }
+  return &_catchAllHandler;
+}
+
+#endif // SIGNALK_SIM
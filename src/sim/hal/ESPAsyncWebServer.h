@@ -0,0 +1,517 @@
+// ESPAsyncWebServer (ESP32Async 3.x) for the simulator, on the sim AsyncTCP
+//
+// Request parsing, handler selection, responses and WebSockets follow the
+// library's behaviour where the firmware depends on it:
+//  - handlers are tried in registration order; "/path" also matches
+//    "/path/...", "/prefix*" and "/*.ext" as in AsyncCallbackWebHandler
+//  - body handlers get the body in chunks, then onRequest runs; a request
+//    no handler responds to stays open, as on the device
+//  - responses are produced as the send buffer drains (chunked fillers may
+//    return RESPONSE_TRY_AGAIN) and the connection is closed afterwards
+//  - every callback runs on the async_tcp task; a WebSocket client's
+//    message queue holds WS_MAX_QUEUED_MESSAGES and disconnected clients
+//    stay in getClients() until cleanupClients()
+#ifndef SIM_ESPASYNCWEBSERVER_H
+#define SIM_ESPASYNCWEBSERVER_H
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef enum {
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_DELETE = 0b00000100,
+  HTTP_PUT = 0b00001000,
+  HTTP_PATCH = 0b00010000,
+  HTTP_HEAD = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+#define WS_MAX_QUEUED_MESSAGES 32
+#define DEFAULT_MAX_WS_CLIENTS 8
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+class AsyncWebSocket;
+class AsyncWebSocketClient;
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, const String& filename, size_t index,
+                           uint8_t* data, size_t len, bool final)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                           size_t index, size_t total)> ArBodyHandlerFunction;
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+// ====== HEADERS AND PARAMETERS ======
+
+class AsyncWebHeader {
+public:
+  AsyncWebHeader(const String& name, const String& value) : _name(name), _value(value) {}
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+  String toString() const { return _name + ": " + _value + "\r\n"; }
+
+private:
+  String _name;
+  String _value;
+};
+
+class AsyncWebParameter {
+public:
+  AsyncWebParameter(const String& name, const String& value, bool form = false)
+    : _name(name), _value(value), _isForm(form) {}
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+  bool isPost() const { return _isForm; }
+  bool isFile() const { return false; }
+
+private:
+  String _name;
+  String _value;
+  bool _isForm;
+};
+
+/**
+ * Headers added to every response, e.g. for CORS
+ */
+class DefaultHeaders {
+public:
+  static DefaultHeaders& Instance() {
+    static DefaultHeaders instance;
+    return instance;
+  }
+  void addHeader(const String& name, const String& value) { _headers.emplace_back(name, value); }
+  std::list<AsyncWebHeader>::const_iterator begin() const { return _headers.begin(); }
+  std::list<AsyncWebHeader>::const_iterator end() const { return _headers.end(); }
+
+private:
+  DefaultHeaders() = default;
+  std::list<AsyncWebHeader> _headers;
+};
+
+// ====== RESPONSES ======
+
+class AsyncWebServerResponse {
+public:
+  AsyncWebServerResponse();
+  virtual ~AsyncWebServerResponse() = default;
+
+  void setCode(int code) { _code = code; }
+  int code() const { return _code; }
+  void setContentType(const String& type) { _contentType = type; }
+  void setContentLength(size_t len) { _contentLength = len; }
+  bool addHeader(const char* name, const char* value, bool replaceExisting = true);
+  bool addHeader(const String& name, const String& value, bool replaceExisting = true) {
+    return addHeader(name.c_str(), value.c_str(), replaceExisting);
+  }
+  static const char* responseCodeToString(int code);
+
+protected:
+  friend class AsyncWebServerRequest;
+
+  // Produce up to maxLen body bytes at index; 0 when done,
+  // RESPONSE_TRY_AGAIN when nothing is ready yet
+  virtual size_t fill(uint8_t* buffer, size_t maxLen, size_t index) = 0;
+  virtual bool chunked() const { return false; }
+
+  void start(AsyncWebServerRequest* request);  // On send()
+  void resume();                               // After an ACK or poll
+  void acknowledged(size_t len);
+
+  int _code = 200;
+  String _contentType;
+  size_t _contentLength = 0;
+  std::list<AsyncWebHeader> _headers;
+
+private:
+  AsyncWebServerRequest* _request = nullptr;
+  std::string _pending;       // Head and framing not yet accepted by the client
+  size_t _index = 0;          // Body bytes produced
+  size_t _inFlight = 0;       // Written to the client, not yet acknowledged
+  bool _encodeChunks = false;
+  bool _finished = false;
+};
+
+class AsyncBasicResponse : public AsyncWebServerResponse {
+public:
+  AsyncBasicResponse(int code, const String& contentType = String(), const String& content = String());
+
+protected:
+  size_t fill(uint8_t* buffer, size_t maxLen, size_t index) override;
+
+private:
+  String _content;
+};
+
+class AsyncProgmemResponse : public AsyncWebServerResponse {
+public:
+  AsyncProgmemResponse(int code, const String& contentType, const uint8_t* content, size_t len);
+
+protected:
+  size_t fill(uint8_t* buffer, size_t maxLen, size_t index) override;
+
+private:
+  const uint8_t* _content;
+};
+
+class AsyncChunkedResponse : public AsyncWebServerResponse {
+public:
+  AsyncChunkedResponse(const String& contentType, AwsResponseFiller callback);
+
+protected:
+  size_t fill(uint8_t* buffer, size_t maxLen, size_t index) override;
+  bool chunked() const override { return true; }
+
+private:
+  AwsResponseFiller _callback;
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+  explicit AsyncResponseStream(const String& contentType, size_t bufferSize = 1460);
+
+  size_t write(uint8_t data) override { return write(&data, 1); }
+  size_t write(const uint8_t* data, size_t len) override;
+  using Print::write;
+
+protected:
+  size_t fill(uint8_t* buffer, size_t maxLen, size_t index) override;
+
+private:
+  std::string _content;
+};
+
+// ====== REQUEST ======
+
+class AsyncWebHandler;
+
+class AsyncWebServerRequest {
+public:
+  AsyncWebServerRequest(AsyncWebServer* server, AsyncClient* client);
+  ~AsyncWebServerRequest();
+
+  AsyncClient* client() { return _client; }
+  uint8_t version() const { return _version; }
+  WebRequestMethodComposite method() const { return _method; }
+  const char* methodToString() const;
+  const String& url() const { return _url; }
+  const String& host() const { return _host; }
+  const String& contentType() const { return _contentType; }
+  size_t contentLength() const { return _contentLength; }
+  bool isHTTP() const { return !_isWebSocketUpgrade; }
+  bool isWebSocketUpgrade() const { return _isWebSocketUpgrade; }
+
+  size_t headers() const { return _headers.size(); }
+  bool hasHeader(const char* name) const { return getHeader(name) != nullptr; }
+  bool hasHeader(const String& name) const { return hasHeader(name.c_str()); }
+  const AsyncWebHeader* getHeader(const char* name) const;
+  const AsyncWebHeader* getHeader(const String& name) const { return getHeader(name.c_str()); }
+  const AsyncWebHeader* getHeader(size_t num) const;
+  const String& header(const char* name) const;
+  const String& header(const String& name) const { return header(name.c_str()); }
+
+  size_t params() const { return _params.size(); }
+  bool hasParam(const char* name, bool post = false, bool file = false) const {
+    return getParam(name, post, file) != nullptr;
+  }
+  bool hasParam(const String& name, bool post = false, bool file = false) const {
+    return hasParam(name.c_str(), post, file);
+  }
+  const AsyncWebParameter* getParam(const char* name, bool post = false, bool file = false) const;
+  const AsyncWebParameter* getParam(const String& name, bool post = false, bool file = false) const {
+    return getParam(name.c_str(), post, file);
+  }
+  const AsyncWebParameter* getParam(size_t num) const;
+  bool hasArg(const char* name) const { return hasParam(name); }
+  const String& arg(const char* name) const;
+  const String& arg(const String& name) const { return arg(name.c_str()); }
+
+  void send(AsyncWebServerResponse* response);
+  void send(int code, const char* contentType = "", const char* content = "") {
+    send(beginResponse(code, String(contentType), String(content)));
+  }
+  void send(int code, const String& contentType, const String& content = String()) {
+    send(beginResponse(code, contentType, content));
+  }
+  void send(int code, const String& contentType, const char* content) {
+    send(beginResponse(code, contentType, String(content)));
+  }
+  void send(int code, const String& contentType, AwsResponseFiller callback) {
+    AsyncWebServerResponse* response = beginChunkedResponse(contentType, callback);
+    response->setCode(code);
+    send(response);
+  }
+  void send_P(int code, const String& contentType, PGM_P content) {
+    send(new AsyncProgmemResponse(code, contentType, (const uint8_t*)content, strlen_P(content)));
+  }
+  void send_P(int code, const String& contentType, const uint8_t* content, size_t len) {
+    send(new AsyncProgmemResponse(code, contentType, content, len));
+  }
+  void redirect(const char* url, int code = 302);
+  void redirect(const String& url, int code = 302) { redirect(url.c_str(), code); }
+
+  AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(),
+                                        const String& content = String()) {
+    return new AsyncBasicResponse(code, contentType, content);
+  }
+  AsyncWebServerResponse* beginResponse(int code, const char* contentType, const char* content) {
+    return new AsyncBasicResponse(code, String(contentType), String(content));
+  }
+  AsyncWebServerResponse* beginResponse_P(int code, const String& contentType, PGM_P content) {
+    return new AsyncProgmemResponse(code, contentType, (const uint8_t*)content, strlen_P(content));
+  }
+  AsyncWebServerResponse* beginChunkedResponse(const String& contentType, AwsResponseFiller callback) {
+    return new AsyncChunkedResponse(contentType, callback);
+  }
+  AsyncResponseStream* beginResponseStream(const String& contentType, size_t bufferSize = 1460) {
+    return new AsyncResponseStream(contentType, bufferSize);
+  }
+
+private:
+  friend class AsyncWebServerResponse;
+  friend class AsyncWebSocket;
+
+  enum ParseState { kRequestLine, kHeaders, kBody, kComplete };
+
+  void onData(uint8_t* data, size_t len);
+  bool parseRequestLine(const String& line);
+  void parseHeader(const String& line);
+  void headersComplete();
+  void bodyComplete();
+  void responseFinished();
+
+  AsyncWebServer* _server;
+  AsyncClient* _client;
+  ParseState _state = kRequestLine;
+  std::string _line;
+  uint8_t _version = 0;
+  WebRequestMethodComposite _method = HTTP_GET;
+  String _url;
+  String _host;
+  String _contentType;
+  size_t _contentLength = 0;
+  size_t _bodyIndex = 0;
+  bool _isWebSocketUpgrade = false;
+  bool _expectingContinue = false;
+  std::list<AsyncWebHeader> _headers;
+  std::list<AsyncWebParameter> _params;
+  AsyncWebHandler* _handler = nullptr;
+  AsyncWebServerResponse* _response = nullptr;
+  AsyncWebSocketClient* _webSocket = nullptr;  // Took over the connection
+};
+
+// ====== HANDLERS ======
+
+class AsyncWebHandler {
+public:
+  virtual ~AsyncWebHandler() = default;
+  virtual bool canHandle(AsyncWebServerRequest* request) const { return false; }
+  virtual void handleRequest(AsyncWebServerRequest* request) {}
+  virtual void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                          size_t index, size_t total) {}
+  virtual bool isRequestHandlerTrivial() const { return true; }
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+public:
+  void setUri(const String& uri) { _uri = uri; }
+  void setMethod(WebRequestMethodComposite method) { _method = method; }
+  void onRequest(ArRequestHandlerFunction fn) { _onRequest = fn; }
+  void onUpload(ArUploadHandlerFunction fn) { _onUpload = fn; }
+  void onBody(ArBodyHandlerFunction fn) { _onBody = fn; }
+
+  bool canHandle(AsyncWebServerRequest* request) const override;
+  void handleRequest(AsyncWebServerRequest* request) override;
+  void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                  size_t index, size_t total) override;
+  bool isRequestHandlerTrivial() const override { return !_onRequest; }
+
+private:
+  String _uri;
+  WebRequestMethodComposite _method = HTTP_ANY;
+  ArRequestHandlerFunction _onRequest;
+  ArUploadHandlerFunction _onUpload;
+  ArBodyHandlerFunction _onBody;
+};
+
+// ====== WEBSOCKET ======
+
+typedef enum { WS_DISCONNECTED, WS_CONNECTED, WS_DISCONNECTING } AwsClientStatus;
+typedef enum { WS_CONTINUATION, WS_TEXT, WS_BINARY, WS_DISCONNECT = 0x08, WS_PING, WS_PONG } AwsFrameType;
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PING, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+
+typedef struct {
+  uint8_t message_opcode;
+  uint32_t num;
+  uint8_t final;
+  uint8_t masked;
+  uint8_t opcode;
+  uint64_t len;
+  uint8_t mask[4];
+  uint64_t index;
+} AwsFrameInfo;
+
+typedef std::shared_ptr<std::vector<uint8_t>> AsyncWebSocketSharedBuffer;
+
+typedef std::function<void(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type,
+                           void* arg, uint8_t* data, size_t len)> AwsEventHandler;
+
+class AsyncWebSocketClient {
+public:
+  AsyncWebSocketClient(AsyncClient* client, AsyncWebSocket* server);
+  ~AsyncWebSocketClient();
+
+  uint32_t id() const { return _id; }
+  AwsClientStatus status() const { return _status.load(); }
+  AsyncClient* client() { return _client; }
+  AsyncWebSocket* server() { return _server; }
+  IPAddress remoteIP() const { return _remoteIp; }
+  uint16_t remotePort() const { return _remotePort; }
+
+  size_t queueLen() const;
+  bool queueIsFull() const;
+  bool canSend() const { return !queueIsFull(); }
+
+  /**
+   * Send a close frame; the connection closes once the peer answers (or
+   * on the next poll)
+   */
+  void close(uint16_t code = 0, const char* message = nullptr);
+  void ping(const uint8_t* data = nullptr, size_t len = 0);
+
+  bool text(const char* message, size_t len);
+  bool text(const char* message) { return text(message, strlen(message)); }
+  bool text(const String& message) { return text(message.c_str(), message.length()); }
+  bool text(AsyncWebSocketSharedBuffer buffer);
+  bool binary(const uint8_t* message, size_t len);
+  bool binary(AsyncWebSocketSharedBuffer buffer);
+
+private:
+  friend class AsyncWebSocket;
+  friend class AsyncWebServerRequest;
+
+  struct Message {
+    AsyncWebSocketSharedBuffer payload;
+    uint8_t opcode;
+    size_t sent = 0;        // Of header + payload
+    std::string header;
+  };
+
+  bool queueMessage(AsyncWebSocketSharedBuffer payload, uint8_t opcode, bool control = false);
+  void runQueue();  // With _lock held
+  void onData(const uint8_t* data, size_t len);
+  void onAck();
+  void onPoll();
+  void onDisconnect(AsyncClient* client);
+  void handleFrame(uint8_t opcode, bool final, uint8_t* payload, size_t len);
+
+  AsyncWebSocket* _server;
+  AsyncClient* _client;
+  uint32_t _id;
+  std::atomic<AwsClientStatus> _status{WS_CONNECTED};
+  IPAddress _remoteIp;
+  uint16_t _remotePort;
+  mutable std::recursive_mutex _lock;  // Queue and _client; taken before the AsyncClient's lock
+  std::deque<Message> _queue;
+  std::string _input;           // Partial frames (async_tcp task only)
+  bool _closeSent = false;
+  bool _abort = false;          // Close on the next poll without waiting for the peer
+  uint32_t _closeSentAt = 0;
+  uint8_t _messageOpcode = WS_TEXT;  // Of a fragmented message
+  uint32_t _fragment = 0;
+};
+
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+  explicit AsyncWebSocket(const String& url) : _url(url) {}
+  ~AsyncWebSocket();
+
+  const char* url() const { return _url.c_str(); }
+  void enable(bool e) { _enabled = e; }
+  bool enabled() const { return _enabled; }
+  void onEvent(AwsEventHandler handler) { _eventHandler = handler; }
+
+  size_t count() const;
+  AsyncWebSocketClient* client(uint32_t id);
+  bool hasClient(uint32_t id) { return client(id) != nullptr; }
+  std::list<AsyncWebSocketClient>& getClients() { return _clients; }
+
+  /**
+   * Remove disconnected clients and close the oldest ones beyond maxClients.
+   * Call from loop(): clients are destroyed here.
+   */
+  void cleanupClients(uint16_t maxClients = DEFAULT_MAX_WS_CLIENTS);
+
+  void closeAll(uint16_t code = 0, const char* message = nullptr);
+  void textAll(const char* message, size_t len);
+  void textAll(const char* message) { textAll(message, strlen(message)); }
+  void textAll(const String& message) { textAll(message.c_str(), message.length()); }
+  void textAll(AsyncWebSocketSharedBuffer buffer);
+  bool text(uint32_t id, const String& message);
+
+  bool canHandle(AsyncWebServerRequest* request) const override;
+  void handleRequest(AsyncWebServerRequest* request) override;
+
+private:
+  friend class AsyncWebSocketClient;
+
+  void handleEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len);
+
+  String _url;
+  bool _enabled = true;
+  AwsEventHandler _eventHandler;
+  std::list<AsyncWebSocketClient> _clients;
+  mutable std::mutex _lock;  // List membership and WS_DISCONNECTED transitions
+  uint32_t _nextId = 1;
+};
+
+// ====== SERVER ======
+
+class AsyncWebServer {
+public:
+  explicit AsyncWebServer(uint16_t port);
+  ~AsyncWebServer();
+
+  void begin();
+  void end();
+
+  AsyncWebHandler& addHandler(AsyncWebHandler* handler);
+  bool removeHandler(AsyncWebHandler* handler);
+
+  AsyncCallbackWebHandler& on(const char* uri, ArRequestHandlerFunction onRequest) {
+    return on(uri, HTTP_ANY, onRequest);
+  }
+  AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method,
+                              ArRequestHandlerFunction onRequest,
+                              ArUploadHandlerFunction onUpload = nullptr,
+                              ArBodyHandlerFunction onBody = nullptr);
+
+  void onNotFound(ArRequestHandlerFunction fn) { _catchAllHandler.onRequest(fn); }
+  void onFileUpload(ArUploadHandlerFunction fn) { _catchAllHandler.onUpload(fn); }
+  void onRequestBody(ArBodyHandlerFunction fn) { _catchAllHandler.onBody(fn); }
+  void reset();
+
+private:
+  friend class AsyncWebServerRequest;
+
+  AsyncWebHandler* findHandler(AsyncWebServerRequest* request);
+
+  AsyncServer _server;
+  std::vector<AsyncWebHandler*> _handlers;
+  std::vector<AsyncCallbackWebHandler*> _ownedHandlers;
+  AsyncCallbackWebHandler _catchAllHandler;
+};
+
+#endif // SIM_ESPASYNCWEBSERVER_H
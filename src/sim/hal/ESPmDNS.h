@@ -0,0 +1,16 @@
+// mDNS responder for the simulator: nothing is advertised
+#ifndef SIM_ESPMDNS_H
+#define SIM_ESPMDNS_H
+
+#include <Arduino.h>
+
+class MDNSResponder {
+public:
+  bool begin(const char* hostName) { return true; }
+  void end() {}
+  bool addService(const char* service, const char* proto, uint16_t port) { return true; }
+};
+
+extern MDNSResponder MDNS;
+
+#endif // SIM_ESPMDNS_H
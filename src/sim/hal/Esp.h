@@ -0,0 +1,26 @@
+// ESP32 system API (EspClass) for the simulator
+#ifndef SIM_ESP_H
+#define SIM_ESP_H
+
+#include <stdint.h>
+
+class EspClass {
+public:
+  /**
+   * Re-executes the simulator with the same command line, so the firmware
+   * starts from setup() again with Preferences kept (--nvs)
+   */
+  [[noreturn]] void restart();
+
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getHeapSize();
+  const char* getChipModel() { return "Linux simulator"; }
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint64_t getEfuseMac();
+};
+
+extern EspClass ESP;
+
+#endif // SIM_ESP_H
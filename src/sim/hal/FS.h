@@ -0,0 +1,74 @@
+// ESP32 FS file API for the simulator
+// Files are ordinary host files; a File is a shared handle like on the
+// device, so copies refer to the same open file.
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+struct SimFileImpl;
+
+class File : public Stream {
+public:
+  File() {}
+  explicit File(std::shared_ptr<SimFileImpl> impl) : _impl(impl) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  size_t read(uint8_t* buf, size_t size);
+  size_t readBytes(char* buffer, size_t length) override { return read((uint8_t*)buffer, length); }
+  using Stream::readBytes;
+  int peek() override;
+  void flush() override;
+
+  bool seek(uint32_t pos);
+  size_t position() const;
+  size_t size() const;
+  void close();
+  operator bool() const { return _impl != nullptr; }
+
+  // Path on the device ("/capture.bin") and its last component
+  const char* path() const;
+  const char* name() const;
+
+  bool isDirectory() const;
+  File openNextFile(const char* mode = FILE_READ);
+
+private:
+  std::shared_ptr<SimFileImpl> _impl;
+};
+
+class FS {
+public:
+  File open(const char* path, const char* mode = FILE_READ, const bool create = false);
+  File open(const String& path, const char* mode = FILE_READ, const bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+
+protected:
+  // Host directory the device paths are mapped into
+  virtual const char* root() const = 0;
+  bool hostPath(const char* path, std::string& out) const;
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // SIM_FS_H
@@ -0,0 +1,95 @@
+#ifdef SIGNALK_SIM
+
+#include "HTTPClient.h"
+#include "sim_sha.h"
+
+bool HTTPClient::begin(Client& client, const String& url) {
+  int schemeEnd = url.indexOf("://");
+  if (schemeEnd < 0) return false;
+  String scheme = url.substring(0, schemeEnd);
+  String rest = url.substring(schemeEnd + 3);
+
+  int slash = rest.indexOf('/');
+  String hostPort = slash < 0 ? rest : rest.substring(0, slash);
+  _path = slash < 0 ? String("/") : rest.substring(slash);
+
+  int colon = hostPort.indexOf(':');
+  _port = scheme == "https" ? 443 : 80;
+  if (colon >= 0) {
+    _port = (uint16_t)hostPort.substring(colon + 1).toInt();
+    hostPort = hostPort.substring(0, colon);
+  }
+  _host = hostPort;
+  _client = &client;
+  _body = "";
+  return _host.length() > 0;
+}
+
+void HTTPClient::end() {
+  if (_client != nullptr) _client->stop();
+  _client = nullptr;
+}
+
+void HTTPClient::setAuthorization(const char* user, const char* password) {
+  String credentials = String(user) + ":" + password;
+  _authorization = simBase64((const uint8_t*)credentials.c_str(), credentials.length()).c_str();
+}
+
+bool HTTPClient::readLine(String& line, uint32_t deadline) {
+  line = "";
+  while ((int32_t)(millis() - deadline) < 0) {
+    int c = _client->read();
+    if (c < 0) {
+      if (!_client->connected()) return line.length() > 0;
+      delay(1);
+      continue;
+    }
+    if (c == '\n') return true;
+    if (c != '\r') line += (char)c;
+  }
+  return false;
+}
+
+int HTTPClient::GET() {
+  if (_client == nullptr) return HTTPC_ERROR_NOT_CONNECTED;
+  if (!_client->connected() && !_client->connect(_host.c_str(), _port)) {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+
+  String request = "GET " + _path + " HTTP/1.0\r\nHost: " + _host + "\r\nUser-Agent: " + _userAgent + "\r\n";
+  if (_authorization.length() > 0) request += "Authorization: Basic " + _authorization + "\r\n";
+  request += "Connection: close\r\n\r\n";
+  if (_client->write((const uint8_t*)request.c_str(), request.length()) != request.length()) {
+    return HTTPC_ERROR_SEND_HEADER_FAILED;
+  }
+
+  uint32_t deadline = millis() + _timeout;
+  String line;
+  if (!readLine(line, deadline) || !line.startsWith("HTTP/")) return HTTPC_ERROR_READ_TIMEOUT;
+  int code = line.substring(line.indexOf(' ') + 1).toInt();
+
+  long contentLength = -1;
+  while (readLine(line, deadline) && line.length() > 0) {
+    int colon = line.indexOf(':');
+    if (colon > 0 && line.substring(0, colon).equalsIgnoreCase("Content-Length")) {
+      contentLength = line.substring(colon + 1).toInt();
+    }
+  }
+
+  _body = "";
+  while ((contentLength < 0 || (long)_body.length() < contentLength) &&
+         (int32_t)(millis() - deadline) < 0) {
+    uint8_t buffer[256];
+    int n = _client->read(buffer, sizeof(buffer));
+    if (n > 0) {
+      _body.concat((const char*)buffer, (unsigned int)n);
+    } else if (!_client->connected()) {
+      break;
+    } else {
+      delay(1);
+    }
+  }
+  return code;
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,42 @@
+// ESP32 HTTPClient subset for the simulator: GET over any Client, HTTP/1.0
+// so the body is delimited by Content-Length or the connection closing
+#ifndef SIM_HTTPCLIENT_H
+#define SIM_HTTPCLIENT_H
+
+#include <Arduino.h>
+#include "Client.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+class HTTPClient {
+public:
+  bool begin(Client& client, const String& url);
+  void end();
+
+  void setConnectTimeout(int32_t connectTimeout) { _connectTimeout = connectTimeout; }
+  void setTimeout(uint16_t timeout) { _timeout = timeout; }
+  void setAuthorization(const char* user, const char* password);
+  void setUserAgent(const String& userAgent) { _userAgent = userAgent; }
+
+  int GET();
+  String getString() { return _body; }
+  int getSize() { return (int)_body.length(); }
+
+private:
+  bool readLine(String& line, uint32_t deadline);
+
+  Client* _client = nullptr;
+  String _host;
+  uint16_t _port = 80;
+  String _path;
+  String _authorization;
+  String _userAgent = "ESP32HTTPClient";
+  int32_t _connectTimeout = 5000;
+  uint16_t _timeout = 5000;
+  String _body;
+};
+
+#endif // SIM_HTTPCLIENT_H
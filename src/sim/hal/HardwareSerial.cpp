@@ -0,0 +1,48 @@
+#ifdef SIGNALK_SIM
+
+#include <Arduino.h>
+#include "../sim.h"
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin,
+                           bool invert, unsigned long timeout_ms, uint8_t rxfifo_full_thrhd) {
+  if (_uart == 0) return;  // The console is always open
+  char name[16];
+  snprintf(name, sizeof(name), "uart%u", _uart);
+  _port.open(name);
+}
+
+void HardwareSerial::end() {
+  if (_uart != 0) _port.close();
+}
+
+int HardwareSerial::available() {
+  return _uart == 0 ? 0 : _port.available();
+}
+
+int HardwareSerial::read() {
+  return _uart == 0 ? -1 : _port.read();
+}
+
+int HardwareSerial::peek() {
+  return _uart == 0 ? -1 : _port.peek();
+}
+
+size_t HardwareSerial::readBytes(char* buffer, size_t length) {
+  return _uart == 0 ? 0 : _port.read((uint8_t*)buffer, length);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  if (_uart != 0) return _port.write(buffer, size);
+  if (!simOptions.quiet) fwrite(buffer, 1, size, stdout);
+  return size;
+}
+
+void HardwareSerial::flush() {
+  if (_uart == 0) fflush(stdout);
+}
+
+#endif // SIGNALK_SIM
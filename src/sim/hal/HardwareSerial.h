@@ -0,0 +1,47 @@
+// ESP32 HardwareSerial for the simulator
+// UART0 (Serial) is the console on stdout; every other UART becomes a
+// pseudo-terminal when begin() is called, linked as <portDir>/uart<n>.
+#ifndef SIM_HARDWARESERIAL_H
+#define SIM_HARDWARESERIAL_H
+
+#include <stdint.h>
+#include "Stream.h"
+#include "sim_port.h"
+
+#define SERIAL_8N1 0x800001c
+#define SERIAL_8E1 0x800001e
+#define SERIAL_8O1 0x800001f
+
+class HardwareSerial : public Stream {
+public:
+  explicit HardwareSerial(uint8_t uart_nr) : _uart(uart_nr) {}
+
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1,
+             bool invert = false, unsigned long timeout_ms = 20000UL, uint8_t rxfifo_full_thrhd = 112);
+  void end();
+  size_t setRxBufferSize(size_t size) { return size; }
+  void updateBaudRate(unsigned long baud) {}
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char* buffer, size_t length) override;
+  using Stream::readBytes;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int availableForWrite() override { return 128; }
+  void flush() override;
+
+  operator bool() const { return true; }
+
+private:
+  uint8_t _uart;
+  SimPort _port;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // SIM_HARDWARESERIAL_H
@@ -0,0 +1,39 @@
+// Arduino IPAddress (IPv4) for the simulator
+#ifndef SIM_IPADDRESS_H
+#define SIM_IPADDRESS_H
+
+#include <stdint.h>
+#include "Print.h"
+#include "WString.h"
+
+class IPAddress : public Printable {
+public:
+  IPAddress() : _address(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    _bytes[0] = a;
+    _bytes[1] = b;
+    _bytes[2] = c;
+    _bytes[3] = d;
+  }
+  // Network byte order, like lwIP's u32_t addresses
+  IPAddress(uint32_t address) : _address(address) {}
+
+  operator uint32_t() const { return _address; }
+  bool operator==(const IPAddress& other) const { return _address == other._address; }
+  bool operator!=(const IPAddress& other) const { return _address != other._address; }
+  uint8_t operator[](int index) const { return _bytes[index]; }
+  uint8_t& operator[](int index) { return _bytes[index]; }
+
+  bool fromString(const char* address);
+  bool fromString(const String& address) { return fromString(address.c_str()); }
+  String toString() const;
+  size_t printTo(Print& p) const override { return p.print(toString()); }
+
+private:
+  union {
+    uint8_t _bytes[4];
+    uint32_t _address;
+  };
+};
+
+#endif // SIM_IPADDRESS_H
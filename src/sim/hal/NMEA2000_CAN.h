@@ -0,0 +1,11 @@
+// NMEA2000_CAN.h for the simulator: the global NMEA2000 instance on the
+// host CAN backend, as the library's header does for SocketCAN on Linux
+#ifndef SIM_NMEA2000_CAN_H
+#define SIM_NMEA2000_CAN_H
+
+#include <NMEA2000.h>
+#include "NMEA2000_SocketCAN.h"
+
+tNMEA2000& NMEA2000 = *(new tNMEA2000_SocketCAN());
+
+#endif // SIM_NMEA2000_CAN_H
@@ -0,0 +1,123 @@
+#ifdef SIGNALK_SIM
+
+#include "NMEA2000_SocketCAN.h"
+#include "../sim.h"
+#include <errno.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool tNMEA2000_SocketCAN::CANOpen() {
+  if (simOptions.canLog != nullptr) {
+    _log = fopen(simOptions.canLog, "r");
+    if (_log == nullptr) {
+      simLog("sim: cannot open CAN log %s: %s\n", simOptions.canLog, strerror(errno));
+      return false;
+    }
+    simLog("sim: replaying CAN log %s\n", simOptions.canLog);
+    return true;
+  }
+
+  if (simOptions.canInterface == nullptr) {
+    simLog("sim: no CAN interface (--can) or log (--can-log), NMEA 2000 bus is silent\n");
+    return true;
+  }
+
+  _socket = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+  if (_socket < 0) {
+    simLog("sim: SocketCAN unavailable: %s\n", strerror(errno));
+    return false;
+  }
+  ifreq ifr = {};
+  strncpy(ifr.ifr_name, simOptions.canInterface, IFNAMSIZ - 1);
+  sockaddr_can addr = {};
+  addr.can_family = AF_CAN;
+  if (ioctl(_socket, SIOCGIFINDEX, &ifr) < 0 ||
+      (addr.can_ifindex = ifr.ifr_ifindex,
+       bind(_socket, (sockaddr*)&addr, sizeof(addr)) < 0)) {
+    simLog("sim: cannot open CAN interface %s: %s\n", simOptions.canInterface, strerror(errno));
+    close(_socket);
+    _socket = -1;
+    return false;
+  }
+  simLog("sim: NMEA 2000 on CAN interface %s\n", simOptions.canInterface);
+  return true;
+}
+
+bool tNMEA2000_SocketCAN::CANSendFrame(unsigned long id, unsigned char len, const unsigned char* buf,
+                                       bool wait_sent) {
+  if (_socket < 0) return true;  // Log replay or silent bus: sent to nobody
+
+  can_frame frame = {};
+  frame.can_id = (id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+  frame.can_dlc = len > 8 ? 8 : len;
+  memcpy(frame.data, buf, frame.can_dlc);
+  return write(_socket, &frame, sizeof(frame)) == (ssize_t)sizeof(frame);
+}
+
+bool tNMEA2000_SocketCAN::CANGetFrame(unsigned long& id, unsigned char& len, unsigned char* buf) {
+  if (_socket >= 0) {
+    can_frame frame;
+    while (read(_socket, &frame, sizeof(frame)) == (ssize_t)sizeof(frame)) {
+      if (frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG)) continue;
+      id = frame.can_id & ((frame.can_id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK);
+      len = frame.can_dlc > 8 ? 8 : frame.can_dlc;
+      memcpy(buf, frame.data, len);
+      return true;
+    }
+    return false;
+  }
+
+  if (_log == nullptr) return false;
+  if (!_haveNext && !readLogFrame()) return false;
+
+  // Frames are released at the pace they were recorded
+  if (_logStart < 0) {
+    _logStart = _nextTime;
+    _replayStart = millis();
+  }
+  if ((double)(millis() - _replayStart) < (_nextTime - _logStart) * 1000.0) return false;
+
+  id = _nextId;
+  len = _nextLen;
+  memcpy(buf, _nextData, len);
+  _haveNext = false;
+  return true;
+}
+
+// candump -l format: "(1700000000.123456) can0 09F80103#0123456789ABCDEF"
+bool tNMEA2000_SocketCAN::readLogFrame() {
+  char line[256];
+  while (fgets(line, sizeof(line), _log) != nullptr) {
+    double time;
+    char iface[32];
+    char frame[64];
+    if (sscanf(line, " (%lf) %31s %63s", &time, iface, frame) != 3) continue;
+    char* hash = strchr(frame, '#');
+    if (hash == nullptr || hash[1] == 'R') continue;  // Remote frames carry no data
+
+    *hash = '\0';
+    _nextId = strtoul(frame, nullptr, 16) & CAN_EFF_MASK;
+    const char* hex = hash + 1;
+    _nextLen = 0;
+    while (_nextLen < 8 && isxdigit((unsigned char)hex[0]) && isxdigit((unsigned char)hex[1])) {
+      char byte[3] = {hex[0], hex[1], 0};
+      _nextData[_nextLen++] = (unsigned char)strtoul(byte, nullptr, 16);
+      hex += 2;
+    }
+    _nextTime = time;
+    _haveNext = true;
+    return true;
+  }
+
+  simLog("sim: end of CAN log %s\n", simOptions.canLog);
+  fclose(_log);
+  _log = nullptr;
+  return false;
+}
+
+#endif // SIGNALK_SIM
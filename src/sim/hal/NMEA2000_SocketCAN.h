@@ -0,0 +1,35 @@
+// NMEA 2000 CAN backend for the simulator
+// The NMEA2000 library's NMEA2000_CAN.h picks the SocketCAN backend on
+// Linux; this one reads frames from --can <interface> (e.g. vcan0, or a
+// USB adapter via slcand) or replays a candump log given with --can-log at
+// its recorded pace. Without either the bus is silent.
+#ifndef SIM_NMEA2000_SOCKETCAN_H
+#define SIM_NMEA2000_SOCKETCAN_H
+
+#include <NMEA2000.h>
+#include <stdio.h>
+
+class tNMEA2000_SocketCAN : public tNMEA2000 {
+public:
+  tNMEA2000_SocketCAN() {}
+
+protected:
+  bool CANSendFrame(unsigned long id, unsigned char len, const unsigned char* buf, bool wait_sent = true) override;
+  bool CANOpen() override;
+  bool CANGetFrame(unsigned long& id, unsigned char& len, unsigned char* buf) override;
+
+private:
+  bool readLogFrame();  // Parse the next candump line into _next
+
+  int _socket = -1;
+  FILE* _log = nullptr;
+  bool _haveNext = false;
+  double _nextTime = 0;
+  unsigned long _nextId = 0;
+  unsigned char _nextLen = 0;
+  unsigned char _nextData[8];
+  double _logStart = -1;     // Timestamp of the first frame in the log
+  uint32_t _replayStart = 0; // millis() when it was replayed
+};
+
+#endif // SIM_NMEA2000_SOCKETCAN_H
@@ -0,0 +1,186 @@
+#ifdef SIGNALK_SIM
+
+#include "Preferences.h"
+#include "../sim.h"
+#include <stdio.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+// NVS limits keys and namespace names to 15 characters; enforced so that
+// the simulator rejects what the device would
+static const size_t kMaxKeyLength = 15;
+
+typedef std::map<std::string, std::string> Namespace;
+
+static std::mutex storeLock;
+static std::map<std::string, Namespace> store;
+static bool loaded = false;
+
+// ====== FILE ======
+// One "namespace<TAB>key<TAB>value" line per entry; \, tab and newline in
+// values are escaped
+
+static std::string escape(const std::string& s) {
+  std::string out;
+  for (char c : s) {
+    if (c == '\\') out += "\\\\";
+    else if (c == '\t') out += "\\t";
+    else if (c == '\n') out += "\\n";
+    else out += c;
+  }
+  return out;
+}
+
+static std::string unescape(const std::string& s) {
+  std::string out;
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] == '\\' && i + 1 < s.size()) {
+      char c = s[++i];
+      out += c == 't' ? '\t' : c == 'n' ? '\n' : c;
+    } else {
+      out += s[i];
+    }
+  }
+  return out;
+}
+
+static void loadLocked() {
+  if (loaded) return;
+  loaded = true;
+  if (simOptions.nvsFile == nullptr) return;
+
+  FILE* f = fopen(simOptions.nvsFile, "r");
+  if (f == nullptr) return;
+  char* line = nullptr;
+  size_t cap = 0;
+  ssize_t len;
+  size_t entries = 0;
+  while ((len = getline(&line, &cap, f)) > 0) {
+    std::string text(line, line[len - 1] == '\n' ? len - 1 : len);
+    size_t tab1 = text.find('\t');
+    size_t tab2 = tab1 == std::string::npos ? tab1 : text.find('\t', tab1 + 1);
+    if (tab2 == std::string::npos) continue;
+    store[text.substr(0, tab1)][text.substr(tab1 + 1, tab2 - tab1 - 1)] = unescape(text.substr(tab2 + 1));
+    entries++;
+  }
+  free(line);
+  fclose(f);
+  simLog("sim: loaded %u preferences from %s\n", (unsigned)entries, simOptions.nvsFile);
+}
+
+static void saveLocked() {
+  if (simOptions.nvsFile == nullptr) return;
+  std::string temp = std::string(simOptions.nvsFile) + ".tmp";
+  FILE* f = fopen(temp.c_str(), "w");
+  if (f == nullptr) {
+    simLog("sim: cannot write %s\n", temp.c_str());
+    return;
+  }
+  for (const auto& ns : store) {
+    for (const auto& entry : ns.second) {
+      fprintf(f, "%s\t%s\t%s\n", ns.first.c_str(), entry.first.c_str(), escape(entry.second).c_str());
+    }
+  }
+  fclose(f);
+  rename(temp.c_str(), simOptions.nvsFile);
+}
+
+// ====== PREFERENCES ======
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition_label) {
+  if (_started) return false;
+  if (name == nullptr || strlen(name) == 0 || strlen(name) > kMaxKeyLength) {
+    Serial.printf("[Preferences] invalid namespace name '%s'\n", name ? name : "");
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(storeLock);
+  loadLocked();
+  _namespace = name;
+  _readOnly = readOnly;
+  _started = true;
+  return true;
+}
+
+void Preferences::end() {
+  _started = false;
+}
+
+bool Preferences::clear() {
+  if (!_started || _readOnly) return false;
+  std::lock_guard<std::mutex> lock(storeLock);
+  store.erase(_namespace.c_str());
+  saveLocked();
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!_started || _readOnly || key == nullptr) return false;
+  std::lock_guard<std::mutex> lock(storeLock);
+  bool removed = store[_namespace.c_str()].erase(key) > 0;
+  if (removed) saveLocked();
+  return removed;
+}
+
+bool Preferences::isKey(const char* key) {
+  String value;
+  return getValue(key, value);
+}
+
+bool Preferences::putValue(const char* key, const char* value) {
+  if (!_started || _readOnly || key == nullptr) return false;
+  if (strlen(key) > kMaxKeyLength) {
+    Serial.printf("[Preferences] key '%s' is longer than %u characters, not stored\n",
+                  key, (unsigned)kMaxKeyLength);
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(storeLock);
+  std::string& slot = store[_namespace.c_str()][key];
+  if (slot != value) {
+    slot = value;
+    saveLocked();
+  }
+  return true;
+}
+
+bool Preferences::getValue(const char* key, String& value) {
+  if (!_started || key == nullptr) return false;
+  std::lock_guard<std::mutex> lock(storeLock);
+  auto ns = store.find(_namespace.c_str());
+  if (ns == store.end()) return false;
+  auto entry = ns->second.find(key);
+  if (entry == ns->second.end()) return false;
+  value = entry->second.c_str();
+  return true;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+  return putValue(key, value ? value : "") ? strlen(value ? value : "") : 0;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+  String value;
+  return getValue(key, value) ? value.toInt() != 0 : defaultValue;
+}
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+  String value;
+  return getValue(key, value) ? (int32_t)value.toInt() : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+  String value;
+  return getValue(key, value) ? (uint32_t)strtoul(value.c_str(), nullptr, 10) : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+  String value;
+  return getValue(key, value) ? value.toFloat() : defaultValue;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+  String value;
+  return getValue(key, value) ? value : defaultValue;
+}
+
+#endif // SIGNALK_SIM
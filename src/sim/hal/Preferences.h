@@ -0,0 +1,43 @@
+// ESP32 Preferences (NVS) for the simulator
+// All namespaces live in one in-memory store. With --nvs FILE it is loaded
+// at start-up and rewritten after every change, so settings survive a
+// restart like on the device.
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false, const char* partition_label = nullptr);
+  void end();
+
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+
+  size_t putBool(const char* key, bool value) { return putValue(key, value ? "1" : "0") ? 1 : 0; }
+  size_t putInt(const char* key, int32_t value) { return putValue(key, String(value).c_str()) ? 4 : 0; }
+  size_t putUInt(const char* key, uint32_t value) { return putValue(key, String(value).c_str()) ? 4 : 0; }
+  size_t putULong(const char* key, uint32_t value) { return putUInt(key, value); }
+  size_t putFloat(const char* key, float value) { return putValue(key, String(value, 7).c_str()) ? 4 : 0; }
+  size_t putString(const char* key, const char* value);
+  size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+
+  bool getBool(const char* key, bool defaultValue = false);
+  int32_t getInt(const char* key, int32_t defaultValue = 0);
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+  uint32_t getULong(const char* key, uint32_t defaultValue = 0) { return getUInt(key, defaultValue); }
+  float getFloat(const char* key, float defaultValue = NAN);
+  String getString(const char* key, const String& defaultValue = String());
+
+private:
+  bool putValue(const char* key, const char* value);
+  bool getValue(const char* key, String& value);
+
+  String _namespace;
+  bool _started = false;
+  bool _readOnly = false;
+};
+
+#endif // SIM_PREFERENCES_H
@@ -0,0 +1,103 @@
+#ifdef SIGNALK_SIM
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// ====== PRINT ======
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size-- > 0 && write(*buffer++)) n++;
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char stackBuffer[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+  va_end(args);
+  if (len < 0) return 0;
+  if ((size_t)len < sizeof(stackBuffer)) return write((const uint8_t*)stackBuffer, len);
+
+  char* heapBuffer = new char[len + 1];
+  va_start(args, format);
+  vsnprintf(heapBuffer, len + 1, format, args);
+  va_end(args);
+  size_t n = write((const uint8_t*)heapBuffer, len);
+  delete[] heapBuffer;
+  return n;
+}
+
+size_t Print::print(long long n, int base) {
+  return print(String(n, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long long n, int base) {
+  return print(String(n, (unsigned char)base));
+}
+
+size_t Print::print(double n, int digits) {
+  return print(String(n, (unsigned int)digits));
+}
+
+// ====== STREAM ======
+
+int Stream::timedRead() {
+  uint32_t start = millis();
+  do {
+    int c = read();
+    if (c >= 0) return c;
+    delay(1);
+  } while (millis() - start < _timeout);
+  return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+  size_t count = 0;
+  while (count < length) {
+    int c = timedRead();
+    if (c < 0) break;
+    buffer[count++] = (char)c;
+  }
+  return count;
+}
+
+String Stream::readString() {
+  String result;
+  int c;
+  while ((c = timedRead()) >= 0) result += (char)c;
+  return result;
+}
+
+String Stream::readStringUntil(char terminator) {
+  String result;
+  int c;
+  while ((c = timedRead()) >= 0 && c != terminator) result += (char)c;
+  return result;
+}
+
+// ====== IPADDRESS ======
+
+bool IPAddress::fromString(const char* address) {
+  unsigned int a, b, c, d;
+  char extra;
+  if (address == nullptr ||
+      sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &extra) != 4 ||
+      a > 255 || b > 255 || c > 255 || d > 255) {
+    return false;
+  }
+  _bytes[0] = a;
+  _bytes[1] = b;
+  _bytes[2] = c;
+  _bytes[3] = d;
+  return true;
+}
+
+String IPAddress::toString() const {
+  char text[16];
+  snprintf(text, sizeof(text), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+  return String(text);
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,32 @@
+// ESP32 SPIFFS for the simulator
+// The file system is the directory given by --spiffs (default sim-spiffs).
+// Like SPIFFS it has no directories: "/a/b" is one file, stored as a%2Fb
+// on the host.
+#ifndef SIM_SPIFFS_H
+#define SIM_SPIFFS_H
+
+#include "FS.h"
+
+// Size of the spiffs partition in huge_app.csv
+#define SIM_SPIFFS_TOTAL_BYTES 0xE0000
+
+class SPIFFSFS : public fs::FS {
+public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/spiffs",
+             uint8_t maxOpenFiles = 10, const char* partitionLabel = nullptr);
+  void end() { _mounted = false; }
+  bool format();
+
+  size_t totalBytes() { return SIM_SPIFFS_TOTAL_BYTES; }
+  size_t usedBytes();
+
+protected:
+  const char* root() const override;
+
+private:
+  bool _mounted = false;
+};
+
+extern SPIFFSFS SPIFFS;
+
+#endif // SIM_SPIFFS_H
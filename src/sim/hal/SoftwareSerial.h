@@ -0,0 +1,48 @@
+// EspSoftwareSerial for the simulator: a pseudo-terminal linked as
+// <portDir>/gpio<rx>, e.g. sim-ports/gpio25 for the GPS input
+#ifndef SIM_SOFTWARESERIAL_H
+#define SIM_SOFTWARESERIAL_H
+
+#include <Arduino.h>
+#include "sim_port.h"
+
+enum SoftwareSerialConfig {
+  SWSERIAL_5N1 = 0, SWSERIAL_6N1, SWSERIAL_7N1, SWSERIAL_8N1,
+  SWSERIAL_8E1 = 0x1B, SWSERIAL_8O1 = 0x3B, SWSERIAL_8M1 = 0x2B, SWSERIAL_8S1 = 0x0B,
+};
+
+class SoftwareSerial : public Stream {
+public:
+  SoftwareSerial() {}
+  SoftwareSerial(int8_t rxPin, int8_t txPin = -1, bool invert = false) : _rxPin(rxPin) {}
+
+  void begin(uint32_t baud) { begin(baud, SWSERIAL_8N1, _rxPin); }
+  void begin(uint32_t baud, SoftwareSerialConfig config, int8_t rxPin, int8_t txPin = -1,
+             bool invert = false, int bufCapacity = 64, int isrBufCapacity = 0) {
+    char name[16];
+    _rxPin = rxPin;
+    snprintf(name, sizeof(name), "gpio%d", rxPin);
+    _port.open(name);
+  }
+  void end() { _port.close(); }
+  bool isListening() { return _port.isOpen(); }
+  void enableRx(bool on) {}
+  bool overflow() { return false; }  // The pty buffers everything
+
+  int available() override { return _port.available(); }
+  int read() override { return _port.read(); }
+  int peek() override { return _port.peek(); }
+  size_t readBytes(char* buffer, size_t length) override { return _port.read((uint8_t*)buffer, length); }
+  using Stream::readBytes;
+  size_t write(uint8_t c) override { return _port.write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override { return _port.write(buffer, size); }
+  using Print::write;
+
+  operator bool() const { return _port.isOpen(); }
+
+private:
+  int8_t _rxPin = -1;
+  SimPort _port;
+};
+
+#endif // SIM_SOFTWARESERIAL_H
@@ -0,0 +1,185 @@
+#ifdef SIGNALK_SIM
+
+#include "WString.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+
+static std::string formatInteger(unsigned long long value, unsigned char base, bool negative) {
+  if (base < 2 || base > 36) base = 10;
+  char digits[66];
+  int pos = sizeof(digits);
+  digits[--pos] = '\0';
+  do {
+    int d = (int)(value % base);
+    digits[--pos] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+    value /= base;
+  } while (value > 0);
+  if (negative) digits[--pos] = '-';
+  return std::string(digits + pos);
+}
+
+String::String(long long value, unsigned char base) {
+  // Like the ESP32 core, only base 10 is signed
+  if (base == 10 && value < 0) {
+    _s = formatInteger(0ULL - (unsigned long long)value, base, true);
+  } else {
+    _s = formatInteger((unsigned long long)value, base, false);
+  }
+}
+
+String::String(unsigned long long value, unsigned char base) {
+  _s = formatInteger(value, base, false);
+}
+
+String::String(double value, unsigned int decimalPlaces) {
+  if (isnan(value)) {
+    _s = "nan";
+  } else if (isinf(value)) {
+    _s = value > 0 ? "inf" : "-inf";
+  } else {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimalPlaces, value);
+    _s = buffer;
+  }
+}
+
+char& String::operator[](unsigned int index) {
+  static char dummy;
+  if (index >= _s.size()) {
+    dummy = 0;
+    return dummy;
+  }
+  return _s[index];
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+  if (bufsize == 0 || buf == nullptr) return;
+  if (index >= _s.size()) {
+    buf[0] = 0;
+    return;
+  }
+  size_t n = std::min((size_t)bufsize - 1, _s.size() - index);
+  memcpy(buf, _s.data() + index, n);
+  buf[n] = 0;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+  if (beginIndex > endIndex) std::swap(beginIndex, endIndex);
+  if (beginIndex >= _s.size()) return String();
+  if (endIndex > _s.size()) endIndex = (unsigned int)_s.size();
+  return String(_s.data() + beginIndex, endIndex - beginIndex);
+}
+
+void String::replace(char find, char replace) {
+  std::replace(_s.begin(), _s.end(), find, replace);
+}
+
+void String::replace(const String& find, const String& replace) {
+  if (find._s.empty()) return;
+  size_t pos = 0;
+  while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+    _s.replace(pos, find._s.size(), replace._s);
+    pos += replace._s.size();
+  }
+}
+
+void String::toLowerCase() {
+  for (char& c : _s) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+  for (char& c : _s) c = (char)toupper((unsigned char)c);
+}
+
+void String::trim() {
+  size_t begin = 0;
+  while (begin < _s.size() && isspace((unsigned char)_s[begin])) begin++;
+  size_t end = _s.size();
+  while (end > begin && isspace((unsigned char)_s[end - 1])) end--;
+  _s = _s.substr(begin, end - begin);
+}
+
+// ====== CONCATENATION ======
+// Arduino's operator+ appends to the left-hand temporary in place
+
+StringSumHelper& operator+(const StringSumHelper& lhs, const String& rhs) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(rhs);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, const char* cstr) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(cstr);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, char c) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(c);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, unsigned char num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, int num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, unsigned int num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, long num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, unsigned long num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, long long num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, unsigned long long num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, float num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, double num) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(num);
+  return a;
+}
+
+StringSumHelper& operator+(const StringSumHelper& lhs, const __FlashStringHelper* rhs) {
+  StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+  a.concat(rhs);
+  return a;
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,175 @@
+// Arduino String for the simulator
+// Same interface as the ESP32 core's WString (including StringSumHelper,
+// which ArduinoJson relies on), stored in a std::string.
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+class __FlashStringHelper;
+#define FPSTR(pstr_pointer) (reinterpret_cast<const __FlashStringHelper*>(pstr_pointer))
+#define F(string_literal) (FPSTR(string_literal))
+
+class StringSumHelper;
+
+class String {
+public:
+  String(const char* cstr = "") : _s(cstr ? cstr : "") {}
+  String(const char* cstr, unsigned int length) : _s(cstr ? cstr : "", cstr ? length : 0) {}
+  String(const String& str) = default;
+  String(String&& rval) = default;
+  String(StringSumHelper&& rval);
+  String(const __FlashStringHelper* str) : String(reinterpret_cast<const char*>(str)) {}
+  explicit String(char c) : _s(1, c) {}
+  explicit String(unsigned char value, unsigned char base = 10) : String((unsigned long long)value, base) {}
+  explicit String(int value, unsigned char base = 10) : String((long long)value, base) {}
+  explicit String(unsigned int value, unsigned char base = 10) : String((unsigned long long)value, base) {}
+  explicit String(long value, unsigned char base = 10) : String((long long)value, base) {}
+  explicit String(unsigned long value, unsigned char base = 10) : String((unsigned long long)value, base) {}
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2) : String((double)value, decimalPlaces) {}
+  explicit String(double value, unsigned int decimalPlaces = 2);
+  ~String() {}
+
+  String& operator=(const String& rhs) = default;
+  String& operator=(String&& rval) = default;
+  String& operator=(const char* cstr) { _s = cstr ? cstr : ""; return *this; }
+  String& operator=(const __FlashStringHelper* str) { return *this = reinterpret_cast<const char*>(str); }
+  String& operator=(StringSumHelper&& rval);
+
+  bool reserve(unsigned int size) { _s.reserve(size); return true; }
+  inline unsigned int length() const { return (unsigned int)_s.size(); }
+  inline bool isEmpty() const { return _s.empty(); }
+  void clear() { _s.clear(); }
+
+  // Concatenation; these return true on success (always, on the host)
+  bool concat(const String& str) { _s += str._s; return true; }
+  bool concat(const char* cstr) { if (cstr) _s += cstr; return cstr != nullptr; }
+  bool concat(const char* cstr, unsigned int length) { if (cstr) _s.append(cstr, length); return cstr != nullptr; }
+  bool concat(const uint8_t* cstr, unsigned int length) { return concat((const char*)cstr, length); }
+  bool concat(char c) { _s += c; return true; }
+  bool concat(unsigned char num) { return concat(String(num)); }
+  bool concat(int num) { return concat(String(num)); }
+  bool concat(unsigned int num) { return concat(String(num)); }
+  bool concat(long num) { return concat(String(num)); }
+  bool concat(unsigned long num) { return concat(String(num)); }
+  bool concat(long long num) { return concat(String(num)); }
+  bool concat(unsigned long long num) { return concat(String(num)); }
+  bool concat(float num) { return concat(String(num)); }
+  bool concat(double num) { return concat(String(num)); }
+  bool concat(const __FlashStringHelper* str) { return concat(reinterpret_cast<const char*>(str)); }
+
+  template <typename T>
+  String& operator+=(const T& rhs) { concat(rhs); return *this; }
+  String& operator+=(const char* cstr) { concat(cstr); return *this; }
+
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, const String& rhs);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, const char* cstr);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, char c);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, unsigned char num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, int num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, unsigned int num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, long num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, unsigned long num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, long long num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, unsigned long long num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, float num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, double num);
+  friend StringSumHelper& operator+(const StringSumHelper& lhs, const __FlashStringHelper* rhs);
+
+  // Comparison
+  int compareTo(const String& s) const { return _s.compare(s._s); }
+  bool equals(const String& s) const { return _s == s._s; }
+  bool equals(const char* cstr) const { return _s == (cstr ? cstr : ""); }
+  bool equalsIgnoreCase(const String& s) const {
+    return _s.size() == s._s.size() && strcasecmp(_s.c_str(), s._s.c_str()) == 0;
+  }
+  bool operator==(const String& rhs) const { return equals(rhs); }
+  bool operator==(const char* cstr) const { return equals(cstr); }
+  bool operator!=(const String& rhs) const { return !equals(rhs); }
+  bool operator!=(const char* cstr) const { return !equals(cstr); }
+  bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+  bool operator>(const String& rhs) const { return compareTo(rhs) > 0; }
+  bool operator<=(const String& rhs) const { return compareTo(rhs) <= 0; }
+  bool operator>=(const String& rhs) const { return compareTo(rhs) >= 0; }
+  bool startsWith(const String& prefix) const { return startsWith(prefix, 0); }
+  bool startsWith(const String& prefix, unsigned int offset) const {
+    return offset <= _s.size() && _s.compare(offset, prefix._s.size(), prefix._s) == 0;
+  }
+  bool endsWith(const String& suffix) const {
+    return _s.size() >= suffix._s.size() &&
+           _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+  }
+
+  // Character access
+  char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+  void setCharAt(unsigned int index, char c) { if (index < _s.size()) _s[index] = c; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  char& operator[](unsigned int index);
+  void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+  void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+    getBytes((unsigned char*)buf, bufsize, index);
+  }
+  const char* c_str() const { return _s.c_str(); }
+  char* begin() { return &_s[0]; }
+  char* end() { return &_s[0] + _s.size(); }
+  const char* begin() const { return c_str(); }
+  const char* end() const { return c_str() + _s.size(); }
+
+  // Search
+  int indexOf(char ch, unsigned int fromIndex = 0) const { return found(_s.find(ch, fromIndex)); }
+  int indexOf(const String& str, unsigned int fromIndex = 0) const { return found(_s.find(str._s, fromIndex)); }
+  int lastIndexOf(char ch) const { return found(_s.rfind(ch)); }
+  int lastIndexOf(char ch, unsigned int fromIndex) const { return found(_s.rfind(ch, fromIndex)); }
+  int lastIndexOf(const String& str) const { return found(_s.rfind(str._s)); }
+  int lastIndexOf(const String& str, unsigned int fromIndex) const { return found(_s.rfind(str._s, fromIndex)); }
+  String substring(unsigned int beginIndex) const { return substring(beginIndex, length()); }
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  // Modification
+  void replace(char find, char replace);
+  void replace(const String& find, const String& replace);
+  void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  // Parsing
+  long toInt() const { return atol(_s.c_str()); }
+  float toFloat() const { return (float)atof(_s.c_str()); }
+  double toDouble() const { return atof(_s.c_str()); }
+
+private:
+  static int found(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+
+  std::string _s;
+};
+
+class StringSumHelper : public String {
+public:
+  StringSumHelper(const String& s) : String(s) {}
+  StringSumHelper(const char* p) : String(p) {}
+  StringSumHelper(char c) : String(c) {}
+  StringSumHelper(unsigned char num) : String(num) {}
+  StringSumHelper(int num) : String(num) {}
+  StringSumHelper(unsigned int num) : String(num) {}
+  StringSumHelper(long num) : String(num) {}
+  StringSumHelper(unsigned long num) : String(num) {}
+  StringSumHelper(long long num) : String(num) {}
+  StringSumHelper(unsigned long long num) : String(num) {}
+  StringSumHelper(float num) : String(num) {}
+  StringSumHelper(double num) : String(num) {}
+};
+
+inline String::String(StringSumHelper&& rval) : String(static_cast<String&&>(rval)) {}
+inline String& String::operator=(StringSumHelper&& rval) { return *this = static_cast<String&&>(rval); }
+
+inline bool operator==(const char* lhs, const String& rhs) { return rhs == lhs; }
+inline bool operator!=(const char* lhs, const String& rhs) { return rhs != lhs; }
+
+#endif // SIM_WSTRING_H
@@ -0,0 +1,149 @@
+#ifdef SIGNALK_SIM
+
+#include <WiFi.h>
+#include "../sim.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+// ====== WIFI ======
+
+IPAddress WiFiClass::localIP() {
+  IPAddress ip;
+  if (!ip.fromString(simOptions.bindAddress)) ip = IPAddress(127, 0, 0, 1);
+  return ip;
+}
+
+int WiFiClass::hostByName(const char* host, IPAddress& result) {
+  addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* found = nullptr;
+  if (host == nullptr || getaddrinfo(host, nullptr, &hints, &found) != 0 || found == nullptr) {
+    return 0;
+  }
+  result = IPAddress((uint32_t)reinterpret_cast<sockaddr_in*>(found->ai_addr)->sin_addr.s_addr);
+  freeaddrinfo(found);
+  return 1;
+}
+
+// ====== WIFICLIENT ======
+
+int WiFiClient::connect(IPAddress ip, uint16_t port, int32_t timeout_ms) {
+  stop();
+  _fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (_fd < 0) return 0;
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = (uint32_t)ip;
+  int rc = ::connect(_fd, (sockaddr*)&addr, sizeof(addr));
+  if (rc != 0 && errno == EINPROGRESS) {
+    pollfd pfd = {_fd, POLLOUT, 0};
+    int error = ETIMEDOUT;
+    if (::poll(&pfd, 1, timeout_ms) == 1) {
+      socklen_t len = sizeof(error);
+      getsockopt(_fd, SOL_SOCKET, SO_ERROR, &error, &len);
+    }
+    rc = error == 0 ? 0 : -1;
+  }
+  if (rc != 0) {
+    stop();
+    return 0;
+  }
+
+  _remote = ip;
+  _remotePort = port;
+  return 1;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeout_ms) {
+  IPAddress ip;
+  if (!ip.fromString(host) && !WiFi.hostByName(host, ip)) return 0;
+  return connect(ip, port, timeout_ms);
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+  // Blocking with the stream timeout, like lwIP's socket send
+  size_t sent = 0;
+  uint32_t start = millis();
+  while (_fd >= 0 && sent < size) {
+    ssize_t n = ::send(_fd, buf + sent, size - sent, MSG_NOSIGNAL);
+    if (n > 0) {
+      sent += (size_t)n;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (millis() - start > _timeout) break;
+      pollfd pfd = {_fd, POLLOUT, 0};
+      ::poll(&pfd, 1, 10);
+    } else {
+      stop();
+    }
+  }
+  return sent;
+}
+
+int WiFiClient::available() {
+  if (_fd < 0) return 0;
+  int pending = 0;
+  ioctl(_fd, FIONREAD, &pending);
+  return pending + (_peeked >= 0 ? 1 : 0);
+}
+
+int WiFiClient::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+  if (_fd < 0 || size == 0) return -1;
+  size_t got = 0;
+  if (_peeked >= 0) {
+    buf[got++] = (uint8_t)_peeked;
+    _peeked = -1;
+  }
+  ssize_t n = ::recv(_fd, buf + got, size - got, MSG_DONTWAIT);
+  if (n > 0) got += (size_t)n;
+  return got > 0 ? (int)got : -1;
+}
+
+int WiFiClient::peek() {
+  if (_peeked < 0) {
+    uint8_t c;
+    if (_fd >= 0 && ::recv(_fd, &c, 1, MSG_DONTWAIT) == 1) _peeked = c;
+  }
+  return _peeked;
+}
+
+void WiFiClient::stop() {
+  if (_fd >= 0) ::close(_fd);
+  _fd = -1;
+  _peeked = -1;
+}
+
+uint8_t WiFiClient::connected() {
+  if (_fd < 0) return 0;
+  if (_peeked >= 0) return 1;
+  // Connected while unread data is pending or the peer has not closed
+  uint8_t c;
+  ssize_t n = ::recv(_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) return 1;
+  stop();
+  return 0;
+}
+
+void WiFiClient::setNoDelay(bool nodelay) {
+  int flag = nodelay ? 1 : 0;
+  if (_fd >= 0) setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,90 @@
+// ESP32 WiFi for the simulator: the station is always "connected" with the
+// --bind address, the access point is a no-op and WiFiClient is a plain
+// host TCP socket
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include <Arduino.h>
+#include "Client.h"
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3,
+} wifi_mode_t;
+
+class WiFiClient : public Client {
+public:
+  WiFiClient() {}
+  ~WiFiClient() { stop(); }
+  WiFiClient(const WiFiClient&) = delete;
+  WiFiClient& operator=(const WiFiClient&) = delete;
+
+  int connect(IPAddress ip, uint16_t port) override { return connect(ip, port, 3000); }
+  int connect(IPAddress ip, uint16_t port, int32_t timeout_ms);
+  int connect(const char* host, uint16_t port) override { return connect(host, port, 3000); }
+  int connect(const char* host, uint16_t port, int32_t timeout_ms);
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buf, size_t size) override;
+  size_t readBytes(char* buffer, size_t length) override { return (size_t)max(0, read((uint8_t*)buffer, length)); }
+  using Stream::readBytes;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+
+  void setNoDelay(bool nodelay);
+  IPAddress remoteIP() const { return _remote; }
+  uint16_t remotePort() const { return _remotePort; }
+
+private:
+  int _fd = -1;
+  IPAddress _remote;
+  uint16_t _remotePort = 0;
+  int _peeked = -1;
+};
+
+class WiFiClass {
+public:
+  wl_status_t status() { return WL_CONNECTED; }
+  bool mode(wifi_mode_t mode) { return true; }
+  bool disconnect(bool wifioff = false) { return true; }
+  bool reconnect() { return true; }
+  String SSID() { return "sim"; }
+  int8_t RSSI() { return -50; }
+  IPAddress localIP();
+  String macAddress() { return "AA:BB:CC:DD:EE:FF"; }
+  bool setHostname(const char* hostname) { return true; }
+
+  bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1,
+              int ssid_hidden = 0, int max_connection = 4) { return true; }
+  bool softAPConfig(IPAddress local_ip, IPAddress gateway, IPAddress subnet) { return true; }
+  IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+  String softAPmacAddress() { return "AA:BB:CC:DD:EE:FE"; }
+  uint8_t softAPgetStationNum() { return 0; }
+
+  /**
+   * Resolve with the host resolver (IPv4); 1 on success like the ESP32 core
+   */
+  int hostByName(const char* host, IPAddress& result);
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,25 @@
+// WiFiClientSecure for the simulator. There is no TLS stack on the host
+// side: connections fail, so HTTPS users (DynDNS updates, Expo push over
+// TLS) report errors as they would without network access.
+#ifndef SIM_WIFICLIENTSECURE_H
+#define SIM_WIFICLIENTSECURE_H
+
+#include "WiFi.h"
+#include "../sim.h"
+
+class WiFiClientSecure : public WiFiClient {
+public:
+  void setInsecure() {}
+  void setCACert(const char* rootCA) {}
+
+  int connect(IPAddress ip, uint16_t port) override { return refuse(); }
+  int connect(const char* host, uint16_t port) override { return refuse(); }
+
+private:
+  int refuse() {
+    simLog("sim: WiFiClientSecure: TLS is not available in the simulator\n");
+    return 0;
+  }
+};
+
+#endif // SIM_WIFICLIENTSECURE_H
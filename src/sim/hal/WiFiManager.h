@@ -0,0 +1,30 @@
+// WiFiManager for the simulator: the host network is already configured,
+// so there are no credentials to manage and no captive portal
+#ifndef SIM_WIFIMANAGER_H
+#define SIM_WIFIMANAGER_H
+
+#include <Arduino.h>
+#include <functional>
+
+class WiFiManager {
+public:
+  bool autoConnect(const char* apName = nullptr, const char* apPassword = nullptr) { return true; }
+  void process() {}
+  void resetSettings() {}
+  void startWebPortal() { _portalActive = true; }
+  void stopWebPortal() { _portalActive = false; }
+  bool getWebPortalActive() { return _portalActive; }
+
+  void setDebugOutput(bool debug) {}
+  void setConfigPortalBlocking(bool shouldBlock) {}
+  void setConfigPortalTimeout(unsigned long seconds) {}
+  void setConnectTimeout(unsigned long seconds) {}
+  void setConnectRetries(uint8_t numRetries) {}
+  void setWiFiAutoReconnect(bool enable) {}
+  void setSaveConfigCallback(std::function<void()> func) {}
+
+private:
+  bool _portalActive = false;
+};
+
+#endif // SIM_WIFIMANAGER_H
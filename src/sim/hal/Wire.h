@@ -0,0 +1,15 @@
+// I2C for the simulator: an empty bus
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+  void end() {}
+};
+
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
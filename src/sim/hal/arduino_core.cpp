@@ -0,0 +1,154 @@
+#ifdef SIGNALK_SIM
+
+#include <Arduino.h>
+#include <esp_random.h>
+#include <ESPmDNS.h>
+#include <Wire.h>
+#include "../sim.h"
+#include <malloc.h>
+#include <sys/random.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// ====== TIME ======
+// millis() counts from process start, like from boot on the ESP32
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+uint32_t millis() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - bootTime).count();
+}
+
+uint32_t micros() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char* server1,
+                const char* server2, const char* server3) {
+  simLog("sim: configTime(%s) - using the host clock\n", server1 ? server1 : "");
+}
+
+// ====== GPIO ======
+
+static std::atomic<uint64_t> pinLevels(0);
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= 64) return;
+  if (val) pinLevels |= 1ULL << pin;
+  else pinLevels &= ~(1ULL << pin);
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < 64 && (pinLevels & (1ULL << pin)) ? HIGH : LOW;
+}
+
+// ====== RANDOM ======
+
+extern "C" uint32_t esp_random(void) {
+  uint32_t value;
+  if (getrandom(&value, sizeof(value), 0) != sizeof(value)) value = (uint32_t)rand();
+  return value;
+}
+
+extern "C" void esp_fill_random(void* buf, size_t len) {
+  uint8_t* p = static_cast<uint8_t*>(buf);
+  while (len > 0) {
+    ssize_t n = getrandom(p, len, 0);
+    if (n <= 0) break;
+    p += n;
+    len -= (size_t)n;
+  }
+}
+
+// Like the ESP32 core: the hardware RNG unless a seed was given
+static bool seeded = false;
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    srand((unsigned)seed);
+    seeded = true;
+  }
+}
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  uint32_t value = seeded ? (uint32_t)rand() : esp_random();
+  return (long)(value % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+// ====== PERIPHERALS ======
+
+MDNSResponder MDNS;
+TwoWire Wire;
+
+// ====== ESP ======
+// Heap figures are host allocations against a nominal 4 MB (PSRAM board)
+// heap: they track what the firmware allocates, not ESP32 fragmentation.
+
+static const uint32_t kSimHeapSize = 4 * 1024 * 1024;
+static std::atomic<uint32_t> minFreeHeap(kSimHeapSize);
+
+EspClass ESP;
+
+void EspClass::restart() {
+  simLog("sim: ESP.restart() - re-executing\n");
+  fflush(stdout);
+  fflush(stderr);
+  if (simOptions.argv != nullptr) {
+    execv("/proc/self/exe", simOptions.argv);
+    simLog("sim: re-exec failed, exiting\n");
+  }
+  _exit(0);
+}
+
+uint32_t EspClass::getHeapSize() {
+  return kSimHeapSize;
+}
+
+uint32_t EspClass::getFreeHeap() {
+  struct mallinfo2 info = mallinfo2();
+  uint32_t used = info.uordblks + info.hblkhd > kSimHeapSize
+                    ? kSimHeapSize : (uint32_t)(info.uordblks + info.hblkhd);
+  uint32_t free = kSimHeapSize - used;
+  uint32_t low = minFreeHeap.load();
+  while (free < low && !minFreeHeap.compare_exchange_weak(low, free)) {}
+  return free;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  getFreeHeap();
+  return minFreeHeap.load();
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+  return getFreeHeap();
+}
+
+uint64_t EspClass::getEfuseMac() {
+  return 0x0000AABBCCDDEEFFULL;
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,13 @@
+// ESP-IDF UART driver header for the simulator. The firmware only includes
+// it; inverted RX is a HardwareSerial::begin() argument, which sim ports
+// accept and ignore.
+#ifndef SIM_DRIVER_UART_H
+#define SIM_DRIVER_UART_H
+
+typedef int uart_port_t;
+
+#define UART_NUM_0 0
+#define UART_NUM_1 1
+#define UART_NUM_2 2
+
+#endif // SIM_DRIVER_UART_H
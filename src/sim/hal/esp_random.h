@@ -0,0 +1,19 @@
+// ESP32 hardware RNG for the simulator, backed by the host's getrandom()
+#ifndef SIM_ESP_RANDOM_H
+#define SIM_ESP_RANDOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_random(void);
+void esp_fill_random(void* buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_ESP_RANDOM_H
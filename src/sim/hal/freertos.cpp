@@ -0,0 +1,148 @@
+#ifdef SIGNALK_SIM
+
+#include "freertos/FreeRTOS.h"
+#include <Arduino.h>
+#include "../sim.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct SimTask {
+  std::string name;
+  uint32_t stackDepth = 0;
+  std::mutex lock;  // Guards notifications
+  std::condition_variable notified;
+  uint32_t notifications = 0;
+};
+
+struct SimSemaphore {
+  std::recursive_timed_mutex mutex;
+};
+
+static thread_local SimTask* currentTask = nullptr;
+
+// ====== TASKS ======
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority,
+                                   TaskHandle_t* createdTask, BaseType_t coreId) {
+  SimTask* task = new SimTask();
+  task->name = name ? name : "";
+  task->stackDepth = stackDepth;
+  // The handle is published before the task runs, as FreeRTOS does
+  if (createdTask != nullptr) *createdTask = task;
+
+  std::thread([task, code, parameters] {
+    currentTask = task;
+    pthread_setname_np(pthread_self(), task->name.substr(0, 15).c_str());
+    code(parameters);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* createdTask) {
+  return xTaskCreatePinnedToCore(code, name, stackDepth, parameters, priority, createdTask,
+                                 tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (task != nullptr && task != currentTask) {
+    simLog("sim: vTaskDelete() of another task is not supported\n");
+    return;
+  }
+  // Leak the handle: other tasks may still hold it
+  pthread_exit(nullptr);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  // Threads not started by xTaskCreate (main = loopTask) get a handle on first use
+  if (currentTask == nullptr) {
+    currentTask = new SimTask();
+    currentTask->name = "loopTask";
+    currentTask->stackDepth = 8192;
+  }
+  return currentTask;
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+  if (task == nullptr) task = xTaskGetCurrentTaskHandle();
+  return task->name.c_str();
+}
+
+void vTaskDelay(TickType_t ticks) {
+  delay(ticks);
+}
+
+TickType_t xTaskGetTickCount() {
+  return millis();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  if (task == nullptr) task = xTaskGetCurrentTaskHandle();
+  return task->stackDepth;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+  SimTask* task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(task->lock);
+  auto pending = [task] { return task->notifications > 0; };
+  if (ticksToWait == portMAX_DELAY) {
+    task->notified.wait(lock, pending);
+  } else if (!task->notified.wait_for(lock, std::chrono::milliseconds(ticksToWait), pending)) {
+    return 0;
+  }
+  uint32_t count = task->notifications;
+  task->notifications = clearCountOnExit ? 0 : count - 1;
+  return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  {
+    std::lock_guard<std::mutex> lock(task->lock);
+    task->notifications++;
+  }
+  task->notified.notify_one();
+  return pdPASS;
+}
+
+// ====== SEMAPHORES ======
+// Mutex and recursive mutex are both recursive here; the firmware never
+// relies on a plain mutex deadlocking on re-entry.
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return new SimSemaphore();
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  return new SimSemaphore();
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+  delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+  if (ticksToWait == portMAX_DELAY) {
+    semaphore->mutex.lock();
+    return pdTRUE;
+  }
+  return semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticksToWait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  semaphore->mutex.unlock();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+  return xSemaphoreTake(semaphore, ticksToWait);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+  return xSemaphoreGive(semaphore);
+}
+
+#endif // SIGNALK_SIM
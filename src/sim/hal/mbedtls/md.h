@@ -0,0 +1,61 @@
+// mbed TLS message digest API for the simulator: SHA-256 and SHA-1 only,
+// computed by sim_sha.cpp
+#ifndef SIM_MBEDTLS_MD_H
+#define SIM_MBEDTLS_MD_H
+
+#include <stddef.h>
+#include "../sim_sha.h"
+
+typedef enum {
+  MBEDTLS_MD_NONE = 0,
+  MBEDTLS_MD_SHA1 = 4,
+  MBEDTLS_MD_SHA256 = 6,
+} mbedtls_md_type_t;
+
+typedef struct {
+  mbedtls_md_type_t type;
+} mbedtls_md_info_t;
+
+typedef struct {
+  const mbedtls_md_info_t* info;
+  SimSha1 sha1;
+  SimSha256 sha256;
+} mbedtls_md_context_t;
+
+inline const mbedtls_md_info_t* mbedtls_md_info_from_type(mbedtls_md_type_t type) {
+  static const mbedtls_md_info_t sha1 = {MBEDTLS_MD_SHA1};
+  static const mbedtls_md_info_t sha256 = {MBEDTLS_MD_SHA256};
+  return type == MBEDTLS_MD_SHA1 ? &sha1 : type == MBEDTLS_MD_SHA256 ? &sha256 : nullptr;
+}
+
+inline void mbedtls_md_init(mbedtls_md_context_t* ctx) { ctx->info = nullptr; }
+inline void mbedtls_md_free(mbedtls_md_context_t* ctx) { ctx->info = nullptr; }
+
+inline int mbedtls_md_setup(mbedtls_md_context_t* ctx, const mbedtls_md_info_t* info, int hmac) {
+  if (info == nullptr || hmac) return -1;
+  ctx->info = info;
+  return 0;
+}
+
+inline int mbedtls_md_starts(mbedtls_md_context_t* ctx) {
+  if (ctx->info == nullptr) return -1;
+  ctx->sha1 = SimSha1();
+  ctx->sha256 = SimSha256();
+  return 0;
+}
+
+inline int mbedtls_md_update(mbedtls_md_context_t* ctx, const unsigned char* input, size_t len) {
+  if (ctx->info == nullptr) return -1;
+  if (ctx->info->type == MBEDTLS_MD_SHA1) ctx->sha1.update(input, len);
+  else ctx->sha256.update(input, len);
+  return 0;
+}
+
+inline int mbedtls_md_finish(mbedtls_md_context_t* ctx, unsigned char* output) {
+  if (ctx->info == nullptr) return -1;
+  if (ctx->info->type == MBEDTLS_MD_SHA1) ctx->sha1.finish(output);
+  else ctx->sha256.finish(output);
+  return 0;
+}
+
+#endif // SIM_MBEDTLS_MD_H
@@ -0,0 +1,244 @@
+#ifdef SIGNALK_SIM
+
+#include "SPIFFS.h"
+#include "../sim.h"
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+
+SPIFFSFS SPIFFS;
+
+// SPIFFS_OBJ_NAME_LEN in the ESP-IDF configuration, including the NUL
+static const size_t kMaxPathLength = 31;
+
+namespace fs {
+
+struct SimFileImpl {
+  FILE* file = nullptr;
+  DIR* dir = nullptr;
+  std::string path;      // Device path
+  std::string hostDir;   // For directories: where entries are read from
+
+  ~SimFileImpl() {
+    if (file != nullptr) fclose(file);
+    if (dir != nullptr) closedir(dir);
+  }
+};
+
+// ====== FLAT NAMES ======
+
+static std::string encodeName(const char* path) {
+  std::string out;
+  for (const char* p = path + 1; *p; p++) {
+    if (*p == '/') out += "%2F";
+    else if (*p == '%') out += "%25";
+    else out += *p;
+  }
+  return out;
+}
+
+static std::string decodeName(const char* name) {
+  std::string out = "/";
+  for (const char* p = name; *p; p++) {
+    if (p[0] == '%' && p[1] == '2' && (p[2] == 'F' || p[2] == '5')) {
+      out += p[2] == 'F' ? '/' : '%';
+      p += 2;
+    } else {
+      out += *p;
+    }
+  }
+  return out;
+}
+
+bool FS::hostPath(const char* path, std::string& out) const {
+  if (path == nullptr || path[0] != '/' || strlen(path) > kMaxPathLength) {
+    return false;
+  }
+  out = std::string(root()) + "/" + encodeName(path);
+  return true;
+}
+
+// ====== FILE ======
+
+size_t File::write(const uint8_t* buf, size_t size) {
+  if (!_impl || _impl->file == nullptr) return 0;
+  return fwrite(buf, 1, size, _impl->file);
+}
+
+int File::available() {
+  if (!_impl || _impl->file == nullptr) return 0;
+  long remaining = (long)size() - (long)position();
+  return remaining > 0 ? (int)remaining : 0;
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+  if (!_impl || _impl->file == nullptr) return 0;
+  return fread(buf, 1, size, _impl->file);
+}
+
+int File::peek() {
+  if (!_impl || _impl->file == nullptr) return -1;
+  int c = fgetc(_impl->file);
+  if (c != EOF) ungetc(c, _impl->file);
+  return c == EOF ? -1 : c;
+}
+
+void File::flush() {
+  if (_impl && _impl->file != nullptr) fflush(_impl->file);
+}
+
+bool File::seek(uint32_t pos) {
+  return _impl && _impl->file != nullptr && fseek(_impl->file, pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+  if (!_impl || _impl->file == nullptr) return 0;
+  long pos = ftell(_impl->file);
+  return pos > 0 ? (size_t)pos : 0;
+}
+
+size_t File::size() const {
+  if (!_impl || _impl->file == nullptr) return 0;
+  fflush(_impl->file);
+  struct stat st;
+  return fstat(fileno(_impl->file), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() {
+  _impl.reset();
+}
+
+const char* File::path() const {
+  return _impl ? _impl->path.c_str() : nullptr;
+}
+
+const char* File::name() const {
+  if (!_impl) return nullptr;
+  const char* slash = strrchr(_impl->path.c_str(), '/');
+  return slash != nullptr ? slash + 1 : _impl->path.c_str();
+}
+
+bool File::isDirectory() const {
+  return _impl && _impl->dir != nullptr;
+}
+
+File File::openNextFile(const char* mode) {
+  if (!_impl || _impl->dir == nullptr) return File();
+
+  struct dirent* entry;
+  while ((entry = readdir(_impl->dir)) != nullptr) {
+    if (entry->d_name[0] == '.') continue;
+    std::string host = _impl->hostDir + "/" + entry->d_name;
+    FILE* f = fopen(host.c_str(), mode[0] == 'r' ? "rb" : mode[0] == 'a' ? "ab" : "wb");
+    if (f == nullptr) continue;
+    auto impl = std::make_shared<SimFileImpl>();
+    impl->file = f;
+    impl->path = decodeName(entry->d_name);
+    return File(impl);
+  }
+  return File();
+}
+
+// ====== FS ======
+
+File FS::open(const char* path, const char* mode, const bool create) {
+  // The root directory, for listing
+  if (path != nullptr && strcmp(path, "/") == 0) {
+    DIR* dir = opendir(root());
+    if (dir == nullptr) return File();
+    auto impl = std::make_shared<SimFileImpl>();
+    impl->dir = dir;
+    impl->path = "/";
+    impl->hostDir = root();
+    return File(impl);
+  }
+
+  std::string host;
+  if (!hostPath(path, host)) return File();
+
+  const char* hostMode = "rb";
+  if (mode[0] == 'w') hostMode = mode[1] == '+' ? "w+b" : "wb";
+  else if (mode[0] == 'a') hostMode = mode[1] == '+' ? "a+b" : "ab";
+  else if (mode[1] == '+') hostMode = "r+b";
+
+  FILE* f = fopen(host.c_str(), hostMode);
+  if (f == nullptr) return File();
+  auto impl = std::make_shared<SimFileImpl>();
+  impl->file = f;
+  impl->path = path;
+  return File(impl);
+}
+
+bool FS::exists(const char* path) {
+  std::string host;
+  struct stat st;
+  return hostPath(path, host) && stat(host.c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+  std::string host;
+  return hostPath(path, host) && unlink(host.c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  std::string hostFrom, hostTo;
+  return hostPath(from, hostFrom) && hostPath(to, hostTo) &&
+         ::rename(hostFrom.c_str(), hostTo.c_str()) == 0;
+}
+
+} // namespace fs
+
+// ====== SPIFFS ======
+
+const char* SPIFFSFS::root() const {
+  return simOptions.spiffsDir;
+}
+
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles,
+                     const char* partitionLabel) {
+  if (mkdir(root(), 0755) != 0 && errno != EEXIST) {
+    simLog("sim: cannot create SPIFFS directory %s: %s\n", root(), strerror(errno));
+    return false;
+  }
+  _mounted = true;
+  return true;
+}
+
+bool SPIFFSFS::format() {
+  DIR* dir = opendir(root());
+  if (dir == nullptr) return false;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    if (entry->d_name[0] == '.') continue;
+    unlink((std::string(root()) + "/" + entry->d_name).c_str());
+  }
+  closedir(dir);
+  return true;
+}
+
+size_t SPIFFSFS::usedBytes() {
+  size_t used = 0;
+  DIR* dir = opendir(root());
+  if (dir == nullptr) return 0;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    struct stat st;
+    if (entry->d_name[0] != '.' &&
+        stat((std::string(root()) + "/" + entry->d_name).c_str(), &st) == 0) {
+      used += st.st_size;
+    }
+  }
+  closedir(dir);
+  return used;
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,117 @@
+#ifdef SIGNALK_SIM
+
+#include "sim_port.h"
+#include "../sim.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+#include <algorithm>
+
+bool SimPort::open(const char* name) {
+  std::lock_guard<std::mutex> lock(_lock);
+
+  if (_master < 0) {
+    _master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (_master < 0 || grantpt(_master) != 0 || unlockpt(_master) != 0) {
+      simLog("sim: cannot create a pseudo-terminal for %s: %s\n", name, strerror(errno));
+      if (_master >= 0) ::close(_master);
+      _master = -1;
+      return false;
+    }
+    fcntl(_master, F_SETFL, fcntl(_master, F_GETFL) | O_NONBLOCK);
+
+    _slave = ::open(ptsname(_master), O_RDWR | O_NOCTTY);
+    if (_slave >= 0) {
+      termios tio;
+      tcgetattr(_slave, &tio);
+      cfmakeraw(&tio);
+      tcsetattr(_slave, TCSANOW, &tio);
+    }
+  } else if (!_link.empty()) {
+    unlink(_link.c_str());
+  }
+
+  mkdir(simOptions.portDir, 0755);
+  _link = std::string(simOptions.portDir) + "/" + name;
+  unlink(_link.c_str());
+  if (symlink(ptsname(_master), _link.c_str()) != 0) {
+    simLog("sim: cannot link %s: %s\n", _link.c_str(), strerror(errno));
+    _link = ptsname(_master);
+  }
+  simLog("sim: %-8s -> %s (%s)\n", name, _link.c_str(), ptsname(_master));
+  return true;
+}
+
+void SimPort::close() {
+  std::lock_guard<std::mutex> lock(_lock);
+  if (_master < 0) return;
+  if (!_link.empty() && _link.compare(0, 9, "/dev/pts/") != 0) unlink(_link.c_str());
+  ::close(_master);
+  if (_slave >= 0) ::close(_slave);
+  _master = -1;
+  _slave = -1;
+  _link.clear();
+  _head = 0;
+  _count = 0;
+}
+
+bool SimPort::fill() {
+  if (_master < 0) return false;
+  if (_count == sizeof(_buffer)) return true;
+
+  // Compact first so a single read() can fill the free tail
+  if (_head > 0) {
+    memmove(_buffer, _buffer + _head, _count);
+    _head = 0;
+  }
+  ssize_t n = ::read(_master, _buffer + _count, sizeof(_buffer) - _count);
+  if (n > 0) _count += (size_t)n;
+  return _count > 0;
+}
+
+int SimPort::available() {
+  std::lock_guard<std::mutex> lock(_lock);
+  fill();
+  return (int)_count;
+}
+
+int SimPort::read() {
+  std::lock_guard<std::mutex> lock(_lock);
+  if (_count == 0 && !fill()) return -1;
+  uint8_t byte = _buffer[_head++];
+  _count--;
+  return byte;
+}
+
+int SimPort::peek() {
+  std::lock_guard<std::mutex> lock(_lock);
+  if (_count == 0 && !fill()) return -1;
+  return _buffer[_head];
+}
+
+size_t SimPort::read(uint8_t* buffer, size_t length) {
+  std::lock_guard<std::mutex> lock(_lock);
+  size_t total = 0;
+  while (total < length && (_count > 0 || fill())) {
+    size_t n = std::min(length - total, _count);
+    memcpy(buffer + total, _buffer + _head, n);
+    _head += n;
+    _count -= n;
+    total += n;
+  }
+  return total;
+}
+
+size_t SimPort::write(const uint8_t* buffer, size_t size) {
+  std::lock_guard<std::mutex> lock(_lock);
+  if (_master < 0) return 0;
+  // Nobody reading the slave: drop what does not fit, like a UART with no listener
+  ssize_t n = ::write(_master, buffer, size);
+  return n > 0 ? (size_t)n : 0;
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,54 @@
+// Pseudo-terminal standing in for a serial port in the simulator
+#ifndef SIM_PORT_H
+#define SIM_PORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+#include <string>
+
+/**
+ * One PTY per opened serial port
+ *
+ * The firmware reads and writes the master side without blocking; tools
+ * attach to the slave, which is linked as <portDir>/<name> (e.g.
+ * sim-ports/uart1) so the path is stable across runs:
+ *
+ *   socat -u FILE:track.nmea,ignoreeof sim-ports/uart1,raw
+ *
+ * Baud rate, parity and inversion are accepted and ignored; bytes arrive
+ * as fast as the writer sends them.
+ */
+class SimPort {
+public:
+  ~SimPort() { close(); }
+
+  /**
+   * Create the PTY and its link; a port that is already open is reused
+   * under the new name
+   */
+  bool open(const char* name);
+  void close();
+  bool isOpen() const { return _master >= 0; }
+  const char* path() const { return _link.c_str(); }
+
+  int available();
+  int read();
+  int peek();
+  size_t read(uint8_t* buffer, size_t length);
+  size_t write(const uint8_t* buffer, size_t size);
+
+private:
+  bool fill();  // Top up _buffer from the master; false when nothing is readable
+
+  int _master = -1;
+  int _slave = -1;  // Held open so the master never sees a hangup between readers
+  std::string _link;
+
+  std::mutex _lock;
+  uint8_t _buffer[256];
+  size_t _head = 0;
+  size_t _count = 0;
+};
+
+#endif // SIM_PORT_H
@@ -0,0 +1,157 @@
+#ifdef SIGNALK_SIM
+
+#include "sim_sha.h"
+#include <string.h>
+
+static inline uint32_t rol(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+static inline uint32_t ror(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+static inline uint32_t loadBE(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void storeBE(uint8_t* p, uint32_t v) {
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+// Shared Merkle-Damgard padding: 0x80, zeros, 64-bit big-endian bit length
+template <typename Hash>
+static void pad(Hash& hash, uint64_t length) {
+  uint8_t tail[72] = {0x80};
+  size_t used = (size_t)(length % 64);
+  size_t padLen = (used < 56 ? 56 : 120) - used;
+  uint64_t bits = length * 8;
+  for (int i = 0; i < 8; i++) tail[padLen + i] = (uint8_t)(bits >> (56 - 8 * i));
+  hash.update(tail, padLen + 8);
+}
+
+// ====== SHA-1 ======
+
+SimSha1::SimSha1() : _h{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0} {}
+
+void SimSha1::block(const uint8_t* p) {
+  uint32_t w[80];
+  for (int i = 0; i < 16; i++) w[i] = loadBE(p + 4 * i);
+  for (int i = 16; i < 80; i++) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+  uint32_t a = _h[0], b = _h[1], c = _h[2], d = _h[3], e = _h[4];
+  for (int i = 0; i < 80; i++) {
+    uint32_t f, k;
+    if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+    else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+    else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+    else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+    uint32_t t = rol(a, 5) + f + e + k + w[i];
+    e = d;
+    d = c;
+    c = rol(b, 30);
+    b = a;
+    a = t;
+  }
+  _h[0] += a; _h[1] += b; _h[2] += c; _h[3] += d; _h[4] += e;
+}
+
+void SimSha1::update(const uint8_t* data, size_t len) {
+  _length += len;
+  while (len > 0) {
+    size_t n = 64 - _buffered < len ? 64 - _buffered : len;
+    memcpy(_buffer + _buffered, data, n);
+    _buffered += n;
+    data += n;
+    len -= n;
+    if (_buffered == 64) {
+      block(_buffer);
+      _buffered = 0;
+    }
+  }
+}
+
+void SimSha1::finish(uint8_t digest[20]) {
+  pad(*this, _length);
+  for (int i = 0; i < 5; i++) storeBE(digest + 4 * i, _h[i]);
+}
+
+// ====== SHA-256 ======
+
+static const uint32_t K256[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+SimSha256::SimSha256()
+  : _h{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19} {}
+
+void SimSha256::block(const uint8_t* p) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++) w[i] = loadBE(p + 4 * i);
+  for (int i = 16; i < 64; i++) {
+    uint32_t s0 = ror(w[i - 15], 7) ^ ror(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = ror(w[i - 2], 17) ^ ror(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = _h[0], b = _h[1], c = _h[2], d = _h[3], e = _h[4], f = _h[5], g = _h[6], h = _h[7];
+  for (int i = 0; i < 64; i++) {
+    uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + K256[i] + w[i];
+    uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  _h[0] += a; _h[1] += b; _h[2] += c; _h[3] += d;
+  _h[4] += e; _h[5] += f; _h[6] += g; _h[7] += h;
+}
+
+void SimSha256::update(const uint8_t* data, size_t len) {
+  _length += len;
+  while (len > 0) {
+    size_t n = 64 - _buffered < len ? 64 - _buffered : len;
+    memcpy(_buffer + _buffered, data, n);
+    _buffered += n;
+    data += n;
+    len -= n;
+    if (_buffered == 64) {
+      block(_buffer);
+      _buffered = 0;
+    }
+  }
+}
+
+void SimSha256::finish(uint8_t digest[32]) {
+  pad(*this, _length);
+  for (int i = 0; i < 8; i++) storeBE(digest + 4 * i, _h[i]);
+}
+
+// ====== BASE64 ======
+
+std::string simBase64(const uint8_t* data, size_t len) {
+  static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  out.reserve((len + 2) / 3 * 4);
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = (uint32_t)data[i] << 16;
+    if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < len) v |= data[i + 2];
+    out += alphabet[(v >> 18) & 63];
+    out += alphabet[(v >> 12) & 63];
+    out += i + 1 < len ? alphabet[(v >> 6) & 63] : '=';
+    out += i + 2 < len ? alphabet[v & 63] : '=';
+  }
+  return out;
+}
+
+#endif // SIGNALK_SIM
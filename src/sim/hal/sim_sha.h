@@ -0,0 +1,42 @@
+// SHA-1 (WebSocket handshake), SHA-256 (mbedtls/md.h) and Base64 for the
+// simulator
+#ifndef SIM_SHA_H
+#define SIM_SHA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class SimSha1 {
+public:
+  SimSha1();
+  void update(const uint8_t* data, size_t len);
+  void finish(uint8_t digest[20]);
+
+private:
+  void block(const uint8_t* p);
+
+  uint32_t _h[5];
+  uint8_t _buffer[64];
+  size_t _buffered = 0;
+  uint64_t _length = 0;
+};
+
+class SimSha256 {
+public:
+  SimSha256();
+  void update(const uint8_t* data, size_t len);
+  void finish(uint8_t digest[32]);
+
+private:
+  void block(const uint8_t* p);
+
+  uint32_t _h[8];
+  uint8_t _buffer[64];
+  size_t _buffered = 0;
+  uint64_t _length = 0;
+};
+
+std::string simBase64(const uint8_t* data, size_t len);
+
+#endif // SIM_SHA_H
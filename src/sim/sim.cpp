@@ -0,0 +1,16 @@
+#ifdef SIGNALK_SIM
+
+#include "sim.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+SimOptions simOptions;
+
+void simLog(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+}
+
+#endif // SIGNALK_SIM
@@ -0,0 +1,44 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+/**
+ * Linux simulator ([env:sim])
+ *
+ * Runs the unmodified firmware - setup(), loop() and every module they
+ * call - as a Linux process. The Arduino, ESP32 and library APIs the
+ * firmware uses are provided by the host implementations in src/sim/hal:
+ *
+ *  - Serial is the console; UARTs and SoftwareSerial ports are
+ *    pseudo-terminals, linked as <portDir>/uart1, <portDir>/gpio25, ...
+ *  - AsyncTCP and ESPAsyncWebServer run on real sockets with a single
+ *    async_tcp event task, so the HTTP/WebSocket (3000) and NMEA 0183 TCP
+ *    (10110) servers accept ordinary clients
+ *  - NMEA 2000 frames come from a SocketCAN interface or a candump log
+ *  - FreeRTOS tasks are threads; Preferences can persist to a file and
+ *    SPIFFS is a directory
+ *
+ * The [env:native] unit tests run on the same HAL, without sim_main.cpp.
+ */
+
+struct SimOptions {
+  const char* bindAddress = "127.0.0.1";  // Listen address for all servers
+  const char* portDir = "sim-ports";      // Where the serial port links are created
+  const char* canInterface = nullptr;     // SocketCAN interface, e.g. vcan0
+  const char* canLog = nullptr;           // candump log to replay instead
+  const char* nvsFile = nullptr;          // Preferences file; nullptr = in memory
+  const char* spiffsDir = "sim-spiffs";   // Directory holding the SPIFFS files
+  bool quiet = false;                     // Discard the Serial console output
+  int argc = 0;                           // Command line, for ESP.restart()
+  char** argv = nullptr;
+};
+
+extern SimOptions simOptions;
+
+/**
+ * Print a simulator message to stderr (not the firmware's Serial console)
+ */
+void simLog(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+#endif // SIM_H
@@ -0,0 +1,68 @@
+#ifdef SIGNALK_SIM
+
+#include <Arduino.h>
+#include "sim.h"
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static void usage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --bind ADDR       Listen address for HTTP/WebSocket and NMEA TCP (default 127.0.0.1)\n"
+          "  --port-dir DIR    Where serial port links are created (default sim-ports)\n"
+          "  --can IFACE       Read and write NMEA 2000 on a SocketCAN interface\n"
+          "  --can-log FILE    Replay a candump -l log as the NMEA 2000 bus\n"
+          "  --nvs FILE        Keep Preferences in FILE across runs (default: in memory)\n"
+          "  --spiffs DIR      Directory holding the SPIFFS files (default sim-spiffs)\n"
+          "  --quiet           Discard the Serial console output\n",
+          program);
+}
+
+// Ends the process without running static destructors: the firmware's
+// tasks are still using the globals
+static void onSignal(int signal) {
+  _exit(0);
+}
+
+int main(int argc, char** argv) {
+  simOptions.argc = argc;
+  simOptions.argv = argv;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (strcmp(arg, "--bind") == 0 && hasValue) {
+      simOptions.bindAddress = argv[++i];
+    } else if (strcmp(arg, "--port-dir") == 0 && hasValue) {
+      simOptions.portDir = argv[++i];
+    } else if (strcmp(arg, "--can") == 0 && hasValue) {
+      simOptions.canInterface = argv[++i];
+    } else if (strcmp(arg, "--can-log") == 0 && hasValue) {
+      simOptions.canLog = argv[++i];
+    } else if (strcmp(arg, "--nvs") == 0 && hasValue) {
+      simOptions.nvsFile = argv[++i];
+    } else if (strcmp(arg, "--spiffs") == 0 && hasValue) {
+      simOptions.spiffsDir = argv[++i];
+    } else if (strcmp(arg, "--quiet") == 0) {
+      simOptions.quiet = true;
+    } else {
+      usage(argv[0]);
+      return strcmp(arg, "--help") == 0 ? 0 : 2;
+    }
+  }
+
+  signal(SIGPIPE, SIG_IGN);  // Closed sockets and ports report errors instead
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  // As the ESP32 core's loopTask does
+  setup();
+  for (;;) {
+    loop();
+  }
+}
+
+#endif // SIGNALK_SIM
@@ -2,6 +2,7 @@
 #define TYPES_H
 
 #include <Arduino.h>
+#include <memory>
 #include <vector>
 #include <map>
 #include <set>
@@ -39,29 +40,111 @@ enum TcpClientState {
 };
 
 // ====== PATH STORAGE ======
-struct PathValue {
-  JsonVariant value;
-  String strValue;      // For string storage
-  double numValue;
-  bool isNumeric = false;
-  bool isJson = false;
-  String jsonValue;     // For JSON storage
-  String timestamp;     // ISO8601
-  String source;        // e.g., "nmea0183.GPS"
-
-  // Metadata
+// Compact handle for an interned SignalK path (index into dataStore)
+typedef uint16_t PathId;
+#define INVALID_PATH_ID 0xFFFF
+
+// Compact handle for a top-level path group ("navigation", "environment", ...)
+typedef uint8_t GroupId;
+#define INVALID_GROUP_ID 0xFF
+
+// Compact handle for an interned update source label (e.g. "nmea0183.GPS")
+typedef uint8_t SourceId;
+#define INVALID_SOURCE_ID 0xFF
+
+// What a PathValue currently holds
+enum PathValueKind : uint8_t {
+  PV_NONE = 0,  // Registered but no update received yet
+  PV_NUMBER,    // numValue
+  PV_STRING,    // text holds a plain string
+  PV_JSON,      // text holds a serialized JSON object
+  PV_POSITION,  // fields = latitude, longitude, altitude (NaN = absent)
+  PV_ATTITUDE,  // fields = roll, pitch, yaw
+  PV_CURRENT    // fields = drift, setTrue
+};
+
+// Largest number of members in a composite kind
+#define PATH_VALUE_MAX_FIELDS 3
+
+// Static per-path metadata. Replaced as a whole (never modified in place)
+// when units or a description are added later, so a reader on another
+// task can hold on to the version it loaded.
+struct PathMeta {
   String units;
   String description;
+};
+
+typedef std::shared_ptr<const PathMeta> PathMetaRef;
 
-  bool changed;         // For delta compression
+// Immutable string/JSON payload, shared the same way
+typedef std::shared_ptr<const String> PathText;
+
+// Hot per-path record, rewritten on every update
+struct PathValue {
+  union {
+    double numValue = 0;            // PV_NUMBER
+    double fields[PATH_VALUE_MAX_FIELDS]; // Composite kinds
+  };
+  PathText text;                    // PV_STRING / PV_JSON payload only
+  uint64_t timestamp = 0;           // Epoch milliseconds (0 = clock not set)
+  SourceId source = INVALID_SOURCE_ID;
+  PathValueKind kind = PV_NONE;
+  bool changed = false;             // For delta compression
+
+  // Payload of PV_STRING / PV_JSON ("" for other kinds)
+  const String& textValue() const {
+    static const String kEmpty;
+    return text ? *text : kEmpty;
+  }
 };
 
 // ====== WEBSOCKET SUBSCRIPTIONS ======
+// SignalK subscription policies
+enum SubscriptionPolicy : uint8_t {
+  POLICY_INSTANT,  // Send every change, no faster than minPeriod
+  POLICY_IDEAL,    // Like instant, but resend the last value every period if idle
+  POLICY_FIXED     // Send the latest value every period, changed or not
+};
+
+#define SUBSCRIPTION_DEFAULT_PERIOD 1000  // ms, SignalK default
+#define SUBSCRIPTION_NO_ENTRY 0xFF
+#define SUBSCRIPTION_NO_SLOT 0xFF
+
+// One entry of a subscribe message
+struct SubscriptionEntry {
+  String pattern;                   // Path pattern, may contain wildcards
+  uint32_t period = SUBSCRIPTION_DEFAULT_PERIOD;
+  uint32_t minPeriod = 0;
+  SubscriptionPolicy policy = POLICY_IDEAL;
+};
+
+// Per-client, per-path delivery state
+struct ClientPathState {
+  uint32_t lastSent = 0;            // millis() of the last send
+  uint8_t entry = SUBSCRIPTION_NO_ENTRY; // Index of the governing SubscriptionEntry
+  bool pending = false;             // Changed since lastSent (coalesced)
+  bool sent = false;                // Sent at least once
+};
+
 struct ClientSubscription {
-  std::set<String> paths;
-  uint32_t minPeriod;
+  std::vector<SubscriptionEntry> entries;
+  std::vector<ClientPathState> paths; // Indexed by PathId
+  std::vector<PathId> subscribedIds;  // Paths with an entry, in ID order
+  PathId resolvedCount = 0;         // Paths already matched against entries
+  uint32_t nextCheck = 0;           // millis() when a periodic send is next due
+  uint8_t slot = SUBSCRIPTION_NO_SLOT; // Bit in the shared per-path subscriber mask
+  bool hasPending = false;          // Any path pending since the last scan
   String format; // "delta" or "full"
-  uint32_t lastSend;
+};
+
+// Per-client WebSocket send accounting (backpressure)
+struct ClientSendState {
+  std::vector<PathId> deferred;     // Paths held back while busy, in ID order
+  uint32_t busySince = 0;           // millis() when the queue first stayed full
+  bool busy = false;                // Last send attempt found the queue full
+  uint32_t sent = 0;                // Messages queued
+  uint32_t dropped = 0;             // Messages not queued because the client was busy
+  uint32_t conflated = 0;           // Deferred path values superseded by newer ones
 };
 
 // ====== NMEA STATE ======
@@ -116,6 +199,12 @@ struct DynDnsConfig {
   String lastUpdated;
   bool lastSuccess = false;
   unsigned long lastUpdateMs = 0;
+  String publicIp;           // Public IP seen by the last check
+  bool lastSkipped = false;  // Last check found the IP unchanged and skipped the HTTPS call
+  uint32_t lookupMs = 0;     // Phase timings of the last attempt
+  uint32_t connectMs = 0;
+  uint32_t requestMs = 0;
+  uint32_t totalMs = 0;
 };
 
 // ====== TOKEN STORAGE ======
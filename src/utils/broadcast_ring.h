@@ -0,0 +1,141 @@
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Per-reader position and counters in a BroadcastRing
+ * Positions are absolute byte/sentence counts, so they stay valid across
+ * wrap-around as long as they are compared by difference.
+ */
+struct BroadcastCursor {
+  uint32_t pos = 0;               // Next byte to send
+  uint32_t mark = 0;              // Next sentence to complete
+  uint32_t bytesSent = 0;
+  uint32_t sentencesSent = 0;
+  uint32_t sentencesDropped = 0;  // Overwritten before this reader got to them
+  uint32_t latencyAvgUs = 0;      // Append-to-sent latency, moving average
+  uint32_t latencyMaxUs = 0;
+};
+
+/**
+ * Shared outbound ring for fan-out of line-oriented data (NMEA 0183)
+ *
+ * Each sentence is copied in once; every reader only keeps a cursor. The
+ * writer never waits: a reader that falls more than Bytes (or Sentences)
+ * behind skips forward to the oldest sentence still held and the skipped
+ * sentences are counted as dropped, so a slow reader loses old data instead
+ * of holding up the others. Not thread safe; use from one task.
+ * Bytes and Sentences must be powers of two.
+ */
+template <size_t Bytes, size_t Sentences>
+class BroadcastRing {
+  static_assert((Bytes & (Bytes - 1)) == 0, "BroadcastRing byte size must be a power of two");
+  static_assert((Sentences & (Sentences - 1)) == 0, "BroadcastRing sentence count must be a power of two");
+
+public:
+  BroadcastRing() : _head(0), _markHead(0) {}
+
+  /**
+   * Append one sentence
+   * @return false if it is larger than the ring (nothing is written)
+   */
+  bool append(const char* data, size_t len, uint32_t nowUs) {
+    if (len == 0 || len > Bytes) {
+      return false;
+    }
+    size_t at = _head & (Bytes - 1);
+    size_t first = len < Bytes - at ? len : Bytes - at;
+    memcpy(_buf + at, data, first);
+    memcpy(_buf, data + first, len - first);
+
+    Mark& m = _marks[_markHead & (Sentences - 1)];
+    m.start = _head;
+    m.end = _head + (uint32_t)len;
+    m.queuedAt = nowUs;
+    _head += (uint32_t)len;
+    _markHead++;
+    return true;
+  }
+
+  // Position c at the end: it receives only sentences appended from now on
+  void attach(BroadcastCursor& c) const {
+    c.pos = _head;
+    c.mark = _markHead;
+  }
+
+  // Move c to the end without sending (reader does not want output)
+  void skipAll(BroadcastCursor& c) const {
+    c.pos = _head;
+    c.mark = _markHead;
+  }
+
+  /**
+   * Contiguous unsent bytes for c
+   * Skips (and counts) sentences that were overwritten. Data that wraps
+   * around the end of the ring takes two calls.
+   * @return Number of bytes at *data (0 when c is up to date)
+   */
+  size_t pending(BroadcastCursor& c, const uint8_t** data) {
+    if (_head - c.pos > Bytes || _markHead - c.mark > Sentences) {
+      skipToOldest(c);
+    }
+    uint32_t unsent = _head - c.pos;
+    size_t at = c.pos & (Bytes - 1);
+    *data = _buf + at;
+    return unsent < Bytes - at ? unsent : Bytes - at;
+  }
+
+  // Record that n bytes returned by pending() were sent
+  void consume(BroadcastCursor& c, size_t n, uint32_t nowUs) {
+    c.pos += (uint32_t)n;
+    c.bytesSent += (uint32_t)n;
+
+    while (c.mark != _markHead) {
+      const Mark& m = _marks[c.mark & (Sentences - 1)];
+      if ((int32_t)(c.pos - m.end) < 0) break;
+
+      uint32_t latency = nowUs - m.queuedAt;
+      c.latencyAvgUs = c.sentencesSent == 0 ? latency
+                                            : c.latencyAvgUs - c.latencyAvgUs / 8 + latency / 8;
+      if (latency > c.latencyMaxUs) c.latencyMaxUs = latency;
+      c.sentencesSent++;
+      c.mark++;
+    }
+  }
+
+  // Unsent bytes for c, including any it will drop
+  uint32_t backlog(const BroadcastCursor& c) const { return _head - c.pos; }
+
+  uint32_t bytesWritten() const { return _head; }
+  uint32_t sentencesWritten() const { return _markHead; }
+
+private:
+  struct Mark {
+    uint32_t start;
+    uint32_t end;
+    uint32_t queuedAt;
+  };
+
+  // Jump c to the oldest sentence whose marker and bytes are both still held.
+  // A sentence c was part-way through is dropped too, so the reader sees one
+  // truncated line (which fails its checksum) rather than a stall.
+  void skipToOldest(BroadcastCursor& c) {
+    uint32_t first = _markHead - c.mark > Sentences ? _markHead - Sentences : c.mark;
+    while (first != _markHead && _head - _marks[first & (Sentences - 1)].start > Bytes) {
+      first++;
+    }
+    c.sentencesDropped += first - c.mark;
+    c.mark = first;
+    c.pos = first == _markHead ? _head : _marks[first & (Sentences - 1)].start;
+  }
+
+  uint8_t _buf[Bytes];
+  Mark _marks[Sentences];
+  uint32_t _head;      // Bytes appended
+  uint32_t _markHead;  // Sentences appended
+};
+
+#endif // BROADCAST_RING_H
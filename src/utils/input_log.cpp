@@ -0,0 +1,120 @@
+#include "input_log.h"
+#include <string.h>
+
+static const uint8_t MAGIC[4] = {'S', 'K', 'I', 'L'};
+
+const char* inputPortName(InputPort port) {
+  switch (port) {
+    case INPUT_PORT_RS485: return "rs485";
+    case INPUT_PORT_GPS: return "gps";
+    case INPUT_PORT_SINGLE_ENDED: return "singleEnded";
+    case INPUT_PORT_SEATALK: return "seatalk";
+    case INPUT_PORT_N2K: return "n2k";
+    case INPUT_PORT_TCP_SERVER: return "tcpServer";
+    case INPUT_PORT_TCP_CLIENT: return "tcpClient";
+    default: return "unknown";
+  }
+}
+
+size_t writeInputLogHeader(uint8_t* out, uint32_t startTime) {
+  memcpy(out, MAGIC, sizeof(MAGIC));
+  out[4] = INPUT_LOG_VERSION;
+  out[5] = out[6] = out[7] = 0;
+  out[8] = (uint8_t)startTime;
+  out[9] = (uint8_t)(startTime >> 8);
+  out[10] = (uint8_t)(startTime >> 16);
+  out[11] = (uint8_t)(startTime >> 24);
+  return INPUT_LOG_HEADER_SIZE;
+}
+
+bool readInputLogHeader(const uint8_t* in, size_t len, uint32_t* startTime) {
+  if (len < INPUT_LOG_HEADER_SIZE || memcmp(in, MAGIC, sizeof(MAGIC)) != 0 ||
+      in[4] != INPUT_LOG_VERSION) {
+    return false;
+  }
+  if (startTime != nullptr) {
+    *startTime = (uint32_t)in[8] | ((uint32_t)in[9] << 8) |
+                 ((uint32_t)in[10] << 16) | ((uint32_t)in[11] << 24);
+  }
+  return true;
+}
+
+size_t encodeInputRecord(uint8_t* out, size_t cap, InputPort port, uint8_t channel,
+                         uint32_t deltaMicros, const uint8_t* data, size_t len) {
+  if (len == 0 || len > INPUT_LOG_MAX_PAYLOAD || port >= INPUT_PORT_COUNT ||
+      channel >= INPUT_LOG_CHANNELS) {
+    return 0;
+  }
+
+  uint8_t head[1 + 1 + 5 + 1];
+  size_t n = 0;
+  head[n++] = (uint8_t)port;
+  head[n++] = channel;
+  do {
+    uint8_t b = deltaMicros & 0x7F;
+    deltaMicros >>= 7;
+    head[n++] = deltaMicros ? (b | 0x80) : b;
+  } while (deltaMicros);
+  head[n++] = (uint8_t)len;
+
+  if (n + len > cap) {
+    return 0;
+  }
+  memcpy(out, head, n);
+  memcpy(out + n, data, len);
+  return n + len;
+}
+
+int decodeInputRecord(const uint8_t* in, size_t avail, InputRecord& rec) {
+  if (avail < 1) {
+    return 0;
+  }
+  uint8_t port = in[0];
+  if (port >= INPUT_PORT_COUNT) {
+    return -1;
+  }
+  if (avail < 2) {
+    return 0;
+  }
+  uint8_t channel = in[1];
+  if (channel >= INPUT_LOG_CHANNELS) {
+    return -1;
+  }
+
+  size_t pos = 2;
+  uint32_t delta = 0;
+  for (int shift = 0;; shift += 7) {
+    if (pos >= avail) return 0;
+    if (shift > 28) return -1;  // More than 5 bytes
+    uint8_t b = in[pos++];
+    delta |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) break;
+  }
+
+  if (pos >= avail) return 0;
+  uint8_t len = in[pos++];
+  if (len == 0) return -1;
+  if (pos + len > avail) return 0;
+
+  rec.port = (InputPort)port;
+  rec.channel = channel;
+  rec.deltaMicros = delta;
+  rec.len = len;
+  rec.data = in + pos;
+  return (int)(pos + len);
+}
+
+size_t encodeN2kPayload(uint8_t* out, uint32_t pgn, uint8_t priority, uint8_t source,
+                        uint8_t destination, const uint8_t* data, size_t len) {
+  if (INPUT_LOG_N2K_HEADER + len > INPUT_LOG_MAX_PAYLOAD) {
+    return 0;
+  }
+  out[0] = (uint8_t)pgn;
+  out[1] = (uint8_t)(pgn >> 8);
+  out[2] = (uint8_t)(pgn >> 16);
+  out[3] = priority;
+  out[4] = source;
+  out[5] = destination;
+  memcpy(out + INPUT_LOG_N2K_HEADER, data, len);
+  return INPUT_LOG_N2K_HEADER + len;
+}
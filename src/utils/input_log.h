@@ -0,0 +1,101 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Raw input log format
+ *
+ * A recording is a 12-byte header followed by one record per chunk of
+ * input, in arrival order:
+ *
+ *   header:  "SKIL", version (2), 3 reserved bytes, start time (uint32 LE,
+ *            Unix seconds; 0 if the clock was not set)
+ *   record:  port
+ *            channel 0..INPUT_LOG_CHANNELS-1
+ *            delta   microseconds since the previous record (LEB128 varint)
+ *            length  payload bytes, 1..INPUT_LOG_MAX_PAYLOAD
+ *            payload
+ *
+ * Serial and TCP records carry the bytes exactly as read; the channel
+ * tells apart the connections of the TCP server. Seatalk records hold one
+ * datagram and N2K records one message (see encodeN2kPayload()).
+ *
+ * Has no Arduino dependency so it can be built and tested on a host.
+ */
+
+#define INPUT_LOG_VERSION 2
+#define INPUT_LOG_HEADER_SIZE 12
+#define INPUT_LOG_MAX_PAYLOAD 255
+#define INPUT_LOG_CHANNELS 32  // Per port; at least MAX_NMEA_CLIENTS
+
+// Largest encoded record: port, channel, 5-byte delta, length, payload
+#define INPUT_LOG_MAX_RECORD (1 + 1 + 5 + 1 + INPUT_LOG_MAX_PAYLOAD)
+
+// N2K payload: PGN (3 bytes LE), priority, source, destination, data
+#define INPUT_LOG_N2K_HEADER 6
+
+// Where a record came from
+enum InputPort : uint8_t {
+  INPUT_PORT_RS485 = 0,     // Serial1
+  INPUT_PORT_GPS,           // gpsSerial
+  INPUT_PORT_SINGLE_ENDED,  // SingleEndedSerial
+  INPUT_PORT_SEATALK,       // Seatalk 1 datagrams
+  INPUT_PORT_N2K,           // NMEA 2000 messages
+  INPUT_PORT_TCP_SERVER,    // Clients of the NMEA 0183 TCP server (channel = slot)
+  INPUT_PORT_TCP_CLIENT,    // Connection to the configured TCP server
+  INPUT_PORT_COUNT
+};
+
+// One decoded record; data points into the buffer it was decoded from
+struct InputRecord {
+  InputPort port;
+  uint8_t channel;
+  uint32_t deltaMicros;
+  uint8_t len;
+  const uint8_t* data;
+};
+
+// Short lowercase name for status output ("rs485", "n2k", ...)
+const char* inputPortName(InputPort port);
+
+/**
+ * Write the file header
+ * @param out At least INPUT_LOG_HEADER_SIZE bytes
+ * @return INPUT_LOG_HEADER_SIZE
+ */
+size_t writeInputLogHeader(uint8_t* out, uint32_t startTime);
+
+/**
+ * Check a file header
+ * @param startTime Set to the recorded start time (may be nullptr)
+ * @return false if in is not a header of a supported version
+ */
+bool readInputLogHeader(const uint8_t* in, size_t len, uint32_t* startTime);
+
+/**
+ * Encode one record
+ * @return Bytes written, or 0 if the record does not fit in cap, the
+ *         channel is out of range or the payload is empty or longer than
+ *         INPUT_LOG_MAX_PAYLOAD
+ */
+size_t encodeInputRecord(uint8_t* out, size_t cap, InputPort port, uint8_t channel,
+                         uint32_t deltaMicros, const uint8_t* data, size_t len);
+
+/**
+ * Decode the record at the start of in
+ * @return Bytes consumed; 0 if in holds only part of a record; -1 if the
+ *         data is not a valid record
+ */
+int decodeInputRecord(const uint8_t* in, size_t avail, InputRecord& rec);
+
+/**
+ * Build an N2K record payload
+ * @param out At least INPUT_LOG_N2K_HEADER + len bytes
+ * @return Payload length, or 0 if it would exceed INPUT_LOG_MAX_PAYLOAD
+ */
+size_t encodeN2kPayload(uint8_t* out, uint32_t pgn, uint8_t priority, uint8_t source,
+                        uint8_t destination, const uint8_t* data, size_t len);
+
+#endif // INPUT_LOG_H
@@ -0,0 +1,14 @@
+#include "input_stats.h"
+
+InputCounters inputStats[INPUT_PORT_COUNT];
+
+const char* inputCounterName(InputCounter counter) {
+  switch (counter) {
+    case INPUT_BYTES: return "bytes";
+    case INPUT_SENTENCES: return "sentences";
+    case INPUT_CHECKSUM_ERRORS: return "checksum_errors";
+    case INPUT_OVERFLOWS: return "overflows";
+    case INPUT_PARSE_ERRORS: return "parse_errors";
+    default: return "unknown";
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef INPUT_STATS_H
+#define INPUT_STATS_H
+
+#include <stdint.h>
+#include <atomic>
+#include "input_log.h"
+
+/**
+ * Per-input ingest counters
+ *
+ * One block of counters per InputPort, counted where the input is read
+ * and parsed and exported by services/metrics.h. Each count is a relaxed
+ * atomic add, cheap enough for the per-byte and per-sentence paths; the
+ * counters only ever increase (and wrap at 2^32), so readers on other
+ * tasks need no lock.
+ *
+ * Has no Arduino dependency so it can be built and tested on a host.
+ */
+
+enum InputCounter : uint8_t {
+  INPUT_BYTES = 0,        // Raw bytes received
+  INPUT_SENTENCES,        // Sentences parsed, N2K messages or Seatalk datagrams received
+  INPUT_CHECKSUM_ERRORS,  // Sentences with a wrong checksum (parsed anyway)
+  INPUT_OVERFLOWS,        // Lost to a full buffer or queue, or too long to keep
+  INPUT_PARSE_ERRORS,     // Line noise, malformed sentences, cut-off datagrams
+  INPUT_COUNTER_COUNT
+};
+
+struct InputCounters {
+  std::atomic<uint32_t> value[INPUT_COUNTER_COUNT];
+
+  void add(InputCounter counter, uint32_t n = 1) {
+    value[counter].fetch_add(n, std::memory_order_relaxed);
+  }
+  uint32_t get(InputCounter counter) const {
+    return value[counter].load(std::memory_order_relaxed);
+  }
+};
+
+// Counters since boot, indexed by InputPort
+extern InputCounters inputStats[INPUT_PORT_COUNT];
+
+/**
+ * Count on an input
+ * Ports outside the enum (INPUT_PORT_COUNT, used for replayed input) are
+ * not counted.
+ */
+inline void countInput(InputPort port, InputCounter counter, uint32_t n = 1) {
+  if (port < INPUT_PORT_COUNT) {
+    inputStats[port].add(counter, n);
+  }
+}
+
+// Metric name suffix of a counter ("bytes", "checksum_errors", ...)
+const char* inputCounterName(InputCounter counter);
+
+#endif // INPUT_STATS_H
@@ -0,0 +1,100 @@
+#include "json_writer.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+JsonWriter::JsonWriter(char* buffer, size_t capacity)
+  : _buf(buffer), _cap(capacity), _len(0), _overflow(false) {}
+
+void JsonWriter::raw(char c) {
+  if (_len >= _cap) {
+    _overflow = true;
+    return;
+  }
+  _buf[_len++] = c;
+}
+
+void JsonWriter::raw(const char* s, size_t len) {
+  if (_len + len > _cap) {
+    _overflow = true;
+    return;
+  }
+  memcpy(_buf + _len, s, len);
+  _len += len;
+}
+
+void JsonWriter::raw(const char* s) {
+  raw(s, strlen(s));
+}
+
+static const char kHex[] = "0123456789abcdef";
+
+void JsonWriter::string(const char* s, size_t len) {
+  raw('"');
+  size_t runStart = 0;
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)s[i];
+    if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+    // Flush the plain run before this character, then its escape
+    raw(s + runStart, i - runStart);
+    runStart = i + 1;
+    switch (c) {
+      case '"':  raw("\\\"", 2); break;
+      case '\\': raw("\\\\", 2); break;
+      case '\n': raw("\\n", 2); break;
+      case '\r': raw("\\r", 2); break;
+      case '\t': raw("\\t", 2); break;
+      default: {
+        char esc[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0x0F]};
+        raw(esc, sizeof(esc));
+        break;
+      }
+    }
+  }
+  raw(s + runStart, len - runStart);
+  raw('"');
+}
+
+void JsonWriter::string(const char* s) {
+  string(s, strlen(s));
+}
+
+void JsonWriter::string(const String& s) {
+  string(s.c_str(), s.length());
+}
+
+void JsonWriter::key(const char* k) {
+  string(k);
+  raw(':');
+}
+
+void JsonWriter::number(double value) {
+  if (isnan(value) || isinf(value)) {
+    raw("null", 4);
+    return;
+  }
+  // 10 significant digits keeps ~1 cm resolution on lat/lon in degrees
+  char tmp[kMaxNumberLength + 1];
+  int n = snprintf(tmp, sizeof(tmp), "%.10g", value);
+  if (n < 0) {
+    raw("null", 4);
+    return;
+  }
+  raw(tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+}
+
+size_t JsonWriter::quotedLength(const char* s, size_t len) {
+  size_t out = 2;
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)s[i];
+    if (c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t') {
+      out += 2;
+    } else if (c < 0x20) {
+      out += 6;
+    } else {
+      out += 1;
+    }
+  }
+  return out;
+}
@@ -0,0 +1,53 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+
+/**
+ * Minimal streaming JSON writer over a caller-owned byte buffer
+ *
+ * Used on hot serialization paths (WebSocket deltas) where building an
+ * ArduinoJson document and then a String would cost two extra copies.
+ * The caller is responsible for structure (braces, commas); the writer
+ * handles escaping and number formatting and never writes past capacity.
+ * If the buffer is too small, overflowed() is set and the output must be
+ * discarded.
+ */
+class JsonWriter {
+public:
+  JsonWriter(char* buffer, size_t capacity);
+
+  // Unescaped output (literals and already-serialized JSON)
+  void raw(char c);
+  void raw(const char* s);
+  void raw(const char* s, size_t len);
+
+  // Quoted, escaped JSON string
+  void string(const char* s, size_t len);
+  void string(const char* s);
+  void string(const String& s);
+
+  // "key":
+  void key(const char* k);
+
+  // JSON number; NaN and infinities are written as null
+  void number(double value);
+
+  size_t length() const { return _len; }
+  bool overflowed() const { return _overflow; }
+
+  // Length of s once quoted and escaped by string()
+  static size_t quotedLength(const char* s, size_t len);
+  static size_t quotedLength(const String& s) { return quotedLength(s.c_str(), s.length()); }
+
+  // Upper bound on the characters written by number()
+  static const size_t kMaxNumberLength = 24;
+
+private:
+  char* _buf;
+  size_t _cap;
+  size_t _len;
+  bool _overflow;
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,95 @@
+#include "line_assembler.h"
+
+LineAssembler::LineAssembler(const char* sourceTag, InputPort port)
+  : _tag(sourceTag), _port(port), _tap(nullptr), _tapContext(nullptr), _head(0), _tail(0), _count(0),
+    _lineLen(0), _overflow(false), _bytes(0), _sentences(0), _errors(0), _lastActivity(0) {}
+
+void LineAssembler::reset() {
+  _head = _tail = _count = 0;
+  _lineLen = 0;
+  _overflow = false;
+}
+
+size_t LineAssembler::poll(Stream& in, LineHandler handler, void* context) {
+  size_t total = 0;
+  int avail;
+  while ((avail = in.available()) > 0) {
+    // Fill the contiguous free space up to the end of the ring (the ring
+    // is drained after every read, so all of it is free)
+    size_t n = LINE_ASSEMBLER_RING_SIZE - _head;
+    if ((size_t)avail < n) n = (size_t)avail;
+    n = in.readBytes(reinterpret_cast<char*>(_ring + _head), n);
+    if (n == 0) break;
+    if (_tap != nullptr) _tap(_ring + _head, n, _tapContext);
+
+    _head = (_head + n) % LINE_ASSEMBLER_RING_SIZE;
+    _count += n;
+    _bytes += n;
+    countInput(_port, INPUT_BYTES, n);
+    total += n;
+    _lastActivity = millis();
+
+    if (!drain(handler, context)) break;
+  }
+  return total;
+}
+
+void LineAssembler::feed(const uint8_t* data, size_t len, LineHandler handler, void* context) {
+  while (len > 0) {
+    size_t n = LINE_ASSEMBLER_RING_SIZE - _head;
+    if (len < n) n = len;
+    memcpy(_ring + _head, data, n);
+    if (_tap != nullptr) _tap(data, n, _tapContext);
+    _head = (_head + n) % LINE_ASSEMBLER_RING_SIZE;
+    _count += n;
+    _bytes += n;
+    countInput(_port, INPUT_BYTES, n);
+    _lastActivity = millis();
+    data += n;
+    len -= n;
+
+    if (!drain(handler, context)) return;
+  }
+}
+
+bool LineAssembler::drain(LineHandler handler, void* context) {
+  while (_count > 0) {
+    char c = (char)_ring[_tail];
+    _tail = (_tail + 1) % LINE_ASSEMBLER_RING_SIZE;
+    _count--;
+
+    if (c == '\n' || c == '\r') {
+      if (_overflow) {
+        _overflow = false;
+      } else if (_lineLen > 6 && _line[0] == '$') {
+        _line[_lineLen] = '\0';
+        size_t len = _lineLen;
+        _lineLen = 0;
+        _sentences++;
+        if (!handler(_line, len, *this, context)) {
+          _tail = _head;  // Stop requested; drop what is left
+          _count = 0;
+          return false;
+        }
+      } else if (_lineLen > 0) {
+        _errors++;  // Not a sentence
+        countInput(_port, INPUT_PARSE_ERRORS);
+      }
+      _lineLen = 0;
+    } else if (c >= 32 && c <= 126) {
+      if (_overflow) continue;
+      if (_lineLen < LINE_ASSEMBLER_MAX_LINE) {
+        _line[_lineLen++] = c;
+      } else {
+        _errors++;
+        countInput(_port, INPUT_OVERFLOWS);
+        _overflow = true;
+        _lineLen = 0;
+      }
+    } else {
+      _errors++;  // Line noise, wrong baud rate or inverted signal
+      countInput(_port, INPUT_PARSE_ERRORS);
+    }
+  }
+  return true;
+}
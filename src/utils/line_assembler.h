@@ -0,0 +1,97 @@
+#ifndef LINE_ASSEMBLER_H
+#define LINE_ASSEMBLER_H
+
+#include <Arduino.h>
+#include "nmea_tokenizer.h"
+#include "input_stats.h"
+
+// Raw bytes buffered per input between polls
+#define LINE_ASSEMBLER_RING_SIZE 256
+
+// Longest line kept; longer lines are dropped and counted as errors
+#define LINE_ASSEMBLER_MAX_LINE NMEA_MAX_SENTENCE_LENGTH
+
+class LineAssembler;
+
+/**
+ * Called for each complete sentence
+ * line is NUL-terminated and valid only for the duration of the call.
+ * @return false to stop processing further input in this poll
+ */
+typedef bool (*LineHandler)(const char* line, size_t len, LineAssembler& input, void* context);
+
+/**
+ * Called with each chunk of raw bytes as it arrives, before it is split
+ * into lines (e.g. to record the input)
+ */
+typedef void (*RawByteTap)(const uint8_t* data, size_t len, void* context);
+
+/**
+ * Byte-oriented NMEA 0183 line assembler
+ *
+ * One instance per input (serial port, TCP connection). poll() bulk-reads
+ * whatever the stream has buffered into a fixed ring, then splits it into
+ * CR/LF terminated lines without any heap allocation. Only printable ASCII
+ * is kept; lines that do not look like a sentence ('$' plus at least six
+ * characters) or overflow LINE_ASSEMBLER_MAX_LINE are dropped and counted
+ * as errors.
+ *
+ * An assembler constructed with an InputPort also counts bytes, overlong
+ * lines and noise in that port's inputStats; sentences are counted when
+ * they are parsed.
+ */
+class LineAssembler {
+public:
+  explicit LineAssembler(const char* sourceTag, InputPort port = INPUT_PORT_COUNT);
+
+  /**
+   * Read all available bytes from in and emit the complete sentences
+   * @return Bytes read
+   */
+  size_t poll(Stream& in, LineHandler handler, void* context = nullptr);
+
+  // Feed bytes that were received some other way
+  void feed(const uint8_t* data, size_t len, LineHandler handler, void* context = nullptr);
+
+  // Discard any partial line (e.g. after a reconnect); counters are kept
+  void reset();
+
+  // Observe the raw input; nullptr removes the tap
+  void setTap(RawByteTap tap, void* context = nullptr) {
+    _tapContext = context;
+    _tap = tap;
+  }
+
+  const char* sourceTag() const { return _tag; }
+  InputPort port() const { return _port; }
+
+  // Counters since boot
+  uint32_t bytes() const { return _bytes; }
+  uint32_t sentences() const { return _sentences; }
+  uint32_t errors() const { return _errors; }
+
+  // millis() of the last received byte (0 if none yet)
+  uint32_t lastActivity() const { return _lastActivity; }
+
+private:
+  // Split buffered ring bytes into lines; false if the handler stopped
+  bool drain(LineHandler handler, void* context);
+
+  const char* _tag;
+  InputPort _port;
+  RawByteTap _tap;
+  void* _tapContext;
+  uint8_t _ring[LINE_ASSEMBLER_RING_SIZE];
+  size_t _head;   // Next write position
+  size_t _tail;   // Next unread position
+  size_t _count;  // Unread bytes
+  char _line[LINE_ASSEMBLER_MAX_LINE + 1];
+  size_t _lineLen;
+  bool _overflow; // Current line exceeded the limit and is being skipped
+  uint32_t _bytes;
+  uint32_t _sentences;
+  uint32_t _errors;
+  uint32_t _lastActivity;
+};
+
+#endif // LINE_ASSEMBLER_H
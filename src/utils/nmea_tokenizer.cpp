@@ -0,0 +1,112 @@
+#include "nmea_tokenizer.h"
+#include <math.h>
+#include <string.h>
+
+bool NmeaField::equals(const char* s) const {
+  size_t n = strlen(s);
+  return n == len && memcmp(ptr, s, n) == 0;
+}
+
+bool NmeaField::endsWith(const char* suffix) const {
+  size_t n = strlen(suffix);
+  return n <= len && memcmp(ptr + len - n, suffix, n) == 0;
+}
+
+// Exact powers of ten; 1e18 is the largest a 64-bit mantissa needs
+static const double kPow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+};
+
+// Digits kept in the integer mantissa; more would overflow uint64_t
+static const int kMaxMantissaDigits = 18;
+
+double parseNmeaNumber(const char* s, size_t len) {
+  size_t i = 0;
+  bool negative = false;
+  if (i < len && (s[i] == '-' || s[i] == '+')) {
+    negative = s[i] == '-';
+    i++;
+  }
+
+  uint64_t mantissa = 0;
+  int digits = 0;     // Significant digits in mantissa
+  int scale = 0;      // Power of ten to divide (fraction) or multiply (dropped digits)
+  bool any = false;
+  bool fraction = false;
+
+  for (; i < len; i++) {
+    char c = s[i];
+    if (c >= '0' && c <= '9') {
+      any = true;
+      if (digits < kMaxMantissaDigits) {
+        mantissa = mantissa * 10 + (uint64_t)(c - '0');
+        if (mantissa != 0) digits++;
+        if (fraction) scale--;
+      } else if (!fraction) {
+        scale++;  // Integer digit beyond precision
+      }
+    } else if (c == '.' && !fraction) {
+      fraction = true;
+    } else {
+      return NAN;
+    }
+  }
+  if (!any) {
+    return NAN;
+  }
+
+  double value = (double)mantissa;
+  if (scale < 0) {
+    value /= -scale <= kMaxMantissaDigits ? kPow10[-scale] : pow(10.0, -scale);
+  } else if (scale > 0) {
+    value *= pow(10.0, scale);
+  }
+  return negative ? -value : value;
+}
+
+NmeaTokenizer::NmeaTokenizer() : _count(0) {
+  _buf[0] = '\0';
+  _empty.ptr = _buf + NMEA_MAX_SENTENCE_LENGTH;  // Always '\0'
+  _empty.len = 0;
+  _buf[NMEA_MAX_SENTENCE_LENGTH] = '\0';
+}
+
+bool NmeaTokenizer::tokenize(const char* sentence, size_t len) {
+  _count = 0;
+  while (len > 0 && (sentence[len - 1] == '\r' || sentence[len - 1] == '\n')) {
+    len--;
+  }
+  const char* star = (const char*)memchr(sentence, '*', len);
+  if (star) {
+    len = star - sentence;
+  }
+  if (len > NMEA_MAX_SENTENCE_LENGTH) {
+    return false;
+  }
+
+  memcpy(_buf, sentence, len);
+  _buf[len] = '\0';
+
+  size_t start = 0;
+  for (size_t i = 0; i <= len; i++) {
+    if (i < len && (_buf[i] != ',' || _count == NMEA_MAX_FIELDS - 1)) continue;
+    _buf[i] = '\0';
+    _fields[_count].ptr = _buf + start;
+    _fields[_count].len = (uint8_t)(i - start);
+    _count++;
+    start = i + 1;
+  }
+  return true;
+}
+
+double NmeaTokenizer::number(size_t i) const {
+  const NmeaField& f = (*this)[i];
+  return parseNmeaNumber(f.ptr, f.len);
+}
+
+long NmeaTokenizer::integer(size_t i, long fallback) const {
+  const NmeaField& f = (*this)[i];
+  double v = parseNmeaNumber(f.ptr, f.len);
+  return isnan(v) ? fallback : (long)v;
+}
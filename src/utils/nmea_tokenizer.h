@@ -0,0 +1,72 @@
+#ifndef NMEA_TOKENIZER_H
+#define NMEA_TOKENIZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Zero-allocation NMEA 0183 tokenizer
+ *
+ * The sentence is copied once into a fixed buffer and split in place: every
+ * ',' and the '*' before the checksum become '\0', and each field is a view
+ * (pointer + length) into that buffer. Views stay valid until the next
+ * tokenize() call. Numbers are parsed with parseNmeaNumber(), which does not
+ * depend on the C locale and does not allocate.
+ *
+ * Has no Arduino dependency so it can be built and benchmarked on a host.
+ */
+
+// Longest sentence accepted (the standard allows 82; some devices exceed it)
+#define NMEA_MAX_SENTENCE_LENGTH 128
+
+// Maximum number of fields, including the talker/sentence ID
+#define NMEA_MAX_FIELDS 40
+
+// View of one field; always NUL-terminated inside the tokenizer buffer
+struct NmeaField {
+  const char* ptr;
+  uint8_t len;
+
+  bool empty() const { return len == 0; }
+  bool equals(char c) const { return len == 1 && ptr[0] == c; }
+  bool equals(const char* s) const;
+  bool endsWith(const char* suffix) const;
+};
+
+/**
+ * Parse a plain decimal number ("-12.345", "007", ".5")
+ * No exponents, no whitespace, no locale.
+ * @return The value, or NAN if the field is empty or not a number
+ */
+double parseNmeaNumber(const char* s, size_t len);
+
+class NmeaTokenizer {
+public:
+  NmeaTokenizer();
+
+  /**
+   * Split a sentence into fields
+   * Anything from '*' on (checksum) is excluded. Trailing CR/LF is ignored.
+   * @return false if the sentence is longer than NMEA_MAX_SENTENCE_LENGTH
+   */
+  bool tokenize(const char* sentence, size_t len);
+
+  size_t count() const { return _count; }
+
+  // Field i, or an empty field if the sentence has fewer fields
+  const NmeaField& operator[](size_t i) const { return i < _count ? _fields[i] : _empty; }
+
+  // Field i as a number (NAN if missing, empty or malformed)
+  double number(size_t i) const;
+
+  // Field i as an integer, or fallback if missing, empty or malformed
+  long integer(size_t i, long fallback = 0) const;
+
+private:
+  char _buf[NMEA_MAX_SENTENCE_LENGTH + 1];
+  NmeaField _fields[NMEA_MAX_FIELDS];
+  NmeaField _empty;
+  size_t _count;
+};
+
+#endif // NMEA_TOKENIZER_H
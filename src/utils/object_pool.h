@@ -0,0 +1,74 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Fixed-capacity pool of N objects with O(1) acquire/release
+ *
+ * Storage is allocated once with the pool, so connections coming and going
+ * never touch the heap. In-use objects are kept in a dense list: iterating
+ * with size()/at() visits only those, however large N is. release() moves
+ * the last in-use object into the freed position, so when releasing while
+ * iterating, iterate from size() - 1 down to 0. Not thread safe.
+ */
+template <typename T, size_t N>
+class ObjectPool {
+  static_assert(N > 0 && N <= 0xFFFF, "ObjectPool size must be 1..65535");
+
+public:
+  ObjectPool() : _used(0), _highWater(0) {
+    for (size_t i = 0; i < N; i++) {
+      _order[i] = (uint16_t)i;
+      _position[i] = (uint16_t)i;
+    }
+  }
+
+  // Take a free object (left as the previous user released it); nullptr when exhausted
+  T* acquire() {
+    if (_used == N) {
+      return nullptr;
+    }
+    T* item = &_items[_order[_used++]];
+    if (_used > _highWater) _highWater = _used;
+    return item;
+  }
+
+  // Return an object obtained from acquire()
+  void release(T* item) {
+    size_t index = indexOf(item);
+    if (index >= N || _position[index] >= _used) {
+      return;  // Not from this pool, or already free
+    }
+
+    size_t at = _position[index];
+    size_t last = _used - 1;
+    uint16_t moved = _order[last];
+    _order[at] = moved;
+    _position[moved] = (uint16_t)at;
+    _order[last] = (uint16_t)index;
+    _position[index] = (uint16_t)last;
+    _used--;
+  }
+
+  // i-th in-use object, 0 <= i < size()
+  T& at(size_t i) { return _items[_order[i]]; }
+  const T& at(size_t i) const { return _items[_order[i]]; }
+
+  // Stable slot number of an object (0..N-1), e.g. for log messages
+  size_t indexOf(const T* item) const { return (size_t)(item - _items); }
+
+  size_t size() const { return _used; }
+  size_t highWater() const { return _highWater; }
+  static constexpr size_t capacity() { return N; }
+
+private:
+  T _items[N];
+  uint16_t _order[N];     // First _used entries are in use
+  uint16_t _position[N];  // Item index -> position in _order
+  size_t _used;
+  size_t _highWater;
+};
+
+#endif // OBJECT_POOL_H
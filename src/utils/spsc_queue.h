@@ -0,0 +1,83 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Lock-free single-producer / single-consumer ring
+ *
+ * Exactly one task may call push() and exactly one (other) task may call
+ * pop()/peek(); neither side ever blocks or takes a lock. Items are copied
+ * in and out by value, so T should be a small trivially copyable struct.
+ * One slot is kept free to tell full from empty, so the queue holds N - 1
+ * items. N must be a power of two.
+ */
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+public:
+  SpscQueue() : _head(0), _tail(0), _highWater(0), _dropped(0) {}
+
+  /**
+   * Producer side: append an item
+   * @return false (and counts a drop) when the queue is full
+   */
+  bool push(const T& item) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t next = (head + 1) & (N - 1);
+    size_t tail = _tail.load(std::memory_order_acquire);
+    if (next == tail) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    _items[head] = item;
+    _head.store(next, std::memory_order_release);
+
+    size_t used = (next - tail) & (N - 1);
+    if (used > _highWater.load(std::memory_order_relaxed)) {
+      _highWater.store(used, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  /**
+   * Consumer side: take the oldest item
+   * @return false when the queue is empty
+   */
+  bool pop(T& item) {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = _items[tail];
+    _tail.store((tail + 1) & (N - 1), std::memory_order_release);
+    return true;
+  }
+
+  // Approximate when called from a third task
+  size_t size() const {
+    return (_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire)) & (N - 1);
+  }
+
+  bool empty() const { return size() == 0; }
+
+  static constexpr size_t capacity() { return N - 1; }
+
+  // Most items ever queued at once
+  size_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+  // Items rejected because the queue was full
+  uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+  T _items[N];
+  std::atomic<size_t> _head;  // Next write position (producer owned)
+  std::atomic<size_t> _tail;  // Next read position (consumer owned)
+  std::atomic<size_t> _highWater;
+  std::atomic<uint32_t> _dropped;
+};
+
+#endif // SPSC_QUEUE_H
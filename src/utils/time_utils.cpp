@@ -1,12 +1,63 @@
 #include "time_utils.h"
 #include <time.h>
+#include <sys/time.h>
+#include <string.h>
 
-String iso8601Now() {
-  time_t now = time(nullptr);
-  if (now < 100000) return ""; // Time not set
-  struct tm t;
-  gmtime_r(&now, &t);
-  char buf[32];
-  strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S.000Z", &t);
+uint64_t epochMillisNow() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  if (tv.tv_sec < 100000) return 0; // Time not set
+  return (uint64_t)tv.tv_sec * 1000ULL + (uint64_t)(tv.tv_usec / 1000);
+}
+
+static inline void write2(char* p, uint32_t v) {
+  p[0] = '0' + v / 10;
+  p[1] = '0' + v % 10;
+}
+
+size_t formatIso8601(uint64_t epochMillis, char* buf, size_t len) {
+  if (len == 0) return 0;
+  if (epochMillis == 0 || len < ISO8601_BUF_LEN) {
+    buf[0] = '\0';
+    return 0;
+  }
+
+  // "YYYY-MM-DDTHH:" only changes once an hour; cache it per thread so the
+  // web server task and the main loop never share the buffer.
+  static thread_local uint32_t cachedHour = 0;
+  static thread_local char cachedPrefix[16];
+
+  uint32_t seconds = (uint32_t)(epochMillis / 1000ULL);
+  uint32_t hour = seconds / 3600;
+  if (hour != cachedHour || cachedPrefix[0] == '\0') {
+    time_t t = (time_t)hour * 3600;
+    struct tm tmv;
+    gmtime_r(&t, &tmv);
+    strftime(cachedPrefix, sizeof(cachedPrefix), "%Y-%m-%dT%H:", &tmv);
+    cachedHour = hour;
+  }
+
+  uint32_t inHour = seconds % 3600;
+  uint32_t ms = (uint32_t)(epochMillis % 1000ULL);
+
+  memcpy(buf, cachedPrefix, 14);
+  write2(buf + 14, inHour / 60);
+  buf[16] = ':';
+  write2(buf + 17, inHour % 60);
+  buf[19] = '.';
+  buf[20] = '0' + ms / 100;
+  write2(buf + 21, ms % 100);
+  buf[23] = 'Z';
+  buf[24] = '\0';
+  return 24;
+}
+
+String formatIso8601(uint64_t epochMillis) {
+  char buf[ISO8601_BUF_LEN];
+  formatIso8601(epochMillis, buf, sizeof(buf));
   return String(buf);
 }
+
+String iso8601Now() {
+  return formatIso8601(epochMillisNow());
+}
@@ -3,6 +3,23 @@
 
 #include <Arduino.h>
 
+// Buffer size for a formatted timestamp: "YYYY-MM-DDTHH:MM:SS.mmmZ" + NUL
+#define ISO8601_BUF_LEN 25
+
 String iso8601Now();
 
+// Current UTC time in epoch milliseconds, or 0 if the clock has not been set
+uint64_t epochMillisNow();
+
+/**
+ * Format an epoch-millis timestamp as ISO8601 into buf.
+ * The "YYYY-MM-DDTHH:" prefix is cached per thread and only rebuilt when
+ * the hour changes, so repeated calls cost a few digit writes.
+ * @return Characters written (0 for an unset timestamp or short buffer)
+ */
+size_t formatIso8601(uint64_t epochMillis, char* buf, size_t len);
+
+// Format an epoch-millis timestamp as ISO8601 ("" for 0 / clock not set)
+String formatIso8601(uint64_t epochMillis);
+
 #endif // TIME_UTILS_H
@@ -0,0 +1,35 @@
+// SoftwareSerial for [env:native] tests, in front of the simulator's
+// pseudo-terminal version (src/sim/hal/SoftwareSerial.h): reads come from
+// a byte queue that the test fills with hostInput()
+#ifndef TEST_SOFTWARESERIAL_H
+#define TEST_SOFTWARESERIAL_H
+
+#include <Arduino.h>
+#include <deque>
+
+class SoftwareSerial : public Stream {
+public:
+  SoftwareSerial(int8_t rxPin, int8_t txPin = -1, bool invert = false) {}
+
+  void begin(uint32_t baud) {}
+  bool overflow() { return false; }
+
+  int available() override { return (int)hostInput().size(); }
+  int read() override {
+    if (hostInput().empty()) return -1;
+    uint8_t byte = hostInput().front();
+    hostInput().pop_front();
+    return byte;
+  }
+  int peek() override { return hostInput().empty() ? -1 : hostInput().front(); }
+  size_t write(uint8_t c) override { return 1; }  // Nothing listens
+  using Print::write;
+
+  // Bytes waiting to be read, shared by all instances
+  static std::deque<uint8_t>& hostInput() {
+    static std::deque<uint8_t> input;
+    return input;
+  }
+};
+
+#endif // TEST_SOFTWARESERIAL_H
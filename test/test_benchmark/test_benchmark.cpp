@@ -0,0 +1,225 @@
+// Micro-benchmarks: NMEA 0183 parsing, delta serialization and conversions
+//
+// Run from the repository root (-v shows the timings):
+//   pio test -e native -f test_benchmark -v
+//
+// Each benchmark repeats a fixed workload and reports the mean time per
+// sentence, delta or conversion. Numbers are only comparable between runs
+// on the same machine; compare against a run of the previous commit.
+
+#include <unity.h>
+#include "hardware/nmea0183.h"
+#include "hardware/seatalk1.h"
+#include "signalk/data_store.h"
+#include "signalk/delta_writer.h"
+#include "utils/conversions.h"
+#include "utils/nmea0183_converter.h"
+#include "sim/sim.h"
+#include <chrono>
+#include <vector>
+
+// Typical traffic from a GPS, wind and depth instruments
+static const char* const kSentences[] = {
+  "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A",
+  "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47",
+  "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K",
+  "$GPGLL,4916.45,N,12311.12,W,225444,A",
+  "$HCHDG,101.1,,,7.1,W",
+  "$IIMWV,045.0,R,10.5,N,A",
+  "$IIMWV,120.0,T,15.0,N,A",
+  "$IIVHW,,T,,M,5.5,N,10.2,K",
+  "$SDDPT,12.5,0.5",
+  "$SDDBT,32.8,f,10.0,M,5.5,F",
+  "$IIMTW,18.5,C",
+  "$IIXDR,C,19.5,C,AIRTEMP,P,1.013,B,BARO",
+};
+static const size_t kSentenceCount = sizeof(kSentences) / sizeof(kSentences[0]);
+
+static const uint64_t kTimestamp = 1700000000000ULL;
+static const char* kContext = "vessels.urn:mrn:signalk:uuid:6b0e776f-811a-4b86-9a4d-1c6d1b3e2b11";
+
+static volatile double sink;  // Keeps results observable to the optimizer
+
+static double elapsedNs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, double ns, size_t count, const char* unit) {
+  printf("%-28s %10.1f ns/%s\n", name, ns / count, unit);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ====== PARSING ======
+
+void bench_parse_sentences(void) {
+  size_t lengths[kSentenceCount];
+  for (size_t i = 0; i < kSentenceCount; i++) lengths[i] = strlen(kSentences[i]);
+
+  const size_t rounds = 20000;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < kSentenceCount; i++) {
+      parseNMEASentence(kSentences[i], lengths[i]);
+    }
+  }
+  report("parseNMEASentence", elapsedNs(start), rounds * kSentenceCount, "sentence");
+  clearDirtyPaths();
+
+  TEST_ASSERT_NOT_EQUAL(INVALID_PATH_ID, findPath("navigation.position"));
+}
+
+void bench_checksum(void) {
+  const size_t rounds = 50000;
+  size_t valid = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    valid += validateNmeaChecksum(kSentences[r % 2], strlen(kSentences[r % 2]));
+  }
+  report("validateNmeaChecksum", elapsedNs(start), rounds, "sentence");
+  TEST_ASSERT_EQUAL(rounds, valid);
+}
+
+void bench_seatalk_decode(void) {
+  SeatalkMessage msg = {};
+  msg.command = 0x00;  // Depth: 00 02 YZ XX XX
+  msg.attribute = 0x02;
+  msg.data[1] = 0x64;
+  msg.length = 5;
+  msg.valid = true;
+
+  const size_t rounds = 200000;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    msg.data[1] = (uint8_t)r;
+    decodeSeatalkMessage(msg);
+  }
+  report("decodeSeatalkMessage", elapsedNs(start), rounds, "datagram");
+  clearDirtyPaths();
+}
+
+// ====== DELTAS ======
+
+// The paths a broadcast tick usually carries after parsing kSentences
+static std::vector<PathId> deltaPaths() {
+  std::vector<PathId> ids;
+  for (PathId id = 0; id < getPathCount(); id++) {
+    if (dataStore[id].kind != PV_NONE) ids.push_back(id);
+  }
+  return ids;
+}
+
+void bench_delta_cached(void) {
+  std::vector<PathId> ids = deltaPaths();
+  TEST_ASSERT_GREATER_THAN(10, ids.size());
+
+  DeltaFragmentCache cache;
+  std::vector<char> buffer;
+  const size_t rounds = 20000;
+  size_t bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    cache.beginTick(kTimestamp + r);
+    size_t size = cache.deltaSize(kContext, ids.data(), ids.size());
+    buffer.resize(size);
+    JsonWriter out(buffer.data(), size);
+    cache.writeDelta(out, kContext, ids.data(), ids.size());
+    bytes += out.length();
+  }
+  double ns = elapsedNs(start);
+  report("DeltaFragmentCache", ns, rounds, "delta");
+  printf("%-28s %10zu paths, %zu bytes\n", "", ids.size(), bytes / rounds);
+  TEST_ASSERT_GREATER_THAN(0, bytes);
+}
+
+void bench_delta_snapshot(void) {
+  std::vector<PathId> ids = deltaPaths();
+  DeltaSnapshot snapshot;
+  std::vector<char> buffer;
+  const size_t rounds = 20000;
+  size_t bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    snapshot.capture(ids.data(), ids.size());
+    buffer.resize(estimateDeltaSize(kContext, snapshot));
+    JsonWriter out(buffer.data(), buffer.size());
+    writeDelta(out, kContext, kTimestamp + r, snapshot);
+    bytes += out.length();
+  }
+  report("DeltaSnapshot + writeDelta", elapsedNs(start), rounds, "delta");
+  TEST_ASSERT_GREATER_THAN(0, bytes);
+}
+
+// ====== CONVERSIONS ======
+
+void bench_sentence_builders(void) {
+  const char* ts = "2024-01-15T12:34:56.789Z";
+  const size_t rounds = 50000;
+  size_t length = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    length += convertToRMC(48.1173, 11.5166, 1.2, 3.4 + r * 1e-6, ts).length();
+  }
+  report("convertToRMC", elapsedNs(start), rounds, "conversion");
+
+  start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    length += convertToMWV(0.7, 5.0 + r * 1e-6, 'R').length();
+  }
+  report("convertToMWV", elapsedNs(start), rounds, "conversion");
+
+  start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    length += convertToDPT(4.0 + r * 1e-6, 0.3).length();
+  }
+  report("convertToDPT", elapsedNs(start), rounds, "conversion");
+
+  TEST_ASSERT_GREATER_THAN(0, length);
+}
+
+void bench_unit_conversions(void) {
+  NmeaTokenizer fields;
+  const char* s = "$GPGLL,4807.038,N,01131.000,E";
+  TEST_ASSERT_TRUE(fields.tokenize(s, strlen(s)));
+
+  const size_t rounds = 1000000;
+  double total = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    total += nmeaCoordToDec(fields[1], fields[2]);
+  }
+  report("nmeaCoordToDec", elapsedNs(start), rounds, "conversion");
+
+  start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    total += knotsToMS(r * 0.01) + degToRad(r * 0.001);
+  }
+  report("knotsToMS + degToRad", elapsedNs(start), rounds, "conversion");
+
+  start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    total += haversineDistance(48.1173, 11.5166, 48.1173 + r * 1e-7, 11.5166);
+  }
+  report("haversineDistance", elapsedNs(start), rounds, "conversion");
+
+  sink = total;
+  TEST_ASSERT_GREATER_THAN(0, total);
+}
+
+int main(int argc, char** argv) {
+  simOptions.quiet = true;
+  initNMEA0183Paths();
+  initSeatalk1(32);
+
+  UNITY_BEGIN();
+  RUN_TEST(bench_parse_sentences);
+  RUN_TEST(bench_checksum);
+  RUN_TEST(bench_seatalk_decode);
+  RUN_TEST(bench_delta_cached);
+  RUN_TEST(bench_delta_snapshot);
+  RUN_TEST(bench_sentence_builders);
+  RUN_TEST(bench_unit_conversions);
+  return UNITY_END();
+}
@@ -0,0 +1,140 @@
+// Unit tests: unit conversions and SignalK -> NMEA 0183 sentence builders
+//
+// Run from the repository root:
+//   pio test -e native -f test_conversions
+
+#include <unity.h>
+#include "hardware/nmea0183.h"
+#include "signalk/data_store.h"
+#include "utils/conversions.h"
+#include "utils/nmea0183_converter.h"
+#include "sim/sim.h"
+
+// Sentence without the CRLF the converters append
+static String stripLineEnd(const String& sentence) {
+  TEST_ASSERT_TRUE(sentence.endsWith("\r\n"));
+  return sentence.substring(0, sentence.length() - 2);
+}
+
+// Sentence without checksum and CRLF
+static String body(const String& sentence) {
+  int star = sentence.indexOf('*');
+  TEST_ASSERT_TRUE(star > 0);
+  return sentence.substring(0, star);
+}
+
+static double numberAt(const char* path) {
+  PathId id = findPath(path);
+  TEST_ASSERT_NOT_EQUAL(INVALID_PATH_ID, id);
+  return dataStore[id].numValue;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ====== UNITS ======
+
+void test_units(void) {
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.514444, knotsToMS(1.0));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-12, M_PI, degToRad(180.0));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-12, -M_PI / 2, degToRad(-90.0));
+}
+
+void test_haversine(void) {
+  // One minute of latitude is about one nautical mile
+  TEST_ASSERT_DOUBLE_WITHIN(2.0, 1852.0, haversineDistance(48.0, 11.0, 48.0 + 1.0 / 60, 11.0));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.0, haversineDistance(-33.9, 151.2, -33.9, 151.2));
+  // Across the antimeridian
+  TEST_ASSERT_DOUBLE_WITHIN(1.0, 22239.0, haversineDistance(0.0, 179.9, 0.0, -179.9));
+}
+
+// ====== SENTENCE BUILDERS ======
+
+void test_checksum(void) {
+  String sentence = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,";
+  TEST_ASSERT_EQUAL_STRING("47", calculateNMEAChecksum(sentence).c_str());
+  TEST_ASSERT_EQUAL_STRING((sentence + "*47\r\n").c_str(), addNMEAChecksum(sentence).c_str());
+  // An existing checksum is replaced, not appended to
+  TEST_ASSERT_EQUAL_STRING((sentence + "*47\r\n").c_str(), addNMEAChecksum(sentence + "*00").c_str());
+}
+
+void test_coordinate_format(void) {
+  char buffer[16];
+  TEST_ASSERT_EQUAL_STRING("4807.0380,N", formatLatitude(48.1173, buffer));
+  TEST_ASSERT_EQUAL_STRING("3354.0000,S", formatLatitude(-33.9, buffer));
+  TEST_ASSERT_EQUAL_STRING("01131.0000,E", formatLongitude(11.516666667, buffer));
+  TEST_ASSERT_EQUAL_STRING("15112.0000,W", formatLongitude(-151.2, buffer));
+}
+
+void test_time_and_date_format(void) {
+  char buffer[16];
+  TEST_ASSERT_EQUAL_STRING("123456.000", formatTime("2024-01-15T12:34:56.789Z", buffer));
+  TEST_ASSERT_EQUAL_STRING("000000.000", formatTime("", buffer));
+  TEST_ASSERT_EQUAL_STRING("150124", formatDate("2024-01-15T12:34:56.789Z", buffer));
+}
+
+void test_simple_sentences(void) {
+  TEST_ASSERT_EQUAL_STRING("$WIMWV,270.0,R,5.00,M,A", body(convertToMWV(-M_PI / 2, 5.0, 'R')).c_str());
+  TEST_ASSERT_EQUAL_STRING("$SDDPT,12.30,0.50", body(convertToDPT(12.3, 0.5)).c_str());
+  TEST_ASSERT_EQUAL_STRING("$YXMTW,20.0,C", body(convertToMTW(293.15)).c_str());
+  TEST_ASSERT_EQUAL_STRING("$GPHDT,90.0,T", body(convertToHDG(M_PI / 2)).c_str());
+  TEST_ASSERT_EQUAL_STRING("$GPHDG,180.0,,,,", body(convertToHDG(M_PI, true)).c_str());
+}
+
+void test_built_sentences_validate(void) {
+  const char* ts = "2024-01-15T12:34:56.789Z";
+  String sentences[] = {
+    convertToGGA(48.1173, 11.516666667, ts, 8, 545.4),
+    convertToGGA(48.1173, 11.516666667, ts),
+    convertToGLL(-33.9, 151.2, ts),
+    convertToVTG(1.0, 3.0),
+    convertToRMC(48.1173, 11.516666667, 1.0, 3.0, ts),
+    convertToMWV(0.5, 7.0),
+    convertToDPT(4.0),
+    convertToMTW(285.0),
+    convertToHDG(2.0, true),
+  };
+  for (const String& sentence : sentences) {
+    String line = stripLineEnd(sentence);
+    TEST_ASSERT_TRUE_MESSAGE(validateNmeaChecksum(line), line.c_str());
+  }
+}
+
+// Sentences built from SignalK values parse back to the same values
+void test_round_trip(void) {
+  const char* ts = "2024-01-15T12:34:56.789Z";
+  double cog = degToRad(123.4);
+  double sog = knotsToMS(6.5);
+
+  String rmc = stripLineEnd(convertToRMC(-33.856, 151.215, cog, sog, ts));
+  parseNMEASentence(rmc);
+  PathId position = findPath("navigation.position");
+  TEST_ASSERT_NOT_EQUAL(INVALID_PATH_ID, position);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, -33.856, dataStore[position].fields[0]);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, 151.215, dataStore[position].fields[1]);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-3, cog, numberAt("navigation.courseOverGroundTrue"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-2, sog, numberAt("navigation.speedOverGround"));
+
+  parseNMEASentence(stripLineEnd(convertToDPT(7.25, 0.4)));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 7.25, numberAt("environment.depth.belowTransducer"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 7.65, numberAt("environment.depth.belowSurface"));
+
+  parseNMEASentence(stripLineEnd(convertToMTW(288.15)));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 288.15, numberAt("environment.water.temperature"));
+}
+
+int main(int argc, char** argv) {
+  simOptions.quiet = true;
+  initNMEA0183Paths();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_units);
+  RUN_TEST(test_haversine);
+  RUN_TEST(test_checksum);
+  RUN_TEST(test_coordinate_format);
+  RUN_TEST(test_time_and_date_format);
+  RUN_TEST(test_simple_sentences);
+  RUN_TEST(test_built_sentences_validate);
+  RUN_TEST(test_round_trip);
+  return UNITY_END();
+}
@@ -0,0 +1,195 @@
+// Unit tests: data store registry, change tracking and delta serialization
+//
+// Run from the repository root:
+//   pio test -e native -f test_data_store
+
+#include <unity.h>
+#include "signalk/data_store.h"
+#include "signalk/delta_writer.h"
+#include "sim/sim.h"
+#include <vector>
+
+static const uint64_t kTimestamp = 1700000000000ULL;  // 2023-11-14T22:13:20.000Z
+static const char* kContext = "vessels.urn:mrn:signalk:uuid:test";
+
+static SourceId source;
+
+// Serialize ids with both delta writers; they must agree byte for byte
+static String delta(std::initializer_list<PathId> ids) {
+  std::vector<PathId> list(ids);
+
+  DeltaSnapshot snapshot;
+  snapshot.capture(list.data(), list.size());
+  std::vector<char> buffer(estimateDeltaSize(kContext, snapshot));
+  JsonWriter out(buffer.data(), buffer.size());
+  writeDelta(out, kContext, kTimestamp, snapshot);
+  TEST_ASSERT_FALSE(out.overflowed());
+
+  static DeltaFragmentCache cache;
+  cache.beginTick(kTimestamp);
+  size_t size = cache.deltaSize(kContext, list.data(), list.size());
+  TEST_ASSERT_EQUAL(out.length(), size);
+  std::vector<char> cached(size);
+  JsonWriter cachedOut(cached.data(), size);
+  cache.writeDelta(cachedOut, kContext, list.data(), list.size());
+  TEST_ASSERT_FALSE(cachedOut.overflowed());
+  TEST_ASSERT_EQUAL(size, cachedOut.length());
+  TEST_ASSERT_EQUAL(0, memcmp(buffer.data(), cached.data(), size));
+
+  return String(buffer.data(), out.length());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ====== REGISTRY ======
+
+void test_register_and_find(void) {
+  PathId id = registerPath("environment.outside.temperature", "K", "Outside temperature");
+  TEST_ASSERT_NOT_EQUAL(INVALID_PATH_ID, id);
+  TEST_ASSERT_EQUAL(id, registerPath("environment.outside.temperature"));
+  TEST_ASSERT_EQUAL(id, findPath("environment.outside.temperature"));
+  TEST_ASSERT_EQUAL_STRING("environment.outside.temperature", getPathName(id).c_str());
+  TEST_ASSERT_EQUAL_STRING("K", getPathMeta(id).units.c_str());
+  TEST_ASSERT_EQUAL_STRING("environment", getGroupName(getPathGroup(id)).c_str());
+  TEST_ASSERT_EQUAL(INVALID_PATH_ID, findPath("environment.outside"));
+}
+
+void test_invalid_names_are_rejected(void) {
+  TEST_ASSERT_EQUAL(INVALID_PATH_ID, registerPath(""));
+  TEST_ASSERT_EQUAL(INVALID_PATH_ID, registerPath(".navigation"));
+  TEST_ASSERT_EQUAL(INVALID_PATH_ID, registerPath("navigation."));
+  TEST_ASSERT_EQUAL(INVALID_PATH_ID, registerPath("navigation..speed"));
+  TEST_ASSERT_EQUAL(INVALID_PATH_ID, registerPath("navigation.\"speed\""));
+  TEST_ASSERT_EQUAL(INVALID_PATH_ID, registerPath("navigation.speed over ground"));
+}
+
+void test_late_metadata_bumps_group(void) {
+  PathId id = registerPath("propulsion.main.revolutions");
+  GroupId group = getPathGroup(id);
+  uint32_t version = getGroupVersion(group);
+  TEST_ASSERT_EQUAL_STRING("", getPathMeta(id).units.c_str());
+
+  registerPath("propulsion.main.revolutions", "Hz", "Engine speed");
+  TEST_ASSERT_EQUAL_STRING("Hz", readPathMeta(id)->units.c_str());
+  TEST_ASSERT_NOT_EQUAL(version, getGroupVersion(group));
+}
+
+// ====== VALUES & CHANGE TRACKING ======
+
+void test_values_and_snapshots(void) {
+  PathId number = registerPath("navigation.speedThroughWater", "m/s");
+  PathId text = registerPath("navigation.state");
+  PathId attitude = registerPath("navigation.attitude", "rad");
+
+  setPathValue(number, 3.25, source);
+  setPathValue(text, String("sailing"), source);
+  setPathComposite(attitude, PV_ATTITUDE, 0.1, -0.2, NAN, source);
+
+  PathValue pv;
+  TEST_ASSERT_TRUE(readPathValue(number, pv));
+  TEST_ASSERT_EQUAL(PV_NUMBER, pv.kind);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-12, 3.25, pv.numValue);
+  TEST_ASSERT_EQUAL_STRING("test", getSourceName(pv.source).c_str());
+
+  TEST_ASSERT_TRUE(readPathValue(text, pv));
+  TEST_ASSERT_EQUAL_STRING("sailing", pv.textValue().c_str());
+
+  // A snapshot keeps its text when the stored value is replaced
+  setPathValue(text, String("anchored"), source);
+  TEST_ASSERT_EQUAL_STRING("sailing", pv.textValue().c_str());
+  TEST_ASSERT_EQUAL_STRING("anchored", dataStore[text].textValue().c_str());
+
+  TEST_ASSERT_TRUE(readPathValue(attitude, pv));
+  TEST_ASSERT_EQUAL(PV_ATTITUDE, pv.kind);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-12, -0.2, pv.fields[1]);
+
+  TEST_ASSERT_FALSE(readPathValue(registerPath("navigation.neverSet"), pv));
+}
+
+void test_dirty_paths_coalesce(void) {
+  PathId a = registerPath("electrical.batteries.house.voltage", "V");
+  PathId b = registerPath("electrical.batteries.house.current", "A");
+  clearDirtyPaths();
+  uint32_t coalesced = getTotalCoalescedUpdates();
+
+  setPathValue(b, 1.0, source);
+  setPathValue(a, 12.6, source);
+  setPathValue(b, 2.0, source);
+  setPathValue(b, 3.0, source);
+
+  TEST_ASSERT_EQUAL(2, getDirtyCount());
+  TEST_ASSERT_EQUAL(b, getDirtyPaths()[0]);  // First-change order
+  TEST_ASSERT_EQUAL(a, getDirtyPaths()[1]);
+  TEST_ASSERT_EQUAL(2, getCoalescedUpdates(b));
+  TEST_ASSERT_EQUAL(coalesced + 2, getTotalCoalescedUpdates());
+  TEST_ASSERT_DOUBLE_WITHIN(1e-12, 3.0, dataStore[b].numValue);
+
+  clearDirtyPaths();
+  TEST_ASSERT_EQUAL(0, getDirtyCount());
+  TEST_ASSERT_FALSE(dataStore[b].changed);
+}
+
+void test_json_values_are_canonical(void) {
+  setPathValueJson("navigation.anchor.test", "{ \"radius\": 50,\n  \"on\" : true }", "test");
+  PathId id = findPath("navigation.anchor.test");
+
+  PathValue pv;
+  TEST_ASSERT_TRUE(readPathValue(id, pv));
+  TEST_ASSERT_EQUAL(PV_JSON, pv.kind);
+  TEST_ASSERT_EQUAL_STRING("{\"radius\":50,\"on\":true}", pv.textValue().c_str());
+
+  // Input that does not parse is kept as text, not as raw JSON
+  setPathValueJson("navigation.anchor.test", "{\"radius\":", "test");
+  TEST_ASSERT_TRUE(readPathValue(id, pv));
+  TEST_ASSERT_EQUAL(PV_STRING, pv.kind);
+  TEST_ASSERT_EQUAL_STRING("{\"radius\":", pv.textValue().c_str());
+}
+
+// ====== DELTAS ======
+
+void test_delta_number_with_meta(void) {
+  PathId id = registerPath("environment.depth.belowKeel", "m", "Depth below keel");
+  setPathValue(id, 4.5, source);
+
+  TEST_ASSERT_EQUAL_STRING(
+    "{\"context\":\"vessels.urn:mrn:signalk:uuid:test\","
+    "\"updates\":[{\"timestamp\":\"2023-11-14T22:13:20.000Z\","
+    "\"source\":{\"label\":\"ESP32-SignalK\",\"type\":\"NMEA0183\"},"
+    "\"values\":[{\"path\":\"environment.depth.belowKeel\",\"value\":4.5,"
+    "\"units\":\"m\",\"description\":\"Depth below keel\"}]}]}",
+    delta({id}).c_str());
+}
+
+void test_delta_mixed_kinds(void) {
+  PathId position = registerPath("navigation.position");
+  PathId name = registerPath("design.name");
+  PathId unset = registerPath("design.unset");
+  setPathComposite(position, PV_POSITION, 48.5, -123.25, NAN, source);
+  setPathValue(name, String("Say \"hi\""), source);
+
+  // Paths without a value are left out; NaN composite fields are omitted
+  TEST_ASSERT_EQUAL_STRING(
+    "{\"context\":\"vessels.urn:mrn:signalk:uuid:test\","
+    "\"updates\":[{\"timestamp\":\"2023-11-14T22:13:20.000Z\","
+    "\"source\":{\"label\":\"ESP32-SignalK\",\"type\":\"NMEA0183\"},"
+    "\"values\":[{\"path\":\"navigation.position\",\"value\":{\"latitude\":48.5,\"longitude\":-123.25}},"
+    "{\"path\":\"design.name\",\"value\":\"Say \\\"hi\\\"\"}]}]}",
+    delta({position, unset, name}).c_str());
+}
+
+int main(int argc, char** argv) {
+  simOptions.quiet = true;
+  source = registerSource("test");
+
+  UNITY_BEGIN();
+  RUN_TEST(test_register_and_find);
+  RUN_TEST(test_invalid_names_are_rejected);
+  RUN_TEST(test_late_metadata_bumps_group);
+  RUN_TEST(test_values_and_snapshots);
+  RUN_TEST(test_dirty_paths_coalesce);
+  RUN_TEST(test_json_values_are_canonical);
+  RUN_TEST(test_delta_number_with_meta);
+  RUN_TEST(test_delta_mixed_kinds);
+  return UNITY_END();
+}
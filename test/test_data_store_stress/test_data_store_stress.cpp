@@ -0,0 +1,365 @@
+// Stress test: data store snapshot reads while the writer keeps updating
+//
+// Run from the repository root (-v shows the counts):
+//   pio test -e native -f test_data_store_stress -v
+//
+// The test plays the loop task, the only writer: it rewrites every value each
+// pass, fills in metadata late and registers new paths while readers run.
+// Three threads play AsyncTCP handlers: one checks readPathValue() snapshots
+// for torn values, one serializes the full model and initial-state deltas
+// and checks they are valid JSON, and one looks paths up by name and sends
+// name-based updates that must come back through the deferred write queue.
+// Every value encodes the pass that wrote it, so a torn or mixed read shows.
+
+#include <unity.h>
+#include "signalk/data_store.h"
+#include "signalk/delta_writer.h"
+#include "signalk/vessel_model.h"
+#include "sim/sim.h"
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ====== HELPERS ======
+
+// Unity assertions must not fail on another thread, so the reader threads
+// count failed checks and the test asserts the count when they are done
+static std::atomic<int> failures(0);
+
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);         \
+      failures++;                                                    \
+    }                                                                \
+  } while (0)
+
+static const uint32_t kRunMs = 3000;
+static const int kNumberPaths = 48;
+static const int kTextPaths = 12;
+static const int kLatePaths = 64;       // Registered while the readers run
+static const int kWebWrites = 2000;
+static const uint32_t kMetaPass = 200;  // Pass that adds units to every number path
+
+// What the writer stores in each registered path
+enum PathRole { ROLE_NUMBER, ROLE_POSITION, ROLE_STRING, ROLE_JSON, ROLE_LATE, ROLE_WEB };
+
+struct TestPath {
+  String name;
+  PathRole role;
+  PathId id;
+};
+
+static std::vector<TestPath> paths;       // Fixed before the readers start
+static const char* const kGroups[] = {"navigation", "environment", "propulsion", "electrical", "steering"};
+static std::atomic<bool> running(true);
+static std::atomic<uint32_t> passes(0);
+
+// Payload of text paths: "g=<pass>|" and a run of one letter whose length depends on the pass
+static std::string textPayload(uint32_t pass, int index) {
+  std::string s = "g=" + std::to_string(pass) + "|";
+  s.append(pass % 97, (char)('a' + index % 26));
+  return s;
+}
+
+static bool checkTextPayload(const String& text, int index, uint32_t& pass) {
+  const char* s = text.c_str();
+  if (strncmp(s, "g=", 2) != 0) return false;
+  char* end = nullptr;
+  pass = strtoul(s + 2, &end, 10);
+  return end != nullptr && *end == '|' && textPayload(pass, index) == s;
+}
+
+// Minimal JSON syntax check
+struct JsonChecker {
+  const char* p;
+  const char* end;
+
+  void ws() { while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++; }
+  bool lit(const char* s) {
+    size_t n = strlen(s);
+    if ((size_t)(end - p) < n || strncmp(p, s, n) != 0) return false;
+    p += n;
+    return true;
+  }
+  bool str() {
+    if (p >= end || *p != '"') return false;
+    for (p++; p < end; p++) {
+      if (*p == '\\') { p++; continue; }
+      if (*p == '"') { p++; return true; }
+      if ((unsigned char)*p < 0x20) return false;
+    }
+    return false;
+  }
+  bool num() {
+    const char* start = p;
+    if (p < end && *p == '-') p++;
+    while (p < end && ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-')) p++;
+    return p > start;
+  }
+  bool value() {
+    ws();
+    if (p >= end) return false;
+    if (*p == '{') {
+      p++; ws();
+      if (p < end && *p == '}') { p++; return true; }
+      for (;;) {
+        ws();
+        if (!str()) return false;
+        ws();
+        if (p >= end || *p++ != ':') return false;
+        if (!value()) return false;
+        ws();
+        if (p < end && *p == ',') { p++; continue; }
+        if (p < end && *p == '}') { p++; return true; }
+        return false;
+      }
+    }
+    if (*p == '[') {
+      p++; ws();
+      if (p < end && *p == ']') { p++; return true; }
+      for (;;) {
+        if (!value()) return false;
+        ws();
+        if (p < end && *p == ',') { p++; continue; }
+        if (p < end && *p == ']') { p++; return true; }
+        return false;
+      }
+    }
+    if (*p == '"') return str();
+    if (lit("true") || lit("false") || lit("null")) return true;
+    return num();
+  }
+  static bool valid(const char* text, size_t len) {
+    JsonChecker c{text, text + len};
+    if (!c.value()) return false;
+    c.ws();
+    return c.p == c.end;
+  }
+};
+
+// ====== WRITER (loop task) ======
+
+static void registerTestPaths() {
+  for (int i = 0; i < kNumberPaths; i++) {
+    // Every fourth path also gets a child, so values nest under values
+    char name[64];
+    snprintf(name, sizeof(name), "%s.sensor%d.value", kGroups[i % 5], i);
+    paths.push_back({name, ROLE_NUMBER, INVALID_PATH_ID});
+    if (i % 4 == 0) {
+      snprintf(name, sizeof(name), "%s.sensor%d.value.raw", kGroups[i % 5], i);
+      paths.push_back({name, ROLE_NUMBER, INVALID_PATH_ID});
+    }
+  }
+  paths.push_back({"navigation.position", ROLE_POSITION, INVALID_PATH_ID});
+  for (int i = 0; i < kTextPaths; i++) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s.state%d", kGroups[i % 5], i);
+    paths.push_back({name, i % 2 ? ROLE_JSON : ROLE_STRING, INVALID_PATH_ID});
+  }
+  paths.push_back({"electrical.webInput", ROLE_WEB, INVALID_PATH_ID});
+
+  for (TestPath& p : paths) {
+    p.id = registerPath(p.name);
+    CHECK(p.id != INVALID_PATH_ID);
+  }
+}
+
+static void writePass(uint32_t pass, SourceId source) {
+  for (size_t i = 0; i < paths.size(); i++) {
+    const TestPath& p = paths[i];
+    switch (p.role) {
+      case ROLE_NUMBER:
+        setPathValue(p.id, (double)pass * 1000 + i, source);
+        break;
+      case ROLE_POSITION:
+        setPathComposite(p.id, PV_POSITION, pass, pass, pass, source);
+        break;
+      case ROLE_STRING:
+        setPathValue(p.id, String(textPayload(pass, i).c_str()), source);
+        break;
+      case ROLE_JSON:
+        setPathValueJson(p.name, String(("{\"g\":\"" + textPayload(pass, i) + "\"}").c_str()), "test.json");
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (pass == kMetaPass) {
+    for (const TestPath& p : paths) {
+      if (p.role == ROLE_NUMBER) registerPath(p.name, "m/s", "Late metadata");
+    }
+  }
+  if (pass % 8 == 0 && pass / 8 <= kLatePaths) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s.late%u", kGroups[pass % 5], pass / 8);
+    setPathValue(registerPath(name), (double)pass, source);
+  }
+}
+
+// ====== READERS (web server task) ======
+
+// Snapshots of the fixed paths must never mix two passes
+static void valueReader(uint64_t& reads) {
+  std::mt19937 rng(1);
+  std::vector<uint32_t> lastPass(paths.size(), 0);
+  PathValue pv;
+  while (running) {
+    size_t i = rng() % paths.size();
+    const TestPath& p = paths[i];
+    if (!readPathValue(p.id, pv)) continue;
+    reads++;
+
+    uint32_t pass = 0;
+    switch (p.role) {
+      case ROLE_NUMBER:
+        CHECK(pv.kind == PV_NUMBER);
+        pass = (uint32_t)(pv.numValue / 1000);
+        CHECK(pv.numValue == (double)pass * 1000 + i);
+        break;
+      case ROLE_POSITION:
+        CHECK(pv.kind == PV_POSITION);
+        CHECK(pv.fields[0] == pv.fields[1] && pv.fields[1] == pv.fields[2]);
+        pass = (uint32_t)pv.fields[0];
+        break;
+      case ROLE_STRING:
+        CHECK(pv.kind == PV_STRING);
+        CHECK(checkTextPayload(pv.textValue(), i, pass));
+        break;
+      case ROLE_JSON: {
+        CHECK(pv.kind == PV_JSON);
+        const String& json = pv.textValue();
+        String inner = json.substring(6, json.length() - 2);
+        CHECK(json.startsWith("{\"g\":\"") && json.endsWith("\"}") && checkTextPayload(inner, i, pass));
+        break;
+      }
+      default:
+        continue;
+    }
+    CHECK(pass >= lastPass[i]);  // Never older than a value already seen
+    lastPass[i] = pass;
+    CHECK(getSourceName(pv.source).length() > 0);
+  }
+}
+
+// Full model and initial-state deltas: sized from a snapshot, so they must
+// never overflow and always be valid JSON
+static void modelReader(uint64_t& models, uint64_t& deltas, uint64_t& rebuilds) {
+  std::vector<uint8_t> body;
+  std::vector<PathId> ids;
+  std::vector<char> buffer;
+  DeltaSnapshot snapshot;
+  String context = "vessels.urn:mrn:signalk:uuid:test";
+  while (running) {
+    VesselModelSnapshot model = getVesselModelSnapshot("urn:mrn:signalk:uuid:test", "Stress");
+    body.resize(model.length());
+    size_t offset = 0;
+    while (offset < body.size()) {
+      offset += model.read(offset, body.data() + offset, 1460);
+    }
+    CHECK(JsonChecker::valid((const char*)body.data(), body.size()));
+    models++;
+
+    ids.clear();
+    for (PathId id = 0; id < getPathCount(); id++) ids.push_back(id);
+    snapshot.capture(ids.data(), ids.size());
+    buffer.resize(estimateDeltaSize(context, snapshot));
+    JsonWriter out(buffer.data(), buffer.size());
+    writeDelta(out, context, epochMillisNow(), snapshot);
+    CHECK(!out.overflowed());
+    CHECK(JsonChecker::valid(buffer.data(), out.length()));
+    deltas++;
+  }
+  rebuilds = getVesselModelStats().groupsRebuilt;
+}
+
+// Lookups by name, late metadata, and name-based writes from this task
+static void registryReader(uint64_t& lookups, uint32_t& webWrites) {
+  std::mt19937 rng(2);
+  PathId webId = findPath("electrical.webInput");
+  while (running) {
+    PathId count = getPathCount();
+    PathId id = rng() % count;
+    const String& name = getPathName(id);
+    CHECK(name.length() > 0);
+    CHECK(findPath(name) == id);
+    CHECK(getPathGroup(id) < getGroupCount());
+
+    PathMetaRef meta = readPathMeta(id);
+    CHECK(meta->units.length() == 0 || meta->units == "m/s");
+    lookups++;
+
+    if (webWrites < kWebWrites) {
+      webWrites++;
+      setPathValue(getPathName(webId), (double)webWrites, "ws.test", "", "WebSocket update");
+      std::this_thread::yield();
+    }
+  }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_readers_never_see_torn_values(void) {
+  setDataStoreWriter();
+  registerTestPaths();
+  SourceId source = registerSource("test.writer");
+
+  uint32_t pass = 1;
+  writePass(pass, source);
+
+  uint64_t valueReads = 0, models = 0, deltas = 0, rebuilds = 0, lookups = 0;
+  uint32_t webWrites = 0;
+  std::thread values(valueReader, std::ref(valueReads));
+  std::thread model(modelReader, std::ref(models), std::ref(deltas), std::ref(rebuilds));
+  std::thread registry(registryReader, std::ref(lookups), std::ref(webWrites));
+
+  uint32_t start = millis();
+  uint32_t maxPassUs = 0;
+  while (millis() - start < kRunMs) {
+    uint32_t t0 = micros();
+    pass++;
+    writePass(pass, source);
+    processDeferredStoreWrites();
+    clearDirtyPaths();
+    uint32_t us = micros() - t0;
+    if (us > maxPassUs) maxPassUs = us;
+  }
+  running = false;
+  values.join();
+  model.join();
+  registry.join();
+  processDeferredStoreWrites();
+
+  printf("Writer: %u passes over %u paths, slowest pass %u us\n",
+         pass, (unsigned)getPathCount(), maxPassUs);
+  printf("Readers: %llu value snapshots, %llu models (%llu group rebuilds), %llu deltas, %llu lookups\n",
+         (unsigned long long)valueReads, (unsigned long long)models, (unsigned long long)rebuilds,
+         (unsigned long long)deltas, (unsigned long long)lookups);
+  printf("Web writes: %u sent, %u applied, %u dropped\n",
+         webWrites, getDeferredStoreWrites(), getDroppedStoreWrites());
+
+  TEST_ASSERT_EQUAL_MESSAGE(0, failures.load(), "Reader checks failed (see FAIL lines)");
+
+  // Every web write was either applied in order or counted as dropped
+  PathValue web;
+  TEST_ASSERT_EQUAL(webWrites, getDeferredStoreWrites() + getDroppedStoreWrites());
+  TEST_ASSERT_TRUE(readPathValue(findPath("electrical.webInput"), web));
+  TEST_ASSERT_TRUE(web.numValue <= webWrites && web.numValue > 0);
+  TEST_ASSERT_EQUAL_STRING("WebSocket update", getPathMeta(findPath("electrical.webInput")).description.c_str());
+
+  TEST_ASSERT_GREATER_THAN(kMetaPass, pass);
+  TEST_ASSERT_GREATER_THAN(paths.size(), getPathCount());
+}
+
+int main(int argc, char** argv) {
+  simOptions.quiet = true;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_readers_never_see_torn_values);
+  return UNITY_END();
+}
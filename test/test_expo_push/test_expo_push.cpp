@@ -0,0 +1,389 @@
+// Unit tests: ExpoPushClient against a local HTTP stand-in for the Expo API
+//
+// Run from the repository root:
+//   pio test -e native -f test_expo_push
+//
+// The stand-in listens on 127.0.0.1 and answers each request with the next
+// scripted response, recording request bodies and accepted connections, so
+// batching, keep-alive reuse, reconnects and retry classification can be
+// checked without network access.
+
+#include <unity.h>
+#include <Client.h>
+#include "services/expo_push_client.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ====== POSIX CLIENT ======
+// Behaves like WiFiClient: non-blocking available()/read(), connected()
+// turns false once the peer has closed and nothing is left to read.
+
+class PosixClient : public Client {
+public:
+  ~PosixClient() override { stop(); }
+
+  int connect(const char* host, uint16_t port) override {
+    stop();
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, host, &addr.sin_addr);
+    if (::connect(_fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+      stop();
+      return 0;
+    }
+    return 1;
+  }
+
+  int connect(IPAddress ip, uint16_t port) override {
+    return connect(ip.toString().c_str(), port);
+  }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+
+  size_t write(const uint8_t* buf, size_t size) override {
+    if (_fd < 0) return 0;
+    ssize_t n = ::send(_fd, buf, size, MSG_NOSIGNAL);
+    return n < 0 ? 0 : (size_t)n;
+  }
+
+  int available() override {
+    if (_fd < 0) return 0;
+    int n = 0;
+    ioctl(_fd, FIONREAD, &n);
+    return n;
+  }
+
+  int read() override {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+
+  int read(uint8_t* buf, size_t size) override {
+    if (_fd < 0) return -1;
+    ssize_t n = recv(_fd, buf, size, MSG_DONTWAIT);
+    return n <= 0 ? -1 : (int)n;
+  }
+
+  int peek() override {
+    uint8_t c;
+    if (_fd < 0 || recv(_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) != 1) return -1;
+    return c;
+  }
+
+  void flush() override {}
+
+  void stop() override {
+    if (_fd >= 0) close(_fd);
+    _fd = -1;
+  }
+
+  uint8_t connected() override {
+    if (_fd < 0) return 0;
+    char c;
+    ssize_t n = recv(_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+  }
+
+  operator bool() override { return connected(); }
+
+private:
+  int _fd = -1;
+};
+
+// ====== STAND-IN SERVER ======
+
+struct ScriptedResponse {
+  int status;
+  bool chunked;      // Chunked body instead of Content-Length
+  bool closeHeader;  // Send "Connection: close"
+  bool closeAfter;   // Close the socket after responding (with or without the header)
+};
+
+class StandIn {
+public:
+  StandIn() {
+    _listen = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(_listen, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(_listen, (sockaddr*)&addr, sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(_listen, (sockaddr*)&addr, &len);
+    _port = ntohs(addr.sin_port);
+    listen(_listen, 4);
+    _thread = std::thread([this] { run(); });
+  }
+
+  ~StandIn() {
+    shutdown(_listen, SHUT_RDWR);
+    close(_listen);
+    _thread.join();
+  }
+
+  uint16_t port() const { return _port; }
+
+  void script(const ScriptedResponse& r) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _script.push_back(r);
+  }
+
+  int accepts() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _accepts;
+  }
+
+  std::vector<std::string> bodies() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bodies;
+  }
+
+private:
+  void run() {
+    for (;;) {
+      int fd = accept(_listen, nullptr, nullptr);
+      if (fd < 0) return;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _accepts++;
+      }
+      serve(fd);
+      close(fd);
+    }
+  }
+
+  // Serve requests on one connection until the script says close or the client does
+  void serve(int fd) {
+    std::string buffer;
+    for (;;) {
+      size_t headerEnd;
+      while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (!receive(fd, buffer)) return;
+      }
+      size_t lengthPos = buffer.find("Content-Length: ");
+      size_t contentLength = lengthPos < headerEnd ? atol(buffer.c_str() + lengthPos + 16) : 0;
+      while (buffer.size() < headerEnd + 4 + contentLength) {
+        if (!receive(fd, buffer)) return;
+      }
+
+      ScriptedResponse r = {200, false, false, false};
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bodies.push_back(buffer.substr(headerEnd + 4, contentLength));
+        if (!_script.empty()) {
+          r = _script.front();
+          _script.pop_front();
+        }
+      }
+      buffer.erase(0, headerEnd + 4 + contentLength);
+
+      std::string body = "{\"data\":[{\"status\":\"ok\",\"id\":\"0\"}]}";
+      std::string response = "HTTP/1.1 " + std::to_string(r.status) + " X\r\n"
+                             "Content-Type: application/json\r\n";
+      if (r.closeHeader) response += "Connection: close\r\n";
+      if (r.chunked) {
+        response += "Transfer-Encoding: chunked\r\n\r\n";
+        char size[16];
+        snprintf(size, sizeof(size), "%zx\r\n", body.size());
+        response += size + body + "\r\n0\r\n\r\n";
+      } else {
+        response += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+      }
+      ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+      if (r.closeAfter || r.closeHeader) return;
+    }
+  }
+
+  static bool receive(int fd, std::string& buffer) {
+    char chunk[512];
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) return false;
+    buffer.append(chunk, n);
+    return true;
+  }
+
+  int _listen;
+  uint16_t _port;
+  std::thread _thread;
+  std::mutex _mutex;
+  std::deque<ScriptedResponse> _script;
+  std::vector<std::string> _bodies;
+  int _accepts = 0;
+};
+
+// ====== TESTS ======
+
+static size_t countOf(const std::string& s, const char* needle) {
+  size_t n = 0;
+  for (size_t pos = s.find(needle); pos != std::string::npos; pos = s.find(needle, pos + 1)) n++;
+  return n;
+}
+
+static ExpoPushJob makeJob(const char* title, const char* alarmType, size_t tokens) {
+  ExpoPushJob job;
+  job.title = title;
+  job.body = "Vessel left geofence: 84 m (> 50 m)";
+  job.alarmType = alarmType;
+  for (size_t i = 0; i < tokens; i++) {
+    job.tokens.push_back(String(("ExponentPushToken[" + std::to_string(i) + "]").c_str()));
+  }
+  return job;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_payload(void) {
+  std::vector<ExpoPushJob> jobs = {makeJob("Geofence \"Alert\"", "geofence", 3),
+                                   makeJob("Info", "", 1)};
+  jobs[1].data = "{\"k\":1}";
+  std::string payload = buildExpoPushPayload(jobs).c_str();
+
+  TEST_ASSERT_EQUAL('[', payload.front());
+  TEST_ASSERT_EQUAL(']', payload.back());
+  TEST_ASSERT_EQUAL(4, countOf(payload, "\"to\":"));
+  TEST_ASSERT_EQUAL(3, countOf(payload, "\"channelId\":\"geofence-alarms\""));
+  TEST_ASSERT_EQUAL(1, countOf(payload, "\"sound\":\"default\""));
+  TEST_ASSERT_TRUE(payload.find("\"title\":\"Geofence \\\"Alert\\\"\"") != std::string::npos);
+  TEST_ASSERT_TRUE(payload.find("\"data\":\"{\\\"k\\\":1}\"") != std::string::npos);
+
+  TEST_ASSERT_EQUAL_STRING("[]", buildExpoPushPayload({}).c_str());
+}
+
+void test_backoff(void) {
+  TEST_ASSERT_EQUAL(1000, expoPushBackoffMs(1));
+  TEST_ASSERT_EQUAL(2000, expoPushBackoffMs(2));
+  TEST_ASSERT_EQUAL(4000, expoPushBackoffMs(3));
+  TEST_ASSERT_EQUAL(30000, expoPushBackoffMs(6));
+  TEST_ASSERT_EQUAL(30000, expoPushBackoffMs(200));
+}
+
+void test_batch_and_keep_alive(void) {
+  StandIn server;
+  PosixClient transport;
+  ExpoPushClient client(transport, "127.0.0.1", server.port());
+
+  std::vector<ExpoPushJob> batch = {makeJob("Geofence Alert", "geofence", 5)};
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+  TEST_ASSERT_EQUAL(200, client.lastStatus());
+
+  // Chunked response on the same connection
+  server.script({200, true, false, false});
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+
+  std::vector<std::string> bodies = server.bodies();
+  TEST_ASSERT_EQUAL(3, bodies.size());
+  TEST_ASSERT_EQUAL(5, countOf(bodies[0], "\"to\":"));  // One request for all tokens
+  TEST_ASSERT_EQUAL(1, server.accepts());  // Connection reused
+  TEST_ASSERT_EQUAL(1, client.connects());
+}
+
+void test_large_job_is_split(void) {
+  StandIn server;
+  PosixClient transport;
+  ExpoPushClient client(transport, "127.0.0.1", server.port());
+  std::deque<ExpoPushJob> pending = {makeJob("Geofence Alert", "geofence", 250),
+                                     makeJob("Info", "", 10)};
+
+  std::vector<size_t> sizes;
+  std::vector<ExpoPushJob> batch;
+  for (takeExpoPushBatch(pending, batch); !batch.empty(); takeExpoPushBatch(pending, batch)) {
+    size_t messages = 0;
+    for (const ExpoPushJob& job : batch) messages += job.tokens.size();
+    sizes.push_back(messages);
+    TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+  }
+  TEST_ASSERT_TRUE(pending.empty());
+
+  // Full requests first; the last one carries the rest and the next job
+  std::vector<std::string> bodies = server.bodies();
+  TEST_ASSERT_EQUAL(3, bodies.size());
+  size_t expected[] = {100, 100, 60};
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL(expected[i], sizes[i]);
+    TEST_ASSERT_EQUAL(expected[i], countOf(bodies[i], "\"to\":"));
+  }
+  TEST_ASSERT_TRUE(bodies[0].find("ExponentPushToken[99]") != std::string::npos);
+  TEST_ASSERT_TRUE(bodies[1].find("\"to\":\"ExponentPushToken[100]\"") != std::string::npos);
+  TEST_ASSERT_EQUAL(50, countOf(bodies[2], "\"channelId\":\"geofence-alarms\""));
+  TEST_ASSERT_EQUAL(10, countOf(bodies[2], "\"title\":\"Info\""));
+}
+
+void test_reconnect(void) {
+  StandIn server;
+  PosixClient transport;
+  ExpoPushClient client(transport, "127.0.0.1", server.port());
+  std::vector<ExpoPushJob> batch = {makeJob("Depth Alert", "depth", 2)};
+
+  // Server drops the kept-alive connection without saying so
+  server.script({200, false, false, true});
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+  delay(20);
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+
+  // "Connection: close" is honoured
+  server.script({200, false, true, false});
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+
+  TEST_ASSERT_EQUAL(4, server.bodies().size());  // No request sent twice
+  TEST_ASSERT_EQUAL(3, server.accepts());
+  TEST_ASSERT_EQUAL(3, client.connects());
+}
+
+void test_status_classification(void) {
+  StandIn server;
+  PosixClient transport;
+  ExpoPushClient client(transport, "127.0.0.1", server.port());
+  std::vector<ExpoPushJob> batch = {makeJob("Wind Alert", "wind", 1)};
+
+  server.script({503, false, false, false});
+  TEST_ASSERT_EQUAL(EXPO_PUSH_RETRY, client.send(batch));
+  server.script({429, false, false, false});
+  TEST_ASSERT_EQUAL(EXPO_PUSH_RETRY, client.send(batch));
+  server.script({400, false, false, false});
+  TEST_ASSERT_EQUAL(EXPO_PUSH_REJECTED, client.send(batch));
+  TEST_ASSERT_EQUAL(400, client.lastStatus());
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send(batch));
+
+  // Nothing to send
+  TEST_ASSERT_EQUAL(EXPO_PUSH_SENT, client.send({}));
+  TEST_ASSERT_EQUAL(4, server.bodies().size());
+}
+
+void test_connect_failure(void) {
+  uint16_t port;
+  {
+    StandIn server;  // Grab a free port, then close it
+    port = server.port();
+  }
+  PosixClient transport;
+  ExpoPushClient client(transport, "127.0.0.1", port);
+  TEST_ASSERT_EQUAL(EXPO_PUSH_RETRY, client.send({makeJob("Geofence Alert", "geofence", 1)}));
+  TEST_ASSERT_EQUAL(0, client.lastStatus());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_payload);
+  RUN_TEST(test_backoff);
+  RUN_TEST(test_batch_and_keep_alive);
+  RUN_TEST(test_large_job_is_split);
+  RUN_TEST(test_reconnect);
+  RUN_TEST(test_status_classification);
+  RUN_TEST(test_connect_failure);
+  return UNITY_END();
+}
@@ -0,0 +1,169 @@
+// Unit tests: raw input log records (recorder and replay format)
+//
+// Run from the repository root:
+//   pio test -e native -f test_input_log
+
+#include <unity.h>
+#include <string.h>
+#include "utils/input_log.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ====== HEADER ======
+
+void test_header_round_trip(void) {
+  uint8_t header[INPUT_LOG_HEADER_SIZE];
+  TEST_ASSERT_EQUAL(INPUT_LOG_HEADER_SIZE, writeInputLogHeader(header, 1760000000u));
+  TEST_ASSERT_EQUAL_MEMORY("SKIL", header, 4);
+
+  uint32_t start = 0;
+  TEST_ASSERT_TRUE(readInputLogHeader(header, sizeof(header), &start));
+  TEST_ASSERT_EQUAL_UINT32(1760000000u, start);
+
+  TEST_ASSERT_FALSE(readInputLogHeader(header, sizeof(header) - 1, &start));  // Short
+  header[4] = INPUT_LOG_VERSION + 1;
+  TEST_ASSERT_FALSE(readInputLogHeader(header, sizeof(header), &start));      // Newer format
+}
+
+// ====== RECORDS ======
+
+void test_record_round_trip(void) {
+  const char* sentence = "$SDDBT,7.8,f,2.4,M,1.3,F*0D\r\n";
+  uint8_t buf[INPUT_LOG_MAX_RECORD];
+  size_t n = encodeInputRecord(buf, sizeof(buf), INPUT_PORT_TCP_SERVER, 5, 300000,
+                               (const uint8_t*)sentence, strlen(sentence));
+  // Port, channel, 3-byte delta (300000 < 2^21), length, payload
+  TEST_ASSERT_EQUAL(1 + 1 + 3 + 1 + strlen(sentence), n);
+
+  InputRecord rec;
+  TEST_ASSERT_EQUAL((int)n, decodeInputRecord(buf, n, rec));
+  TEST_ASSERT_EQUAL(INPUT_PORT_TCP_SERVER, rec.port);
+  TEST_ASSERT_EQUAL(5, rec.channel);
+  TEST_ASSERT_EQUAL_UINT32(300000, rec.deltaMicros);
+  TEST_ASSERT_EQUAL(strlen(sentence), rec.len);
+  TEST_ASSERT_EQUAL_MEMORY(sentence, rec.data, rec.len);
+}
+
+void test_every_tcp_slot_keeps_its_channel(void) {
+  const uint8_t byte = 'x';
+  uint8_t buf[INPUT_LOG_MAX_RECORD];
+  InputRecord rec;
+
+  for (uint8_t channel = 0; channel < INPUT_LOG_CHANNELS; channel++) {
+    size_t n = encodeInputRecord(buf, sizeof(buf), INPUT_PORT_TCP_SERVER, channel, 0, &byte, 1);
+    TEST_ASSERT_EQUAL((int)n, decodeInputRecord(buf, n, rec));
+    TEST_ASSERT_EQUAL(INPUT_PORT_TCP_SERVER, rec.port);
+    TEST_ASSERT_EQUAL(channel, rec.channel);
+  }
+}
+
+void test_delta_encoding_sizes(void) {
+  const uint8_t byte = 'x';
+  uint8_t buf[INPUT_LOG_MAX_RECORD];
+  InputRecord rec;
+
+  // Back-to-back chunks cost four bytes of overhead
+  TEST_ASSERT_EQUAL(5, encodeInputRecord(buf, sizeof(buf), INPUT_PORT_GPS, 0, 0, &byte, 1));
+  TEST_ASSERT_EQUAL(5, encodeInputRecord(buf, sizeof(buf), INPUT_PORT_GPS, 0, 127, &byte, 1));
+  TEST_ASSERT_EQUAL(6, encodeInputRecord(buf, sizeof(buf), INPUT_PORT_GPS, 0, 128, &byte, 1));
+
+  // Longest gap: the full 32 bits in five bytes
+  size_t n = encodeInputRecord(buf, sizeof(buf), INPUT_PORT_GPS, 0, 0xFFFFFFFFu, &byte, 1);
+  TEST_ASSERT_EQUAL(9, n);
+  TEST_ASSERT_EQUAL((int)n, decodeInputRecord(buf, n, rec));
+  TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFFu, rec.deltaMicros);
+}
+
+void test_partial_record_needs_more(void) {
+  uint8_t payload[200];
+  memset(payload, '$', sizeof(payload));
+  uint8_t buf[INPUT_LOG_MAX_RECORD];
+  size_t n = encodeInputRecord(buf, sizeof(buf), INPUT_PORT_RS485, 0, 1000, payload, sizeof(payload));
+
+  InputRecord rec;
+  for (size_t avail = 0; avail < n; avail++) {
+    TEST_ASSERT_EQUAL(0, decodeInputRecord(buf, avail, rec));
+  }
+  TEST_ASSERT_EQUAL((int)n, decodeInputRecord(buf, n, rec));
+}
+
+void test_invalid_records(void) {
+  const uint8_t byte = 'x';
+  uint8_t buf[INPUT_LOG_MAX_RECORD + 1];
+  uint8_t big[INPUT_LOG_MAX_PAYLOAD + 1] = {};
+  InputRecord rec;
+
+  // Not encodable: empty, too long, unknown port, unknown channel, no room
+  TEST_ASSERT_EQUAL(0, encodeInputRecord(buf, sizeof(buf), INPUT_PORT_GPS, 0, 0, &byte, 0));
+  TEST_ASSERT_EQUAL(0, encodeInputRecord(buf, sizeof(buf), INPUT_PORT_GPS, 0, 0, big, sizeof(big)));
+  TEST_ASSERT_EQUAL(0, encodeInputRecord(buf, sizeof(buf), INPUT_PORT_COUNT, 0, 0, &byte, 1));
+  TEST_ASSERT_EQUAL(0, encodeInputRecord(buf, sizeof(buf), INPUT_PORT_TCP_SERVER, INPUT_LOG_CHANNELS,
+                                         0, &byte, 1));
+  TEST_ASSERT_EQUAL(0, encodeInputRecord(buf, 4, INPUT_PORT_GPS, 0, 0, &byte, 1));
+
+  // Not decodable: unknown port or channel, zero length, delta longer than five bytes
+  const uint8_t badPort[] = {0x0F, 0x00, 0x00, 0x01, 'x'};
+  const uint8_t badChannel[] = {INPUT_PORT_TCP_SERVER, INPUT_LOG_CHANNELS, 0x00, 0x01, 'x'};
+  const uint8_t zeroLength[] = {INPUT_PORT_GPS, 0x00, 0x00, 0x00};
+  const uint8_t longDelta[] = {INPUT_PORT_GPS, 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01, 0x01, 'x'};
+  TEST_ASSERT_EQUAL(-1, decodeInputRecord(badPort, sizeof(badPort), rec));
+  TEST_ASSERT_EQUAL(-1, decodeInputRecord(badChannel, sizeof(badChannel), rec));
+  TEST_ASSERT_EQUAL(-1, decodeInputRecord(zeroLength, sizeof(zeroLength), rec));
+  TEST_ASSERT_EQUAL(-1, decodeInputRecord(longDelta, sizeof(longDelta), rec));
+}
+
+void test_record_sequence(void) {
+  // Records are decoded back to back from one buffer, as the replay reads them
+  uint8_t log[64];
+  size_t len = 0;
+  const uint8_t a[] = {'$', 'G'};
+  const uint8_t b[] = {0x00, 0x02, 0x00, 0x64, 0x00};
+  len += encodeInputRecord(log + len, sizeof(log) - len, INPUT_PORT_GPS, 0, 10, a, sizeof(a));
+  len += encodeInputRecord(log + len, sizeof(log) - len, INPUT_PORT_SEATALK, 0, 20, b, sizeof(b));
+
+  InputRecord rec;
+  int used = decodeInputRecord(log, len, rec);
+  TEST_ASSERT_GREATER_THAN(0, used);
+  TEST_ASSERT_EQUAL(INPUT_PORT_GPS, rec.port);
+  TEST_ASSERT_EQUAL_UINT32(10, rec.deltaMicros);
+
+  TEST_ASSERT_EQUAL((int)(len - used), decodeInputRecord(log + used, len - used, rec));
+  TEST_ASSERT_EQUAL(INPUT_PORT_SEATALK, rec.port);
+  TEST_ASSERT_EQUAL_UINT32(20, rec.deltaMicros);
+  TEST_ASSERT_EQUAL_MEMORY(b, rec.data, sizeof(b));
+}
+
+// ====== N2K PAYLOAD ======
+
+void test_n2k_payload(void) {
+  const uint8_t data[] = {0xFF, 0x10, 0x27, 0x00, 0x00, 0x00, 0x00, 0xFF};
+  uint8_t payload[INPUT_LOG_MAX_PAYLOAD];
+  size_t n = encodeN2kPayload(payload, 128267, 3, 35, 255, data, sizeof(data));
+  TEST_ASSERT_EQUAL(INPUT_LOG_N2K_HEADER + sizeof(data), n);
+
+  uint32_t pgn = payload[0] | (payload[1] << 8) | ((uint32_t)payload[2] << 16);
+  TEST_ASSERT_EQUAL_UINT32(128267, pgn);
+  TEST_ASSERT_EQUAL(3, payload[3]);
+  TEST_ASSERT_EQUAL(35, payload[4]);
+  TEST_ASSERT_EQUAL(255, payload[5]);
+  TEST_ASSERT_EQUAL_MEMORY(data, payload + INPUT_LOG_N2K_HEADER, sizeof(data));
+
+  // Fast-packet maximum (223 bytes) fits; more than a record can hold does not
+  uint8_t big[INPUT_LOG_MAX_PAYLOAD] = {};
+  TEST_ASSERT_EQUAL(INPUT_LOG_N2K_HEADER + 223, encodeN2kPayload(payload, 126996, 6, 1, 255, big, 223));
+  TEST_ASSERT_EQUAL(0, encodeN2kPayload(payload, 126996, 6, 1, 255, big, INPUT_LOG_MAX_PAYLOAD));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_header_round_trip);
+  RUN_TEST(test_record_round_trip);
+  RUN_TEST(test_every_tcp_slot_keeps_its_channel);
+  RUN_TEST(test_delta_encoding_sizes);
+  RUN_TEST(test_partial_record_needs_more);
+  RUN_TEST(test_invalid_records);
+  RUN_TEST(test_record_sequence);
+  RUN_TEST(test_n2k_payload);
+  return UNITY_END();
+}
@@ -0,0 +1,220 @@
+// Unit tests: NMEA 0183 parsing into the data store
+//
+// Run from the repository root:
+//   pio test -e native -f test_nmea0183
+
+#include <unity.h>
+#include "hardware/nmea0183.h"
+#include "signalk/data_store.h"
+#include "utils/conversions.h"
+#include "utils/input_stats.h"
+#include "sim/sim.h"
+
+// Latest number stored at path
+static double numberAt(const char* path) {
+  PathId id = findPath(path);
+  TEST_ASSERT_NOT_EQUAL(INVALID_PATH_ID, id);
+  TEST_ASSERT_EQUAL(PV_NUMBER, dataStore[id].kind);
+  return dataStore[id].numValue;
+}
+
+static void parse(const char* sentence) {
+  parseNMEASentence(sentence, strlen(sentence));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ====== CHECKSUM & COORDINATES ======
+
+void test_checksum(void) {
+  TEST_ASSERT_TRUE(validateNmeaChecksum(String("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47")));
+  TEST_ASSERT_FALSE(validateNmeaChecksum(String("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48")));
+  TEST_ASSERT_FALSE(validateNmeaChecksum(String("$GPGGA,123519,4807.038,N*4")));
+  TEST_ASSERT_TRUE(validateNmeaChecksum(String("$IIMWV,045.0,R,10.5,N,A")));  // No checksum
+}
+
+void test_coordinates(void) {
+  NmeaTokenizer fields;
+  const char* s = "$GPGLL,4807.038,N,01131.000,E,4807.038,S,01131.000,W";
+  TEST_ASSERT_TRUE(fields.tokenize(s, strlen(s)));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-6, 48.1173, nmeaCoordToDec(fields[1], fields[2]));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-6, 11.516666667, nmeaCoordToDec(fields[3], fields[4]));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-6, -48.1173, nmeaCoordToDec(fields[5], fields[6]));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-6, -11.516666667, nmeaCoordToDec(fields[7], fields[8]));
+  TEST_ASSERT_DOUBLE_IS_NAN(nmeaCoordToDec(fields[2], fields[2]));  // Too short
+}
+
+// ====== SENTENCES ======
+
+void test_rmc(void) {
+  parse("$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A");
+
+  PathId position = findPath("navigation.position");
+  TEST_ASSERT_NOT_EQUAL(INVALID_PATH_ID, position);
+  TEST_ASSERT_EQUAL(PV_POSITION, dataStore[position].kind);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-6, 48.1173, dataStore[position].fields[0]);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-6, 11.516666667, dataStore[position].fields[1]);
+
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, knotsToMS(22.4), numberAt("navigation.speedOverGround"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, degToRad(84.4), numberAt("navigation.courseOverGroundTrue"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, degToRad(-3.1), numberAt("navigation.magneticVariation"));
+}
+
+void test_rmc_void_fix_is_ignored(void) {
+  parse("$GPRMC,123519,A,4807.038,N,01131.000,E,010.0,084.4,230394,003.1,W");
+  parse("$GPRMC,123520,V,4807.038,N,01131.000,E,099.0,084.4,230394,003.1,W");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, knotsToMS(10.0), numberAt("navigation.speedOverGround"));
+}
+
+void test_gga(void) {
+  parse("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 8, numberAt("navigation.gnss.satellitesInView"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 545.4, numberAt("navigation.gnss.altitude"));
+}
+
+void test_empty_fields_are_skipped(void) {
+  parse("$GPVTG,054.7,T,,M,005.5,N,010.2,K");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, degToRad(54.7), numberAt("navigation.courseOverGroundTrue"));
+
+  // No course: speed is updated, course keeps its last value
+  parse("$GPVTG,,T,,M,006.0,N,011.1,K");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, knotsToMS(6.0), numberAt("navigation.speedOverGround"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, degToRad(54.7), numberAt("navigation.courseOverGroundTrue"));
+}
+
+void test_mwv(void) {
+  parse("$IIMWV,045.0,R,10.5,N,A");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, degToRad(45.0), numberAt("environment.wind.angleApparent"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, knotsToMS(10.5), numberAt("environment.wind.speedApparent"));
+
+  parse("$IIMWV,120.0,T,15.0,N,A");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, degToRad(120.0), numberAt("environment.wind.angleTrueWater"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, knotsToMS(15.0), numberAt("environment.wind.speedTrue"));
+
+  // Invalid status: nothing changes
+  parse("$IIMWV,090.0,R,30.0,N,V");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, degToRad(45.0), numberAt("environment.wind.angleApparent"));
+}
+
+void test_dpt_offsets(void) {
+  parse("$SDDPT,12.5,0.5");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 12.5, numberAt("environment.depth.belowTransducer"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 13.0, numberAt("environment.depth.belowSurface"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 0.5, numberAt("environment.depth.surfaceToTransducer"));
+
+  parse("$SDDPT,8.0,-1.2");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 6.8, numberAt("environment.depth.belowKeel"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 1.2, numberAt("environment.depth.transducerToKeel"));
+}
+
+void test_dbt_prefers_meters(void) {
+  parse("$SDDBT,32.8,f,10.0,M,5.5,F");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 10.0, numberAt("environment.depth.belowTransducer"));
+
+  parse("$SDDBT,10.0,f,,M,,F");
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 3.048, numberAt("environment.depth.belowTransducer"));
+}
+
+void test_short_and_malformed_sentences(void) {
+  PathId count = getPathCount();
+  parse("$GPRMC,123519,A");
+  parse("GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W");
+  parse("$");
+  parse("$GPZZZ,1,2,3");
+  TEST_ASSERT_EQUAL(count, getPathCount());
+}
+
+// ====== DISPATCH TABLE ======
+
+static int customCalls = 0;
+static double customValue = 0;
+
+static void handleCustom(const NmeaTokenizer& fields) {
+  customCalls++;
+  customValue = fields.number(1);
+}
+
+void test_custom_sentence_with_talker_filter(void) {
+  TEST_ASSERT_TRUE(registerNMEA0183Sentence("XYZ", 3, handleCustom, "P1"));
+  TEST_ASSERT_FALSE(registerNMEA0183Sentence("XY", 3, handleCustom));
+
+  parse("$P1XYZ,4.25,A");
+  TEST_ASSERT_EQUAL(1, customCalls);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, 4.25, customValue);
+
+  parse("$GPXYZ,9.0,A");  // Talker not accepted
+  parse("$P1XYZ,9.0");    // Too few fields
+  TEST_ASSERT_EQUAL(1, customCalls);
+}
+
+// ====== COUNTERS ======
+
+static NmeaSentenceStats statsFor(const char* formatter) {
+  for (const NmeaSentenceStats& s : getNMEA0183SentenceStats()) {
+    if (strcmp(s.formatter, formatter) == 0) return s;
+  }
+  TEST_FAIL_MESSAGE("no stats entry");
+  return NmeaSentenceStats();
+}
+
+static void parseFrom(InputPort port, const char* sentence) {
+  parseNMEASentence(sentence, strlen(sentence), port);
+}
+
+void test_counters_per_port_and_type(void) {
+  InputCounters& gps = inputStats[INPUT_PORT_GPS];
+  uint32_t sentences = gps.get(INPUT_SENTENCES);
+  uint32_t checksumErrors = gps.get(INPUT_CHECKSUM_ERRORS);
+  uint32_t parseErrors = gps.get(INPUT_PARSE_ERRORS);
+  NmeaSentenceStats gga = statsFor("GGA");
+  NmeaSentenceStats other = statsFor("");
+
+  parseFrom(INPUT_PORT_GPS, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+  parseFrom(INPUT_PORT_GPS, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48");
+  parseFrom(INPUT_PORT_GPS, "$GPGGA,123519,4807.038,N");
+  parseFrom(INPUT_PORT_GPS, "$GPZZZ,1,2,3");
+  parseFrom(INPUT_PORT_RS485, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+
+  TEST_ASSERT_EQUAL_UINT32(sentences + 4, gps.get(INPUT_SENTENCES));
+  TEST_ASSERT_EQUAL_UINT32(checksumErrors + 1, gps.get(INPUT_CHECKSUM_ERRORS));
+  TEST_ASSERT_EQUAL_UINT32(parseErrors + 1, gps.get(INPUT_PARSE_ERRORS));
+
+  NmeaSentenceStats ggaAfter = statsFor("GGA");
+  TEST_ASSERT_EQUAL_UINT32(gga.received + 4, ggaAfter.received);
+  TEST_ASSERT_EQUAL_UINT32(gga.checksumErrors + 1, ggaAfter.checksumErrors);
+  TEST_ASSERT_EQUAL_UINT32(gga.parseErrors + 1, ggaAfter.parseErrors);
+  TEST_ASSERT_EQUAL_UINT32(other.received + 1, statsFor("").received);
+}
+
+void test_replayed_input_is_not_counted_per_port(void) {
+  uint32_t before[INPUT_PORT_COUNT];
+  for (uint8_t p = 0; p < INPUT_PORT_COUNT; p++) before[p] = inputStats[p].get(INPUT_SENTENCES);
+
+  parse("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+
+  for (uint8_t p = 0; p < INPUT_PORT_COUNT; p++) {
+    TEST_ASSERT_EQUAL_UINT32(before[p], inputStats[p].get(INPUT_SENTENCES));
+  }
+}
+
+int main(int argc, char** argv) {
+  simOptions.quiet = true;
+  initNMEA0183Paths();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_checksum);
+  RUN_TEST(test_coordinates);
+  RUN_TEST(test_rmc);
+  RUN_TEST(test_rmc_void_fix_is_ignored);
+  RUN_TEST(test_gga);
+  RUN_TEST(test_empty_fields_are_skipped);
+  RUN_TEST(test_mwv);
+  RUN_TEST(test_dpt_offsets);
+  RUN_TEST(test_dbt_prefers_meters);
+  RUN_TEST(test_short_and_malformed_sentences);
+  RUN_TEST(test_custom_sentence_with_talker_filter);
+  RUN_TEST(test_counters_per_port_and_type);
+  RUN_TEST(test_replayed_input_is_not_counted_per_port);
+  return UNITY_END();
+}
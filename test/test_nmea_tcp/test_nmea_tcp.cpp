@@ -0,0 +1,347 @@
+// Load test: NMEA 0183 TCP server with dozens of local connections
+//
+// Run from the repository root (-v shows the timings):
+//   pio test -e native -f test_nmea_tcp -v
+//
+// The server runs on the simulator's AsyncTCP (src/sim/hal/AsyncTCP.h) and
+// listens on 127.0.0.1:NMEA_TCP_PORT; the test plays the loop task. The tests run in
+// order on the same connections: fill every pool slot and check that extra
+// connections are refused, measure what processNMEA0183Server() costs with
+// all clients idle, stream sentences to all of them while one never reads,
+// and exercise inbound sentences, the rate limit, slot reuse and shutdown.
+// The 30 s idle timeout is not covered.
+
+#include <unity.h>
+#include "hardware/nmea0183.h"
+#include "services/nmea0183_tcp.h"
+#include "signalk/data_store.h"
+#include "sim/sim.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ====== HELPERS ======
+
+static const int kSentences = 20000;
+static const int kExtraClients = 8;  // Beyond MAX_NMEA_CLIENTS
+
+static int connectClient(int receiveBuffer = 0) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (receiveBuffer > 0) {
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+  }
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(NMEA_TCP_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static void sendText(int fd, const std::string& text) {
+  ::send(fd, text.data(), text.size(), MSG_NOSIGNAL);
+}
+
+// Pump the loop side until pred() holds or timeoutMs passes
+template <typename Pred>
+static bool pumpUntil(Pred pred, uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (!pred()) {
+    if (millis() - start > timeoutMs) return false;
+    processNMEA0183Server();
+    delay(1);
+  }
+  return true;
+}
+
+// True once the peer has closed fd (reads and discards anything pending)
+static bool waitClosed(int fd, uint32_t timeoutMs) {
+  uint32_t start = millis();
+  char buffer[4096];
+  while (millis() - start < timeoutMs) {
+    processNMEA0183Server();
+    pollfd p = {fd, POLLIN, 0};
+    if (poll(&p, 1, 5) > 0) {
+      ssize_t n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+      if (n == 0 || (n < 0 && errno == ECONNRESET)) return true;
+    }
+  }
+  return false;
+}
+
+static std::string makeSentence(const char* body) {
+  uint8_t checksum = 0;
+  for (const char* p = body; *p; p++) checksum ^= (uint8_t)*p;
+  char text[96];
+  snprintf(text, sizeof(text), "$%s*%02X\r\n", body, checksum);
+  return text;
+}
+
+// Sequence number of a "$GPTST,<seq>*CS" line, or -1 if malformed
+static long parseSequence(const std::string& line) {
+  size_t star = line.find('*');
+  if (line.size() < 10 || line[0] != '$' || star == std::string::npos || star + 3 != line.size()) {
+    return -1;
+  }
+  uint8_t checksum = 0;
+  for (size_t i = 1; i < star; i++) checksum ^= (uint8_t)line[i];
+  if (strtoul(line.c_str() + star + 1, nullptr, 16) != checksum) return -1;
+  if (line.compare(1, 6, "GPTST,") != 0) return -1;
+  return strtol(line.c_str() + 7, nullptr, 10);
+}
+
+// Reads every socket in fds on its own thread; sentences must arrive
+// complete, in order and without gaps
+class Readers {
+public:
+  explicit Readers(const std::vector<int>& fds)
+    : _fds(fds), _buffers(fds.size()), _next(fds.size(), 0), _errors(0), _minReceived(0) {
+    _thread = std::thread([this] { run(); });
+  }
+
+  ~Readers() { stop(); }
+
+  void stop() {
+    if (!_thread.joinable()) return;
+    _stop = true;
+    _thread.join();
+  }
+
+  long minReceived() const { return _minReceived.load(); }
+  int errors() const { return _errors.load(); }
+
+private:
+  void run() {
+    std::vector<pollfd> fds;
+    for (int fd : _fds) fds.push_back({fd, POLLIN, 0});
+    char chunk[8192];
+
+    while (!_stop) {
+      poll(fds.data(), fds.size(), 5);
+      long lowest = kSentences;
+      for (size_t i = 0; i < _fds.size(); i++) {
+        ssize_t n;
+        while ((n = recv(_fds[i], chunk, sizeof(chunk), MSG_DONTWAIT)) > 0) {
+          _buffers[i].append(chunk, n);
+        }
+        size_t eol;
+        while ((eol = _buffers[i].find("\r\n")) != std::string::npos) {
+          long seq = parseSequence(_buffers[i].substr(0, eol));
+          if (seq != _next[i]) _errors++;
+          _next[i] = seq + 1;
+          _buffers[i].erase(0, eol + 2);
+        }
+        if (_next[i] < lowest) lowest = _next[i];
+      }
+      _minReceived = lowest;
+    }
+  }
+
+  std::vector<int> _fds;
+  std::vector<std::string> _buffers;
+  std::vector<long> _next;
+  std::atomic<int> _errors;
+  std::atomic<long> _minReceived;
+  std::atomic<bool> _stop{false};
+  std::thread _thread;
+};
+
+// Sentences of one type the parser has seen
+static uint32_t sentencesParsed(const char* formatter) {
+  for (const NmeaSentenceStats& s : getNMEA0183SentenceStats()) {
+    if (strcmp(s.formatter, formatter) == 0) return s.received;
+  }
+  return 0;
+}
+
+// ====== TESTS ======
+
+// Shared by the tests, which run in order
+static std::vector<int> fast;
+static int slow = -1;  // Never reads; small window so it backs up quickly
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Every pool slot, then a few more that must be refused
+void test_capacity(void) {
+  slow = connectClient(4096);
+  TEST_ASSERT_GREATER_OR_EQUAL(0, slow);
+  TEST_ASSERT_TRUE(pumpUntil([] { return getNMEA0183ClientCount() == 1; }, 2000));
+
+  for (int i = 1; i < MAX_NMEA_CLIENTS; i++) {
+    int fd = connectClient();
+    TEST_ASSERT_GREATER_OR_EQUAL(0, fd);
+    fast.push_back(fd);
+  }
+  TEST_ASSERT_TRUE(pumpUntil([] { return getNMEA0183ClientCount() == MAX_NMEA_CLIENTS; }, 5000));
+
+  int refused = 0;
+  for (int i = 0; i < kExtraClients; i++) {
+    int fd = connectClient();
+    if (fd >= 0 && waitClosed(fd, 2000)) refused++;
+    if (fd >= 0) close(fd);
+  }
+  TEST_ASSERT_EQUAL(kExtraClients, refused);
+  TEST_ASSERT_EQUAL(MAX_NMEA_CLIENTS, getNMEA0183ClientCount());
+}
+
+// Nothing broadcast, nothing acknowledged
+void test_idle_cost(void) {
+  const int kIdleCalls = 200000;
+  processNMEA0183Server();
+  uint32_t idleStart = micros();
+  for (int i = 0; i < kIdleCalls; i++) {
+    processNMEA0183Server();
+  }
+  double idleNs = (micros() - idleStart) * 1000.0 / kIdleCalls;
+  printf("Idle processNMEA0183Server(): %.0f ns per call with %d clients\n", idleNs, MAX_NMEA_CLIENTS);
+  TEST_ASSERT_LESS_THAN(1000, (int)idleNs);
+}
+
+// Broadcast to all clients while one of them does not read
+void test_broadcast_with_stalled_client(void) {
+  Readers readers(fast);
+  uint32_t streamStart = millis();
+  for (long seq = 0; seq < kSentences; seq++) {
+    // Keep the readers within the ring so only the stalled client drops
+    while (seq - readers.minReceived() > 64) {
+      processNMEA0183Server();
+      yield();
+    }
+    char body[32];
+    snprintf(body, sizeof(body), "GPTST,%06ld", seq);
+    std::string sentence = makeSentence(body);
+    broadcastNMEA0183(sentence.c_str(), sentence.size());
+    processNMEA0183Server();
+  }
+  bool delivered = pumpUntil([&] { return readers.minReceived() == kSentences; }, 10000);
+  uint32_t streamMs = millis() - streamStart;
+  readers.stop();
+  TEST_ASSERT_TRUE(delivered);
+  TEST_ASSERT_EQUAL(0, readers.errors());
+
+  std::vector<NMEA0183ClientStats> stats = getNMEA0183ClientStats();
+  TEST_ASSERT_EQUAL(MAX_NMEA_CLIENTS, stats.size());
+  int dropping = 0;
+  uint32_t latencyAvg = 0;
+  uint32_t latencyMax = 0;
+  for (const NMEA0183ClientStats& s : stats) {
+    if (s.sentencesDropped > 0) {
+      dropping++;
+    } else {
+      TEST_ASSERT_EQUAL(kSentences, s.sentencesSent);
+      latencyAvg += s.latencyAvgUs;
+      if (s.latencyMaxUs > latencyMax) latencyMax = s.latencyMaxUs;
+    }
+  }
+  TEST_ASSERT_EQUAL(1, dropping);  // Only the client that never reads
+
+  // The stalled client lost whole sentences but still sees ordered data
+  std::string backlog;
+  char chunk[8192];
+  ssize_t n;
+  while ((n = recv(slow, chunk, sizeof(chunk), MSG_DONTWAIT)) > 0) backlog.append(chunk, n);
+  long lastSeq = -1;
+  int complete = 0;
+  for (size_t start = 0, eol; (eol = backlog.find("\r\n", start)) != std::string::npos; start = eol + 2) {
+    long seq = parseSequence(backlog.substr(start, eol - start));
+    if (seq < 0) continue;  // Cut where the client was skipped forward
+    TEST_ASSERT_GREATER_THAN(lastSeq, seq);
+    lastSeq = seq;
+    complete++;
+  }
+  TEST_ASSERT_GREATER_THAN(0, complete);
+  TEST_ASSERT_LESS_THAN(kSentences, complete);
+
+  printf("Streamed %d sentences to %d clients in %u ms, latency avg %u us, max %u us\n",
+         kSentences, MAX_NMEA_CLIENTS - 1, (unsigned)streamMs,
+         (unsigned)(latencyAvg / (MAX_NMEA_CLIENTS - 1)), (unsigned)latencyMax);
+  printf("Stalled client: %d complete sentences, rest dropped\n", complete);
+}
+
+// Inbound sentences reach the parser; the sender is not echoed to
+void test_inbound_sentences(void) {
+  int feeder = fast.back();
+  std::string mtw = makeSentence("IIMTW,18.5,C");
+  uint32_t before = sentencesParsed("MTW");
+  for (int i = 0; i < 5; i++) sendText(feeder, mtw);
+  TEST_ASSERT_TRUE(pumpUntil([&] { return sentencesParsed("MTW") == before + 5; }, 2000));
+
+  PathValue water;
+  TEST_ASSERT_TRUE(readPathValue(findPath("environment.water.temperature"), water));
+  TEST_ASSERT_DOUBLE_WITHIN(0.001, 291.65, water.numValue);
+
+  int listening = 0;
+  for (const NMEA0183ClientStats& s : getNMEA0183ClientStats()) {
+    if (s.receiving) listening++;
+  }
+  TEST_ASSERT_EQUAL(MAX_NMEA_CLIENTS - 1, listening);
+}
+
+// A flood is cut off
+void test_rate_limit(void) {
+  int feeder = fast.back();
+  std::string mtw = makeSentence("IIMTW,18.5,C");
+  std::string flood;
+  for (int i = 0; i < MAX_SENTENCES_PER_SECOND + 50; i++) flood += mtw;
+  sendText(feeder, flood);
+  TEST_ASSERT_TRUE(waitClosed(feeder, 3000));
+  close(feeder);
+  fast.pop_back();
+  TEST_ASSERT_TRUE(pumpUntil([] { return getNMEA0183ClientCount() == MAX_NMEA_CLIENTS - 1; }, 2000));
+}
+
+// Slots are returned and reused
+void test_slot_reuse(void) {
+  for (int i = 0; i < MAX_NMEA_CLIENTS / 2; i++) {
+    close(fast.back());
+    fast.pop_back();
+  }
+  size_t remaining = 1 + fast.size();
+  TEST_ASSERT_TRUE(pumpUntil([&] { return getNMEA0183ClientCount() == (int)remaining; }, 3000));
+  while ((int)(1 + fast.size()) < MAX_NMEA_CLIENTS) {
+    fast.push_back(connectClient());
+  }
+  TEST_ASSERT_TRUE(pumpUntil([] { return getNMEA0183ClientCount() == MAX_NMEA_CLIENTS; }, 3000));
+}
+
+// Shutdown closes everything
+void test_shutdown(void) {
+  stopNMEA0183Server();
+  TEST_ASSERT_EQUAL(0, getNMEA0183ClientCount());
+  TEST_ASSERT_TRUE(waitClosed(slow, 2000));
+  int closed = 0;
+  for (int fd : fast) {
+    if (waitClosed(fd, 2000)) closed++;
+    close(fd);
+  }
+  close(slow);
+  TEST_ASSERT_EQUAL(fast.size(), closed);
+}
+
+int main(int argc, char** argv) {
+  simOptions.quiet = true;
+  initNMEA0183Paths();
+  initNMEA0183Server();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_capacity);
+  RUN_TEST(test_idle_cost);
+  RUN_TEST(test_broadcast_with_stalled_client);
+  RUN_TEST(test_inbound_sentences);
+  RUN_TEST(test_rate_limit);
+  RUN_TEST(test_slot_reuse);
+  RUN_TEST(test_shutdown);
+  return UNITY_END();
+}
@@ -0,0 +1,170 @@
+// NmeaTokenizer vs. the former splitNMEA() + String::toDouble()
+//
+// Run from the repository root (-v shows the timings):
+//   pio test -e native -f test_nmea_tokenizer -v
+//
+// Both implementations tokenize every sentence of sample.nmea (next to this
+// file) and parse every field as a number, which is what
+// parseNMEASentence() does. The suite checks that both agree on field text
+// and values and that the tokenizer does not allocate, then reports time
+// and heap allocations per sentence.
+
+#include <unity.h>
+#include <Arduino.h>
+#include "utils/nmea_tokenizer.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+// ====== ALLOCATION COUNTER ======
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+  allocations++;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ====== FORMER IMPLEMENTATION ======
+// Verbatim copy of splitNMEA() as it was in src/hardware/nmea0183.cpp
+static std::vector<String> splitNMEA(const String& sentence) {
+  std::vector<String> fields;
+  int start = 0;
+  int idx;
+
+  String s = sentence;
+  int starPos = s.indexOf('*');
+  if (starPos > 0) {
+    s = s.substring(0, starPos);
+  }
+
+  while ((idx = s.indexOf(',', start)) >= 0) {
+    fields.push_back(s.substring(start, idx));
+    start = idx + 1;
+  }
+  fields.push_back(s.substring(start));
+
+  return fields;
+}
+
+// ====== BENCHMARK ======
+
+static double runLegacy(const std::vector<String>& lines) {
+  double sum = 0;
+  for (const String& line : lines) {
+    std::vector<String> fields = splitNMEA(line);
+    for (size_t i = 1; i < fields.size(); i++) {
+      sum += fields[i].toDouble();
+    }
+  }
+  return sum;
+}
+
+static double runTokenizer(const std::vector<String>& lines) {
+  static NmeaTokenizer fields;
+  double sum = 0;
+  for (const String& line : lines) {
+    if (!fields.tokenize(line.c_str(), line.length())) continue;
+    for (size_t i = 1; i < fields.count(); i++) {
+      double v = fields.number(i);
+      if (!std::isnan(v)) sum += v;
+    }
+  }
+  return sum;
+}
+
+// Field-by-field comparison; returns the number of mismatches
+static int verify(const std::vector<String>& lines) {
+  NmeaTokenizer fields;
+  int mismatches = 0;
+  for (const String& line : lines) {
+    std::vector<String> legacy = splitNMEA(line);
+    fields.tokenize(line.c_str(), line.length());
+    if (legacy.size() != fields.count()) {
+      printf("field count differs: %s\n", line.c_str());
+      mismatches++;
+      continue;
+    }
+    for (size_t i = 0; i < legacy.size(); i++) {
+      if (std::string(legacy[i].c_str()) != std::string(fields[i].ptr, fields[i].len)) {
+        printf("field %zu differs: %s\n", i, line.c_str());
+        mismatches++;
+      }
+      double v = fields.number(i);
+      double ref = legacy[i].toDouble();
+      if (!std::isnan(v) && std::fabs(v - ref) > 1e-12 * std::fabs(ref)) {
+        printf("value %zu differs (%.17g vs %.17g): %s\n", i, v, ref, line.c_str());
+        mismatches++;
+      }
+    }
+  }
+  return mismatches;
+}
+
+// Returns heap allocations per sentence
+template <typename F>
+static double measure(const char* name, const std::vector<String>& lines, int rounds, F fn) {
+  double sink = 0;
+  size_t before = allocations;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    sink += fn(lines);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double sentences = (double)lines.size() * rounds;
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  double allocs = (allocations - before) / sentences;
+  printf("%-12s %8.1f ns/sentence  %6.2f allocs/sentence  (checksum %.3f)\n",
+         name, ns / sentences, allocs, sink);
+  return allocs;
+}
+
+// ====== TESTS ======
+
+static const int kRounds = 200;
+static std::vector<String> lines;
+
+// sample.nmea sits next to this file, so the suite runs from any directory
+static void loadSample() {
+  std::string path = __FILE__;
+  path = path.substr(0, path.find_last_of('/') + 1) + "sample.nmea";
+
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.pop_back();
+    if (!line.empty()) lines.push_back(String(line.c_str()));
+  }
+  printf("%zu sentences from %s\n", lines.size(), path.c_str());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_matches_split_nmea(void) {
+  TEST_ASSERT_GREATER_THAN_MESSAGE(0, lines.size(), "sample.nmea not found or empty");
+  TEST_ASSERT_EQUAL(0, verify(lines));
+}
+
+void bench_tokenizer_vs_split_nmea(void) {
+  TEST_ASSERT_GREATER_THAN(0, lines.size());
+  measure("splitNMEA", lines, kRounds, runLegacy);
+  double allocs = measure("tokenizer", lines, kRounds, runTokenizer);
+  TEST_ASSERT_EQUAL_DOUBLE(0.0, allocs);
+}
+
+int main(int argc, char** argv) {
+  loadSample();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_split_nmea);
+  RUN_TEST(bench_tokenizer_vs_split_nmea);
+  return UNITY_END();
+}
@@ -0,0 +1,147 @@
+// Unit tests: Seatalk 1 datagram framing and decoding
+//
+// Run from the repository root:
+//   pio test -e native -f test_seatalk1
+//
+// Expected values follow the datagram layouts in Thomas Knauf's SeaTalk
+// technical reference, quoted next to each case in seatalk1.cpp.
+
+#include <unity.h>
+#include <SoftwareSerial.h>
+#include "hardware/seatalk1.h"
+#include "signalk/data_store.h"
+#include "utils/conversions.h"
+#include "sim/sim.h"
+
+static SeatalkMessage datagram(std::initializer_list<uint8_t> bytes) {
+  SeatalkMessage msg = {};
+  const uint8_t* b = bytes.begin();
+  msg.command = b[0];
+  msg.attribute = b[1];
+  msg.length = (uint8_t)bytes.size();
+  for (size_t i = 2; i < bytes.size(); i++) {
+    msg.data[i - 2] = b[i];
+  }
+  msg.valid = true;
+  return msg;
+}
+
+static double numberAt(const char* path) {
+  PathId id = findPath(path);
+  TEST_ASSERT_NOT_EQUAL(INVALID_PATH_ID, id);
+  TEST_ASSERT_EQUAL(PV_NUMBER, dataStore[id].kind);
+  return dataStore[id].numValue;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ====== DECODING ======
+
+void test_depth(void) {
+  // 00 02 YZ XX XX: 0x0064 = 100 -> 10.0 ft; flags in YZ do not change the depth
+  decodeSeatalkMessage(datagram({0x00, 0x02, 0x00, 0x64, 0x00}));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-4, 3.048, numberAt("environment.depth.belowTransducer"));
+
+  decodeSeatalkMessage(datagram({0x00, 0x02, 0x41, 0x2C, 0x01}));  // 300 -> 30.0 ft
+  TEST_ASSERT_DOUBLE_WITHIN(1e-4, 9.144, numberAt("environment.depth.belowTransducer"));
+}
+
+void test_apparent_wind_angle(void) {
+  // 10 01 XX YY: XXYY / 2 degrees right of bow
+  decodeSeatalkMessage(datagram({0x10, 0x01, 0x00, 0x5A}));  // 90 -> 45 degrees
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, degToRad(45.0), numberAt("environment.wind.angleApparent"));
+
+  decodeSeatalkMessage(datagram({0x10, 0x01, 0x02, 0x3A}));  // 570 -> 285 = 75 to port
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, degToRad(-75.0), numberAt("environment.wind.angleApparent"));
+}
+
+void test_apparent_wind_speed(void) {
+  // 11 01 XX 0Y: (XX & 0x7F) + Y / 10 knots; bit 7 only selects display units
+  decodeSeatalkMessage(datagram({0x11, 0x01, 0x0C, 0x05}));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, knotsToMS(12.5), numberAt("environment.wind.speedApparent"));
+
+  decodeSeatalkMessage(datagram({0x11, 0x01, 0x8C, 0x05}));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, knotsToMS(12.5), numberAt("environment.wind.speedApparent"));
+}
+
+void test_speed_through_water(void) {
+  // 20 01 XX XX: XXXX / 10 knots, LSB first
+  decodeSeatalkMessage(datagram({0x20, 0x01, 0x41, 0x00}));  // 65 -> 6.5 kn
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, knotsToMS(6.5), numberAt("navigation.speedThroughWater"));
+}
+
+void test_water_temperature(void) {
+  // 23 Z1 XX YY: XX degrees Celsius, YY Fahrenheit
+  decodeSeatalkMessage(datagram({0x23, 0x01, 0x12, 0x40}));  // 18 C / 64 F
+  TEST_ASSERT_DOUBLE_WITHIN(1e-4, 291.15, numberAt("environment.water.temperature"));
+
+  // Z & 4: sensor defective, value ignored
+  decodeSeatalkMessage(datagram({0x23, 0x41, 0x00, 0x20}));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-4, 291.15, numberAt("environment.water.temperature"));
+
+  // 27 01 XX XX: (XXXX - 100) / 10 degrees Celsius, LSB first
+  decodeSeatalkMessage(datagram({0x27, 0x01, 0x2B, 0x01}));  // 299 -> 19.9 C
+  TEST_ASSERT_DOUBLE_WITHIN(1e-4, 293.05, numberAt("environment.water.temperature"));
+}
+
+void test_compass_heading(void) {
+  // 9C U1 VW RR: (U & 3) * 90 + (VW & 0x3F) * 2, plus 1 or 2 from the high bits of U
+  decodeSeatalkMessage(datagram({0x9C, 0x21, 0x0A, 0x00}));  // 2*90 + 10*2 = 200
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, degToRad(200.0), numberAt("navigation.headingMagnetic"));
+
+  decodeSeatalkMessage(datagram({0x9C, 0xC1, 0x01, 0x00}));  // 0 + 2 + 2 = 4
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, degToRad(4.0), numberAt("navigation.headingMagnetic"));
+
+  decodeSeatalkMessage(datagram({0x9C, 0x41, 0x05, 0x00}));  // 0 + 10 + 1 = 11
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, degToRad(11.0), numberAt("navigation.headingMagnetic"));
+}
+
+void test_autopilot_course(void) {
+  // 84 U6 VW XY 0Z 0M RR SS TT: course = (VW >> 6) * 90 + XY / 2
+  decodeSeatalkMessage(datagram({0x84, 0x06, 0x80, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00}));  // 180 + 30
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, degToRad(210.0), numberAt("steering.autopilot.target.headingMagnetic"));
+}
+
+void test_short_datagrams_are_ignored(void) {
+  double depth = numberAt("environment.depth.belowTransducer");
+  decodeSeatalkMessage(datagram({0x00, 0x02, 0x00, 0x10}));  // Missing a depth byte
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, depth, numberAt("environment.depth.belowTransducer"));
+
+  SeatalkMessage invalid = datagram({0x00, 0x02, 0x00, 0x10, 0x00});
+  invalid.valid = false;
+  decodeSeatalkMessage(invalid);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-9, depth, numberAt("environment.depth.belowTransducer"));
+}
+
+// ====== FRAMING ======
+
+void test_byte_stream_framing(void) {
+  // Two datagrams back to back; the attribute byte gives each one's length
+  const uint8_t bytes[] = {0x20, 0x01, 0x50, 0x00,  0x00, 0x02, 0x00, 0xC8, 0x00};
+  SoftwareSerial::hostInput().assign(bytes, bytes + sizeof(bytes));
+
+  TEST_ASSERT_TRUE(processSeatalk1());
+  TEST_ASSERT_EQUAL(0, SoftwareSerial::hostInput().size());
+  TEST_ASSERT_DOUBLE_WITHIN(1e-5, knotsToMS(8.0), numberAt("navigation.speedThroughWater"));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-4, 6.096, numberAt("environment.depth.belowTransducer"));
+
+  TEST_ASSERT_FALSE(processSeatalk1());  // Nothing pending
+}
+
+int main(int argc, char** argv) {
+  simOptions.quiet = true;
+  initSeatalk1(32);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_depth);
+  RUN_TEST(test_apparent_wind_angle);
+  RUN_TEST(test_apparent_wind_speed);
+  RUN_TEST(test_speed_through_water);
+  RUN_TEST(test_water_temperature);
+  RUN_TEST(test_compass_heading);
+  RUN_TEST(test_autopilot_course);
+  RUN_TEST(test_short_datagrams_are_ignored);
+  RUN_TEST(test_byte_stream_framing);
+  return UNITY_END();
+}